@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBSbsParser.h"
+#include "ADSBTCPLink.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QString>
+
+#include <array>
+
+namespace {
+    // SBS-1 field positions
+    constexpr int kFieldTransmissionType = 1;
+    constexpr int kFieldIcaoAddress = 4;
+    constexpr int kFieldCallsign = 10;
+    constexpr int kFieldAltitude = 11;
+    constexpr int kFieldTrack = 13;
+    constexpr int kFieldLatitude = 14;
+    constexpr int kFieldLongitude = 15;
+    constexpr int kFieldAlert = 19;
+}
+
+qsizetype ADSBSbsParser::parse(QByteArrayView data)
+{
+    qsizetype consumed = 0;
+    while (consumed < data.size()) {
+        const qsizetype newline = data.indexOf('\n', consumed);
+        if (newline < 0) {
+            break;
+        }
+
+        (void) parseLine(data.sliced(consumed, newline - consumed));
+        consumed = newline + 1;
+    }
+
+    if ((data.size() - consumed) > kMaxLineLength) {
+        qCDebug(ADSBTCPLinkLog) << "ADSB SBS-1 dropping" << (data.size() - consumed) << "bytes without a line terminator";
+        consumed = data.size();
+    }
+
+    return consumed;
+}
+
+bool ADSBSbsParser::parseLine(QByteArrayView line)
+{
+    _lineCount++;
+
+    while (line.endsWith('\n') || line.endsWith('\r')) {
+        line.chop(1);
+    }
+
+    if (!line.startsWith("MSG,")) {
+        return false;
+    }
+
+    std::array<QByteArrayView, kFieldCount> values;
+    int valueCount = 0;
+    qsizetype start = 0;
+    while (valueCount < kFieldCount) {
+        const qsizetype comma = line.indexOf(',', start);
+        if (comma < 0) {
+            values[valueCount++] = line.sliced(start);
+            break;
+        }
+        values[valueCount++] = line.sliced(start, comma - start);
+        start = comma + 1;
+    }
+
+    if (valueCount <= kFieldIcaoAddress) {
+        return false;
+    }
+
+    bool msgTypeOk;
+    const int msgType = values[kFieldTransmissionType].toInt(&msgTypeOk);
+    if (!msgTypeOk) {
+        qCDebug(ADSBTCPLinkLog) << "ADSB Invalid message type" << values[kFieldTransmissionType];
+        return false;
+    }
+
+    // Skip unsupported mesg types to avoid parsing
+    if ((msgType == ADSB::SurfacePosition) || (msgType > ADSB::SurveillanceId) || (msgType < ADSB::IdentificationAndCategory)) {
+        return false;
+    }
+
+    bool icaoOk;
+    const uint32_t icaoAddress = values[kFieldIcaoAddress].toUInt(&icaoOk, 16);
+    if (!icaoOk) {
+        return false;
+    }
+
+    switch (msgType) {
+    case ADSB::IdentificationAndCategory:
+    case ADSB::SurveillanceAltitude:
+    case ADSB::SurveillanceId:
+    {
+        if (valueCount <= kFieldCallsign) {
+            return false;
+        }
+
+        const QByteArrayView callsign = values[kFieldCallsign].trimmed();
+        if (callsign.isEmpty()) {
+            return false;
+        }
+
+        ADSB::VehicleInfo_t &adsbInfo = _pendingUpdate(icaoAddress);
+        const QLatin1String latin1Callsign(callsign.data(), callsign.size());
+        if (adsbInfo.callsign != latin1Callsign) {
+            adsbInfo.callsign = latin1Callsign;
+        }
+        adsbInfo.availableFlags |= ADSB::CallsignAvailable;
+        return true;
+    }
+    case ADSB::AirbornePosition:
+    {
+        if (valueCount <= kFieldAlert) {
+            return false;
+        }
+
+        // Altitude is either Barometric - based on pressure, in ft
+        // or HAE - as reported by GPS - based on WGS84 Ellipsoid, in ft
+        // If altitude ends with H, we have HAE
+        // There's a slight difference between Barometric alt and HAE, but it would require
+        // knowledge about Geoid shape in particular Lat, Lon. It's not worth complicating the code
+        QByteArrayView altitudeStr = values[kFieldAltitude];
+        if (altitudeStr.endsWith('H')) {
+            altitudeStr.chop(1);
+        }
+
+        bool altOk, latOk, lonOk, alertOk;
+        const int modeCAltitude = altitudeStr.toInt(&altOk);
+        const double lat = values[kFieldLatitude].toDouble(&latOk);
+        const double lon = values[kFieldLongitude].toDouble(&lonOk);
+        const int alert = values[kFieldAlert].toInt(&alertOk);
+
+        if (!altOk || !latOk || !lonOk || !alertOk) {
+            return false;
+        }
+
+        if (qFuzzyIsNull(lat) && qFuzzyIsNull(lon)) {
+            return false;
+        }
+
+        ADSB::VehicleInfo_t &adsbInfo = _pendingUpdate(icaoAddress);
+        adsbInfo.location = QGeoCoordinate(lat, lon);
+        adsbInfo.altitude = modeCAltitude * 0.3048;
+        adsbInfo.alert = (alert == 1);
+        adsbInfo.availableFlags |= ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::AlertAvailable;
+        return true;
+    }
+    case ADSB::AirborneVelocity:
+    {
+        if (valueCount <= kFieldTrack) {
+            return false;
+        }
+
+        bool headingOk;
+        const double heading = values[kFieldTrack].toDouble(&headingOk);
+        if (!headingOk) {
+            return false;
+        }
+
+        ADSB::VehicleInfo_t &adsbInfo = _pendingUpdate(icaoAddress);
+        adsbInfo.heading = heading;
+        adsbInfo.availableFlags |= ADSB::HeadingAvailable;
+        return true;
+    }
+    default:
+        break;
+    }
+
+    return false;
+}
+
+ADSB::VehicleInfo_t &ADSBSbsParser::_pendingUpdate(uint32_t icaoAddress)
+{
+    const auto it = _updateIndexMap.constFind(icaoAddress);
+    if (it != _updateIndexMap.constEnd()) {
+        return _updates[it.value()];
+    }
+
+    (void) _updateIndexMap.insert(icaoAddress, _updates.count());
+    ADSB::VehicleInfo_t &adsbInfo = _updates.emplaceBack();
+    adsbInfo.icaoAddress = icaoAddress;
+    adsbInfo.altitude = 0;
+    adsbInfo.heading = 0;
+    adsbInfo.alert = false;
+    adsbInfo.availableFlags = {};
+    return adsbInfo;
+}
+
+void ADSBSbsParser::clearUpdates()
+{
+    // _updates keeps its capacity for the next batch
+    _updates.clear();
+    _updateIndexMap.clear();
+}
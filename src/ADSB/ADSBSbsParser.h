@@ -0,0 +1,51 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+
+#include "ADSB.h"
+
+/// Parses SBS-1 (BaseStation) text straight out of a byte buffer.
+///
+/// Fields are sliced in place, so a line costs no allocations unless it carries a new callsign. Every line is
+/// merged into a single pending update per ICAO address, so a burst of messages for one aircraft collapses into
+/// one update holding its latest state.
+class ADSBSbsParser
+{
+public:
+    /// Parses every complete line at the start of data
+    ///     @return Number of bytes consumed, a trailing partial line is left for the next call
+    qsizetype parse(QByteArrayView data);
+
+    /// Parses one line, with or without its line terminator
+    ///     @return true if the line updated an aircraft
+    bool parseLine(QByteArrayView line);
+
+    /// Merged updates since the last clearUpdates(), in order of first arrival
+    const QList<ADSB::VehicleInfo_t> &updates() const { return _updates; }
+    void clearUpdates();
+
+    quint64 lineCount() const { return _lineCount; }
+
+    static constexpr qsizetype kMaxLineLength = 512;    ///< Longer partial lines are treated as garbage and dropped
+
+private:
+    /// @return Pending update for the aircraft, created with no available info if this is its first line
+    ADSB::VehicleInfo_t &_pendingUpdate(uint32_t icaoAddress);
+
+    QList<ADSB::VehicleInfo_t> _updates;
+    QHash<uint32_t, qsizetype> _updateIndexMap;     ///< ICAO address to index in _updates
+    quint64 _lineCount = 0;
+
+    static constexpr int kFieldCount = 22;
+};
@@ -0,0 +1,203 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBTrafficModel.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(ADSBTrafficModelLog, "qgc.adsb.adsbtrafficmodel")
+
+ADSBTrafficModel::ADSBTrafficModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    _publishTimer.setInterval(kPublishIntervalMSecs);
+    (void) connect(&_publishTimer, &QTimer::timeout, this, &ADSBTrafficModel::_publish);
+
+    _clock.start();
+
+    // qCDebug(ADSBTrafficModelLog) << Q_FUNC_INFO << this;
+}
+
+ADSBTrafficModel::~ADSBTrafficModel()
+{
+    // qCDebug(ADSBTrafficModelLog) << Q_FUNC_INFO << this;
+}
+
+void ADSBTrafficModel::update(const ADSB::VehicleInfo_t &vehicleInfo)
+{
+    const qint64 nowMsecs = _clock.elapsed();
+    int row = _table.rowOf(vehicleInfo.icaoAddress);
+
+    if (row < 0) {
+        if (!(vehicleInfo.availableFlags & ADSB::LocationAvailable)) {
+            return;
+        }
+
+        beginInsertRows(QModelIndex(), count(), count());
+        (void) _table.update(vehicleInfo, nowMsecs, row);
+        (void) _dirtyRows.append(false);
+        endInsertRows();
+
+        qCDebug(ADSBTrafficModelLog) << "Added" << QString::number(vehicleInfo.icaoAddress, 16);
+        emit countChanged(count());
+
+        if (!_publishTimer.isActive()) {
+            _publishTimer.start();
+        }
+        return;
+    }
+
+    if ((_table.update(vehicleInfo, nowMsecs, row) == ADSBTrafficTable::Changed) && !_dirtyRows[row]) {
+        _dirtyRows[row] = true;
+        _dirtyCount++;
+    }
+}
+
+void ADSBTrafficModel::clear()
+{
+    _publishTimer.stop();
+
+    beginResetModel();
+    _table.clear();
+    _dirtyRows.clear();
+    _dirtyCount = 0;
+    endResetModel();
+
+    emit countChanged(0);
+}
+
+QList<uint32_t> ADSBTrafficModel::trafficWithin(const QGeoCoordinate &center, double radiusMeters) const
+{
+    const QList<int> rows = _table.rowsWithin(center, radiusMeters);
+
+    QList<uint32_t> icaoAddresses;
+    icaoAddresses.reserve(rows.count());
+    for (const int row : rows) {
+        (void) icaoAddresses.append(_table.icaoAddress(row));
+    }
+
+    return icaoAddresses;
+}
+
+void ADSBTrafficModel::_publish()
+{
+    const qint64 nowMsecs = _clock.elapsed();
+    if ((nowMsecs - _lastExpirySweepMsecs) >= 1000) {
+        _lastExpirySweepMsecs = nowMsecs;
+        _removeExpired(nowMsecs);
+    }
+
+    if (_dirtyCount > 0) {
+        int rangeCount = 0;
+        int firstDirty = -1;
+        for (int row = 0; row <= count(); row++) {
+            const bool dirty = (row < count()) && _dirtyRows[row];
+            if (dirty) {
+                _dirtyRows[row] = false;
+                if (firstDirty < 0) {
+                    firstDirty = row;
+                }
+            } else if (firstDirty >= 0) {
+                emit dataChanged(index(firstDirty), index(row - 1));
+                firstDirty = -1;
+                rangeCount++;
+            }
+        }
+
+        qCDebug(ADSBTrafficModelLog) << "Published" << _dirtyCount << "rows in" << rangeCount << "ranges";
+        _dirtyCount = 0;
+    }
+
+    if (count() == 0) {
+        _publishTimer.stop();
+    }
+}
+
+void ADSBTrafficModel::_removeExpired(qint64 nowMsecs)
+{
+    const int oldCount = count();
+
+    // Walking backwards means the row moved into a removed slot has already been checked
+    for (int row = count() - 1; row >= 0; row--) {
+        if ((nowMsecs - _table.lastUpdateMsecs(row)) < kExpirationTimeoutMSecs) {
+            continue;
+        }
+
+        qCDebug(ADSBTrafficModelLog) << "Expired" << QString::number(_table.icaoAddress(row), 16);
+
+        // The last row takes the place of the expired one, so the views see the last row go away and the
+        // expired row change on the next publish
+        const int last = count() - 1;
+        beginRemoveRows(QModelIndex(), last, last);
+        _table.removeRow(row);
+        if (_dirtyRows[last]) {
+            _dirtyCount--;
+        }
+        if ((row != last) && !_dirtyRows[row]) {
+            _dirtyRows[row] = true;
+            _dirtyCount++;
+        }
+        _dirtyRows.removeLast();
+        endRemoveRows();
+    }
+
+    if (count() != oldCount) {
+        emit countChanged(count());
+    }
+}
+
+int ADSBTrafficModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return count();
+}
+
+QVariant ADSBTrafficModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() < 0) || (index.row() >= count())) {
+        return QVariant();
+    }
+
+    const int row = index.row();
+    switch (role) {
+    case IcaoAddressRole:
+        return QVariant::fromValue(static_cast<uint>(_table.icaoAddress(row)));
+    case Qt::DisplayRole:
+    case CallsignRole:
+        return _table.callsign(row);
+    case CoordinateRole:
+        return QVariant::fromValue(_table.coordinate(row));
+    case AltitudeRole:
+        return _table.altitude(row);
+    case HeadingRole:
+        return _table.heading(row);
+    case AlertRole:
+        return _table.alert(row);
+    default:
+        break;
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> ADSBTrafficModel::roleNames() const
+{
+    static const QHash<int, QByteArray> roles = {
+        { IcaoAddressRole, "icaoAddress" },
+        { CallsignRole, "callsign" },
+        { CoordinateRole, "coordinate" },
+        { AltitudeRole, "altitude" },
+        { HeadingRole, "heading" },
+        { AlertRole, "alert" },
+    };
+
+    return roles;
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QTimer>
+
+#include "ADSB.h"
+#include "ADSBTrafficTable.h"
+
+Q_DECLARE_LOGGING_CATEGORY(ADSBTrafficModelLog)
+
+/// List model exposing the ADS-B traffic table to QML, one row per aircraft.
+///
+/// New aircraft are inserted right away. Changes to known aircraft only mark their row dirty, and the dirty rows are
+/// published as contiguous dataChanged ranges on a fixed interval, so a burst of position reports costs the views a
+/// handful of signals instead of one per field per aircraft. Aircraft which stop reporting are removed on the same
+/// clock.
+class ADSBTrafficModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        IcaoAddressRole = Qt::UserRole,
+        CallsignRole,
+        CoordinateRole,
+        AltitudeRole,
+        HeadingRole,
+        AlertRole,
+    };
+
+    explicit ADSBTrafficModel(QObject *parent = nullptr);
+    ~ADSBTrafficModel();
+
+    int count() const { return _table.count(); }
+    const ADSBTrafficTable &table() const { return _table; }
+
+    void update(const ADSB::VehicleInfo_t &vehicleInfo);
+    /// Removes all aircraft
+    void clear();
+
+    /// @return ICAO addresses of all aircraft within radiusMeters of center
+    QList<uint32_t> trafficWithin(const QGeoCoordinate &center, double radiusMeters) const;
+
+    // Overrides from QAbstractListModel
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    static constexpr int kPublishIntervalMSecs = 100;
+    static constexpr qint64 kExpirationTimeoutMSecs = 120000;   ///< Aircraft with no update for this long are removed
+
+signals:
+    void countChanged(int count);
+
+private slots:
+    void _publish();
+
+private:
+    void _removeExpired(qint64 nowMsecs);
+
+    ADSBTrafficTable _table;
+    QList<bool> _dirtyRows;             ///< Rows changed since the last publish, kept the same length as the table
+    int _dirtyCount = 0;
+    QTimer _publishTimer;
+    QElapsedTimer _clock;
+    qint64 _lastExpirySweepMsecs = 0;
+
+    friend class ADSBTest;
+};
@@ -0,0 +1,239 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ADSBTrafficTable.h"
+#include "QGC.h"
+
+#include <QtCore/QtMath>
+
+namespace {
+    constexpr double kEarthMeanRadiusMeters = 6371007.2;    ///< Same radius QGeoCoordinate::distanceTo uses
+    constexpr double kMetersPerDegreeLat = (kEarthMeanRadiusMeters * M_PI) / 180.0;
+}
+
+ADSBTrafficTable::UpdateResult ADSBTrafficTable::update(const ADSB::VehicleInfo_t &vehicleInfo, qint64 nowMsecs, int &row)
+{
+    row = rowOf(vehicleInfo.icaoAddress);
+
+    bool added = false;
+    if (row < 0) {
+        if (!(vehicleInfo.availableFlags & ADSB::LocationAvailable)) {
+            return Ignored;
+        }
+
+        row = count();
+        (void) _icaoAddress.append(vehicleInfo.icaoAddress);
+        (void) _callsign.append(QString());
+        (void) _latitude.append(vehicleInfo.location.latitude());
+        (void) _longitude.append(vehicleInfo.location.longitude());
+        (void) _altitude.append(0);
+        (void) _heading.append(0);
+        (void) _alert.append(false);
+        (void) _lastUpdateMsecs.append(nowMsecs);
+        (void) _cell.append(0);
+        (void) _rowMap.insert(vehicleInfo.icaoAddress, row);
+        _addToCell(row);
+        added = true;
+    }
+
+    bool changed = false;
+
+    if (vehicleInfo.availableFlags & ADSB::CallsignAvailable) {
+        if (vehicleInfo.callsign != _callsign[row]) {
+            _callsign[row] = vehicleInfo.callsign;
+            changed = true;
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
+        const double lat = vehicleInfo.location.latitude();
+        const double lon = vehicleInfo.location.longitude();
+        if (!QGC::fuzzyCompare(lat, _latitude[row]) || !QGC::fuzzyCompare(lon, _longitude[row])) {
+            _latitude[row] = lat;
+            _longitude[row] = lon;
+            const quint32 cell = _cellKey(_latCell(lat), _lonCell(lon));
+            if (cell != _cell[row]) {
+                _removeFromCell(row);
+                _addToCell(row);
+            }
+            changed = true;
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::AltitudeAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.altitude, _altitude[row])) {
+            _altitude[row] = vehicleInfo.altitude;
+            changed = true;
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::HeadingAvailable) {
+        if (!QGC::fuzzyCompare(vehicleInfo.heading, _heading[row])) {
+            _heading[row] = vehicleInfo.heading;
+            changed = true;
+        }
+    }
+
+    if (vehicleInfo.availableFlags & ADSB::AlertAvailable) {
+        if (vehicleInfo.alert != _alert[row]) {
+            _alert[row] = vehicleInfo.alert;
+            changed = true;
+        }
+    }
+
+    _lastUpdateMsecs[row] = nowMsecs;
+
+    if (added) {
+        return Added;
+    }
+    return (changed ? Changed : Unchanged);
+}
+
+void ADSBTrafficTable::removeRow(int row)
+{
+    const int last = count() - 1;
+
+    _removeFromCell(row);
+    (void) _rowMap.remove(_icaoAddress[row]);
+
+    if (row != last) {
+        _removeFromCell(last);
+
+        _icaoAddress[row] = _icaoAddress[last];
+        _callsign[row] = std::move(_callsign[last]);
+        _latitude[row] = _latitude[last];
+        _longitude[row] = _longitude[last];
+        _altitude[row] = _altitude[last];
+        _heading[row] = _heading[last];
+        _alert[row] = _alert[last];
+        _lastUpdateMsecs[row] = _lastUpdateMsecs[last];
+
+        _rowMap[_icaoAddress[row]] = row;
+        _addToCell(row);
+    }
+
+    _icaoAddress.removeLast();
+    _callsign.removeLast();
+    _latitude.removeLast();
+    _longitude.removeLast();
+    _altitude.removeLast();
+    _heading.removeLast();
+    _alert.removeLast();
+    _lastUpdateMsecs.removeLast();
+    _cell.removeLast();
+}
+
+void ADSBTrafficTable::clear()
+{
+    _icaoAddress.clear();
+    _callsign.clear();
+    _latitude.clear();
+    _longitude.clear();
+    _altitude.clear();
+    _heading.clear();
+    _alert.clear();
+    _lastUpdateMsecs.clear();
+    _cell.clear();
+    _rowMap.clear();
+    _cellRows.clear();
+}
+
+QList<int> ADSBTrafficTable::rowsWithin(const QGeoCoordinate &center, double radiusMeters) const
+{
+    QList<int> rows;
+    if (!center.isValid() || (radiusMeters < 0) || _icaoAddress.isEmpty()) {
+        return rows;
+    }
+
+    const double lat = center.latitude();
+    const double lon = center.longitude();
+
+    // Longitude degrees shrink towards the poles, so size the search box at its poleward edge
+    const double latSpan = radiusMeters / kMetersPerDegreeLat;
+    const double poleward = qMin(90.0, qAbs(lat) + latSpan);
+    const double cosPoleward = qCos(qDegreesToRadians(poleward));
+    const double lonSpan = (cosPoleward > 1e-9) ? (latSpan / cosPoleward) : 360.0;
+
+    const int firstLatCell = _latCell(lat - latSpan);
+    const int lastLatCell = _latCell(lat + latSpan);
+    const int firstLonCell = static_cast<int>(qFloor((lon - lonSpan + 180.0) / kCellDegrees));
+    const int lastLonCell = static_cast<int>(qFloor((lon + lonSpan + 180.0) / kCellDegrees));
+    const int lonCellCount = qMin(kLonCells, lastLonCell - firstLonCell + 1);
+
+    const auto addIfWithin = [&](int row) {
+        if (distanceMeters(lat, lon, _latitude[row], _longitude[row]) <= radiusMeters) {
+            (void) rows.append(row);
+        }
+    };
+
+    // A box covering more cells than there are aircraft is cheaper to answer with a straight scan
+    if ((static_cast<qint64>(lastLatCell - firstLatCell + 1) * lonCellCount) >= _icaoAddress.count()) {
+        for (int row = 0; row < count(); row++) {
+            addIfWithin(row);
+        }
+        return rows;
+    }
+
+    for (int latCell = firstLatCell; latCell <= lastLatCell; latCell++) {
+        for (int i = 0; i < lonCellCount; i++) {
+            const int lonCell = (((firstLonCell + i) % kLonCells) + kLonCells) % kLonCells;
+            const auto it = _cellRows.constFind(_cellKey(latCell, lonCell));
+            if (it == _cellRows.constEnd()) {
+                continue;
+            }
+            for (const int row : it.value()) {
+                addIfWithin(row);
+            }
+        }
+    }
+
+    return rows;
+}
+
+double ADSBTrafficTable::distanceMeters(double lat1, double lon1, double lat2, double lon2)
+{
+    const double dlat = qDegreesToRadians(lat2 - lat1);
+    const double dlon = qDegreesToRadians(lon2 - lon1);
+    const double haversineDLat = qSin(dlat / 2.0) * qSin(dlat / 2.0);
+    const double haversineDLon = qSin(dlon / 2.0) * qSin(dlon / 2.0);
+    const double y = haversineDLat + (qCos(qDegreesToRadians(lat1)) * qCos(qDegreesToRadians(lat2)) * haversineDLon);
+    const double x = 2.0 * qAsin(qSqrt(y));
+    return x * kEarthMeanRadiusMeters;
+}
+
+int ADSBTrafficTable::_latCell(double lat)
+{
+    return qBound(0, static_cast<int>(qFloor((lat + 90.0) / kCellDegrees)), kLatCells - 1);
+}
+
+int ADSBTrafficTable::_lonCell(double lon)
+{
+    const int cell = static_cast<int>(qFloor((lon + 180.0) / kCellDegrees));
+    return ((cell % kLonCells) + kLonCells) % kLonCells;
+}
+
+void ADSBTrafficTable::_addToCell(int row)
+{
+    const quint32 cell = _cellKey(_latCell(_latitude[row]), _lonCell(_longitude[row]));
+    _cell[row] = cell;
+    (void) _cellRows[cell].append(row);
+}
+
+void ADSBTrafficTable::_removeFromCell(int row)
+{
+    const auto it = _cellRows.find(_cell[row]);
+    if (it == _cellRows.end()) {
+        return;
+    }
+
+    (void) it.value().removeOne(row);
+    if (it.value().isEmpty()) {
+        (void) _cellRows.erase(it);
+    }
+}
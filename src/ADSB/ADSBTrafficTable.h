@@ -0,0 +1,88 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtPositioning/QGeoCoordinate>
+
+#include "ADSB.h"
+
+/// Flat table of ADS-B traffic, one row per aircraft.
+///
+/// Each field lives in its own column so a sweep over positions or update times stays in cache and no per aircraft
+/// object is allocated. Rows are bucketed into a fixed latitude/longitude grid so range queries only look at the
+/// aircraft in nearby cells. Removing a row moves the last row into its place, so row indices are not stable across
+/// removals.
+class ADSBTrafficTable
+{
+public:
+    enum UpdateResult {
+        Ignored,    ///< Unknown aircraft without a location
+        Added,
+        Changed,
+        Unchanged,
+    };
+
+    /// Applies the fields flagged as available in vehicleInfo. A new row is only added once the aircraft has a
+    /// location.
+    ///     @param[out] row Row of the aircraft, -1 if the update was ignored
+    UpdateResult update(const ADSB::VehicleInfo_t &vehicleInfo, qint64 nowMsecs, int &row);
+
+    /// Moves the last row into row and drops the last row
+    void removeRow(int row);
+    void clear();
+
+    int count() const { return static_cast<int>(_icaoAddress.count()); }
+    /// @return Row of the aircraft, -1 if not in the table
+    int rowOf(uint32_t icaoAddress) const { return _rowMap.value(icaoAddress, -1); }
+
+    uint32_t icaoAddress(int row) const { return _icaoAddress[row]; }
+    const QString &callsign(int row) const { return _callsign[row]; }
+    double latitude(int row) const { return _latitude[row]; }
+    double longitude(int row) const { return _longitude[row]; }
+    QGeoCoordinate coordinate(int row) const { return QGeoCoordinate(_latitude[row], _longitude[row]); }
+    double altitude(int row) const { return _altitude[row]; }
+    double heading(int row) const { return _heading[row]; }
+    bool alert(int row) const { return _alert[row]; }
+    qint64 lastUpdateMsecs(int row) const { return _lastUpdateMsecs[row]; }
+
+    /// @return Rows of all aircraft within radiusMeters of center, in no particular order
+    QList<int> rowsWithin(const QGeoCoordinate &center, double radiusMeters) const;
+
+    /// Great circle distance matching QGeoCoordinate::distanceTo without building QGeoCoordinates
+    static double distanceMeters(double lat1, double lon1, double lat2, double lon2);
+
+    static constexpr double kCellDegrees = 0.25;    ///< About 28km of latitude
+    static constexpr int kLatCells = static_cast<int>(180 / kCellDegrees);
+    static constexpr int kLonCells = static_cast<int>(360 / kCellDegrees);
+
+private:
+    static int _latCell(double lat);
+    static int _lonCell(double lon);
+    static quint32 _cellKey(int latCell, int lonCell) { return static_cast<quint32>((latCell * kLonCells) + lonCell); }
+
+    void _addToCell(int row);
+    void _removeFromCell(int row);
+
+    QList<uint32_t> _icaoAddress;
+    QList<QString>  _callsign;
+    QList<double>   _latitude;
+    QList<double>   _longitude;
+    QList<double>   _altitude;
+    QList<double>   _heading;
+    QList<bool>     _alert;
+    QList<qint64>   _lastUpdateMsecs;
+    QList<quint32>  _cell;              ///< Grid cell each row is bucketed in
+
+    QHash<uint32_t, int> _rowMap;       ///< ICAO address to row
+    QHash<quint32, QList<int>> _cellRows;
+};
@@ -13,12 +13,10 @@
 #include "SettingsManager.h"
 #include "ADSBVehicleManagerSettings.h"
 #include "ADSBTCPLink.h"
-#include "ADSBVehicle.h"
-#include "QmlObjectListModel.h"
+#include "ADSBTrafficModel.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/qapplicationstatic.h>
-#include <QtCore/QTimer>
 #include <qassert.h>
 
 QGC_LOGGING_CATEGORY(ADSBVehicleManagerLog, "qgc.adsb.adsbvehiclemanager")
@@ -28,15 +26,10 @@ Q_APPLICATION_STATIC(ADSBVehicleManager, _adsbVehicleManager, qgcApp()->toolbox(
 ADSBVehicleManager::ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QObject *parent)
     : QObject(parent)
     , _adsbSettings(settings)
-    , _adsbVehicleCleanupTimer(new QTimer(this))
-    , _adsbVehicles(new QmlObjectListModel(this))
+    , _adsbVehicles(new ADSBTrafficModel(this))
 {
     (void) qRegisterMetaType<ADSB::VehicleInfo_t>("ADSB::VehicleInfo_t");
 
-    _adsbVehicleCleanupTimer->setSingleShot(false);
-    _adsbVehicleCleanupTimer->setInterval(1000);
-    (void) connect(_adsbVehicleCleanupTimer, &QTimer::timeout, this, &ADSBVehicleManager::_cleanupStaleVehicles);
-
     Fact* const adsbEnabled = _adsbSettings->adsbServerConnectEnabled();
     Fact* const hostAddress = _adsbSettings->adsbServerHostAddress();
     Fact* const port = _adsbSettings->adsbServerPort();
@@ -68,18 +61,12 @@ ADSBVehicleManager *ADSBVehicleManager::instance()
 
 void ADSBVehicleManager::adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo)
 {
-    const uint32_t icaoAddress = vehicleInfo.icaoAddress;
-    if (_adsbICAOMap.contains(icaoAddress)) {
-        _adsbICAOMap[icaoAddress]->update(vehicleInfo);
-        return;
-    }
+    _adsbVehicles->update(vehicleInfo);
+}
 
-    if (vehicleInfo.availableFlags & ADSB::LocationAvailable) {
-        ADSBVehicle* const adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-        _adsbICAOMap[icaoAddress] = adsbVehicle;
-        (void) _adsbVehicles->append(adsbVehicle);
-        qCDebug(ADSBVehicleManagerLog) << "Added" << QString::number(adsbVehicle->icaoAddress());
-    }
+QList<uint32_t> ADSBVehicleManager::trafficWithin(const QGeoCoordinate &center, double radiusMeters) const
+{
+    return _adsbVehicles->trafficWithin(center, radiusMeters);
 }
 
 void ADSBVehicleManager::_start(const QString &hostAddress, quint16 port)
@@ -88,8 +75,6 @@ void ADSBVehicleManager::_start(const QString &hostAddress, quint16 port)
     _adsbTcpLink = new ADSBTCPLink(QHostAddress(hostAddress), port, this);
     (void) connect(_adsbTcpLink, &ADSBTCPLink::adsbVehicleUpdate, this, &ADSBVehicleManager::adsbVehicleUpdate, Qt::AutoConnection);
     (void) connect(_adsbTcpLink, &ADSBTCPLink::errorOccurred, this, &ADSBVehicleManager::_linkError, Qt::AutoConnection);
-
-    _adsbVehicleCleanupTimer->start();
 }
 
 void ADSBVehicleManager::_stop()
@@ -98,23 +83,7 @@ void ADSBVehicleManager::_stop()
     _adsbTcpLink->deleteLater();
     _adsbTcpLink = nullptr;
 
-    _adsbVehicleCleanupTimer->stop();
-
-    _adsbVehicles->clearAndDeleteContents();
-    _adsbICAOMap.clear();
-}
-
-void ADSBVehicleManager::_cleanupStaleVehicles()
-{
-    for (qsizetype i = _adsbVehicles->count() - 1; i >= 0; i--) {
-        ADSBVehicle* const adsbVehicle = _adsbVehicles->value<ADSBVehicle*>(i);
-        if (adsbVehicle->expired()) {
-            qCDebug(ADSBVehicleManagerLog) << "Expired" << QString::number(adsbVehicle->icaoAddress());
-            (void) _adsbVehicles->removeAt(i);
-            (void) _adsbICAOMap.remove(adsbVehicle->icaoAddress());
-            adsbVehicle->deleteLater();
-        }
-    }
+    _adsbVehicles->clear();
 }
 
 void ADSBVehicleManager::_linkError(const QString &errorMsg, bool stopped)
@@ -17,17 +17,16 @@
 Q_DECLARE_LOGGING_CATEGORY(ADSBVehicleManagerLog)
 
 class ADSBTCPLink;
-class ADSBVehicle;
-class QmlObjectListModel;
-class QTimer;
+class ADSBTrafficModel;
 class ADSBVehicleManagerSettings;
+class QGeoCoordinate;
 
 class ADSBVehicleManager : public QObject
 {
     Q_OBJECT
-    Q_MOC_INCLUDE("QmlObjectListModel.h")
+    Q_MOC_INCLUDE("ADSBTrafficModel.h")
 
-    Q_PROPERTY(const QmlObjectListModel *adsbVehicles READ adsbVehicles CONSTANT)
+    Q_PROPERTY(ADSBTrafficModel *adsbVehicles READ adsbVehicles CONSTANT)
 
 public:
     ADSBVehicleManager(ADSBVehicleManagerSettings *settings, QObject *parent = nullptr);
@@ -35,13 +34,15 @@ public:
 
     static ADSBVehicleManager *instance();
 
-    const QmlObjectListModel *adsbVehicles() const { return _adsbVehicles; }
+    ADSBTrafficModel *adsbVehicles() const { return _adsbVehicles; }
+
+    /// @return ICAO addresses of all traffic within radiusMeters of center
+    QList<uint32_t> trafficWithin(const QGeoCoordinate &center, double radiusMeters) const;
 
 public slots:
     void adsbVehicleUpdate(const ADSB::VehicleInfo_t &vehicleInfo);
 
 private slots:
-    void _cleanupStaleVehicles();
     void _linkError(const QString &errorMsg, bool stopped = false);
 
 private:
@@ -49,9 +50,6 @@ private:
     void _stop();
 
     ADSBVehicleManagerSettings *_adsbSettings = nullptr;
-    QTimer *_adsbVehicleCleanupTimer = nullptr;
-    QmlObjectListModel *_adsbVehicles = nullptr;
-
-    QMap<uint32_t, ADSBVehicle*> _adsbICAOMap;
+    ADSBTrafficModel *_adsbVehicles = nullptr;
     ADSBTCPLink *_adsbTcpLink = nullptr;
 };
@@ -11,9 +11,16 @@
 #include "MAVLinkInspectorController.h"
 #include "QGC.h"
 #include "MAVLinkMessageField.h"
+#include "QGCApplication.h"
+#include "QGCToolbox.h"
 #include "QGCLoggingCategory.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
 
 #include <QtCharts/QAbstractSeries>
+#include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
 
 QGC_LOGGING_CATEGORY(MAVLinkChartControllerLog, "qgc.analyzeview.mavlinkchartcontroller")
 
@@ -77,7 +84,7 @@ MAVLinkChartController::updateYRange()
 {
     if(_chartFields.count()) {
         qreal vmin  = std::numeric_limits<qreal>::max();
-        qreal vmax  = std::numeric_limits<qreal>::min();
+        qreal vmax  = std::numeric_limits<qreal>::lowest();
         for(int i = 0; i < _chartFields.count(); i++) {
             QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
             QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
@@ -149,3 +156,37 @@ MAVLinkChartController::delSeries(QGCMAVLinkMessageField* field)
         }
     }
 }
+
+//-----------------------------------------------------------------------------
+QString
+MAVLinkChartController::exportSeries()
+{
+    const QString saveDirPath = qgcApp()->toolbox()->settingsManager()->appSettings()->telemetrySavePath();
+    if(saveDirPath.isEmpty()) {
+        return QString();
+    }
+    const QString filename = QDir(saveDirPath).filePath(QStringLiteral("Inspector_%1.csv").arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd_hh.mm.ss"))));
+    return exportCsv(filename) ? filename : QString();
+}
+
+//-----------------------------------------------------------------------------
+bool
+MAVLinkChartController::exportCsv(const QString& filename)
+{
+    QSaveFile file(filename);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qCWarning(MAVLinkChartControllerLog) << "Unable to export chart" << filename << file.errorString();
+        return false;
+    }
+    QTextStream stream(&file);
+    stream << "field,time_ms,value\n";
+    for(int i = 0; i < _chartFields.count(); i++) {
+        QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
+        QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
+        if(pField) {
+            pField->chartSeries().writeCsv(stream, pField->label());
+        }
+    }
+    stream.flush();
+    return file.commit();
+}
@@ -54,6 +54,11 @@ public:
 
     Q_INVOKABLE MAVLinkInspectorController* controller() { return _controller; }
 
+    /// Writes the buffered samples of every charted field to a CSV file in the telemetry save path
+    /// @return Path of the file written, empty on failure
+    Q_INVOKABLE QString     exportSeries        ();
+    bool                    exportCsv           (const QString& filename);
+
     QVariantList            chartFields         () { return _chartFields; }
     QDateTime               rangeXMin           () { return _rangeXMin;   }
     QDateTime               rangeXMax           () { return _rangeXMax;   }
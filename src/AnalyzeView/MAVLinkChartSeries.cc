@@ -0,0 +1,119 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChartSeries.h"
+
+#include <QtCore/QTextStream>
+
+MAVLinkChartSeries::MAVLinkChartSeries(qsizetype capacity)
+    : _capacity(qMax<qsizetype>(1, capacity))
+{
+
+}
+
+void MAVLinkChartSeries::append(qint64 timeMsecs, double value)
+{
+    if (_count < _capacity) {
+        if (_times.isEmpty()) {
+            _times.reserve(_capacity);
+            _values.reserve(_capacity);
+        }
+        (void) _times.append(timeMsecs);
+        (void) _values.append(value);
+        _count++;
+    } else {
+        _times[_head] = timeMsecs;
+        _values[_head] = value;
+        _head = (_head + 1) % _capacity;
+    }
+}
+
+void MAVLinkChartSeries::clear()
+{
+    _times.clear();
+    _times.squeeze();
+    _values.clear();
+    _values.squeeze();
+    _head = 0;
+    _count = 0;
+}
+
+qsizetype MAVLinkChartSeries::_lowerBound(qint64 timeMsecs) const
+{
+    qsizetype first = 0;
+    qsizetype length = _count;
+    while (length > 0) {
+        const qsizetype half = length / 2;
+        if (timeAt(first + half) < timeMsecs) {
+            first += half + 1;
+            length -= half + 1;
+        } else {
+            length = half;
+        }
+    }
+
+    return first;
+}
+
+QList<QPointF> MAVLinkChartSeries::decimate(qint64 minTimeMsecs, qint64 maxTimeMsecs, int columns, double &minValue, double &maxValue) const
+{
+    QList<QPointF> points;
+    if ((_count == 0) || (columns <= 0) || (maxTimeMsecs < minTimeMsecs)) {
+        return points;
+    }
+
+    const qint64 span = maxTimeMsecs - minTimeMsecs + 1;
+    qsizetype index = _lowerBound(minTimeMsecs);
+    if ((index >= _count) || (timeAt(index) > maxTimeMsecs)) {
+        return points;
+    }
+
+    points.reserve(qMin<qsizetype>(_count - index, 2 * columns));
+    minValue = valueAt(index);
+    maxValue = minValue;
+
+    while ((index < _count) && (timeAt(index) <= maxTimeMsecs)) {
+        const qint64 column = ((timeAt(index) - minTimeMsecs) * columns) / span;
+
+        qsizetype columnMin = index;
+        qsizetype columnMax = index;
+        for (index++; index < _count; index++) {
+            const qint64 time = timeAt(index);
+            if ((time > maxTimeMsecs) || ((((time - minTimeMsecs) * columns) / span) != column)) {
+                break;
+            }
+            const double value = valueAt(index);
+            if (value < valueAt(columnMin)) {
+                columnMin = index;
+            }
+            if (value > valueAt(columnMax)) {
+                columnMax = index;
+            }
+        }
+
+        const qsizetype first = qMin(columnMin, columnMax);
+        const qsizetype last = qMax(columnMin, columnMax);
+        (void) points.append(QPointF(timeAt(first), valueAt(first)));
+        if (last != first) {
+            (void) points.append(QPointF(timeAt(last), valueAt(last)));
+        }
+
+        minValue = qMin(minValue, valueAt(columnMin));
+        maxValue = qMax(maxValue, valueAt(columnMax));
+    }
+
+    return points;
+}
+
+void MAVLinkChartSeries::writeCsv(QTextStream &stream, const QString &label) const
+{
+    for (qsizetype i = 0; i < _count; i++) {
+        stream << label << ',' << timeAt(i) << ',' << QString::number(valueAt(i), 'g', 17) << '\n';
+    }
+}
@@ -0,0 +1,61 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+
+class QTextStream;
+
+/// Fixed capacity ring buffer holding one charted MAVLink field.
+///
+/// Times and values are kept in separate columns so appending a sample never allocates and a scan over the
+/// times does not drag the values through the cache. Storage is only allocated once the first sample arrives.
+class MAVLinkChartSeries
+{
+public:
+    explicit MAVLinkChartSeries(qsizetype capacity = kDefaultCapacity);
+
+    /// Overwrites the oldest sample once the buffer is full
+    void        append      (qint64 timeMsecs, double value);
+    /// Drops all samples and releases the storage
+    void        clear       ();
+
+    qsizetype   count       () const { return _count; }
+    qsizetype   capacity    () const { return _capacity; }
+
+    /// @param index 0 is the oldest sample
+    qint64      timeAt      (qsizetype index) const { return _times[_physicalIndex(index)]; }
+    double      valueAt     (qsizetype index) const { return _values[_physicalIndex(index)]; }
+
+    /// Reduces the samples inside [minTimeMsecs, maxTimeMsecs] to at most two points per column, the smallest and
+    /// largest value in that column in time order. With one column per pixel the line drawn is the same as the
+    /// line through every sample.
+    ///     @param[out] minValue Smallest value in the window, untouched if the window is empty
+    ///     @param[out] maxValue Largest value in the window, untouched if the window is empty
+    QList<QPointF> decimate (qint64 minTimeMsecs, qint64 maxTimeMsecs, int columns, double &minValue, double &maxValue) const;
+
+    /// Writes one "label,time,value" row per sample, oldest first
+    void        writeCsv    (QTextStream &stream, const QString &label) const;
+
+    static constexpr qsizetype kDefaultCapacity = 100 * 60;    ///< One minute at 100Hz
+
+private:
+    qsizetype   _physicalIndex  (qsizetype index) const { return (_head + index) % _capacity; }
+    /// @return Index of the first sample at or after timeMsecs
+    qsizetype   _lowerBound     (qint64 timeMsecs) const;
+
+    QList<qint64>   _times;
+    QList<double>   _values;
+    qsizetype       _capacity;
+    qsizetype       _head   = 0;    ///< Physical index of the oldest sample
+    qsizetype       _count  = 0;
+};
@@ -13,11 +13,22 @@
 
 QGC_LOGGING_CATEGORY(MAVLinkMessageLog, "qgc.analyzeview.mavlinkmessage")
 
+template<typename T>
+static qreal _readField(const uint8_t* data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return static_cast<qreal>(value);
+}
+
 //-----------------------------------------------------------------------------
 QGCMAVLinkMessage::QGCMAVLinkMessage(QObject *parent, mavlink_message_t* message)
     : QObject(parent)
 {
     _message = *message;
+    _fieldUpdateTimer.setSingleShot(true);
+    _fieldUpdateTimer.setInterval(kFieldUpdateMsecs);
+    connect(&_fieldUpdateTimer, &QTimer::timeout, this, &QGCMAVLinkMessage::_updateFields);
     const mavlink_message_info_t* msgInfo = mavlink_get_message_info(message);
     if (!msgInfo) {
         qCWarning(MAVLinkMessageLog) << QStringLiteral("QGCMAVLinkMessage NULL msgInfo msgid(%1)").arg(message->msgid);
@@ -106,9 +117,13 @@ QGCMAVLinkMessage::update(mavlink_message_t* message)
     _count++;
     _message = *message;
 
-    if (_selected) {
-        // Don't update field info unless selected to reduce perf hit of message processing
-        _updateFields();
+    if (_fieldSelected) {
+        // Charted fields need every sample, but only as a number
+        _updateChartSamples();
+    }
+    if (_selected && !_fieldUpdateTimer.isActive()) {
+        // Field text is only formatted for the message being shown, and no faster than it can be read
+        _fieldUpdateTimer.start();
     }
     emit countChanged();
 }
@@ -139,12 +154,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                     // Enforce null termination
                     str[array_length - 1] = '\0';
                     QString v(str);
-                    f->updateValue(v, 0);
+                    f->updateValue(v);
                 } else {
                     // Single char
                     char b = *(reinterpret_cast<char*>(m + offset));
                     QString v(b);
-                    f->updateValue(v, 0);
+                    f->updateValue(v);
                 }
                 break;
             case MAVLINK_TYPE_UINT8_T:
@@ -156,11 +171,11 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint8_t u = *(m + offset);
-                    f->updateValue(QString::number(u), static_cast<qreal>(u));
+                    f->updateValue(QString::number(u));
                 }
                 break;
             case MAVLINK_TYPE_INT8_T:
@@ -172,11 +187,11 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int8_t n = *(reinterpret_cast<int8_t*>(m + offset));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_UINT16_T:
@@ -189,12 +204,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint16_t n;
                     memcpy(&n, m + offset, sizeof(uint16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_INT16_T:
@@ -207,12 +222,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int16_t n;
                     memcpy(&n, m + offset, sizeof(int16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_UINT32_T:
@@ -225,7 +240,7 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint32_t n;
@@ -233,9 +248,9 @@ void QGCMAVLinkMessage::_updateFields(void)
                     //-- Special case
                     if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                         QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n),Qt::UTC,0);
-                        f->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
+                        f->updateValue(d.toString("HH:mm:ss"));
                     } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
+                        f->updateValue(QString::number(n));
                     }
                 }
                 break;
@@ -249,12 +264,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int32_t n;
                     memcpy(&n, m + offset, sizeof(int32_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             case MAVLINK_TYPE_FLOAT:
@@ -267,12 +282,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                        string += tmp.arg(static_cast<double>(nums[j]));
                     }
                     string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     float fv;
                     memcpy(&fv, m + offset, sizeof(float));
-                    f->updateValue(QString::number(static_cast<double>(fv)), static_cast<qreal>(fv));
+                    f->updateValue(QString::number(static_cast<double>(fv)));
                 }
                 break;
             case MAVLINK_TYPE_DOUBLE:
@@ -285,12 +300,12 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     double d;
                     memcpy(&d, m + offset, sizeof(double));
-                    f->updateValue(QString::number(d), static_cast<qreal>(d));
+                    f->updateValue(QString::number(d));
                 }
                 break;
             case MAVLINK_TYPE_UINT64_T:
@@ -303,7 +318,7 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     uint64_t n;
@@ -311,9 +326,9 @@ void QGCMAVLinkMessage::_updateFields(void)
                     //-- Special case
                     if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
                         QDateTime d = QDateTime::fromMSecsSinceEpoch(n/1000,Qt::UTC,0);
-                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
+                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"));
                     } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
+                        f->updateValue(QString::number(n));
                     }
                 }
                 break;
@@ -327,15 +342,44 @@ void QGCMAVLinkMessage::_updateFields(void)
                         string += tmp.arg(nums[j]);
                     }
                     string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
+                    f->updateValue(string);
                 } else {
                     // Single value
                     int64_t n;
                     memcpy(&n, m + offset, sizeof(int64_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
+                    f->updateValue(QString::number(n));
                 }
                 break;
             }
         }
     }
 }
+
+void QGCMAVLinkMessage::_updateChartSamples(void)
+{
+    const mavlink_message_info_t* msgInfo = mavlink_get_message_info(&_message);
+    if (!msgInfo || (_fields.count() != static_cast<int>(msgInfo->num_fields))) {
+        return;
+    }
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
+    for (int i = 0; i < _fields.count(); ++i) {
+        QGCMAVLinkMessageField* f = qobject_cast<QGCMAVLinkMessageField*>(_fields.get(i));
+        if (f && f->selected()) {
+            // Array fields chart their first element
+            const uint8_t* value = m + msgInfo->fields[i].wire_offset;
+            switch (msgInfo->fields[i].type) {
+            case MAVLINK_TYPE_UINT8_T:  f->appendSample(static_cast<qreal>(*value)); break;
+            case MAVLINK_TYPE_INT8_T:   f->appendSample(static_cast<qreal>(*reinterpret_cast<const int8_t*>(value))); break;
+            case MAVLINK_TYPE_UINT16_T: f->appendSample(_readField<uint16_t>(value)); break;
+            case MAVLINK_TYPE_INT16_T:  f->appendSample(_readField<int16_t>(value)); break;
+            case MAVLINK_TYPE_UINT32_T: f->appendSample(_readField<uint32_t>(value)); break;
+            case MAVLINK_TYPE_INT32_T:  f->appendSample(_readField<int32_t>(value)); break;
+            case MAVLINK_TYPE_FLOAT:    f->appendSample(_readField<float>(value)); break;
+            case MAVLINK_TYPE_DOUBLE:   f->appendSample(_readField<double>(value)); break;
+            case MAVLINK_TYPE_UINT64_T: f->appendSample(_readField<uint64_t>(value)); break;
+            case MAVLINK_TYPE_INT64_T:  f->appendSample(_readField<int64_t>(value)); break;
+            default: break;
+            }
+        }
+    }
+}
@@ -15,6 +15,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QTimer>
 #include <QtCore/QLoggingCategory>
 #include <QtQmlIntegration/QtQmlIntegration>
 
@@ -72,6 +73,9 @@ signals:
 
 private:
     void _updateFields(void);
+    void _updateChartSamples(void);
+
+    static constexpr int kFieldUpdateMsecs = 100;   ///< Field text refresh, 10Hz
 
     QmlObjectListModel  _fields;
     QString             _name;
@@ -82,4 +86,5 @@ private:
     mavlink_message_t   _message;
     bool                _fieldSelected  = false;
     bool                _selected       = false;
+    QTimer              _fieldUpdateTimer;
 };
@@ -13,8 +13,10 @@
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCharts/QChart>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QAbstractSeries>
+#include <QtCore/QtMath>
 
 QGC_LOGGING_CATEGORY(MAVLinkMessageFieldLog, "qgc.analyzeview.mavlinkmessagefield")
 
@@ -36,7 +38,7 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
         _chart = chart;
         _pSeries = series;
         emit seriesChanged();
-        _dataIndex = 0;
+        _chartSeries.clear();
         _msg->updateFieldSelection();
     }
 }
@@ -46,9 +48,9 @@ void
 QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
-        _values.clear();
+        _chartSeries.clear();
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(_values);
+        lineSeries->replace(QList<QPointF>());
         _pSeries = nullptr;
         _chart   = nullptr;
         emit seriesChanged();
@@ -85,46 +87,20 @@ QGCMAVLinkMessageField::chartIndex()
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
+QGCMAVLinkMessageField::updateValue(const QString& newValue)
 {
     if(_value != newValue) {
         _value = newValue;
         emit valueChanged();
     }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::appendSample(qreal v)
+{
     if(_pSeries && _chart) {
-        int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
-            QPointF p(QGC::bootTimeMilliseconds(), v);
-            _values.append(p);
-        } else {
-            if(_dataIndex >= count) _dataIndex = 0;
-            _values[_dataIndex].setX(QGC::bootTimeMilliseconds());
-            _values[_dataIndex].setY(v);
-            _dataIndex++;
-        }
-        //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
-            bool changed = false;
-            if(std::abs(_rangeMin - vmin) > 0.000001) {
-                _rangeMin = vmin;
-                changed = true;
-            }
-            if(std::abs(_rangeMax - vmax) > 0.000001) {
-                _rangeMax = vmax;
-                changed = true;
-            }
-            if(changed) {
-                _chart->updateYRange();
-            }
-        }
+        _chartSeries.append(static_cast<qint64>(QGC::bootTimeMilliseconds()), v);
     }
 }
 
@@ -132,17 +108,35 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
 void
 QGCMAVLinkMessageField::updateSeries()
 {
-    int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
-        int idx = _dataIndex;
-        for(int i = 0; i < count; i++, idx++) {
-            if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
-        }
+    if(!_pSeries || !_chart) {
+        return;
+    }
+    //-- One column per pixel of plot area, anything finer can't be seen
+    int columns = kDefaultColumns;
+    const QChart* chart = _pSeries->chart();
+    if(chart && chart->plotArea().width() >= 1) {
+        columns = qCeil(chart->plotArea().width());
+    }
+    qreal vmin = _rangeMin;
+    qreal vmax = _rangeMax;
+    const QList<QPointF> points = _chartSeries.decimate(_chart->rangeXMin().toMSecsSinceEpoch(), _chart->rangeXMax().toMSecsSinceEpoch(), columns, vmin, vmax);
+    if (points.count() > 1) {
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
+        lineSeries->replace(points);
+    }
+    //-- Auto Range over what is visible
+    if(_chart->rangeYIndex() == 0) {
+        bool changed = false;
+        if(std::abs(_rangeMin - vmin) > 0.000001) {
+            _rangeMin = vmin;
+            changed = true;
+        }
+        if(std::abs(_rangeMax - vmax) > 0.000001) {
+            _rangeMax = vmax;
+            changed = true;
+        }
+        if(changed) {
+            _chart->updateYRange();
+        }
     }
 }
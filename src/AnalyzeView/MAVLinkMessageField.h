@@ -19,6 +19,8 @@
 #include <QtCore/QLoggingCategory>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include "MAVLinkChartSeries.h"
+
 Q_DECLARE_LOGGING_CATEGORY(MAVLinkMessageFieldLog)
 
 class QGCMAVLinkMessage;
@@ -51,13 +53,16 @@ public:
     bool            selectable      () const{ return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
+    const MAVLinkChartSeries& chartSeries() const { return _chartSeries; }
     qreal           rangeMin        () const{ return _rangeMin; }
     qreal           rangeMax        () const{ return _rangeMax; }
     int             chartIndex      ();
 
     void            setSelectable   (bool sel);
-    void            updateValue     (QString newValue, qreal v);
+    /// Only called at display rate while the owning message is shown
+    void            updateValue     (const QString& newValue);
+    /// Called for every received message while the field is charted
+    void            appendSample    (qreal v);
 
     void            addSeries       (MAVLinkChartController* chart, QAbstractSeries* series);
     void            delSeries       ();
@@ -69,16 +74,17 @@ signals:
     void            valueChanged        ();
 
 private:
+    static constexpr int kDefaultColumns = 1000;    ///< Used until the chart has been laid out
+
     QString     _type;
     QString     _name;
     QString     _value;
     bool        _selectable = true;
-    int         _dataIndex  = 0;
     qreal       _rangeMin   = 0;
     qreal       _rangeMax   = 0;
 
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    MAVLinkChartSeries  _chartSeries;
 };
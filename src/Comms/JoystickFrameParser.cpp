@@ -0,0 +1,48 @@
+#include "JoystickFrameParser.h"
+
+void JoystickFrameParser::reset(){
+    mState = State::Sync1;
+    mLength = 0;
+    mChecksum = 0;
+    mPayload.clear();
+}
+
+bool JoystickFrameParser::parseByte(quint8 byte){
+    switch(mState){
+    case State::Sync1:
+        if(byte == kSync1){
+            mState = State::Sync2;
+        }
+        break;
+    case State::Sync2:
+        mState = byte == kSync2 ? State::Length : (byte == kSync1 ? State::Sync2 : State::Sync1);
+        break;
+    case State::Length:
+        if(byte == 0 || byte > kMaxPayload){
+            mErrors++;
+            mState = State::Sync1;
+            break;
+        }
+        mLength = byte;
+        mChecksum = byte;
+        mPayload.clear();
+        mState = State::Payload;
+        break;
+    case State::Payload:
+        mPayload.append(static_cast<char>(byte));
+        mChecksum += byte;
+        if(mPayload.size() == mLength){
+            mState = State::Checksum;
+        }
+        break;
+    case State::Checksum:
+        mState = State::Sync1;
+        if(byte != mChecksum){
+            mErrors++;
+            return false;
+        }
+        mFrames++;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#ifndef JOYSTICKFRAMEPARSER_H
+#define JOYSTICKFRAMEPARSER_H
+
+#include <QByteArray>
+#include <QtGlobal>
+
+/*
+ * Assumed stick framing:
+ *
+ *   0xA5 0x5A | length | payload[length] | checksum
+ *
+ * checksum is the 8-bit sum of the length byte and every payload byte.
+ * The parser resynchronises on the next 0xA5 0x5A after any bad frame.
+ *
+ * This is NOT a documented device protocol. The stick controller's wire
+ * format was never specified in this tree (JoystickLink::isJoystick used to
+ * be a stub returning false), so the sync bytes, length byte and checksum
+ * above are a placeholder. Replace them with the real framing before
+ * relying on detection with a particular controller.
+ */
+class JoystickFrameParser
+{
+public:
+    static constexpr quint8 kSync1 = 0xA5;
+    static constexpr quint8 kSync2 = 0x5A;
+    static constexpr int kMaxPayload = 64;
+
+    /// Feeds one byte. Returns true when a complete, valid frame is available from payload().
+    bool parseByte(quint8 byte);
+    const QByteArray &payload() const { return mPayload; }
+
+    quint64 frames() const { return mFrames; }
+    quint64 errors() const { return mErrors; }
+    void reset();
+
+private:
+    enum class State {
+        Sync1,
+        Sync2,
+        Length,
+        Payload,
+        Checksum,
+    };
+
+    State mState{State::Sync1};
+    int mLength{0};
+    quint8 mChecksum{0};
+    QByteArray mPayload;
+    quint64 mFrames{0};
+    quint64 mErrors{0};
+};
+
+#endif // JOYSTICKFRAMEPARSER_H
@@ -1,78 +1,150 @@
 #include "JoystickLink.h"
-#include "MqttManager.h"
-
-void JoystickLink::detectJoystick(){
-    while (true) {
-        try {
-            qDebug() << "[JoystickLink]detecting joystick......";
-            const auto serialPortInfos = QSerialPortInfo::availablePorts();
-            QSerialPort serialPort;
-            for (const QSerialPortInfo &portInfo : serialPortInfos) {
-                qDebug() << "[JoystickSerialPortManager]\n"
-                         << "Port:" << portInfo.portName() << "\n"
-                         << "Location:" << portInfo.systemLocation() << "\n"
-                         << "Description:" << portInfo.description() << "\n"
-                         << "Manufacturer:" << portInfo.manufacturer() << "\n"
-                         << "Serial number:" << portInfo.serialNumber() << "\n"
-                         << "Vendor Identifier:"
-                         << (portInfo.hasVendorIdentifier()
-                                 ? QByteArray::number(portInfo.vendorIdentifier(), 16)
-                                 : QByteArray()) << "\n"
-                         << "Product Identifier:"
-                         << (portInfo.hasProductIdentifier()
-                                 ? QByteArray::number(portInfo.productIdentifier(), 16)
-                                 : QByteArray());
-                serialPort.setPort(portInfo);
-                if(isJoystick(serialPort)){
-                    mSerialPort = &serialPort;
-                    // 发送串口更新信号
-                    QVariantMap newSerialPort;
-                    newSerialPort.insert("name", portInfo.portName());
-                    newSerialPort.insert("number", portInfo.serialNumber());
-                    // emit updateJoystickSerialPort(newSerialPort);
-                    break;
-                }
-            }
-        } catch (...) {
-            qCritical() << "ERROR: Caught unknown joystick detect exception";
-        }
-        QThread::sleep(3);
+
+#include <QDebug>
+#include <chrono>
+
+JoystickLink::JoystickLink(QObject *parent) : QObject(parent){}
+
+void JoystickLink::start(){
+    // Created here so that the port and timers belong to the reader thread
+    mSerialPort = new QSerialPort(this);
+    mScanTimer = new QTimer(this);
+    mProbeTimer = new QTimer(this);
+    mProbeTimer->setSingleShot(true);
+    mProbeTimer->setInterval(kProbeTimeoutMs);
+    mScanTimer->setInterval(kScanIntervalMs);
+
+    connect(mSerialPort, &QSerialPort::readyRead, this, &JoystickLink::_readBytes);
+    connect(mSerialPort, &QSerialPort::errorOccurred, this, &JoystickLink::_errorOccurred);
+    connect(mScanTimer, &QTimer::timeout, this, &JoystickLink::_scanPorts);
+    connect(mProbeTimer, &QTimer::timeout, this, &JoystickLink::_probeTimeout);
+
+    _scanPorts();
+    mScanTimer->start();
+}
+
+void JoystickLink::stop(){
+    if(mScanTimer){
+        mScanTimer->stop();
+        mProbeTimer->stop();
     }
+    _closePort();
+}
+
+void JoystickLink::setPortFilter(const QString &portName, quint16 vendorId, quint16 productId){
+    mFilterPortName = portName.trimmed();
+    mFilterVendorId = vendorId;
+    mFilterProductId = productId;
+    mProbeQueue.clear();
 }
 
-bool JoystickLink::isJoystick(QSerialPort &serialPort){
-    if (!serialPort.open(QIODevice::ReadWrite)) {
-        qDebug() << "[JoystickLink]open serial port failed.";
+void JoystickLink::setExcludedPorts(const QStringList &portLocations){
+    mExcludedPorts = portLocations;
+    // Give the port up if another link wants it while it is still being probed
+    if(!mConnected && mSerialPort && mSerialPort->isOpen() && mExcludedPorts.contains(QSerialPortInfo(*mSerialPort).systemLocation())){
+        mProbeTimer->stop();
+        _closePort();
+        _probeNextPort();
     }
-    if(serialPort.isOpen()){
-        qint64 byteCount = serialPort.bytesAvailable();
-        if (byteCount) {
-            QByteArray buffer;
-            buffer.resize(byteCount);
-            serialPort.read(buffer.data(), buffer.size());
-            // TODO 根据数据特征判断是否为遥控
-        }
+}
+
+bool JoystickLink::_isCandidate(const QSerialPortInfo &portInfo) const{
+    if(mExcludedPorts.contains(portInfo.systemLocation())){
+        return false;
+    }
+    if(!mFilterPortName.isEmpty()){
+        return (portInfo.portName() == mFilterPortName) || (portInfo.systemLocation() == mFilterPortName);
+    }
+    if(mFilterVendorId != 0){
+        return portInfo.hasVendorIdentifier() && (portInfo.vendorIdentifier() == mFilterVendorId)
+            && ((mFilterProductId == 0) || (portInfo.hasProductIdentifier() && (portInfo.productIdentifier() == mFilterProductId)));
     }
     return false;
 }
 
-void JoystickLink::sendJoystickCmd(){
-    while (true) {
-        try {
-            if(mSerialPort == nullptr){
-                qDebug() << "[JoystickLink]serial port not found.";
-            }else{
-                qint64 byteCount = mSerialPort->bytesAvailable();
-                if (byteCount) {
-                    QByteArray buffer;
-                    buffer.resize(byteCount);
-                    mSerialPort->read(buffer.data(), buffer.size());
-                    // mqttManager->sendJoystickCmd(buffer);
-                }
-            }
-        } catch (...) {
-            qCritical() << "ERROR: Caught unknown joystick exception";
+void JoystickLink::_scanPorts(){
+    QStringList ports;
+    QStringList candidates;
+    const auto serialPortInfos = QSerialPortInfo::availablePorts();
+    for(const QSerialPortInfo &portInfo : serialPortInfos){
+        ports.append(portInfo.portName());
+        if(_isCandidate(portInfo)){
+            candidates.append(portInfo.portName());
+        }
+    }
+    mKnownPorts = ports;
+
+    if(!mConnected && !mSerialPort->isOpen()){
+        // Ports that failed to open or stayed silent last time get another go on every scan
+        mProbeQueue = candidates;
+        _probeNextPort();
+    }
+}
+
+void JoystickLink::_probeNextPort(){
+    while(!mProbeQueue.isEmpty()){
+        const QString portName = mProbeQueue.takeFirst();
+        if(!mKnownPorts.contains(portName)){
+            continue;
+        }
+        const QSerialPortInfo portInfo(portName);
+        if(!_isCandidate(portInfo)){
+            continue;
         }
-        QThread::sleep(1);
+        mSerialPort->setPort(portInfo);
+        mSerialPort->setBaudRate(kBaudRate);
+        if(!mSerialPort->open(QIODevice::ReadWrite)){
+            qDebug() << "[JoystickLink]open serial port failed:" << portName << mSerialPort->errorString();
+            continue;
+        }
+        mParser.reset();
+        mProbeTimer->start();
+        return;
+    }
+}
+
+void JoystickLink::_probeTimeout(){
+    if(!mConnected){
+        qDebug() << "[JoystickLink]No stick frames on" << mSerialPort->portName();
+        _closePort();
+        _probeNextPort();
+    }
+}
+
+void JoystickLink::_readBytes(){
+    const qint64 inputTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const QByteArray bytes = mSerialPort->readAll();
+    for(const char byte : bytes){
+        if(!mParser.parseByte(static_cast<quint8>(byte))){
+            continue;
+        }
+        if(!mConnected){
+            mConnected = true;
+            mProbeTimer->stop();
+            const QSerialPortInfo portInfo(*mSerialPort);
+            qInfo() << "[JoystickLink]Joystick detected on" << portInfo.portName();
+            emit joystickConnected(portInfo.portName(), portInfo.serialNumber());
+        }
+        emit joystickCmdReceived(mParser.payload(), inputTimeNs);
+    }
+}
+
+void JoystickLink::_errorOccurred(QSerialPort::SerialPortError error){
+    if(error != QSerialPort::ResourceError){
+        return;
+    }
+    // Device was unplugged. It is probed again once it comes back.
+    qWarning() << "[JoystickLink]Serial port lost:" << mSerialPort->portName() << mSerialPort->errorString();
+    _closePort();
+    if(mConnected){
+        mConnected = false;
+        emit joystickDisconnected();
+    }
+}
+
+void JoystickLink::_closePort(){
+    if(mSerialPort && mSerialPort->isOpen()){
+        mSerialPort->close();
     }
 }
@@ -4,18 +4,61 @@
 #include <QObject>
 #include <QSerialPort>
 #include <QSerialPortInfo>
+#include <QStringList>
+#include <QTimer>
+#include "JoystickFrameParser.h"
 
-class MqttManager;
-
+/// Event driven reader for the joystick serial port. Lives on its own thread: the ports matching the
+/// configured port name or USB vendor/product id are probed one at a time until one produces valid
+/// stick frames, after which bytes are parsed as they arrive from readyRead. Ports in use by other links
+/// are never opened. Unplugging the device drops back to detection.
 class JoystickLink : public QObject
 {
     Q_OBJECT
 public:
-    void detectJoystick();
-    bool isJoystick(QSerialPort &serialPort);
-    void sendJoystickCmd();
+    explicit JoystickLink(QObject *parent = nullptr);
+
+public slots:
+    void start();
+    void stop();
+    /// Only ports with this name or system location, or with this USB vendor and product id, are probed.
+    /// Nothing is probed while neither is set.
+    void setPortFilter(const QString &portName, quint16 vendorId, quint16 productId);
+    /// System locations of the ports opened, or about to be opened, by other links
+    void setExcludedPorts(const QStringList &portLocations);
+
+signals:
+    /// inputTimeNs is the std::chrono::steady_clock time, in nanoseconds, at which the frame's bytes were read
+    void joystickCmdReceived(const QByteArray &cmd, qint64 inputTimeNs);
+    void joystickConnected(const QString &portName, const QString &serialNumber);
+    void joystickDisconnected();
+
+private slots:
+    void _scanPorts();
+    void _readBytes();
+    void _probeTimeout();
+    void _errorOccurred(QSerialPort::SerialPortError error);
+
 private:
-    QSerialPort *mSerialPort;
+    void _probeNextPort();
+    void _closePort();
+    bool _isCandidate(const QSerialPortInfo &portInfo) const;
+
+    static constexpr int kBaudRate = 115200;
+    static constexpr int kScanIntervalMs = 1000;
+    static constexpr int kProbeTimeoutMs = 500;
+
+    QSerialPort *mSerialPort = nullptr;
+    QTimer *mScanTimer = nullptr;
+    QTimer *mProbeTimer = nullptr;
+    JoystickFrameParser mParser;
+    QStringList mProbeQueue;
+    QStringList mKnownPorts;
+    QStringList mExcludedPorts;
+    QString mFilterPortName;
+    quint16 mFilterVendorId{0};
+    quint16 mFilterProductId{0};
+    bool mConnected{false};
 };
 
 #endif // JOYSTICKLINK_H
@@ -1,27 +1,78 @@
 #include "JoystickSerialPortManager.h"
+#include "AutoConnectSettings.h"
+#include "LinkManager.h"
+#include "SettingsManager.h"
 
 JoystickSerialPortManager::JoystickSerialPortManager(QGCApplication *app, QGCToolbox *toolbox) : QGCTool(app, toolbox){
     mJoystickLink = new JoystickLink();
 }
 
 JoystickSerialPortManager::~JoystickSerialPortManager(){
-    mJoystickSerialPortReadThread.quit();
-    mJoystickSerialPortReadThread.wait();
-    mJoystickSerialPortDetectThread.quit();
-    mJoystickSerialPortDetectThread.wait();
+    mJoystickSerialPortThread.quit();
+    mJoystickSerialPortThread.wait();
 }
 
 void JoystickSerialPortManager::start(){
-    mJoystickLink->moveToThread(&mJoystickSerialPortDetectThread);
-    connect(&mJoystickSerialPortDetectThread, &QThread::started, mJoystickLink, &JoystickLink::detectJoystick);
-    connect(&mJoystickSerialPortDetectThread, &QThread::finished, mJoystickLink, &QObject::deleteLater);
+    // Set before the reader thread runs so that the first scan already sees them
+    _updatePortFilter();
+    _updateExcludedPorts();
 
-    mJoystickLink->moveToThread(&mJoystickSerialPortReadThread);
-    connect(&mJoystickSerialPortReadThread, &QThread::started, mJoystickLink, &JoystickLink::sendJoystickCmd);
-    connect(&mJoystickSerialPortReadThread, &QThread::finished, mJoystickLink, &QObject::deleteLater);
+    AutoConnectSettings *autoConnectSettings = _toolbox->settingsManager()->autoConnectSettings();
+    connect(autoConnectSettings->joystickSerialPort(), &Fact::rawValueChanged, this, &JoystickSerialPortManager::_updatePortFilter);
+    connect(autoConnectSettings->joystickUsbVendorId(), &Fact::rawValueChanged, this, &JoystickSerialPortManager::_updatePortFilter);
+    connect(autoConnectSettings->joystickUsbProductId(), &Fact::rawValueChanged, this, &JoystickSerialPortManager::_updatePortFilter);
 
-    mJoystickSerialPortDetectThread.start();
-    mJoystickSerialPortReadThread.start();
+    // LinkManager has no signal for its links, so its ports are picked up at the scan rate
+    mExcludedPortsTimer.setInterval(kExcludedPortsIntervalMs);
+    connect(&mExcludedPortsTimer, &QTimer::timeout, this, &JoystickSerialPortManager::_updateExcludedPorts);
+    mExcludedPortsTimer.start();
+
+    mJoystickLink->moveToThread(&mJoystickSerialPortThread);
+    connect(&mJoystickSerialPortThread, &QThread::started, mJoystickLink, &JoystickLink::start);
+    connect(&mJoystickSerialPortThread, &QThread::finished, mJoystickLink, &QObject::deleteLater);
+
+    // Publishing is thread safe, so stick frames go straight from the reader thread into the MQTT publish queue
+    MqttManager *mqttManager = _toolbox->mqttManager();
+    connect(mJoystickLink, &JoystickLink::joystickCmdReceived, mqttManager, &MqttManager::sendJoystickCmd, Qt::DirectConnection);
+
+    connect(mJoystickLink, &JoystickLink::joystickConnected, this, [this](const QString &portName, const QString &serialNumber){
+        QVariantMap newSerialPort;
+        newSerialPort.insert("name", portName);
+        newSerialPort.insert("number", serialNumber);
+        emit updateJoystickSerialPort(newSerialPort);
+    });
+    connect(mJoystickLink, &JoystickLink::joystickDisconnected, this, [this](){
+        emit updateJoystickSerialPort(QVariantMap());
+    });
+
+    mJoystickSerialPortThread.start();
 }
 
+void JoystickSerialPortManager::_updatePortFilter(){
+    AutoConnectSettings *autoConnectSettings = _toolbox->settingsManager()->autoConnectSettings();
+    const QString portName = autoConnectSettings->joystickSerialPort()->rawValue().toString();
+    const quint16 vendorId = static_cast<quint16>(autoConnectSettings->joystickUsbVendorId()->rawValue().toUInt());
+    const quint16 productId = static_cast<quint16>(autoConnectSettings->joystickUsbProductId()->rawValue().toUInt());
+    if(!mJoystickSerialPortThread.isRunning()){
+        mJoystickLink->setPortFilter(portName, vendorId, productId);
+        return;
+    }
+    QMetaObject::invokeMethod(mJoystickLink, [this, portName, vendorId, productId](){
+        mJoystickLink->setPortFilter(portName, vendorId, productId);
+    }, Qt::QueuedConnection);
+}
 
+void JoystickSerialPortManager::_updateExcludedPorts(){
+    const QStringList excludedPorts = _toolbox->linkManager()->serialPortsInUse();
+    if(excludedPorts == mExcludedPorts){
+        return;
+    }
+    mExcludedPorts = excludedPorts;
+    if(!mJoystickSerialPortThread.isRunning()){
+        mJoystickLink->setExcludedPorts(excludedPorts);
+        return;
+    }
+    QMetaObject::invokeMethod(mJoystickLink, [this, excludedPorts](){
+        mJoystickLink->setExcludedPorts(excludedPorts);
+    }, Qt::QueuedConnection);
+}
@@ -7,6 +7,7 @@
 #include <QDateTime>
 #include <QSerialPort>
 #include <QSerialPortInfo>
+#include <QTimer>
 #include "MqttManager.h"
 #include "JoystickLink.h"
 
@@ -20,9 +21,15 @@ public:
 signals:
     void updateJoystickSerialPort(const QVariantMap newSerialPort);
 private:
+    void _updatePortFilter();
+    void _updateExcludedPorts();
+
+    static constexpr int kExcludedPortsIntervalMs = 1000;
+
     JoystickLink *mJoystickLink = nullptr;
-    QThread mJoystickSerialPortReadThread;
-    QThread mJoystickSerialPortDetectThread;
+    QTimer mExcludedPortsTimer;
+    QStringList mExcludedPorts;
+    QThread mJoystickSerialPortThread;
 };
 
 #endif // JOYSTICKSERIALPORTMANAGER_H
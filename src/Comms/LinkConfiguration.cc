@@ -38,6 +38,7 @@ LinkConfiguration::LinkConfiguration(const LinkConfiguration *copy, QObject *par
     , _dynamic(copy->isDynamic())
     , _autoConnect(copy->isAutoConnect())
     , _highLatency(copy->isHighLatency())
+    , _forwardMessageIds(copy->forwardMessageIds())
 {
     // qCDebug(AudioOutputLog) << Q_FUNC_INFO << this;
 
@@ -58,6 +59,26 @@ void LinkConfiguration::copyFrom(const LinkConfiguration *source)
     _dynamic = source->isDynamic();
     _autoConnect = source->isAutoConnect();
     _highLatency = source->isHighLatency();
+    _forwardMessageIds = source->forwardMessageIds();
+}
+
+QSet<uint32_t> LinkConfiguration::parseMessageIds(const QString &msgIds)
+{
+    // MAVLink 2 message ids are 24 bits
+    static constexpr uint kMaxMessageId = 0xFFFFFF;
+
+    QSet<uint32_t> result;
+
+    const QStringList entries = msgIds.split(',', Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        bool ok = false;
+        const uint msgId = entry.trimmed().toUInt(&ok);
+        if (ok && (msgId <= kMaxMessageId)) {
+            (void) result.insert(msgId);
+        }
+    }
+
+    return result;
 }
 
 LinkConfiguration *LinkConfiguration::createSettings(int type, const QString &name)
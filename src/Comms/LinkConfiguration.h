@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <QtCore/QSet>
 #include <QtCore/QSettings>
 #include <QtCore/QString>
 
@@ -59,6 +60,18 @@ public:
     /// Set if this is this an High Latency configuration.
     void setHighLatency(bool hl = false);
 
+    /// Is the MAVLink message forwarded to this link? Only applies to MAVLink forwarding links.
+    ///     @return True if the filter is empty or contains msgId
+    bool forwardsMessage(uint32_t msgId) const { return _forwardMessageIds.isEmpty() || _forwardMessageIds.contains(msgId); }
+
+    /// Restricts MAVLink forwarding to this link to the given message ids. An empty set forwards everything.
+    void setForwardMessageIds(const QSet<uint32_t> &msgIds) { _forwardMessageIds = msgIds; }
+    QSet<uint32_t> forwardMessageIds() const { return _forwardMessageIds; }
+
+    /// Parses a comma separated list of message ids, as used by the forwarding settings
+    ///     @return The parsed ids, entries which are not a valid MAVLink message id are skipped
+    static QSet<uint32_t> parseMessageIds(const QString &msgIds);
+
     /// Copy instance data, When manipulating data, you create a copy of the configuration using the copy constructor,
     /// edit it and then transfer its content to the original using this method.
     ///     @param[in] source The source instance (the edited copy)
@@ -133,6 +146,7 @@ private:
     bool _dynamic = false;     ///< A connection added automatically and not persistent (unless it's edited).
     bool _autoConnect = false; ///< This connection is started automatically at boot
     bool _highLatency = false;
+    QSet<uint32_t> _forwardMessageIds; ///< Empty: forward all messages
 };
 
 typedef std::shared_ptr<LinkConfiguration> SharedLinkConfigurationPtr;
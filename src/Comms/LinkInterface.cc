@@ -112,6 +112,11 @@ void LinkInterface::_freeMavlinkChannel()
 void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
 {
     const QByteArray data(bytes, length);
+    writeBytesThreadSafe(data);
+}
+
+void LinkInterface::writeBytesThreadSafe(const QByteArray &data)
+{
     (void) QMetaObject::invokeMethod(this, "_writeBytes", Qt::AutoConnection, data);
 }
 
@@ -41,6 +41,8 @@ public:
     bool decodedFirstMavlinkPacket(void) const { return _decodedFirstMavlinkPacket; }
     void setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
     void writeBytesThreadSafe(const char *bytes, int length);
+    /// Shares data with the link thread instead of copying it, so one frame can be handed to several links
+    void writeBytesThreadSafe(const QByteArray &data);
     void addVehicleReference() { ++_vehicleReferenceCount; }
     void removeVehicleReference();
     bool initMavlinkSigning();
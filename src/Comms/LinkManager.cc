@@ -405,7 +405,8 @@ void LinkManager::_addMAVLinkForwardingLink()
     }
 
     const QString hostName = _toolbox->settingsManager()->appSettings()->forwardMavlinkHostName()->rawValue().toString();
-    _createDynamicForwardLink(_mavlinkForwardingLinkName, hostName);
+    const QString messageIds = _toolbox->settingsManager()->appSettings()->forwardMavlinkMessageIds()->rawValue().toString();
+    _createDynamicForwardLink(_mavlinkForwardingLinkName, hostName, LinkConfiguration::parseMessageIds(messageIds));
 }
 
 #ifdef QGC_ZEROCONF_ENABLED
@@ -706,17 +707,18 @@ LogReplayLink *LinkManager::startLogReplay(const QString &logFile)
     return nullptr;
 }
 
-void LinkManager::_createDynamicForwardLink(const char *linkName, const QString &hostName)
+void LinkManager::_createDynamicForwardLink(const char *linkName, const QString &hostName, const QSet<uint32_t> &forwardMessageIds)
 {
     UDPConfiguration* const udpConfig = new UDPConfiguration(linkName);
 
     udpConfig->setDynamic(true);
     udpConfig->addHost(hostName);
+    udpConfig->setForwardMessageIds(forwardMessageIds);
 
     SharedLinkConfigurationPtr config = addConfiguration(udpConfig);
     createConnectedLink(config);
 
-    qCDebug(LinkManagerLog) << "New dynamic MAVLink forwarding port added:" << linkName << " hostname:" << hostName;
+    qCDebug(LinkManagerLog) << "New dynamic MAVLink forwarding port added:" << linkName << " hostname:" << hostName << " message ids:" << forwardMessageIds;
 }
 
 bool LinkManager::isLinkUSBDirect(const LinkInterface *link)
@@ -915,6 +917,27 @@ bool LinkManager::_allowAutoConnectToBoard(QGCSerialPortInfo::BoardType_t boardT
     return false;
 }
 
+QStringList LinkManager::serialPortsInUse() const
+{
+    QStringList portLocations = _autoconnectPortWaitList.keys();
+
+    for (const SharedLinkInterfacePtr &linkInterface : _rgLinks) {
+        const SharedLinkConfigurationPtr linkConfig = linkInterface->linkConfiguration();
+        const SerialConfiguration* const serialConfig = qobject_cast<const SerialConfiguration*>(linkConfig.get());
+        if (serialConfig) {
+            portLocations.append(serialConfig->portName());
+        }
+    }
+    if (!_autoConnectRTKPort.isEmpty()) {
+        portLocations.append(_autoConnectRTKPort);
+    }
+    if (_nmeaPort) {
+        portLocations.append(_nmeaDeviceName);
+    }
+
+    return portLocations;
+}
+
 bool LinkManager::_portAlreadyConnected(const QString &portName) const
 {
     const QString searchPort = portName.trimmed();
@@ -136,7 +136,7 @@ private:
     void _removeConfiguration(const LinkConfiguration *config);
     void _addUDPAutoConnectLink();
     void _addMAVLinkForwardingLink();
-    void _createDynamicForwardLink(const char *linkName, const QString &hostName);
+    void _createDynamicForwardLink(const char *linkName, const QString &hostName, const QSet<uint32_t> &forwardMessageIds = {});
 #ifdef QGC_ZEROCONF_ENABLED
     void _addZeroConfAutoConnectLink();
 #endif
@@ -177,6 +177,8 @@ public:
     static QStringList serialBaudRates();
     QStringList serialPortStrings();
     QStringList serialPorts();
+    /// System locations of the serial ports opened by a link, or about to be opened by autoconnect
+    QStringList serialPortsInUse() const;
 
 signals:
     void commPortStringsChanged();
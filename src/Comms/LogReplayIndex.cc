@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayIndex.h"
+#include "MAVLinkFraming.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+
+QGC_LOGGING_CATEGORY(LogReplayIndexLog, "qgc.comms.logreplayindex")
+
+bool LogReplayIndex::build(const uchar *data, qint64 size, const std::function<bool()> &isCanceled)
+{
+    _entries.clear();
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+
+    const quint64 nowUSecs = currentTimeUSecs();
+    quint64 recordCount = 0;
+    qint64 offset = 0;
+
+    while (true) {
+        quint64 timestampUSecs;
+        qint64 frameOffset;
+        qint64 frameLength;
+        const qint64 recordOffset = nextRecord(data, size, offset, nowUSecs, timestampUSecs, frameOffset, frameLength);
+        if (recordOffset < 0) {
+            break;
+        }
+
+        if (recordCount == 0) {
+            _startTimeUSecs = timestampUSecs;
+        }
+        _endTimeUSecs = timestampUSecs;
+
+        // Entries must stay sorted for the binary search, records which step back in time are left to the forward walk
+        if (_entries.isEmpty() || (timestampUSecs >= (_entries.constLast().timestampUSecs + kIntervalUSecs))) {
+            (void) _entries.append({ timestampUSecs, recordOffset });
+        }
+
+        offset = frameOffset + frameLength;
+        if (((++recordCount % 65536) == 0) && isCanceled && isCanceled()) {
+            qCDebug(LogReplayIndexLog) << "Index build canceled";
+            _entries.clear();
+            return false;
+        }
+    }
+
+    qCDebug(LogReplayIndexLog) << "Indexed" << recordCount << "records into" << _entries.count() << "entries";
+
+    return !_entries.isEmpty();
+}
+
+bool LogReplayIndex::load(const QString &indexFilename, const QFileInfo &logFileInfo)
+{
+    QFile file(indexFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic;
+    quint32 version;
+    qint64 logSize;
+    qint64 logModifiedMSecs;
+    stream >> magic >> version >> logSize >> logModifiedMSecs;
+    if ((magic != kCacheMagic) || (version != kCacheVersion)) {
+        qCDebug(LogReplayIndexLog) << "Ignoring index with unknown format" << indexFilename;
+        return false;
+    }
+    if ((logSize != logFileInfo.size()) || (logModifiedMSecs != logFileInfo.lastModified().toMSecsSinceEpoch())) {
+        qCDebug(LogReplayIndexLog) << "Ignoring stale index" << indexFilename;
+        return false;
+    }
+
+    quint64 startTimeUSecs;
+    quint64 endTimeUSecs;
+    qint32 count;
+    stream >> startTimeUSecs >> endTimeUSecs >> count;
+    if ((stream.status() != QDataStream::Ok) || (count <= 0) || (count > logSize)) {
+        return false;
+    }
+
+    QList<Entry> entries;
+    entries.reserve(count);
+    for (qint32 i = 0; i < count; i++) {
+        Entry entry;
+        stream >> entry.timestampUSecs >> entry.offset;
+        if ((entry.offset < 0) || (entry.offset >= logSize)) {
+            // Playback reads straight from the mapped log, never trust an offset which would land outside of it
+            qCWarning(LogReplayIndexLog) << "Ignoring index with offset outside of the log" << indexFilename << entry.offset;
+            return false;
+        }
+        (void) entries.append(entry);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(LogReplayIndexLog) << "Truncated index" << indexFilename;
+        return false;
+    }
+
+    _entries = entries;
+    _startTimeUSecs = startTimeUSecs;
+    _endTimeUSecs = endTimeUSecs;
+
+    qCDebug(LogReplayIndexLog) << "Loaded index" << indexFilename << "entries" << _entries.count();
+
+    return true;
+}
+
+bool LogReplayIndex::save(const QString &indexFilename, const QFileInfo &logFileInfo) const
+{
+    QSaveFile file(indexFilename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCDebug(LogReplayIndexLog) << "Unable to cache index" << indexFilename << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream << kCacheMagic << kCacheVersion << static_cast<qint64>(logFileInfo.size()) << static_cast<qint64>(logFileInfo.lastModified().toMSecsSinceEpoch());
+    stream << _startTimeUSecs << _endTimeUSecs << static_cast<qint32>(_entries.count());
+    for (const Entry &entry : _entries) {
+        stream << entry.timestampUSecs << entry.offset;
+    }
+
+    if ((stream.status() != QDataStream::Ok) || !file.commit()) {
+        qCWarning(LogReplayIndexLog) << "Unable to write index" << indexFilename << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+qint64 LogReplayIndex::offsetForTime(quint64 timeUSecs) const
+{
+    if (_entries.isEmpty()) {
+        return 0;
+    }
+
+    const auto entry = std::upper_bound(_entries.cbegin(), _entries.cend(), timeUSecs, [](quint64 time, const Entry &indexEntry) {
+        return time < indexEntry.timestampUSecs;
+    });
+
+    return (entry == _entries.cbegin()) ? _entries.constFirst().offset : std::prev(entry)->offset;
+}
+
+qint64 LogReplayIndex::nextRecord(const uchar *data, qint64 size, qint64 offset, quint64 nowUSecs, quint64 &timestampUSecs, qint64 &frameOffset, qint64 &frameLength)
+{
+    qint64 recordOffset = offset;
+
+    while ((recordOffset + cbTimestamp) < size) {
+        const uchar *const frame = data + recordOffset + cbTimestamp;
+        const qint64 frameBytesAvailable = size - recordOffset - cbTimestamp;
+
+        const qsizetype length = MAVLinkFraming::frameLength(frame, frameBytesAvailable);
+        if (length > 0) {
+            timestampUSecs = parseTimestamp(data + recordOffset, nowUSecs);
+            frameOffset = recordOffset + cbTimestamp;
+            frameLength = length;
+            return recordOffset;
+        }
+
+        // Not a record boundary, try again with the next start of frame marker as the frame
+        recordOffset += 1 + MAVLinkFraming::findNextStx(frame + 1, frameBytesAvailable - 1);
+    }
+
+    return -1;
+}
+
+quint64 LogReplayIndex::parseTimestamp(const uchar *bytes, quint64 nowUSecs)
+{
+    const quint64 timestamp = qFromBigEndian<quint64>(bytes);
+    return (timestamp > nowUSecs) ? qbswap(timestamp) : timestamp;
+}
+
+quint64 LogReplayIndex::currentTimeUSecs()
+{
+    return static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+}
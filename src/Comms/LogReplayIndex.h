@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+
+#include <functional>
+
+class QFileInfo;
+
+Q_DECLARE_LOGGING_CATEGORY(LogReplayIndexLog)
+
+/// Sparse timestamp to file offset index for a telemetry log.
+///
+/// A tlog is a sequence of records, each an 8 byte big endian microsecond timestamp followed by one
+/// MAVLink frame. The index holds one record offset per kIntervalUSecs of log time, so seeking to a
+/// time is a binary search followed by a short forward walk. Indices are cached next to the log and
+/// are only reused while the log's size and modification time still match.
+class LogReplayIndex
+{
+public:
+    struct Entry {
+        quint64 timestampUSecs;
+        qint64  offset;             ///< File offset of the record's timestamp
+    };
+
+    /// Walks every record in the mapped log
+    ///     @param isCanceled Polled periodically, return true to abandon the build
+    /// @return false if the log holds no records or the build was canceled
+    bool build(const uchar *data, qint64 size, const std::function<bool()> &isCanceled = {});
+
+    /// @return false if there is no cache for this log or it is stale
+    bool load(const QString &indexFilename, const QFileInfo &logFileInfo);
+    bool save(const QString &indexFilename, const QFileInfo &logFileInfo) const;
+
+    /// @return Offset of the indexed record closest to, but not after, timeUSecs
+    qint64 offsetForTime(quint64 timeUSecs) const;
+
+    quint64 startTimeUSecs() const { return _startTimeUSecs; }
+    quint64 endTimeUSecs() const { return _endTimeUSecs; }
+    const QList<Entry> &entries() const { return _entries; }
+
+    static QString indexFilename(const QString &logFilename) { return logFilename + QStringLiteral(".idx"); }
+
+    /// Finds the first record at or after offset which holds a complete, CRC valid frame. Bytes that do not
+    /// form one are skipped by jumping to the next start of frame marker.
+    ///     @param[out] timestampUSecs Timestamp of the record found
+    ///     @param[out] frameOffset Offset of the record's frame
+    ///     @param[out] frameLength Length of the record's frame
+    /// @return Offset of the record found, -1 if there are no more records
+    static qint64 nextRecord(const uchar *data, qint64 size, qint64 offset, quint64 nowUSecs, quint64 &timestampUSecs, qint64 &frameOffset, qint64 &frameLength);
+
+    /// Parses a big endian record timestamp. Old logs stored little endian timestamps, those are detected
+    /// because they decode to a time after nowUSecs.
+    static quint64 parseTimestamp(const uchar *bytes, quint64 nowUSecs);
+    static quint64 currentTimeUSecs();
+
+    static constexpr qint64 cbTimestamp = sizeof(quint64);
+    static constexpr quint64 kIntervalUSecs = 250000;
+
+private:
+    QList<Entry> _entries;
+    quint64 _startTimeUSecs = 0;
+    quint64 _endTimeUSecs = 0;
+
+    static constexpr quint32 kCacheMagic = 0x51544C58;   ///< "QTLX"
+    static constexpr quint32 kCacheVersion = 1;
+};
@@ -17,9 +17,8 @@
 #endif
 #include "MAVLinkLib.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QFileInfo>
-#include <QtCore/QtEndian>
-#include <QtTest/QSignalSpy>
 
 LogReplayLinkConfiguration::LogReplayLinkConfiguration(const QString& name)
     : LinkConfiguration(name)
@@ -68,7 +67,6 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     : LinkInterface              (config)
     , _logReplayConfig           (qobject_cast<LogReplayLinkConfiguration*>(config.get()))
     , _connected                 (false)
-    , _mavlinkChannel            (0)
     , _logCurrentTimeUSecs       (0)
     , _logStartTimeUSecs         (0)
     , _logEndTimeUSecs           (0)
@@ -78,6 +76,11 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
     , _playbackStartLogTimeUSecs (0)
     , _mavlink                   (nullptr)
     , _logFileSize               (0)
+    , _logData                   (nullptr)
+    , _logPos                    (0)
+    , _nextFrameOffset           (0)
+    , _nextFrameLength           (0)
+    , _nowUSecs                  (LogReplayIndex::currentTimeUSecs())
 {
     if (!_logReplayConfig) {
         qWarning() << "Internal error";
@@ -85,12 +88,14 @@ LogReplayLink::LogReplayLink(SharedLinkConfigurationPtr& config)
 
     _errorTitle = tr("Log Replay Error");
     
+    _readTickTimer.setTimerType(Qt::PreciseTimer);
     _readTickTimer.moveToThread(this);
     
     QObject::connect(&_readTickTimer, &QTimer::timeout,                 this, &LogReplayLink::_readNextLogEntry);
     QObject::connect(this, &LogReplayLink::_playOnThread,               this, &LogReplayLink::_play);
     QObject::connect(this, &LogReplayLink::_pauseOnThread,              this, &LogReplayLink::_pause);
     QObject::connect(this, &LogReplayLink::_setPlaybackSpeedOnThread,   this, &LogReplayLink::_setPlaybackSpeed);
+    QObject::connect(this, &LogReplayLink::_movePlayheadOnThread,       this, &LogReplayLink::_movePlayhead);
     
     moveToThread(this);
 }
@@ -118,9 +123,14 @@ bool LogReplayLink::_connect(void)
 
 void LogReplayLink::disconnect(void)
 {
-    if (_connected) {
+    if (isRunning()) {
+        // Stops an index build which is still in progress. The thread may still be loading the log with _connected
+        // not yet set, it has to be waited for either way.
+        requestInterruption();
         quit();
         wait();
+    }
+    if (_connected) {
         _connected = false;
         emit disconnected();
     }
@@ -143,6 +153,7 @@ void LogReplayLink::run(void)
     exec();
     
     _readTickTimer.stop();
+    _closeLogFile();
 }
 
 void LogReplayLink::_replayError(const QString& errorMsg)
@@ -157,106 +168,20 @@ void LogReplayLink::_writeBytes(const QByteArray &bytes)
     Q_UNUSED(bytes);
 }
 
-/// Parses a BigEndian quint64 timestamp
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_parseTimestamp(const QByteArray& bytes)
-{
-    quint64 timestamp = qFromBigEndian(*((quint64*)(bytes.constData())));
-    quint64 currentTimestamp = ((quint64)QDateTime::currentMSecsSinceEpoch()) * 1000;
-    
-    // Now if the parsed timestamp is in the future, it must be an old file where the timestamp was stored as
-    // little endian, so switch it.
-    if (timestamp > currentTimestamp) {
-        timestamp = qbswap(timestamp);
-    }
-    
-    return timestamp;
-}
-
-/// Reads the next mavlink message from the log
-///     @param bytes[output] Bytes for mavlink message
-/// @return Unix timestamp in microseconds UTC for NEXT mavlink message or 0 if no message found
-quint64 LogReplayLink::_readNextMavlinkMessage(QByteArray& bytes)
-{
-    char                nextByte;
-    mavlink_status_t    status;
-
-    bytes.clear();
-
-    while (_logFile.getChar(&nextByte)) { // Loop over every byte
-        mavlink_message_t message;
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, &message, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message, clear any partial bytes
-            bytes.clear();
-        }
-        bytes.append(nextByte);
-
-        if (messageFound) {
-            // Return the timestamp for the next message
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
-        }
-    }
-
-    return 0;
-}
-
-/// Seeks to the beginning of the next successfully parsed mavlink message in the log file.
-///     @param nextMsg[output] Parsed next message that was found
-/// @return A Unix timestamp in microseconds UTC for found message or 0 if parsing failed
-quint64 LogReplayLink::_seekToNextMavlinkMessage(mavlink_message_t* nextMsg)
+/// Positions the playhead on the first complete record at or after offset
+/// @return false if there are no more records
+bool LogReplayLink::_seekToRecord(qint64 offset)
 {
-    char                nextByte;
-    mavlink_status_t    status;
-    qint64              messageStartPos = -1;
-
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    while (_logFile.getChar(&nextByte)) {
-        bool messageFound = mavlink_parse_char(_mavlinkChannel, nextByte, nextMsg, &status);
-
-        if (status.parse_state == MAVLINK_PARSE_STATE_GOT_STX) {
-            // This is the possible beginning of a mavlink message
-            messageStartPos = _logFile.pos() - 1;
-        }
-        
-        // If we've found a message, jump back to the start of the message, grab the timestamp,
-        // and go back to the end of this file.
-        if (messageFound && messageStartPos != -1) {
-            _logFile.seek(messageStartPos - cbTimestamp);
-            QByteArray rawTime = _logFile.read(cbTimestamp);
-            return _parseTimestamp(rawTime);
-        }
-    }
-    
-    return 0;
-}
-
-quint64 LogReplayLink::_findLastTimestamp(void)
-{
-    char                nextByte;
-    mavlink_status_t    status;
-    quint64             lastTimestamp = 0;
-    mavlink_message_t   msg;
-
-    // We read through the entire file looking for the last good timestamp. This can be somewhat slow, but trying to work from the
-    // end of the file can be way slower due to all the seeking back and forth required. So instead we take the simple reliable approach.
-
-    _logFile.reset();
-    mavlink_reset_channel_status(_mavlinkChannel);
-
-    while (_logFile.bytesAvailable() > cbTimestamp) {
-        lastTimestamp = _parseTimestamp(_logFile.read(cbTimestamp));
-
-        bool endOfMessage = false;
-        while (!endOfMessage && _logFile.getChar(&nextByte)) {
-            endOfMessage = mavlink_parse_char(_mavlinkChannel, nextByte, &msg, &status);
-        }
+    quint64 timestampUSecs;
+    const qint64 recordOffset = LogReplayIndex::nextRecord(_logData, _logFileSize, offset, _nowUSecs, timestampUSecs, _nextFrameOffset, _nextFrameLength);
+    if (recordOffset < 0) {
+        _logPos = _logFileSize;
+        return false;
     }
 
-    return lastTimestamp;
+    _logPos = recordOffset;
+    _logCurrentTimeUSecs = timestampUSecs;
+    return true;
 }
 
 bool LogReplayLink::_loadLogFile(void)
@@ -264,9 +189,8 @@ bool LogReplayLink::_loadLogFile(void)
     QString errorMsg;
     QString logFilename = _logReplayConfig->logFilename();
     QFileInfo logFileInfo;
+    QString indexFilename;
     int logDurationSecondsTotal;
-    quint64 startTimeUSecs;
-    quint64 endTimeUSecs;
 
     if (_logFile.isOpen()) {
         errorMsg = tr("Attempt to load new log while log being played");
@@ -280,23 +204,47 @@ bool LogReplayLink::_loadLogFile(void)
     }
     logFileInfo.setFile(logFilename);
     _logFileSize = logFileInfo.size();
-    
-    startTimeUSecs = _parseTimestamp(_logFile.read(cbTimestamp));
-    endTimeUSecs = _findLastTimestamp();
 
-    if (endTimeUSecs <= startTimeUSecs) {
+    if (_logFileSize <= LogReplayIndex::cbTimestamp) {
+        errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
+        goto Error;
+    }
+
+    // Playback and seeking read straight from the mapping, the OS pages the log in as needed
+    _logData = _logFile.map(0, _logFileSize);
+    if (!_logData) {
+        errorMsg = tr("Unable to map log file: '%1', error: %2").arg(logFilename).arg(_logFile.errorString());
+        goto Error;
+    }
+
+    // The index replaces a full parse of the log which was needed anyway to find the last timestamp. A cached
+    // index makes reopening a large log immediate. Logs in read only locations just skip the cache.
+    indexFilename = LogReplayIndex::indexFilename(logFilename);
+    if (!_logIndex.load(indexFilename, logFileInfo)) {
+        if (!_logIndex.build(_logData, _logFileSize, [this]() { return isInterruptionRequested(); })) {
+            if (isInterruptionRequested()) {
+                // Disconnected while the index was being built, that's not an error
+                _closeLogFile();
+                return false;
+            }
+            errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
+            goto Error;
+        }
+        (void) _logIndex.save(indexFilename, logFileInfo);
+    }
+
+    if (_logIndex.endTimeUSecs() <= _logIndex.startTimeUSecs()) {
         errorMsg = tr("The log file '%1' is corrupt or empty.").arg(logFilename);
         goto Error;
     }
 
     // Remember the start and end time so we can move around this _logFile with the slider.
-    _logEndTimeUSecs = endTimeUSecs;
-    _logStartTimeUSecs = startTimeUSecs;
-    _logDurationUSecs = endTimeUSecs - startTimeUSecs;
-    _logCurrentTimeUSecs = startTimeUSecs;
+    _logEndTimeUSecs = _logIndex.endTimeUSecs();
+    _logStartTimeUSecs = _logIndex.startTimeUSecs();
+    _logDurationUSecs = _logEndTimeUSecs - _logStartTimeUSecs;
 
-    // Reset our log file so when we go to read it for the first time, we start at the beginning.
-    _logFile.reset();
+    // Start at the beginning when we go to read it for the first time.
+    _resetPlaybackToBeginning();
 
     logDurationSecondsTotal = (_logDurationUSecs) / 1000000;
     
@@ -305,11 +253,21 @@ bool LogReplayLink::_loadLogFile(void)
     return true;
     
 Error:
+    _closeLogFile();
+    _replayError(errorMsg);
+    return false;
+}
+
+void LogReplayLink::_closeLogFile(void)
+{
+    if (_logData) {
+        (void) _logFile.unmap(const_cast<uchar*>(_logData));
+        _logData = nullptr;
+    }
     if (_logFile.isOpen()) {
         _logFile.close();
     }
-    _replayError(errorMsg);
-    return false;
+    _logPos = _logFileSize = 0;
 }
 
 /// This function will read the next available log entry. It will then start
@@ -318,42 +276,52 @@ Error:
 /// induce a static drift into the log file replay.
 void LogReplayLink::_readNextLogEntry(void)
 {
+    // Every message which is due goes out as one buffer. At high playback speeds a tick covers
+    // many messages and a signal per message would limit the replay rate.
     QByteArray bytes;
 
-    // Now parse MAVLink messages, grabbing their timestamps as we go. We stop once we
+    // Now send MAVLink messages, grabbing their timestamps as we go. We stop once we
     // have at least 3ms until the next one.
 
     // We track what the next execution time should be in milliseconds, which we use to set
     // the next timer interrupt.
-    int timeToNextExecutionMSecs = 0;
+    qint64 timeToNextExecutionMSecs = 0;
 
     while (timeToNextExecutionMSecs < 3) {
-        // Read the next mavlink message from the log
-        qint64 nextTimeUSecs = _readNextMavlinkMessage(bytes);
-        emit bytesReceived(this, bytes);
-        emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
-
-        if (_logFile.atEnd()) {
+        if (_atEnd()) {
+            if (!bytes.isEmpty()) {
+                emit bytesReceived(this, bytes);
+            }
             _finishPlayback();
             return;
         }
 
-        _logCurrentTimeUSecs = nextTimeUSecs;
+        (void) bytes.append(reinterpret_cast<const char*>(_logData + _nextFrameOffset), _nextFrameLength);
+
+        // Move to the next message, this also updates _logCurrentTimeUSecs
+        (void) _seekToRecord(_nextFrameOffset + _nextFrameLength);
 
-        // Calculate how long we should wait in real time until parsing this message.
+        // Calculate how long we should wait in real time until sending the next message.
         // We pace ourselves relative to the start time of playback to fix any drift (initially set in play())
 
-        quint64 currentTimeMSecs =                  (quint64)QDateTime::currentMSecsSinceEpoch();
-        quint64 desiredPlayheadMovementTimeMSecs =  ((_logCurrentTimeUSecs - _playbackStartLogTimeUSecs) / 1000) / _playbackSpeed;
-        quint64 desiredCurrentTimeMSecs =           _playbackStartTimeMSecs + desiredPlayheadMovementTimeMSecs;
+        const qint64 currentTimeMSecs =                 QDateTime::currentMSecsSinceEpoch();
+        const qint64 desiredPlayheadMovementTimeMSecs = ((static_cast<qint64>(_logCurrentTimeUSecs) - static_cast<qint64>(_playbackStartLogTimeUSecs)) / 1000) / _playbackSpeed;
+        const qint64 desiredCurrentTimeMSecs =          static_cast<qint64>(_playbackStartTimeMSecs) + desiredPlayheadMovementTimeMSecs;
 
         timeToNextExecutionMSecs = desiredCurrentTimeMSecs - currentTimeMSecs;
+
+        if (bytes.size() >= kMaxTickBytes) {
+            timeToNextExecutionMSecs = qMax(timeToNextExecutionMSecs, static_cast<qint64>(0));
+            break;
+        }
     }
 
+    emit bytesReceived(this, bytes);
+    emit playbackPercentCompleteChanged(((float)(_logCurrentTimeUSecs - _logStartTimeUSecs) / (float)_logDurationUSecs) * 100);
     _signalCurrentLogTimeSecs();
 
     // And schedule the next execution of this function.
-    _readTickTimer.start(timeToNextExecutionMSecs);
+    _readTickTimer.start(static_cast<int>(timeToNextExecutionMSecs));
 }
 
 void LogReplayLink::_play(void)
@@ -364,7 +332,7 @@ void LogReplayLink::_play(void)
 #endif
     
     // Make sure we aren't at the end of the file, if we are, reset to the beginning and play from there.
-    if (_logFile.atEnd()) {
+    if (_atEnd()) {
         _resetPlaybackToBeginning();
     }
     
@@ -389,25 +357,24 @@ void LogReplayLink::_pause(void)
 
 void LogReplayLink::_resetPlaybackToBeginning(void)
 {
-    if (_logFile.isOpen()) {
-        _logFile.reset();
-    }
-    
     // And since we haven't starting playback, clear the time of initial playback and the current timestamp.
     _playbackStartTimeMSecs = 0;
     _playbackStartLogTimeUSecs = 0;
     _logCurrentTimeUSecs = _logStartTimeUSecs;
+
+    if (_logData) {
+        (void) _seekToRecord(0);
+    }
 }
 
-void LogReplayLink::movePlayhead(qreal percentComplete)
+void LogReplayLink::_movePlayhead(qreal percentComplete)
 {
     if (isPlaying()) {
-        _pauseOnThread();
-        QSignalSpy waitForPause(this, SIGNAL(playbackPaused()));
-        waitForPause.wait();
-        if (_readTickTimer.isActive()) {
-            return;
-        }
+        _pause();
+    }
+
+    if (!_logData) {
+        return;
     }
 
     if (percentComplete < 0) {
@@ -416,46 +383,22 @@ void LogReplayLink::movePlayhead(qreal percentComplete)
     if (percentComplete > 100) {
         percentComplete = 100;
     }
-    
-    qreal percentCompleteMult = percentComplete / 100.0;
-    
-    // But if we have a timestamped MAVLink log, then actually aim to hit that percentage in terms of
-    // time through the file.
-    qint64 newFilePos = (qint64)(percentCompleteMult * (qreal)_logFile.size());
 
-    // Now seek to the appropriate position, failing gracefully if we can't.
-    if (!_logFile.seek(newFilePos)) {
-        _replayError(tr("Unable to seek to new position"));
-        return;
-    }
-
-    // But we do align to the next MAVLink message for consistency.
-    mavlink_message_t dummy;
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
-
-    // Now calculate the current file location based on time.
-    qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
-
-    // Calculate the effective baud rate of the file in bytes/s.
-    qreal baudRate = _logFile.size() / (qreal)_logDurationUSecs / 1e6;
-
-    // And the desired time is:
-    qreal desiredTimeUSecs = percentCompleteMult * _logDurationUSecs;
+    const quint64 desiredTimeUSecs = _logStartTimeUSecs + static_cast<quint64>((percentComplete / 100.0) * _logDurationUSecs);
 
-    // And now jump the necessary number of bytes in the proper direction
-    qint64 offset = (newRelativeTimeUSecs - desiredTimeUSecs) * baudRate;
-    if (!_logFile.seek(_logFile.pos() + offset)) {
+    // Jump to the closest indexed record before the desired time, then walk forward to the first message at or after it.
+    // The walk covers at most one index interval of log time.
+    if (!_seekToRecord(_logIndex.offsetForTime(desiredTimeUSecs))) {
         _replayError(tr("Unable to seek to new position"));
         return;
     }
+    while ((_logCurrentTimeUSecs < desiredTimeUSecs) && _seekToRecord(_nextFrameOffset + _nextFrameLength)) {
+    }
 
-    // And scan until we reach the start of a MAVLink message. We make sure to record this timestamp for
-    // smooth jumping around the file.
-    _logCurrentTimeUSecs = _seekToNextMavlinkMessage(&dummy);
     _signalCurrentLogTimeSecs();
 
     // Now update the UI with our actual final position.
-    newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
+    const qreal newRelativeTimeUSecs = (qreal)(_logCurrentTimeUSecs - _logStartTimeUSecs);
     percentComplete = (newRelativeTimeUSecs / _logDurationUSecs) * 100;
     emit playbackPercentCompleteChanged(percentComplete);
 }
@@ -474,7 +417,11 @@ void LogReplayLink::_setPlaybackSpeed(qreal playbackSpeed)
 void LogReplayLink::_finishPlayback(void)
 {
     _pause();
-    
+
+    // The last tick may have sent the final messages without reporting the position, move the UI to the end
+    _signalCurrentLogTimeSecs();
+    emit playbackPercentCompleteChanged(100);
+
     emit playbackAtEnd();
 }
 
@@ -11,6 +11,7 @@
 
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
+#include "LogReplayIndex.h"
 
 #include <QtCore/QTimer>
 #include <QtCore/QFile>
@@ -18,8 +19,6 @@
 class LinkManager;
 class MAVLinkProtocol;
 
-typedef struct __mavlink_message mavlink_message_t;
-
 class LogReplayLinkConfiguration : public LinkConfiguration
 {
     Q_OBJECT
@@ -65,7 +64,8 @@ public:
 
     void play           (void) { emit _playOnThread(); }
     void pause          (void) { emit _pauseOnThread(); }
-    void movePlayhead   (qreal percentComplete);
+    /// Pauses playback and moves to the first message at or after the given position in log time
+    void movePlayhead   (qreal percentComplete) { emit _movePlayheadOnThread(percentComplete); }
 
     // overrides from LinkInterface
     bool isConnected(void) const override { return _connected; }
@@ -88,6 +88,7 @@ signals:
     void _playOnThread              (void);
     void _pauseOnThread             (void);
     void _setPlaybackSpeedOnThread  (qreal playbackSpeed);
+    void _movePlayheadOnThread      (qreal percentComplete);
 
 private slots:
     // LinkInterface overrides
@@ -97,6 +98,7 @@ private slots:
     void _play              (void);
     void _pause             (void);
     void _setPlaybackSpeed  (qreal playbackSpeed);
+    void _movePlayhead      (qreal percentComplete);
 
 private:
 
@@ -104,11 +106,10 @@ private:
     bool _connect(void) override;
 
     void    _replayError                (const QString& errorMsg);
-    quint64 _parseTimestamp             (const QByteArray& bytes);
-    quint64 _seekToNextMavlinkMessage   (mavlink_message_t* nextMsg);
-    quint64 _findLastTimestamp          (void);
-    quint64 _readNextMavlinkMessage     (QByteArray& bytes);
+    bool    _seekToRecord               (qint64 offset);
+    bool    _atEnd                      (void) const { return _logPos >= _logFileSize; }
     bool    _loadLogFile                (void);
+    void    _closeLogFile               (void);
     void    _finishPlayback             (void);
     void    _resetPlaybackToBeginning   (void);
     void    _signalCurrentLogTimeSecs   (void);
@@ -119,7 +120,6 @@ private:
     LogReplayLinkConfiguration* _logReplayConfig;
 
     bool    _connected;
-    uint8_t _mavlinkChannel;
     QTimer  _readTickTimer;      ///< Timer which signals a read of next log record
 
     QString _errorTitle; ///< Title for communicatorError signals
@@ -135,9 +135,15 @@ private:
 
     MAVLinkProtocol*    _mavlink;
     QFile               _logFile;
-    quint64             _logFileSize;
-
-    static const int cbTimestamp = sizeof(quint64);
+    qint64              _logFileSize;
+    const uchar*        _logData;           ///< Memory mapped log file
+    LogReplayIndex      _logIndex;
+    qint64              _logPos;            ///< Offset of the next record to play
+    qint64              _nextFrameOffset;   ///< Frame of the record at _logPos
+    qint64              _nextFrameLength;
+    quint64             _nowUSecs;          ///< Used to detect old little endian timestamps, see LogReplayIndex::parseTimestamp
+
+    static constexpr int kMaxTickBytes = 256 * 1024;    ///< Upper bound on the bytes sent per tick so high speeds still return to the event loop
 };
 
 class LogReplayLinkController : public QObject
@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriter.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QtEndian>
+
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(MAVLinkLogWriterLog, "MAVLinkLogWriterLog")
+
+MAVLinkLogWriter::MAVLinkLogWriter(QObject *parent)
+    : QThread(parent)
+{
+    setObjectName("MAVLinkLogWriter");
+}
+
+MAVLinkLogWriter::~MAVLinkLogWriter()
+{
+    stopLogging();
+}
+
+void MAVLinkLogWriter::startLogging(QFile *file)
+{
+    if (_file) {
+        stopLogging();
+    }
+
+    if (_ring.empty()) {
+        _ring.resize(kRingSize);
+    }
+    _head = 0;
+    _tail = 0;
+    _stopRequested = false;
+    _failed = false;
+    _consecutiveWriteErrors = 0;
+    _framesQueued = 0;
+    _framesDropped = 0;
+    _bytesWritten = 0;
+    _writeErrors = 0;
+    _peakBufferedBytes = 0;
+
+    _file = file;
+    start(QThread::LowPriority);
+}
+
+void MAVLinkLogWriter::stopLogging()
+{
+    if (!_file) {
+        return;
+    }
+
+    {
+        QMutexLocker lock(&_waitMutex);
+        _stopRequested = true;
+        _waitCondition.wakeOne();
+    }
+    (void) wait();
+
+    const Stats logStats = stats();
+    qCDebug(MAVLinkLogWriterLog) << "Stopped" << _file->fileName()
+                                 << "frames" << logStats.framesQueued
+                                 << "dropped" << logStats.framesDropped
+                                 << "bytes" << logStats.bytesWritten
+                                 << "write errors" << logStats.writeErrors
+                                 << "peak buffered" << logStats.peakBufferedBytes;
+    _file = nullptr;
+}
+
+bool MAVLinkLogWriter::writeFrame(quint64 timestampUsecs, const uint8_t *frame, qsizetype length)
+{
+    const quint64 head = _head.load(std::memory_order_relaxed);
+    const quint64 buffered = head - _tail.load(std::memory_order_acquire);
+    const quint64 required = sizeof(quint64) + static_cast<quint64>(length);
+    if (_failed || (buffered + required > static_cast<quint64>(kRingSize))) {
+        _framesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // The tlog format is a big endian microsecond timestamp followed by the raw frame
+    uint8_t timestamp[sizeof(quint64)];
+    qToBigEndian(timestampUsecs, timestamp);
+
+    char *ring = _ring.data();
+    auto copyIn = [ring](quint64 position, const void *source, qsizetype count) {
+        const qsizetype offset = static_cast<qsizetype>(position & (kRingSize - 1));
+        const qsizetype first = qMin(count, kRingSize - offset);
+        (void) memcpy(ring + offset, source, first);
+        (void) memcpy(ring, static_cast<const char*>(source) + first, count - first);
+    };
+    copyIn(head, timestamp, sizeof(timestamp));
+    copyIn(head + sizeof(timestamp), frame, length);
+    _head.store(head + required, std::memory_order_release);
+
+    _framesQueued.fetch_add(1, std::memory_order_relaxed);
+    const quint64 nowBuffered = buffered + required;
+    if (nowBuffered > _peakBufferedBytes.load(std::memory_order_relaxed)) {
+        _peakBufferedBytes.store(nowBuffered, std::memory_order_relaxed);
+    }
+
+    // Only wake the writer early when crossing the chunk threshold, otherwise it wakes itself on the flush interval
+    if ((buffered < static_cast<quint64>(kWriteChunkSize)) && (nowBuffered >= static_cast<quint64>(kWriteChunkSize))) {
+        _waitCondition.wakeOne();
+    }
+
+    return true;
+}
+
+MAVLinkLogWriter::Stats MAVLinkLogWriter::stats() const
+{
+    Stats logStats;
+    logStats.framesQueued = _framesQueued.load(std::memory_order_relaxed);
+    logStats.framesDropped = _framesDropped.load(std::memory_order_relaxed);
+    logStats.bytesWritten = _bytesWritten.load(std::memory_order_relaxed);
+    logStats.writeErrors = _writeErrors.load(std::memory_order_relaxed);
+    logStats.peakBufferedBytes = _peakBufferedBytes.load(std::memory_order_relaxed);
+    return logStats;
+}
+
+void MAVLinkLogWriter::run()
+{
+    bool retryPending = false;
+    while (true) {
+        {
+            QMutexLocker lock(&_waitMutex);
+            const quint64 buffered = _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+            if (!_stopRequested && (retryPending || _failed || (buffered < static_cast<quint64>(kWriteChunkSize)))) {
+                (void) _waitCondition.wait(&_waitMutex, kFlushIntervalMs);
+            }
+        }
+
+        const bool stopping = _stopRequested;
+        if (!_failed) {
+            retryPending = !_drain();
+        }
+
+        // A failed write gets no further retries once stopping
+        if (stopping && (_failed || retryPending || (_head.load(std::memory_order_acquire) == _tail.load(std::memory_order_relaxed)))) {
+            break;
+        }
+    }
+
+    (void) _file->flush();
+}
+
+/// Writes everything currently buffered to the file
+///     @return false if a write failed
+bool MAVLinkLogWriter::_drain()
+{
+    const quint64 head = _head.load(std::memory_order_acquire);
+    quint64 tail = _tail.load(std::memory_order_relaxed);
+
+    while (tail != head) {
+        const qsizetype offset = static_cast<qsizetype>(tail & (kRingSize - 1));
+        const qsizetype contiguous = static_cast<qsizetype>(qMin<quint64>(head - tail, static_cast<quint64>(kRingSize - offset)));
+        const qint64 written = _file->write(_ring.data() + offset, contiguous);
+        if (written <= 0) {
+            _writeErrors.fetch_add(1, std::memory_order_relaxed);
+            qCWarning(MAVLinkLogWriterLog) << "Write failed" << _file->fileName() << _file->errorString();
+            if (++_consecutiveWriteErrors >= kMaxWriteRetries) {
+                _failed = true;
+                emit writeFailed(_file->fileName());
+            }
+            return false;
+        }
+
+        _consecutiveWriteErrors = 0;
+        tail += static_cast<quint64>(written);
+        _tail.store(tail, std::memory_order_release);
+        _bytesWritten.fetch_add(static_cast<quint64>(written), std::memory_order_relaxed);
+    }
+
+    // Push buffered data to the OS so a crash loses at most one flush interval
+    (void) _file->flush();
+
+    return true;
+}
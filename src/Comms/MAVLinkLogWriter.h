@@ -0,0 +1,95 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+#include <vector>
+
+Q_DECLARE_LOGGING_CATEGORY(MAVLinkLogWriterLog)
+
+class QFile;
+
+/// Writes timestamped MAVLink frames to a telemetry log from a dedicated thread.
+///
+/// The protocol thread is the single producer: writeFrame() copies the timestamp and frame into a
+/// lock-free ring buffer and returns immediately. If the writer falls behind and the ring fills up
+/// the frame is dropped and counted rather than blocking message decoding. The writer thread drains
+/// the ring in large sequential writes once kWriteChunkSize bytes are pending or kFlushIntervalMs
+/// has elapsed. A failed write is retried on the next pass, so a slow or briefly unavailable
+/// medium only costs dropped frames.
+class MAVLinkLogWriter : public QThread
+{
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 framesQueued = 0;
+        quint64 framesDropped = 0;
+        quint64 bytesWritten = 0;
+        quint64 writeErrors = 0;
+        quint64 peakBufferedBytes = 0;
+    };
+
+    explicit MAVLinkLogWriter(QObject *parent = nullptr);
+    ~MAVLinkLogWriter();
+
+    /// Starts the writer thread on file, which must already be open. The caller must not touch
+    /// the file again until stopLogging() returns.
+    void startLogging(QFile *file);
+    /// Writes out everything still buffered, flushes the file and joins the writer thread
+    void stopLogging();
+
+    /// Producer side, protocol thread only. Never blocks.
+    ///     @return false if the frame was dropped because the ring buffer is full
+    bool writeFrame(quint64 timestampUsecs, const uint8_t *frame, qsizetype length);
+
+    bool logging() const { return _file != nullptr; }
+    Stats stats() const;
+
+signals:
+    /// Emitted from the writer thread once kMaxWriteRetries consecutive writes have failed. Frames
+    /// are dropped from then on until stopLogging() is called.
+    void writeFailed(const QString &fileName);
+
+protected:
+    void run() final;
+
+private:
+    bool _drain();
+
+    QFile *_file = nullptr;
+
+    std::vector<char> _ring;
+    std::atomic<quint64> _head = 0;     ///< Total bytes produced
+    std::atomic<quint64> _tail = 0;     ///< Total bytes consumed
+    std::atomic_bool _stopRequested = false;
+    std::atomic_bool _failed = false;
+    int _consecutiveWriteErrors = 0;
+
+    QMutex _waitMutex;
+    QWaitCondition _waitCondition;
+
+    std::atomic<quint64> _framesQueued = 0;
+    std::atomic<quint64> _framesDropped = 0;
+    std::atomic<quint64> _bytesWritten = 0;
+    std::atomic<quint64> _writeErrors = 0;
+    std::atomic<quint64> _peakBufferedBytes = 0;
+
+    static constexpr qsizetype kRingSize = 4 * 1024 * 1024;
+    static_assert((kRingSize & (kRingSize - 1)) == 0, "Ring size must be a power of two");
+    static constexpr qsizetype kWriteChunkSize = 64 * 1024;
+    static constexpr unsigned long kFlushIntervalMs = 100;
+    static constexpr int kMaxWriteRetries = 3;
+};
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "MAVLinkProtocol.h"
+#include "MAVLinkFraming.h"
 #include "LinkManager.h"
 #include "QGCApplication.h"
 #include "MultiVehicleManager.h"
@@ -57,6 +58,8 @@ MAVLinkProtocol::MAVLinkProtocol(QGCApplication* app, QGCToolbox* toolbox)
     memset(firstMessage,        1, sizeof(firstMessage));
     memset(&_status,            0, sizeof(_status));
     memset(&_message,           0, sizeof(_message));
+
+    (void) connect(&_logWriter, &MAVLinkLogWriter::writeFailed, this, &MAVLinkProtocol::_logWriteFailed);
 }
 
 MAVLinkProtocol::~MAVLinkProtocol()
@@ -105,6 +108,13 @@ void MAVLinkProtocol::setToolbox(QGCToolbox *toolbox)
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleAdded, this, &MAVLinkProtocol::_vehicleCountChanged);
    connect(_multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &MAVLinkProtocol::_vehicleCountChanged);
 
+   // Cached so receiveBytes does not need a settings lookup for every message
+   Fact* const forwardMavlinkFact = _toolbox->settingsManager()->appSettings()->forwardMavlink();
+   _forwardMavlink = forwardMavlinkFact->rawValue().toBool();
+   connect(forwardMavlinkFact, &Fact::rawValueChanged, this, [this](const QVariant& value) {
+       _forwardMavlink = value.toBool();
+   });
+
    emit versionCheckChanged(_enable_version_check);
 }
 
@@ -153,26 +163,10 @@ void MAVLinkProtocol::resetMetadataForLink(LinkInterface *link)
 
 void MAVLinkProtocol::logSentBytes(LinkInterface* link, QByteArray b){
 
-    uint8_t bytes_time[sizeof(quint64)];
-
     Q_UNUSED(link);
-    if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-
-        quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-
-        qToBigEndian(time,bytes_time);
-
-        b.insert(0,QByteArray((const char*)bytes_time,sizeof(bytes_time)));
-
-        int len = b.length();
-
-        if(_tempLogFile.write(b) != len)
-        {
-            // If there's an error logging data, raise an alert and stop logging.
-            emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-            _stopLogging();
-            _logSuspendError = true;
-        }
+    if (!_logSuspendError && !_logSuspendReplay && _logWriter.logging()) {
+        const quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
+        (void) _logWriter.writeFrame(time, reinterpret_cast<const uint8_t*>(b.constData()), b.length());
     }
 
 }
@@ -196,193 +190,171 @@ void MAVLinkProtocol::receiveBytes(LinkInterface* link, QByteArray b)
         return;
     }
 
-    uint8_t mavlinkChannel = link->mavlinkChannel();
-
-    for (int position = 0; position < b.size(); position++) {
-        if (mavlink_parse_char(mavlinkChannel, static_cast<uint8_t>(b[position]), &_message, &_status)) {
-            // Got a valid message
-            if (!link->decodedFirstMavlinkPacket()) {
-                link->setDecodedFirstMavlinkPacket(true);
-                mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-                if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                    mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-                    // Set all links to v2
-                    setVersion(200);
-                }
-            }
+    const mavlink_channel_t mavlinkChannel = static_cast<mavlink_channel_t>(link->mavlinkChannel());
+    const uint8_t* const data = reinterpret_cast<const uint8_t*>(b.constData());
 
-            //-----------------------------------------------------------------
-            // MAVLink Status
-            uint8_t lastSeq = lastIndex[_message.sysid][_message.compid];
-            uint8_t expectedSeq = lastSeq + 1;
-            // Increase receive counter
-            totalReceiveCounter[mavlinkChannel]++;
-            // Determine what the next expected sequence number is, accounting for
-            // never having seen a message for this system/component pair.
-            if(firstMessage[_message.sysid][_message.compid]) {
-                firstMessage[_message.sysid][_message.compid] = 0;
-                lastSeq     = _message.seq;
-                expectedSeq = _message.seq;
+    // Forwarding links are looked up once for the whole buffer rather than once per message
+    const SharedLinkInterfacePtr forwardingLink = _forwardMavlink ? _linkMgr->mavlinkForwardingLink() : nullptr;
+    const SharedLinkInterfacePtr forwardingSupportLink = _linkMgr->mavlinkSupportForwardingEnabled() ? _linkMgr->mavlinkForwardingSupportLink() : nullptr;
+
+    qsizetype position = 0;
+    while (MAVLinkFraming::parseNext(mavlinkChannel, data, b.size(), position, _message, _status)) {
+        // Got a valid message
+        if (!link->decodedFirstMavlinkPacket()) {
+            link->setDecodedFirstMavlinkPacket(true);
+            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+            if (!(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1) && (mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+                qCDebug(MAVLinkProtocolLog) << "Switching outbound to mavlink 2.0 due to incoming mavlink 2.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+                mavlinkStatus->flags &= ~MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+                // Set all links to v2
+                setVersion(200);
             }
-            // And if we didn't encounter that sequence number, record the error
-            //int foo = 0;
-            if (_message.seq != expectedSeq)
-            {
-                //foo = 1;
-                int lostMessages = 0;
-                //-- Account for overflow during packet loss
-                if(_message.seq < expectedSeq) {
-                    lostMessages = (_message.seq + 255) - expectedSeq;
-                } else {
-                    lostMessages = _message.seq - expectedSeq;
-                }
-                // Log how many were lost
-                totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
+        }
+
+        //-----------------------------------------------------------------
+        // MAVLink Status
+        uint8_t lastSeq = lastIndex[_message.sysid][_message.compid];
+        uint8_t expectedSeq = lastSeq + 1;
+        // Increase receive counter
+        totalReceiveCounter[mavlinkChannel]++;
+        // Determine what the next expected sequence number is, accounting for
+        // never having seen a message for this system/component pair.
+        if(firstMessage[_message.sysid][_message.compid]) {
+            firstMessage[_message.sysid][_message.compid] = 0;
+            lastSeq     = _message.seq;
+            expectedSeq = _message.seq;
+        }
+        // And if we didn't encounter that sequence number, record the error
+        //int foo = 0;
+        if (_message.seq != expectedSeq)
+        {
+            //foo = 1;
+            int lostMessages = 0;
+            //-- Account for overflow during packet loss
+            if(_message.seq < expectedSeq) {
+                lostMessages = (_message.seq + 255) - expectedSeq;
+            } else {
+                lostMessages = _message.seq - expectedSeq;
             }
+            // Log how many were lost
+            totalLossCounter[mavlinkChannel] += static_cast<uint64_t>(lostMessages);
+        }
 
-            // And update the last sequence number for this system/component pair
-            lastIndex[_message.sysid][_message.compid] = _message.seq;;
-            // Calculate new loss ratio
-            uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
-            float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
-            receiveLossPercent *= 100.0f;
-            receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
-            runningLossPercent[mavlinkChannel] = receiveLossPercent;
+        // And update the last sequence number for this system/component pair
+        lastIndex[_message.sysid][_message.compid] = _message.seq;;
 
-            //qDebug() << foo << _message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << _message.sysid << _message.compid << ")";
+        //qDebug() << foo << _message.seq << expectedSeq << lastSeq << totalLossCounter[mavlinkChannel] << totalReceiveCounter[mavlinkChannel] << totalSentCounter[mavlinkChannel] << "(" << _message.sysid << _message.compid << ")";
 
-            //-----------------------------------------------------------------
-            // MAVLink forwarding
-            bool forwardingEnabled = _app->toolbox()->settingsManager()->appSettings()->forwardMavlink()->rawValue().toBool();
-            if (_message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-                forwardingEnabled = false;
-            }
-            if (forwardingEnabled) {
-                SharedLinkInterfacePtr forwardingLink = _linkMgr->mavlinkForwardingLink();
+        //-----------------------------------------------------------------
+        // MAVLink forwarding and logging
+        //
+        // The message is serialized at most once. The same implicitly shared frame is handed to every
+        // forwarding link and copied into the log writer ring, so adding consumers costs no extra encoding.
+        const bool forwardingAllowed = _message.msgid != MAVLINK_MSG_ID_SETUP_SIGNING;
+        const bool forward = forwardingAllowed && forwardingLink && forwardingLink->linkConfiguration()->forwardsMessage(_message.msgid);
+        const bool forwardSupport = forwardingAllowed && forwardingSupportLink && forwardingSupportLink->linkConfiguration()->forwardsMessage(_message.msgid);
+        const bool log = !_logSuspendError && !_logSuspendReplay && _logWriter.logging();
 
-                if (forwardingLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingLink->writeBytesThreadSafe((const char*)buf, len);
-                }
-            }
+        if (forward || forwardSupport || log) {
+            QByteArray frame(MAVLINK_MAX_PACKET_LEN, Qt::Uninitialized);
+            frame.truncate(mavlink_msg_to_send_buffer(reinterpret_cast<uint8_t*>(frame.data()), &_message));
 
-            // MAVLink forwarding support
-            bool forwardingSupportEnabled = _linkMgr->mavlinkSupportForwardingEnabled();
-            if (_message.msgid == MAVLINK_MSG_ID_SETUP_SIGNING) {
-                forwardingSupportEnabled = false;
+            if (forward) {
+                forwardingLink->writeBytesThreadSafe(frame);
             }
-            if (forwardingSupportEnabled) {
-                SharedLinkInterfacePtr forwardingSupportLink = _linkMgr->mavlinkForwardingSupportLink();
-
-                if (forwardingSupportLink) {
-                    uint8_t buf[MAVLINK_MAX_PACKET_LEN];
-                    int len = mavlink_msg_to_send_buffer(buf, &_message);
-                    forwardingSupportLink->writeBytesThreadSafe((const char*)buf, len);
-                }
+            if (forwardSupport) {
+                forwardingSupportLink->writeBytesThreadSafe(frame);
             }
+            if (log) {
+                // The writer prefixes the uint64 time in microseconds in big endian format. This timestamp
+                // is saved in UTC time. We are only saving in ms precision because getting more than this
+                // isn't possible with Qt without a ton of extra code.
+                const quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
+
+                // Never blocks, if the writer has fallen behind the frame is dropped and counted
+                (void) _logWriter.writeFrame(time, reinterpret_cast<const uint8_t*>(frame.constData()), frame.size());
+            }
+        }
 
-            //-----------------------------------------------------------------
-            // Log data
-            if (!_logSuspendError && !_logSuspendReplay && _tempLogFile.isOpen()) {
-                uint8_t buf[MAVLINK_MAX_PACKET_LEN+sizeof(quint64)];
-
-                // Write the uint64 time in microseconds in big endian format before the message.
-                // This timestamp is saved in UTC time. We are only saving in ms precision because
-                // getting more than this isn't possible with Qt without a ton of extra code.
-                quint64 time = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch() * 1000);
-                qToBigEndian(time, buf);
-
-                // Then write the message to the buffer
-                int len = mavlink_msg_to_send_buffer(buf + sizeof(quint64), &_message);
-
-                // Determine how many bytes were written by adding the timestamp size to the message size
-                len += sizeof(quint64);
-
-                // Now write this timestamp/message pair to the log.
-                QByteArray b(reinterpret_cast<const char*>(buf), len);
-                if(_tempLogFile.write(b) != len)
-                {
-                    // If there's an error logging data, raise an alert and stop logging.
-                    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(_tempLogFile.fileName()));
-                    _stopLogging();
-                    _logSuspendError = true;
-                }
-
-                // Check for the vehicle arming going by. This is used to trigger log save.
-                if (!_vehicleWasArmed && _message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                    mavlink_heartbeat_t state;
-                    mavlink_msg_heartbeat_decode(&_message, &state);
-                    if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
-                        _vehicleWasArmed = true;
-                    }
+        if (log) {
+            // Check for the vehicle arming going by. This is used to trigger log save.
+            if (!_vehicleWasArmed && _message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+                mavlink_heartbeat_t state;
+                mavlink_msg_heartbeat_decode(&_message, &state);
+                if (state.base_mode & MAV_MODE_FLAG_DECODE_POSITION_SAFETY) {
+                    _vehicleWasArmed = true;
                 }
             }
+        }
 
-            if (_message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
-                _startLogging();
-                mavlink_heartbeat_t heartbeat;
-                mavlink_msg_heartbeat_decode(&_message, &heartbeat);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, heartbeat.autopilot, heartbeat.type);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
-                _startLogging();
-                mavlink_high_latency_t highLatency;
-                mavlink_msg_high_latency_decode(&_message, &highLatency);
-                // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
-            } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-                _startLogging();
-                mavlink_high_latency2_t highLatency2;
-                mavlink_msg_high_latency2_decode(&_message, &highLatency2);
-                emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, highLatency2.autopilot, highLatency2.type);
-            }
+        if (_message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            _startLogging();
+            mavlink_heartbeat_t heartbeat;
+            mavlink_msg_heartbeat_decode(&_message, &heartbeat);
+            emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, heartbeat.autopilot, heartbeat.type);
+        } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY) {
+            _startLogging();
+            mavlink_high_latency_t highLatency;
+            mavlink_msg_high_latency_decode(&_message, &highLatency);
+            // HIGH_LATENCY does not provide autopilot or type information, generic is our safest bet
+            emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, MAV_AUTOPILOT_GENERIC, MAV_TYPE_GENERIC);
+        } else if (_message.msgid == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+            _startLogging();
+            mavlink_high_latency2_t highLatency2;
+            mavlink_msg_high_latency2_decode(&_message, &highLatency2);
+            emit vehicleHeartbeatInfo(link, _message.sysid, _message.compid, highLatency2.autopilot, highLatency2.type);
+        }
 
 #if 0
-            // Given the current state of SiK Radio firmwares there is no way to make the code below work.
-            // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
-            // packet even if the vehicle is sending Mavlink 2.
-
-            // Detect if we are talking to an old radio not supporting v2
-            mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
-            if (_message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
-                if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
-                && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
-                    _radio_version_mismatch_count++;
-                }
+        // Given the current state of SiK Radio firmwares there is no way to make the code below work.
+        // The ArduPilot implementation of SiK Radio firmware always sends MAVLINK_MSG_ID_RADIO_STATUS as a mavlink 1
+        // packet even if the vehicle is sending Mavlink 2.
+
+        // Detect if we are talking to an old radio not supporting v2
+        mavlink_status_t* mavlinkStatus = mavlink_get_channel_status(mavlinkChannel);
+        if (_message.msgid == MAVLINK_MSG_ID_RADIO_STATUS && _radio_version_mismatch_count != -1) {
+            if ((mavlinkStatus->flags & MAVLINK_STATUS_FLAG_IN_MAVLINK1)
+            && !(mavlinkStatus->flags & MAVLINK_STATUS_FLAG_OUT_MAVLINK1)) {
+                _radio_version_mismatch_count++;
             }
+        }
 
-            if (_radio_version_mismatch_count == 5) {
-                // Warn the user if the radio continues to send v1 while the link uses v2
-                emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
-                // Set to flag warning already shown
-                _radio_version_mismatch_count = -1;
-                // Flick link back to v1
-                qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
-                mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
-            }
+        if (_radio_version_mismatch_count == 5) {
+            // Warn the user if the radio continues to send v1 while the link uses v2
+            emit protocolStatusMessage(tr("MAVLink Protocol"), tr("Detected radio still using MAVLink v1.0 on a link with MAVLink v2.0 enabled. Please upgrade the radio firmware."));
+            // Set to flag warning already shown
+            _radio_version_mismatch_count = -1;
+            // Flick link back to v1
+            qDebug() << "Switching outbound to mavlink 1.0 due to incoming mavlink 1.0 packet:" << mavlinkStatus << mavlinkChannel << mavlinkStatus->flags;
+            mavlinkStatus->flags |= MAVLINK_STATUS_FLAG_OUT_MAVLINK1;
+        }
 #endif
 
-            // Update MAVLink status on every 32th packet
-            if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
-                emit mavlinkMessageStatus(_message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
-            }
-
-            // The packet is emitted as a whole, as it is only 255 - 261 bytes short
-            // kind of inefficient, but no issue for a groundstation pc.
-            // It buys as reentrancy for the whole code over all threads
-            emit messageReceived(link, _message);
+        // Update MAVLink status on every 32th packet. The loss ratio is only needed for this signal
+        // so it is only calculated here rather than for every message.
+        if ((totalReceiveCounter[mavlinkChannel] & 0x1F) == 0) {
+            const uint64_t totalSent = totalReceiveCounter[mavlinkChannel] + totalLossCounter[mavlinkChannel];
+            float receiveLossPercent = static_cast<float>(static_cast<double>(totalLossCounter[mavlinkChannel]) / static_cast<double>(totalSent));
+            receiveLossPercent *= 100.0f;
+            receiveLossPercent = (receiveLossPercent * 0.5f) + (runningLossPercent[mavlinkChannel] * 0.5f);
+            runningLossPercent[mavlinkChannel] = receiveLossPercent;
+            emit mavlinkMessageStatus(_message.sysid, totalSent, totalReceiveCounter[mavlinkChannel], totalLossCounter[mavlinkChannel], receiveLossPercent);
+        }
 
-            // Anyone handling the message could close the connection, which deletes the link,
-            // so we check if it's expired
-            if (1 == linkPtr.use_count()) {
-                break;
-            }
+        // The packet is emitted as a whole, as it is only 255 - 261 bytes short
+        // kind of inefficient, but no issue for a groundstation pc.
+        // It buys as reentrancy for the whole code over all threads
+        emit messageReceived(link, _message);
 
-            // Reset message parsing
-            memset(&_status,  0, sizeof(_status));
-            memset(&_message, 0, sizeof(_message));
+        // Anyone handling the message could close the connection, which deletes the link,
+        // so we check if it's expired
+        if (1 == linkPtr.use_count()) {
+            break;
         }
+
+        // Reset message parsing
+        memset(&_status,  0, sizeof(_status));
+        memset(&_message, 0, sizeof(_message));
     }
 }
 
@@ -431,6 +403,8 @@ void MAVLinkProtocol::_vehicleCountChanged(void)
 bool MAVLinkProtocol::_closeLogFile(void)
 {
     if (_tempLogFile.isOpen()) {
+        // Everything still buffered is written before the file size is checked
+        _logWriter.stopLogging();
         if (_tempLogFile.size() == 0) {
             // Don't save zero byte files
             _tempLogFile.remove();
@@ -444,6 +418,19 @@ bool MAVLinkProtocol::_closeLogFile(void)
     return false;
 }
 
+void MAVLinkProtocol::_logWriteFailed(const QString& fileName)
+{
+    // Queued from the writer thread, the log may already have been closed
+    if (!_logWriter.logging() || (fileName != _tempLogFile.fileName())) {
+        return;
+    }
+
+    // If there's an error logging data, raise an alert and stop logging.
+    emit protocolStatusMessage(tr("MAVLink Protocol"), tr("MAVLink Logging failed. Could not write to file %1, logging disabled.").arg(fileName));
+    _stopLogging();
+    _logSuspendError = true;
+}
+
 void MAVLinkProtocol::_startLogging(void)
 {
     //-- Are we supposed to write logs?
@@ -473,6 +460,7 @@ void MAVLinkProtocol::_startLogging(void)
             }
 
             qCDebug(MAVLinkProtocolLog) << "Temp log" << _tempLogFile.fileName();
+            _logWriter.startLogging(&_tempLogFile);
             emit checkTelemetrySavePath();
 
             _logSuspendError = false;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "LinkInterface.h"
+#include "MAVLinkLogWriter.h"
 #include "QGCMAVLink.h"
 #include "QGCTemporaryFile.h"
 #include "QGCToolbox.h"
@@ -148,6 +149,7 @@ signals:
 
 private slots:
     void _vehicleCountChanged(void);
+    void _logWriteFailed(const QString& fileName);
 
 private:
     bool _closeLogFile(void);
@@ -157,8 +159,10 @@ private:
     bool _logSuspendError;      ///< true: Logging suspended due to error
     bool _logSuspendReplay;     ///< true: Logging suspended due to replay
     bool _vehicleWasArmed;      ///< true: Vehicle was armed during log sequence
+    bool _forwardMavlink = false; ///< Cached AppSettings::forwardMavlink
 
     QGCTemporaryFile    _tempLogFile;            ///< File to log to
+    MAVLinkLogWriter    _logWriter;              ///< Writes _tempLogFile off the protocol thread
     static constexpr const char* _tempLogFileTemplate   = "FlightDataXXXXXX";   ///< Template for temporary log file
     static constexpr const char* _logFileExtension      = "mavlink";            ///< Extension for log files
 
@@ -558,6 +558,20 @@ void MockLink::_writeBytes(const QByteArray &bytes)
 }
 
 void MockLink::_writeBytesQueued(const QByteArray bytes)
+{
+    if ((_linkLossPercent > 0) && ((_linkLossRandom.generateDouble() * 100.0) < _linkLossPercent)) {
+        qCDebug(MockLinkVerboseLog) << "Simulated link dropped" << bytes.length() << "bytes";
+        return;
+    }
+
+    if (_linkLatencyMSecs > 0) {
+        QTimer::singleShot(_linkLatencyMSecs, this, [this, bytes]() { _handleWrittenBytes(bytes); });
+    } else {
+        _handleWrittenBytes(bytes);
+    }
+}
+
+void MockLink::_handleWrittenBytes(const QByteArray& bytes)
 {
     if (_inNSH) {
         _handleIncomingNSHBytes(bytes.constData(), bytes.length());
@@ -848,6 +862,23 @@ void MockLink::_handleParamRequestList(const mavlink_message_t& msg)
     // Start the worker routine
     _currentParamRequestListComponentIndex = 0;
     _currentParamRequestListParamIndex = 0;
+
+    if (_paramHashCheck && (_firmwareType == MAV_AUTOPILOT_PX4)) {
+        mavlink_param_union_t   valueUnion;
+        mavlink_message_t       responseMsg;
+
+        valueUnion.param_uint32 = _paramHashCheck;
+        mavlink_msg_param_value_pack_chan(_vehicleSystemId,
+                                          MAV_COMP_ID_AUTOPILOT1,
+                                          mavlinkChannel(),
+                                          &responseMsg,
+                                          "_HASH_CHECK",
+                                          valueUnion.param_float,
+                                          MAV_PARAM_TYPE_UINT32,
+                                          0,
+                                          UINT16_MAX);
+        respondWithMavlinkMessage(responseMsg);
+    }
 }
 
 /// Sends the next parameter to the vehicle
@@ -918,6 +949,13 @@ void MockLink::_handleParamSet(const mavlink_message_t& msg)
 
     qCDebug(MockLinkLog) << "_handleParamSet" << componentId << paramId << request.param_type;
 
+    if (strcmp(paramId, "_HASH_CHECK") == 0) {
+        // QGC loaded the parameters from its cache, so stop sending them
+        _currentParamRequestListComponentIndex = -1;
+        _paramHashCheckAccepted = true;
+        return;
+    }
+
     Q_ASSERT(_mapParamName2Value.contains(componentId));
     Q_ASSERT(_mapParamName2MavParamType.contains(componentId));
     Q_ASSERT(_mapParamName2Value[componentId].contains(paramId));
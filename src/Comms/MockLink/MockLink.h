@@ -20,6 +20,7 @@
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QMap>
 #include <QtCore/QMutex>
+#include <QtCore/QRandomGenerator>
 
 Q_DECLARE_LOGGING_CATEGORY(MockLinkLog)
 Q_DECLARE_LOGGING_CATEGORY(MockLinkVerboseLog)
@@ -121,6 +122,14 @@ public:
     /// for unit testing.
     void setAPMMissionResponseMode(bool sendHomePositionOnEmptyList) { _apmSendHomePositionOnEmptyList = sendHomePositionOnEmptyList; }
 
+    /// PX4 starts its reply to a param request list with a _HASH_CHECK value, which QGC compares against its
+    /// parameter cache. A _HASH_CHECK param set coming back means the cache matched and the list is stopped.
+    ///     @param paramHash Hash to report, 0 to not send _HASH_CHECK
+    void setParamHashCheck(uint32_t paramHash) { _paramHashCheck = paramHash; }
+
+    /// @return true if QGC has answered a _HASH_CHECK, meaning it loaded the parameters from its cache
+    bool paramHashCheckAccepted() const { return _paramHashCheckAccepted; }
+
     void emitRemoteControlChannelRawChanged(int channel, uint16_t raw);
 
     /// Sends the specified mavlink message to QGC
@@ -158,6 +167,19 @@ public:
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler(void) { _missionItemHandler.reset(); }
 
+    /// Number of MISSION_REQUEST_INT the vehicle keeps outstanding while a mission is written to it
+    ///     @param window 1 to request one item at a time
+    void setMissionItemWriteWindow(int window) { _missionItemHandler.setWriteRequestWindow(window); }
+
+    /// Number of MISSION_REQUEST_INT received during the last mission read
+    int missionItemReadRequestCount(void) const { return _missionItemHandler.readRequestCount(); }
+
+    /// Simulates a slow, lossy link for unit testing. Messages from QGC are dropped at random with the specified
+    /// percentage and the rest are handled latencyMSecs after they were sent, which stands in for the round trip.
+    void setLinkConditions(int latencyMSecs, double lossPercent) { _linkLatencyMSecs = latencyMSecs; _linkLossPercent = lossPercent; }
+    bool linkConditionsSimulated(void) const { return (_linkLatencyMSecs > 0) || (_linkLossPercent > 0); }
+    int  linkLatencyMSecs       (void) const { return _linkLatencyMSecs; }
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
@@ -223,6 +245,7 @@ private:
     void _sendHighLatency2              (void);
     void _handleIncomingNSHBytes        (const char* bytes, int cBytes);
     void _handleIncomingMavlinkBytes    (const uint8_t* bytes, int cBytes);
+    void _handleWrittenBytes            (const QByteArray& bytes);
     void _handleIncomingMavlinkMsg      (const mavlink_message_t& msg);
     void _loadParams                    (void);
     void _handleHeartBeat               (const mavlink_message_t& msg);
@@ -299,6 +322,9 @@ private:
     double                      _vehicleLongitude;
     double                      _vehicleAltitudeAMSL;
     bool                        _commLost                       = false;
+    int                         _linkLatencyMSecs               = 0;
+    double                      _linkLossPercent                = 0;
+    QRandomGenerator            _linkLossRandom                 = QRandomGenerator(1);  ///< Fixed seed keeps lossy test runs repeatable
     bool                        _highLatencyTransmissionEnabled = true;
 
     // These are just set for reporting the fields in _respondWithAutopilotVersion()
@@ -318,6 +344,8 @@ private:
 
     int _currentParamRequestListComponentIndex; // Current component index for param request list workflow, -1 for no request in progress
     int _currentParamRequestListParamIndex;     // Current parameter index for param request list workflow
+    uint32_t _paramHashCheck = 0;               // PARAM_HASH reported through _HASH_CHECK, 0 for none
+    bool _paramHashCheckAccepted = false;
 
     static const uint16_t _logDownloadLogId = 0;        ///< Id of siumulated log file
     static const uint32_t _logDownloadFileSize = 1000;  ///< Size of simulated log file
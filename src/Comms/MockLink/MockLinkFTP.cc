@@ -10,6 +10,7 @@
 
 #include "MockLinkFTP.h"
 #include "MockLink.h"
+#include "QGC.h"
 #include "QGCTemporaryFile.h"
 
 MockLinkFTP::MockLinkFTP(uint8_t systemIdServer, uint8_t componentIdServer, MockLink* mockLink)
@@ -102,30 +103,38 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     Q_UNUSED(cchPath); // Fix initialized-but-not-referenced warning on release builds
     path = (char *)request->data;
 
-    _currentFile.close();
+    // Each open gets its own session, as long as there is one free
+    uint8_t sessionId   = 0;
+    int     openCount   = 0;
+    for (uint8_t i=1; i<=_maxSessions; i++) {
+        if (_sessionFile(i)->isOpen()) {
+            openCount++;
+            if (_rgSessionPaths[i - 1] == path) {
+                // Another session already has this file open, read from the same copy
+                tmpFilename = _sessionFile(i)->fileName();
+            }
+        } else if (sessionId == 0) {
+            sessionId = i;
+        }
+    }
+    if (sessionId == 0 || openCount >= _sessionLimit) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrNoSessionsAvailable, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        return;
+    }
 
-    QString sizePrefix = sizeFilenamePrefix;
-    if (path.startsWith(sizePrefix)) {
-        QString sizeString = path.right(path.length() - sizePrefix.length());
-        tmpFilename = _createTestTempFile(sizeString.toInt());
-    } else if (path == "/general.json") {
-        tmpFilename = ":MockLink/General.MetaData.json";
-    } else if (path == "/general.json.xz") {
-        tmpFilename = ":MockLink/General.MetaData.json.xz";
-    } else if (path == "/parameter.json") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json";
-    } else if (path == "/parameter.json.xz") {
-        tmpFilename = ":MockLink/Parameter.MetaData.json.xz";
-    } else if (_BinParamFileEnabled && path == "@PARAM/param.pck") {
-        tmpFilename = ":MockLink/Arduplane.params.ftp.bin";
+    if (tmpFilename.isEmpty()) {
+        tmpFilename = _filenameForPath(path);
     }
 
+    QFile* file = _sessionFile(sessionId);
     if (!tmpFilename.isEmpty()) {
-        _currentFile.setFileName(tmpFilename);
-        if (!_currentFile.open(QIODevice::ReadOnly)) {
-            _sendNakErrno(senderSystemId, senderComponentId, _currentFile.error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        file->setFileName(tmpFilename);
+        _rgSessionPaths[sessionId - 1] = path;
+        if (!file->open(QIODevice::ReadOnly)) {
+            _sendNakErrno(senderSystemId, senderComponentId, file->error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
             return;
         }
+        _maxSessionsOpen = qMax(_maxSessionsOpen, openCount + 1);
     } else {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
         return;
@@ -133,12 +142,12 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     
     response.hdr.opcode     = MavlinkFTP::kRspAck;
     response.hdr.req_opcode = MavlinkFTP::kCmdOpenFileRO;
-    response.hdr.session    = _sessionId;
+    response.hdr.session    = sessionId;
     
     // Data contains file length
     response.hdr.size = sizeof(uint32_t);
     /* Ardupilot sends constant wrong file size for parameter file due to dynamic on the fly generation */
-    response.openFileLength = (path == "@PARAM/param.pck" ? 1024*1024 : _currentFile.size());
+    response.openFileLength = (path == "@PARAM/param.pck" ? 1024*1024 : file->size());
     
     _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
 }
@@ -147,8 +156,9 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
 {
     MavlinkFTP::Request	response{};
     uint16_t			outgoingSeqNumber = _nextSeqNumber(seqNumber);
+    QFile*              file = _sessionFile(request->hdr.session);
 
-    if (request->hdr.session != _sessionId) {
+    if (!file || !file->isOpen()) {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
         return;
     }
@@ -167,20 +177,20 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
         }
     }
     
-    if (readOffset >= _currentFile.size()) {
+    if (readOffset >= file->size()) {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
         return;
     }
     
-    uint8_t cBytesToRead = (uint8_t)qMin((qint64)sizeof(response.data), _currentFile.size() - readOffset);
-    _currentFile.seek(readOffset);
-    QByteArray bytes = _currentFile.read(cBytesToRead);
+    uint8_t cBytesToRead = (uint8_t)qMin((qint64)sizeof(response.data), file->size() - readOffset);
+    file->seek(readOffset);
+    QByteArray bytes = file->read(cBytesToRead);
     memcpy(response.data, bytes.constData(), cBytesToRead);
     
     // We should always have written something, otherwise there is something wrong with the code above
     Q_ASSERT(cBytesToRead);
     
-    response.hdr.session    = _sessionId;
+    response.hdr.session    = request->hdr.session;
     response.hdr.size       = cBytesToRead;
     response.hdr.offset     = request->hdr.offset;
     response.hdr.opcode     = MavlinkFTP::kRspAck;
@@ -193,8 +203,9 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
 {
     uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
     MavlinkFTP::Request response{};
+    QFile*              file = _sessionFile(request->hdr.session);
 
-    if (request->hdr.session != _sessionId) {
+    if (!file || !file->isOpen()) {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
         return;
     }
@@ -203,18 +214,18 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     int         burstCount  = 1;
     uint32_t    burstOffset = request->hdr.offset;
 
-    while (burstOffset < _currentFile.size() && burstCount++ < burstMax) {
-        _currentFile.seek(burstOffset);
+    while (burstOffset < file->size() && burstCount++ < burstMax) {
+        file->seek(burstOffset);
 
-        uint8_t     cBytes  = (uint8_t)qMin((qint64)sizeof(response.data), _currentFile.size() - burstOffset);
-        QByteArray  bytes   = _currentFile.read(cBytes);
+        uint8_t     cBytes  = (uint8_t)qMin((qint64)sizeof(response.data), file->size() - burstOffset);
+        QByteArray  bytes   = file->read(cBytes);
 
         // We should always have written something, otherwise there is something wrong with the code above
         Q_ASSERT(cBytes);
 
         memcpy(response.data, bytes.constData(), cBytes);
 
-        response.hdr.session        = _sessionId;
+        response.hdr.session        = request->hdr.session;
         response.hdr.size           = cBytes;
         response.hdr.offset         = burstOffset;
         response.hdr.opcode         = MavlinkFTP::kRspAck;
@@ -227,21 +238,80 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
         burstOffset += cBytes;
     }
 
-    if (burstOffset >= _currentFile.size()) {
+    if (burstOffset >= file->size()) {
         // Burst is fully complete
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
     }
 }
 
+/// @return Local file which backs path on the vehicle, empty if there is no such file. Size based paths get a newly
+/// created temp file.
+QString MockLinkFTP::_filenameForPath(const QString& path)
+{
+    QString sizePrefix = sizeFilenamePrefix;
+    if (path.startsWith(sizePrefix)) {
+        QString sizeString = path.right(path.length() - sizePrefix.length());
+        return _createTestTempFile(sizeString.toInt());
+    } else if (path == "/general.json") {
+        return ":MockLink/General.MetaData.json";
+    } else if (path == "/general.json.xz") {
+        return ":MockLink/General.MetaData.json.xz";
+    } else if (path == "/parameter.json") {
+        return ":MockLink/Parameter.MetaData.json";
+    } else if (path == "/parameter.json.xz") {
+        return ":MockLink/Parameter.MetaData.json.xz";
+    } else if (_BinParamFileEnabled && path == "@PARAM/param.pck") {
+        return ":MockLink/Arduplane.params.ftp.bin";
+    }
+
+    return QString();
+}
+
+void MockLinkFTP::_calcFileCRC32Command(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
+{
+    MavlinkFTP::Request response{};
+    uint16_t            outgoingSeqNumber = _nextSeqNumber(seqNumber);
+
+    ensureNullTemination(request);
+    QString path = (char *)request->data;
+
+    QString filename = _filenameForPath(path);
+    if (filename.isEmpty()) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFailFileNotFound, outgoingSeqNumber, MavlinkFTP::kCmdCalcFileCRC32);
+        return;
+    }
+
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        _sendNakErrno(senderSystemId, senderComponentId, file.error(), outgoingSeqNumber, MavlinkFTP::kCmdCalcFileCRC32);
+        return;
+    }
+    QByteArray bytes = file.readAll();
+    file.close();
+    if (path.startsWith(sizeFilenamePrefix)) {
+        file.remove();
+    }
+
+    response.hdr.opcode     = MavlinkFTP::kRspAck;
+    response.hdr.req_opcode = MavlinkFTP::kCmdCalcFileCRC32;
+    response.hdr.session    = 0;
+    response.hdr.size       = sizeof(uint32_t);
+    response.openFileLength = QGC::crc32((const quint8*)bytes.constData(), bytes.size(), 0);
+
+    _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
+}
+
 void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber)
 {
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
+    QFile* file = _sessionFile(request->hdr.session);
+    if (!file || !file->isOpen()) {
         _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
         return;
     }
     
+    _closeSession(request->hdr.session);
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
 
     emit terminateCommandReceived();
@@ -251,8 +321,10 @@ void MockLinkFTP::_resetCommand(uint8_t senderSystemId, uint8_t senderComponentI
 {
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
     
-    _currentFile.close();
-    _currentFile.remove();
+    for (uint8_t i=1; i<=_maxSessions; i++) {
+        _closeSession(i);
+    }
+    _maxSessionsOpen = 0;
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdResetSessions);
     
     emit resetCommandReceived();
@@ -293,6 +365,7 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
 
     uint16_t incomingSeqNumber = request->hdr.seqNumber;
     uint16_t outgoingSeqNumber = _nextSeqNumber(incomingSeqNumber);
+    _requestSessionId = request->hdr.session;
     
     if (request->hdr.opcode != MavlinkFTP::kCmdResetSessions && request->hdr.opcode != MavlinkFTP::kCmdTerminateSession) {
         if (_errMode == errModeNoResponse) {
@@ -330,6 +403,10 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t& message)
         _burstReadCommand(message.sysid, message.compid, request, incomingSeqNumber);
         break;
 
+    case MavlinkFTP::kCmdCalcFileCRC32:
+        _calcFileCRC32Command(message.sysid, message.compid, request, incomingSeqNumber);
+        break;
+
     case MavlinkFTP::kCmdTerminateSession:
         _terminateCommand(message.sysid, message.compid, request, incomingSeqNumber);
         break;
@@ -352,7 +429,7 @@ void MockLinkFTP::_sendAck(uint8_t targetSystemId, uint8_t targetComponentId, ui
     
     ackResponse.hdr.opcode      = MavlinkFTP::kRspAck;
     ackResponse.hdr.req_opcode  = reqOpcode;
-    ackResponse.hdr.session     = _sessionId;
+    ackResponse.hdr.session     = _requestSessionId;
     ackResponse.hdr.size        = 0;
     
     _sendResponse(targetSystemId, targetComponentId, &ackResponse, seqNumber);
@@ -364,7 +441,7 @@ void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, Ma
 
     nakResponse.hdr.opcode      = MavlinkFTP::kRspNak;
     nakResponse.hdr.req_opcode  = reqOpcode;
-    nakResponse.hdr.session     = _sessionId;
+    nakResponse.hdr.session     = _requestSessionId;
     nakResponse.hdr.size        = 1;
     nakResponse.data[0]         = error;
     
@@ -377,7 +454,7 @@ void MockLinkFTP::_sendNakErrno(uint8_t targetSystemId, uint8_t targetComponentI
 
     nakResponse.hdr.opcode      = MavlinkFTP::kRspNak;
     nakResponse.hdr.req_opcode  = reqOpcode;
-    nakResponse.hdr.session     = _sessionId;
+    nakResponse.hdr.session     = _requestSessionId;
     nakResponse.hdr.size        = 2;
     nakResponse.data[0]         = MavlinkFTP::kErrFailErrno;
     nakResponse.data[1]         = nakErrno;
@@ -434,3 +511,30 @@ QString MockLinkFTP::_createTestTempFile(int size)
     tmpFile.close();
     return tmpFile.fileName();
 }
+
+QFile* MockLinkFTP::_sessionFile(uint8_t sessionId)
+{
+    if (sessionId < 1 || sessionId > _maxSessions) {
+        return nullptr;
+    }
+
+    return &_rgSessionFiles[sessionId - 1];
+}
+
+void MockLinkFTP::_closeSession(uint8_t sessionId)
+{
+    QFile* file = _sessionFile(sessionId);
+    if (!file || !file->isOpen()) {
+        return;
+    }
+
+    file->close();
+
+    // Only remove the file once no other session is reading it
+    for (uint8_t i=1; i<=_maxSessions; i++) {
+        if (_sessionFile(i)->isOpen() && _sessionFile(i)->fileName() == file->fileName()) {
+            return;
+        }
+    }
+    file->remove();
+}
@@ -63,6 +63,13 @@ public:
     void enableRandromDrops(bool enable) { _randomDropsEnabled = enable; }
     void enableBinParamFile(bool enable) { _BinParamFileEnabled = enable; }
 
+    /// @brief Sets how many sessions can be open at once. Vehicles which only support a single session Nak any other
+    /// open with kErrNoSessionsAvailable.
+    void setSessionLimit(int sessionLimit) { _sessionLimit = qBound(1, sessionLimit, static_cast<int>(_maxSessions)); }
+
+    /// @return The most sessions which were open at the same time since the last Reset command
+    int maxSessionsOpen(void) const { return _maxSessionsOpen; }
+
     static constexpr const char* sizeFilenamePrefix = "mocklink-size-";
 
 signals:
@@ -81,17 +88,26 @@ private:
     void        _openCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _readCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _burstReadCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _calcFileCRC32Command   (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _terminateCommand       (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _resetCommand           (uint8_t senderSystemId, uint8_t senderComponentId, uint16_t seqNumber);
     uint16_t    _nextSeqNumber          (uint16_t seqNumber);
     QString     _createTestTempFile     (int size);
+    QString     _filenameForPath        (const QString& path);
+    QFile*      _sessionFile            (uint8_t sessionId);
+    void        _closeSession           (uint8_t sessionId);
     
     /// if request is a string, this ensures it's null-terminated
     static void ensureNullTemination(MavlinkFTP::Request* request);
 
     QStringList _fileList;  ///< List of files returned by List command
     
-    QFile                   _currentFile;
+    static const uint8_t    _maxSessions        = 3;
+    QFile                   _rgSessionFiles[_maxSessions];      ///< Open file for each session, session ids start at 1
+    QString                 _rgSessionPaths[_maxSessions];      ///< Path on the vehicle each session opened
+    int                     _sessionLimit       = _maxSessions;
+    int                     _maxSessionsOpen    = 0;
+    uint8_t                 _requestSessionId   = 0;            ///< Session of the request being handled, used in Ack/Nak responses
     ErrorMode_t             _errMode            = errModeNone;  ///< Currently set error mode, as specified by setErrorMode
     const uint8_t           _systemIdServer;                    ///< System ID for server
     const uint8_t           _componentIdServer;                 ///< Component ID for server
@@ -101,7 +117,5 @@ private:
     mavlink_message_t       _lastReply;
     bool                    _randomDropsEnabled = false;
     bool                    _BinParamFileEnabled = false;
-
-    static const uint8_t    _sessionId          = 1;    ///< We only support a single fixed session
 };
 
@@ -15,6 +15,8 @@
 
 #include <QtCore/QDebug>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(MockLinkMissionItemHandlerLog, "MockLinkMissionItemHandlerLog")
 
 MockLinkMissionItemHandler::MockLinkMissionItemHandler(MockLink* mockLink, MAVLinkProtocol* mavlinkProtocol)
@@ -41,7 +43,12 @@ void MockLinkMissionItemHandler::_startMissionItemResponseTimer(void)
         _missionItemResponseTimer = new QTimer();
         connect(_missionItemResponseTimer, &QTimer::timeout, this, &MockLinkMissionItemHandler::_missionItemResponseTimeout);
     }
-    _missionItemResponseTimer->start(500);
+    _missionItemResponseTimer->start(500 + (2 * _mockLink->linkLatencyMSecs()));
+}
+
+bool MockLinkMissionItemHandler::_windowedWrite(void) const
+{
+    return (_writeRequestWindow > 1) || _mockLink->linkConditionsSimulated();
 }
 
 bool MockLinkMissionItemHandler::handleMessage(const mavlink_message_t& msg)
@@ -121,6 +128,7 @@ void MockLinkMissionItemHandler::_handleMissionRequestList(const mavlink_message
     qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequestList read sequence";
     
     _failReadRequest1FirstResponse = true;
+    _readRequestCount = 0;
 
     if (_failureMode == FailReadRequestListNoResponse) {
         qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequestList not responding due to failure mode FailReadRequestListNoResponse";
@@ -182,6 +190,8 @@ void MockLinkMissionItemHandler::_handleMissionRequest(const mavlink_message_t&
     
     Q_ASSERT(request.target_system == _mockLink->vehicleId());
 
+    _readRequestCount++;
+
     if (_failureMode == FailReadRequest0NoResponse && request.seq == 0) {
         qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionRequest not responding due to failure mode FailReadRequest0NoResponse";
     } else if (_failureMode == FailReadRequest1NoResponse && request.seq == 1) {
@@ -285,7 +295,12 @@ void MockLinkMissionItemHandler::_handleMissionCount(const mavlink_message_t& ms
         }
         _failWriteMissionCountFirstResponse = true;
         _writeSequenceIndex = 0;
-        _requestNextMissionItem(_writeSequenceIndex);
+        if (_windowedWrite()) {
+            _writeOutstanding.clear();
+            _requestWriteWindow();
+        } else {
+            _requestNextMissionItem(_writeSequenceIndex);
+        }
     }
 }
 
@@ -311,17 +326,7 @@ void MockLinkMissionItemHandler::_requestNextMissionItem(int sequenceNumber)
             qCDebug(MockLinkMissionItemHandlerLog) << "_requestNextMissionItem sending ack error due to failure mode";
             _sendAck(_failureAckResult);
         } else {
-            mavlink_message_t message;
-
-            mavlink_msg_mission_request_int_pack_chan(_mockLink->vehicleId(),
-                                                      MAV_COMP_ID_AUTOPILOT1,
-                                                      _mockLink->mavlinkChannel(),
-                                                      &message,
-                                                      _mavlinkProtocol->getSystemId(),
-                                                      _mavlinkProtocol->getComponentId(),
-                                                      sequenceNumber,
-                                                      _requestType);
-            _mockLink->respondWithMavlinkMessage(message);
+            _sendMissionRequest(sequenceNumber);
 
             // If response with Mission Item doesn't come before timer fires it's an error
             _startMissionItemResponseTimer();
@@ -329,6 +334,33 @@ void MockLinkMissionItemHandler::_requestNextMissionItem(int sequenceNumber)
     }
 }
 
+/// Keeps _writeRequestWindow requests outstanding until every item has been requested
+void MockLinkMissionItemHandler::_requestWriteWindow(void)
+{
+    while ((_writeOutstanding.count() < _writeRequestWindow) && (_writeSequenceIndex < _writeSequenceCount)) {
+        _writeOutstanding.insert(_writeSequenceIndex);
+        _sendMissionRequest(_writeSequenceIndex++);
+    }
+
+    // Anything still outstanding when the timer fires is requested again
+    _startMissionItemResponseTimer();
+}
+
+void MockLinkMissionItemHandler::_sendMissionRequest(int sequenceNumber)
+{
+    mavlink_message_t message;
+
+    mavlink_msg_mission_request_int_pack_chan(_mockLink->vehicleId(),
+                                              MAV_COMP_ID_AUTOPILOT1,
+                                              _mockLink->mavlinkChannel(),
+                                              &message,
+                                              _mavlinkProtocol->getSystemId(),
+                                              _mavlinkProtocol->getComponentId(),
+                                              sequenceNumber,
+                                              _requestType);
+    _mockLink->respondWithMavlinkMessage(message);
+}
+
 void MockLinkMissionItemHandler::_sendAck(MAV_MISSION_RESULT ackType)
 {
     qCDebug(MockLinkMissionItemHandlerLog) << "_sendAck write sequence complete ackType:" << ackType;
@@ -362,7 +394,13 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
     mavlink_msg_mission_item_int_decode(&msg, &missionItemInt);
     missionType = static_cast<MAV_MISSION_TYPE>(missionItemInt.mission_type);
     seq = missionItemInt.seq;
-    
+
+    if (_windowedWrite() && !_writeOutstanding.remove(seq)) {
+        qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionItem ignoring item which was not outstanding" << seq;
+        _startMissionItemResponseTimer();
+        return;
+    }
+
     switch (missionType) {
     case MAV_MISSION_TYPE_MISSION:
         _missionItems[seq] = missionItemInt;
@@ -379,6 +417,16 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
         break;
     }
 
+    if (_windowedWrite()) {
+        if (_writeOutstanding.isEmpty() && (_writeSequenceIndex >= _writeSequenceCount)) {
+            _missionItemResponseTimer->stop();
+            _sendAck(MAV_MISSION_ACCEPTED);
+        } else {
+            _requestWriteWindow();
+        }
+        return;
+    }
+
     _writeSequenceIndex++;
     if (_writeSequenceIndex < _writeSequenceCount) {
         if (_failureMode == FailWriteFinalAckMissingRequests && _writeSequenceIndex == 3) {
@@ -401,6 +449,22 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
 
 void MockLinkMissionItemHandler::_missionItemResponseTimeout(void)
 {
+    if (_windowedWrite()) {
+        if (_writeOutstanding.isEmpty()) {
+            _missionItemResponseTimer->stop();
+            return;
+        }
+
+        // Like a real vehicle, ask again for the items which never showed up
+        QList<int> sequenceNumbers = _writeOutstanding.values();
+        std::sort(sequenceNumbers.begin(), sequenceNumbers.end());
+        qCDebug(MockLinkMissionItemHandlerLog) << "_missionItemResponseTimeout requesting again" << sequenceNumbers;
+        for (const int sequenceNumber : sequenceNumbers) {
+            _sendMissionRequest(sequenceNumber);
+        }
+        return;
+    }
+
     qWarning() << "Timeout waiting for next MISSION_ITEM_INT";
     Q_ASSERT(false);
 }
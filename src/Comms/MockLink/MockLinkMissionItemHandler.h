@@ -14,6 +14,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QMap>
+#include <QtCore/QSet>
 #include <QtCore/QTimer>
 #include <QtCore/QLoggingCategory>
 
@@ -80,6 +81,14 @@ public:
 
     void setSendHomePositionOnEmptyList(bool sendHomePositionOnEmptyList) { _sendHomePositionOnEmptyList = sendHomePositionOnEmptyList; }
 
+    /// Number of MISSION_REQUEST_INT kept outstanding during a write. Windowed writes, and all writes over a
+    /// simulated slow or lossy link, track items by sequence number and ask again for any which don't arrive.
+    /// The write failure modes are not supported by windowed writes.
+    void setWriteRequestWindow(int window) { _writeRequestWindow = qMax(1, window); }
+
+    /// Number of MISSION_REQUEST_INT received since the last MISSION_REQUEST_LIST
+    int readRequestCount(void) const { return _readRequestCount; }
+
 private slots:
     void _missionItemResponseTimeout(void);
 
@@ -90,6 +99,9 @@ private:
     void _handleMissionCount            (const mavlink_message_t& msg);
     void _handleMissionClearAll         (const mavlink_message_t& msg);
     void _requestNextMissionItem        (int sequenceNumber);
+    void _requestWriteWindow            (void);
+    void _sendMissionRequest            (int sequenceNumber);
+    bool _windowedWrite                 (void) const;
     void _sendAck                       (MAV_MISSION_RESULT ackType);
     void _startMissionItemResponseTimer (void);
 
@@ -98,6 +110,9 @@ private:
     
     int _writeSequenceCount;    ///< Numbers of items about to be written
     int _writeSequenceIndex;    ///< Current index being reqested
+    int _writeRequestWindow = 1;
+    QSet<int> _writeOutstanding;///< Requested items which have not arrived yet, windowed writes only
+    int _readRequestCount = 0;
 
     typedef QMap<uint16_t, mavlink_mission_item_int_t> MissionItemList_t;
 
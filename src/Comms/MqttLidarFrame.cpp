@@ -0,0 +1,121 @@
+#include "MqttLidarFrame.h"
+
+#include <QtCore/QtEndian>
+#include <QDebug>
+#include <cstring>
+
+/********************** MqttLidarFrameHeader **********************/
+bool MqttLidarFrameHeader::parse(const char *data, qsizetype size, MqttLidarFrameHeader &header){
+    if(size < kSize || std::memcmp(data, kMagic, sizeof(kMagic)) != 0){
+        return false;
+    }
+    const uchar *bytes = reinterpret_cast<const uchar*>(data);
+    if(bytes[4] != kVersion){
+        return false;
+    }
+    header.format = static_cast<MqttLidarFrameFormat>(bytes[5]);
+    header.timestampUs = qFromLittleEndian<quint64>(bytes + 8);
+    header.sequence = qFromLittleEndian<quint32>(bytes + 16);
+    header.width = qFromLittleEndian<quint16>(bytes + 20);
+    header.height = qFromLittleEndian<quint16>(bytes + 22);
+    header.payloadLength = qFromLittleEndian<quint32>(bytes + 24);
+    return true;
+}
+
+/********************** MqttLidarFrameBuffer **********************/
+QImage::Format MqttLidarFrameBuffer::_imageFormat(MqttLidarFrameFormat format){
+    switch(format){
+    case MqttLidarFrameFormat::Gray8:
+        return QImage::Format_Grayscale8;
+    case MqttLidarFrameFormat::RGB888:
+        return QImage::Format_RGB888;
+    case MqttLidarFrameFormat::RGBA8888:
+        return QImage::Format_RGBA8888;
+    default:
+        return QImage::Format_Invalid;
+    }
+}
+
+bool MqttLidarFrameBuffer::decode(const char *data, qsizetype size){
+    MqttLidarFrameHeader header;
+    if(!MqttLidarFrameHeader::parse(data, size, header)){
+        qWarning() << "[MqttLidarFrame]Invalid frame header, size:" << size;
+        return false;
+    }
+    if(size - MqttLidarFrameHeader::kSize < static_cast<qsizetype>(header.payloadLength)){
+        qWarning() << "[MqttLidarFrame]Truncated frame" << header.sequence;
+        return false;
+    }
+    const char *payload = data + MqttLidarFrameHeader::kSize;
+
+    switch(header.format){
+    case MqttLidarFrameFormat::Jpeg:
+    case MqttLidarFrameFormat::Png:
+        if(!mBackImage.loadFromData(reinterpret_cast<const uchar*>(payload), header.payloadLength,
+                                     header.format == MqttLidarFrameFormat::Jpeg ? "JPG" : "PNG")){
+            qWarning() << "[MqttLidarFrame]Failed to decode compressed frame" << header.sequence;
+            return false;
+        }
+        break;
+    case MqttLidarFrameFormat::Gray8:
+    case MqttLidarFrameFormat::RGB888:
+    case MqttLidarFrameFormat::RGBA8888:
+    {
+        const QImage::Format imageFormat = _imageFormat(header.format);
+        const int bytesPerPixel = QImage::toPixelFormat(imageFormat).bitsPerPixel() / 8;
+        const qsizetype rowBytes = static_cast<qsizetype>(header.width) * bytesPerPixel;
+        if(header.width == 0 || header.height == 0 || header.payloadLength != rowBytes * header.height){
+            qWarning() << "[MqttLidarFrame]Raw frame size mismatch" << header.sequence;
+            return false;
+        }
+        // Reuse the back buffer unless QML still holds a reference to it or the geometry changed
+        if(mBackImage.width() != header.width || mBackImage.height() != header.height
+            || mBackImage.format() != imageFormat || !mBackImage.isDetached()){
+            mBackImage = QImage(header.width, header.height, imageFormat);
+        }
+        for(int row = 0; row < header.height; row++){
+            std::memcpy(mBackImage.scanLine(row), payload + row * rowBytes, rowBytes);
+        }
+        break;
+    }
+    default:
+        qWarning() << "[MqttLidarFrame]Unsupported frame format" << static_cast<int>(header.format);
+        return false;
+    }
+
+    QMutexLocker locker(&mMutex);
+    mFrontImage.swap(mBackImage);
+    mSequence = header.sequence;
+    mTimestampUs = header.timestampUs;
+    return true;
+}
+
+QImage MqttLidarFrameBuffer::image() const{
+    QMutexLocker locker(&mMutex);
+    return mFrontImage;
+}
+
+quint32 MqttLidarFrameBuffer::sequence() const{
+    QMutexLocker locker(&mMutex);
+    return mSequence;
+}
+
+quint64 MqttLidarFrameBuffer::timestampUs() const{
+    QMutexLocker locker(&mMutex);
+    return mTimestampUs;
+}
+
+/********************** MqttLidarImageProvider **********************/
+MqttLidarImageProvider::MqttLidarImageProvider(std::shared_ptr<MqttLidarFrameBuffer> frameBuffer)
+    : QQuickImageProvider(QQmlImageProviderBase::Image), mFrameBuffer(frameBuffer){}
+
+QImage MqttLidarImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize){
+    Q_UNUSED(id);
+    Q_UNUSED(requestedSize);
+
+    const QImage image = mFrameBuffer->image();
+    if(size){
+        *size = image.size();
+    }
+    return image;
+}
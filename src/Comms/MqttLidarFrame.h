@@ -0,0 +1,88 @@
+#ifndef MQTTLIDARFRAME_H
+#define MQTTLIDARFRAME_H
+
+#include <QImage>
+#include <QMutex>
+#include <QtQuick/QQuickImageProvider>
+#include <memory>
+
+/*
+ * Binary lidar frame published on <subTopic>/LIDAR.
+ *
+ * All fields are little-endian and the header is immediately followed by
+ * payloadLength bytes of image data:
+ *
+ *   offset size field
+ *   0      4    magic            'L' 'D' 'R' '1'
+ *   4      1    version          kVersion
+ *   5      1    format           MqttLidarFrameFormat
+ *   6      2    reserved
+ *   8      8    timestampUs      vehicle time, microseconds
+ *   16     4    sequence
+ *   20     2    width            pixels
+ *   22     2    height           pixels
+ *   24     4    payloadLength    bytes following the header
+ *
+ * Raw formats are tightly packed rows (width * bytesPerPixel). Compressed
+ * formats carry a complete JPEG/PNG stream and width/height are advisory.
+ */
+enum class MqttLidarFrameFormat : quint8 {
+    Gray8       = 0,
+    RGB888      = 1,
+    RGBA8888    = 2,
+    Jpeg        = 3,
+    Png         = 4,
+};
+
+struct MqttLidarFrameHeader {
+    static constexpr char       kMagic[4]   = {'L', 'D', 'R', '1'};
+    static constexpr quint8     kVersion    = 1;
+    static constexpr int        kSize       = 28;
+
+    MqttLidarFrameFormat format{MqttLidarFrameFormat::Gray8};
+    quint64 timestampUs{0};
+    quint32 sequence{0};
+    quint16 width{0};
+    quint16 height{0};
+    quint32 payloadLength{0};
+
+    /// Parses the fixed header from data. Returns false if the buffer is too short or not a lidar frame.
+    static bool parse(const char *data, qsizetype size, MqttLidarFrameHeader &header);
+};
+
+/// Latest decoded lidar frame. Written from the MQTT callback thread, read by the QML image provider.
+class MqttLidarFrameBuffer
+{
+public:
+    /// Decodes one frame into the back buffer and swaps it in. Returns false if the frame was rejected.
+    bool decode(const char *data, qsizetype size);
+
+    QImage image() const;
+    quint32 sequence() const;
+    quint64 timestampUs() const;
+
+private:
+    static QImage::Format _imageFormat(MqttLidarFrameFormat format);
+
+    mutable QMutex mMutex;
+    QImage mFrontImage;
+    QImage mBackImage;
+    quint32 mSequence{0};
+    quint64 mTimestampUs{0};
+};
+
+/// Exposes MqttLidarFrameBuffer to QML as image://MqttLidar/<sequence>
+class MqttLidarImageProvider : public QQuickImageProvider
+{
+public:
+    static constexpr const char *kProviderId = "MqttLidar";
+
+    explicit MqttLidarImageProvider(std::shared_ptr<MqttLidarFrameBuffer> frameBuffer);
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) final;
+
+private:
+    std::shared_ptr<MqttLidarFrameBuffer> mFrameBuffer;
+};
+
+#endif // MQTTLIDARFRAME_H
@@ -14,8 +14,16 @@ void ActionListener::on_success(const mqtt::token &tok){
 /********************** MqttLinkCallback **********************/
 MqttLinkCallback::MqttLinkCallback() : mSubActionListener("MQTT Link Subscription"){}
 
-MqttLinkCallback::MqttLinkCallback(const std::string &subTopic, mqtt::async_client_ptr cli, mqtt::connect_options connOpts)
-    : mSubTopic(subTopic), mMqttClientPtr(cli), mConnectOptions(connOpts), mSubActionListener("MQTT Link Subscription"){}
+MqttLinkCallback::MqttLinkCallback(mqtt::async_client_ptr cli, mqtt::connect_options connOpts)
+    : mMqttClientPtr(cli), mConnectOptions(connOpts), mSubActionListener("MQTT Link Subscription"){}
+
+void MqttLinkCallback::registerTopicHandler(const std::string &topic, MqttTopicHandler handler){
+    mTopicHandlers[topic] = std::move(handler);
+}
+
+void MqttLinkCallback::setConnectedHandler(std::function<void()> handler){
+    mConnectedHandler = std::move(handler);
+}
 
 void MqttLinkCallback::reconnect(){
     std::this_thread::sleep_for(std::chrono::milliseconds(2500));
@@ -38,11 +46,15 @@ void MqttLinkCallback::on_success(const mqtt::token &tok){}
 
 void MqttLinkCallback::connected(const std::string &cause){
     qInfo() << "[MqttLink]Connected.";
-    auto subTopics  = mqtt::string_collection::create({mSubTopic+"/LIDAR", mSubTopic});
-    const std::vector<int> qos{1, 1};
+    auto subTopics = std::make_shared<mqtt::string_collection>();
+    for(const auto &topicHandler : mTopicHandlers){
+        subTopics->push_back(topicHandler.first);
+    }
+    const std::vector<int> qos(subTopics->size(), 1);
     mMqttClientPtr->subscribe(subTopics, qos, nullptr, mSubActionListener);
-
-    // mMqttClientPtr->subscribe(mSubTopic, 1, nullptr, mSubActionListener);
+    if(mConnectedHandler){
+        mConnectedHandler();
+    }
 }
 
 void MqttLinkCallback::connection_lost(const std::string &cause){
@@ -57,44 +69,64 @@ void MqttLinkCallback::connection_lost(const std::string &cause){
 }
 
 void MqttLinkCallback::message_arrived(mqtt::const_message_ptr msg){
-    emit messageArrived(msg->to_string());
+    const auto topicHandler = mTopicHandlers.find(msg->get_topic());
+    if(topicHandler == mTopicHandlers.end()){
+        return;
+    }
+    const MqttPayload &payload = msg->get_payload_ref().ptr();
+    if(payload){
+        topicHandler->second(payload);
+    }
 }
 
 void MqttLinkCallback::delivery_complete(mqtt::delivery_token_ptr token){}
 
 /********************** MqttLink **********************/
-MqttLink::MqttLink(const QString &serverAddr, const QString &subTopic)
-    : mServerAddr(serverAddr), mSubTopic(subTopic)
+MqttLink::MqttLink(const QString &serverAddr, const QString &subTopic, std::shared_ptr<MqttLidarFrameBuffer> lidarFrameBuffer,
+                   int publishQueueDepth)
+    : mServerAddr(serverAddr), mSubTopic(subTopic), mLidarFrameBuffer(lidarFrameBuffer)
 {
     mConnectOptions = mqtt::connect_options_builder()
     .clean_session(true)
         .finalize();
     mAsyncMqttClientPtr = std::make_shared<mqtt::async_client>(serverAddr.toStdString(), mClientId.toStdString());
-    mMqttLinkCallback = new MqttLinkCallback(subTopic.toStdString(), mAsyncMqttClientPtr, mConnectOptions);
-    connect(mMqttLinkCallback, &MqttLinkCallback::messageArrived, this, &MqttLink::subscribedMessage);
+    mMqttLinkCallback = std::make_unique<MqttLinkCallback>(mAsyncMqttClientPtr, mConnectOptions);
+    mPublishQueue = std::make_unique<MqttPublishQueue>(mAsyncMqttClientPtr, publishQueueDepth);
+
+    // Flush anything queued while the broker was unreachable
+    mMqttLinkCallback->setConnectedHandler([this](){
+        mPublishQueue->drain();
+    });
+
+    // Vehicle telemetry, parsed into a typed struct on the callback thread
+    mMqttLinkCallback->registerTopicHandler(subTopic.toStdString(), [this](const MqttPayload &payload){
+        if(MqttVehicleTelemetry::fromJson(payload->data(), static_cast<qsizetype>(payload->size()), mTelemetry)){
+            emit notifyTelemetry(mTelemetry);
+        }
+    });
+
+    // Binary lidar frames, decoded straight from the paho payload
+    mMqttLinkCallback->registerTopicHandler(subTopic.toStdString() + "/LIDAR", [this](const MqttPayload &payload){
+        if(mLidarFrameBuffer->decode(payload->data(), static_cast<qsizetype>(payload->size()))){
+            emit notifyLidarFrame(mLidarFrameBuffer->sequence());
+        }
+    });
 }
 
-void MqttLink::subscribedMessage(const std::string &payload){
-    qDebug() << "======>Data received from mqtt: " << payload;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(QString::fromStdString(payload).toUtf8());
-    QVariantMap msg = jsonDoc.toVariant().toMap();
-    emit notifyMessage(msg);
+bool MqttLink::publishedMessage(const QString &pubTopic, const QByteArray &message, MqttPublishQueue::Clock::time_point origin){
+    return mPublishQueue->enqueue(pubTopic.toStdString(), mqtt::binary(message.constData(), message.size()), origin);
 }
 
-void MqttLink::publishedMessage(const QString &pubTopic, const QString &message){
-    try{
-        if(!mAsyncMqttClientPtr->is_connected()){
-            qWarning() << "[MqttLink]Waiting for Connecting.";
-            return;
-        }
-        std::string topic = pubTopic.toStdString();
-        std::string data = message.toStdString();
+void MqttLink::setTopicOptions(const QString &pubTopic, int qos, MqttPublishQueue::Mode mode){
+    mPublishQueue->setTopicOptions(pubTopic.toStdString(), qos, mode);
+}
 
-        mqtt::message_ptr pubmsg = mqtt::make_message(topic, data, 1, false);
-        mAsyncMqttClientPtr->publish(pubmsg)->wait();
-    } catch (const std::exception& ex) {
-        qCritical() << "[MqttLink]Publish Message Error: " << ex.what();
-    }
+MqttPublishQueue::Stats MqttLink::publishStats() const{
+    return mPublishQueue->stats();
+}
+
+double MqttLink::topicLatencyMs(const QString &pubTopic) const{
+    return mPublishQueue->topicLatencyMs(pubTopic.toStdString());
 }
 
 void MqttLink::start(){
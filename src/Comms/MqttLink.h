@@ -9,6 +9,16 @@
 #include <QThread>
 #include <QtCore/QLoggingCategory>
 #include <mqtt/async_client.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include "MqttLidarFrame.h"
+#include "MqttPublishQueue.h"
+#include "MqttTelemetry.h"
+
+/// Payload shared with the paho message, handed to topic handlers without copying
+using MqttPayload = std::shared_ptr<const std::string>;
+using MqttTopicHandler = std::function<void(const MqttPayload &payload)>;
 
 class ActionListener : public virtual mqtt::iaction_listener{
 
@@ -27,15 +37,17 @@ class MqttLinkCallback : public QObject, public virtual mqtt::callback, public v
 private:
     int mRetryNum{0};
     int mMaxRetryNum{10};
-    std::string mSubTopic{""};
+    std::unordered_map<std::string, MqttTopicHandler> mTopicHandlers;
+    std::function<void()> mConnectedHandler;
     mqtt::async_client_ptr mMqttClientPtr{nullptr};
     mqtt::connect_options mConnectOptions;
     ActionListener mSubActionListener;
-signals:
-    void messageArrived(const std::string &payload);
 public:
     MqttLinkCallback();
-    MqttLinkCallback(const std::string &subTopic, mqtt::async_client_ptr cli, mqtt::connect_options connOpts);
+    MqttLinkCallback(mqtt::async_client_ptr cli, mqtt::connect_options connOpts);
+    /// Handlers run on the MQTT callback thread and must be registered before connecting.
+    void registerTopicHandler(const std::string &topic, MqttTopicHandler handler);
+    void setConnectedHandler(std::function<void()> handler);
     void reconnect();
     void on_failure(const mqtt::token& tok) override;
     void on_success(const mqtt::token& tok) override;
@@ -50,22 +62,33 @@ class MqttLink : public QObject
     Q_OBJECT
 
 public:
-    MqttLink(const QString &serverAddr, const QString &subTopic);
-     void publishedMessage(const QString &pubTopic, const QString &message);
+    MqttLink(const QString &serverAddr, const QString &subTopic, std::shared_ptr<MqttLidarFrameBuffer> lidarFrameBuffer,
+             int publishQueueDepth);
+    /// Queues a message for asynchronous publishing. Safe to call from any thread, never blocks.
+    ///     @return false: the publish queue was full, see MqttPublishQueue::enqueue
+    bool publishedMessage(const QString &pubTopic, const QByteArray &message,
+                          MqttPublishQueue::Clock::time_point origin = MqttPublishQueue::Clock::now());
+    void setTopicOptions(const QString &pubTopic, int qos, MqttPublishQueue::Mode mode);
+    MqttPublishQueue::Stats publishStats() const;
+    double topicLatencyMs(const QString &pubTopic) const;
 
 public slots:
     void start();
-    void subscribedMessage(const std::string &payload);
 
 signals:
-    void notifyMessage(const QVariantMap newSetting);
+    // Emitted from the MQTT callback thread
+    void notifyTelemetry(const MqttVehicleTelemetry &telemetry);
+    void notifyLidarFrame(quint32 sequence);
 
 private:
     bool mStartup{true};
     QString mServerAddr{};
     QString mSubTopic{""};
     QString mClientId{"qgc-mqtt-client-id"};
-    MqttLinkCallback *mMqttLinkCallback = nullptr;
+    std::unique_ptr<MqttLinkCallback> mMqttLinkCallback;
+    std::unique_ptr<MqttPublishQueue> mPublishQueue;
+    std::shared_ptr<MqttLidarFrameBuffer> mLidarFrameBuffer;
+    MqttVehicleTelemetry mTelemetry;
     mqtt::connect_options mConnectOptions;
     mqtt::async_client_ptr mAsyncMqttClientPtr = nullptr;
 };
@@ -3,7 +3,11 @@
 
 MqttManager::MqttManager(QGCApplication *app, QGCToolbox *toolbox) : QGCTool(app, toolbox){
     loadConfig();
-    mMqttLink = new MqttLink(mMqttServerAddr, mMqttSubTopic);
+    mLidarFrameBuffer = std::make_shared<MqttLidarFrameBuffer>();
+    mMqttLink = new MqttLink(mMqttServerAddr, mMqttSubTopic, mLidarFrameBuffer, mPublishQueueDepth);
+    // Gear changes must all arrive, stick input only needs the latest value
+    mMqttLink->setTopicOptions(mMqttPubTopic, 1, MqttPublishQueue::Mode::Queued);
+    mMqttLink->setTopicOptions(mMqttPubTopic + "/Joystick", 0, MqttPublishQueue::Mode::Coalesced);
 }
 
 MqttManager::~MqttManager(){
@@ -26,44 +30,47 @@ void MqttManager::loadConfig(){
     this->mMqttSubTopic = jsonObject.value("subTopic").toString();
     this->mMqttPubTopic = jsonObject.value("pubTopic").toString();
     this->mVideoUrl = jsonObject.value("videoUrl").toString();
+    this->mPublishQueueDepth = jsonObject.value("publishQueueDepth").toInt(mPublishQueueDepth);
 }
 
 void MqttManager::start(){
     mMqttLink->moveToThread(&mMqttLinkWorkThread);
     connect(&mMqttLinkWorkThread, &QThread::started, mMqttLink, &MqttLink::start);
     connect(&mMqttLinkWorkThread, &QThread::finished, mMqttLink, &QObject::deleteLater);
-    connect(mMqttLink, &MqttLink::notifyMessage, this, &MqttManager::handleMessage);
+    // Merged on the MQTT callback thread, the model publishes to QML at most once per frame
+    connect(mMqttLink, &MqttLink::notifyTelemetry, &mTelemetryModel, &MqttTelemetryModel::merge, Qt::DirectConnection);
+    connect(mMqttLink, &MqttLink::notifyLidarFrame, this, &MqttManager::updateLidar);
     mMqttLinkWorkThread.start();
-}
 
-void MqttManager::handleMessage(const QVariantMap message){
-    if(message.contains("Lidar")){
-        emit updateLidar(message);
-    }else{
-        emit updateMessage(message);
-    }
+    mPublishStatsTimer.setInterval(1000);
+    connect(&mPublishStatsTimer, &QTimer::timeout, this, [this](){
+        mPublishStats = mMqttLink->publishStats();
+        mJoystickLatency = mMqttLink->topicLatencyMs(mMqttPubTopic + "/Joystick");
+        emit publishStatsChanged();
+    });
+    mPublishStatsTimer.start();
 }
 
 void MqttManager::changeGear(int value){
-    QVariantMap cmd;
-    cmd.insert("Timestamp", QDateTime::currentMSecsSinceEpoch());
-    cmd.insert("Gear", value);
-
-    QJsonObject jsonObject = QJsonObject::fromVariantMap(cmd);
-    QJsonDocument jsonDocument(jsonObject);
-    QString jsonString = jsonDocument.toJson();
-    mMqttLink->publishedMessage(mMqttPubTopic, jsonString);
+    const QJsonObject cmd{
+        {"Timestamp", QDateTime::currentMSecsSinceEpoch()},
+        {"Gear", value},
+    };
+    if(!mMqttLink->publishedMessage(mMqttPubTopic, QJsonDocument(cmd).toJson(QJsonDocument::Compact))){
+        qCritical() << "[MqttManager]Gear change not sent, publish queue is full:" << value;
+    }
 }
 
-void MqttManager::sendJoystickCmd(QByteArray cmd){
-    QVariantMap data;
-    data.insert("Timestamp", QDateTime::currentMSecsSinceEpoch());
-    data.insert("Cmd", cmd);
-
-    QJsonObject jsonObject = QJsonObject::fromVariantMap(data);
-    QJsonDocument jsonDocument(jsonObject);
-    QString jsonString = jsonDocument.toJson();
-    mMqttLink->publishedMessage(mMqttPubTopic + "/Joystick", jsonString);
+void MqttManager::sendJoystickCmd(const QByteArray &cmd, qint64 inputTimeNs){
+    // Stick frames are binary, JSON strings would mangle every byte which isn't valid UTF-8
+    const QJsonObject data{
+        {"Timestamp", QDateTime::currentMSecsSinceEpoch()},
+        {"Cmd", QString::fromLatin1(cmd.toBase64())},
+        {"CmdEncoding", "base64"},
+    };
+    const MqttPublishQueue::Clock::time_point inputTime(
+        std::chrono::duration_cast<MqttPublishQueue::Clock::duration>(std::chrono::nanoseconds(inputTimeNs)));
+    mMqttLink->publishedMessage(mMqttPubTopic + "/Joystick", QJsonDocument(data).toJson(QJsonDocument::Compact), inputTime);
 }
 
 QString MqttManager::getVideoUrl(){
@@ -5,7 +5,11 @@
 #include <QThread>
 #include "QGCToolbox.h"
 #include <QDateTime>
+#include <QTimer>
+#include <memory>
 #include "MqttLink.h"
+#include "MqttLidarFrame.h"
+#include "MqttTelemetryModel.h"
 
 class SettingManager;
 class QGCApplication;
@@ -13,6 +17,11 @@ class QGCApplication;
 class MqttManager : public QGCTool
 {
     Q_OBJECT
+    Q_PROPERTY(MqttTelemetryModel* telemetry READ telemetry CONSTANT)
+    Q_PROPERTY(int      publishQueueDepth   READ publishQueueDepth  NOTIFY publishStatsChanged)
+    Q_PROPERTY(double   publishLatency      READ publishLatency     NOTIFY publishStatsChanged)
+    Q_PROPERTY(quint64  publishDropped      READ publishDropped     NOTIFY publishStatsChanged)
+    Q_PROPERTY(double   joystickLatency     READ joystickLatency    NOTIFY publishStatsChanged)
 public:
     explicit MqttManager(QGCApplication *app, QGCToolbox *toolbox);
     ~MqttManager();
@@ -20,21 +29,35 @@ public:
     Q_INVOKABLE void changeGear(int value);
     Q_INVOKABLE QString getVideoUrl();
     void loadConfig();
-    void sendJoystickCmd(QByteArray cmd);
+    /// Thread safe, called directly from the joystick reader thread. The raw frame is published base64 encoded in
+    /// the "Cmd" field of a JSON object on <pubTopic>/Joystick.
+    void sendJoystickCmd(const QByteArray &cmd, qint64 inputTimeNs);
+    std::shared_ptr<MqttLidarFrameBuffer> lidarFrameBuffer() const { return mLidarFrameBuffer; }
+    MqttTelemetryModel *telemetry() { return &mTelemetryModel; }
 
-public slots:
-    void handleMessage(const QVariantMap newSetting);
+    int publishQueueDepth() const { return mPublishStats.queueDepth; }
+    double publishLatency() const { return mPublishStats.avgLatencyMs; }
+    quint64 publishDropped() const { return mPublishStats.dropped; }
+    /// Stick input to broker ack, milliseconds
+    double joystickLatency() const { return mJoystickLatency; }
 
 signals:
-    void updateMessage(const QVariantMap newSetting);
-    void updateLidar(const QVariantMap newLidar);
+    /// A new frame is available from image://MqttLidar/<sequence>
+    void updateLidar(quint32 sequence);
+    void publishStatsChanged();
 
 private:
     QThread mMqttLinkWorkThread;
     MqttLink *mMqttLink = nullptr;
+    std::shared_ptr<MqttLidarFrameBuffer> mLidarFrameBuffer;
+    MqttTelemetryModel mTelemetryModel;
     QString mMqttServerAddr{};
     QString mMqttSubTopic{};
     QString mMqttPubTopic{};
     QString mVideoUrl{};
+    int mPublishQueueDepth{64};
+    QTimer mPublishStatsTimer;
+    MqttPublishQueue::Stats mPublishStats;
+    double mJoystickLatency{0};
 };
 #endif // MQTTMANAGER_H
@@ -0,0 +1,151 @@
+#include "MqttPublishQueue.h"
+
+#include <QDebug>
+
+MqttPublishQueue::MqttPublishQueue(mqtt::async_client_ptr client, int maxDepth, int maxInFlight)
+    : mClient(client), mMaxDepth(qMax(1, maxDepth)), mMaxInFlight(qMax(1, maxInFlight)){}
+
+void MqttPublishQueue::setTopicOptions(const std::string &topic, int qos, Mode mode){
+    QMutexLocker locker(&mMutex);
+    mTopicOptions[topic] = TopicOptions{qos, mode};
+}
+
+const MqttPublishQueue::TopicOptions &MqttPublishQueue::_topicOptions(const std::string &topic) const{
+    const auto options = mTopicOptions.find(topic);
+    return options == mTopicOptions.end() ? mDefaultOptions : options->second;
+}
+
+bool MqttPublishQueue::_dropNewestQos0(){
+    for(auto pending = mQueue.end(); pending != mQueue.begin();){
+        --pending;
+        if(pending->qos == 0){
+            _forgetCoalesced(pending);
+            mQueue.erase(pending);
+            mStats.dropped++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void MqttPublishQueue::_forgetCoalesced(std::list<Pending>::iterator pending){
+    const auto coalesced = mCoalescedPending.find(pending->topic);
+    if(coalesced != mCoalescedPending.end() && coalesced->second == pending){
+        mCoalescedPending.erase(coalesced);
+    }
+}
+
+bool MqttPublishQueue::enqueue(const std::string &topic, mqtt::binary payload, Clock::time_point origin){
+    {
+        QMutexLocker locker(&mMutex);
+        const TopicOptions &options = _topicOptions(topic);
+        const bool coalesce = options.mode == Mode::Coalesced;
+        if(coalesce){
+            const auto pending = mCoalescedPending.find(topic);
+            if(pending != mCoalescedPending.end()){
+                pending->second->payload = std::move(payload);
+                pending->second->origin = origin;
+                mStats.coalesced++;
+                return true;
+            }
+        }
+        if(static_cast<int>(mQueue.size()) >= mMaxDepth){
+            if(options.qos == 0){
+                // The message itself is the newest QoS 0 one
+                mStats.dropped++;
+                return false;
+            }
+            if(!_dropNewestQos0()){
+                mStats.rejected++;
+                qWarning() << "[MqttPublishQueue]Queue full, publish rejected:" << QString::fromStdString(topic);
+                return false;
+            }
+        }
+        mQueue.push_back(Pending{topic, std::move(payload), origin, options.qos});
+        if(coalesce){
+            mCoalescedPending[topic] = std::prev(mQueue.end());
+        }
+        mStats.queueDepth = static_cast<int>(mQueue.size());
+        mStats.maxQueueDepth = qMax(mStats.maxQueueDepth, mStats.queueDepth);
+    }
+    drain();
+    return true;
+}
+
+void MqttPublishQueue::drain(){
+    while(true){
+        Pending pending;
+        int qos;
+        {
+            QMutexLocker locker(&mMutex);
+            if(mQueue.empty() || mStats.inFlight >= mMaxInFlight || !mClient->is_connected()){
+                return;
+            }
+            _forgetCoalesced(mQueue.begin());
+            pending = std::move(mQueue.front());
+            mQueue.pop_front();
+            qos = pending.qos;
+            mStats.queueDepth = static_cast<int>(mQueue.size());
+            mStats.inFlight++;
+        }
+
+        // Origin time travels with the token so the ack can compute publish latency
+        InFlight *inFlight = new InFlight{pending.topic, pending.origin};
+        try{
+            mClient->publish(mqtt::make_message(pending.topic, std::move(pending.payload), qos, false), inFlight, *this);
+        } catch (const mqtt::exception& exc) {
+            delete inFlight;
+            qWarning() << "[MqttPublishQueue]Publish Error: " << exc.what();
+            QMutexLocker locker(&mMutex);
+            mStats.inFlight--;
+            mStats.failed++;
+            return;
+        }
+    }
+}
+
+void MqttPublishQueue::on_failure(const mqtt::token &tok){
+    _completed(tok, false);
+}
+
+void MqttPublishQueue::on_success(const mqtt::token &tok){
+    _completed(tok, true);
+}
+
+void MqttPublishQueue::_completed(const mqtt::token &tok, bool success){
+    InFlight *inFlight = static_cast<InFlight*>(tok.get_user_context());
+    {
+        QMutexLocker locker(&mMutex);
+        mStats.inFlight--;
+        if(success && inFlight){
+            const double latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - inFlight->origin).count();
+            mStats.published++;
+            mStats.lastLatencyMs = latencyMs;
+            mStats.avgLatencyMs = mStats.published == 1 ? latencyMs : mStats.avgLatencyMs * 0.9 + latencyMs * 0.1;
+            const auto topicLatency = mTopicLatencyMs.find(inFlight->topic);
+            if(topicLatency == mTopicLatencyMs.end()){
+                mTopicLatencyMs.emplace(inFlight->topic, latencyMs);
+            }else{
+                topicLatency->second = topicLatency->second * 0.9 + latencyMs * 0.1;
+            }
+        }else{
+            mStats.failed++;
+        }
+    }
+    delete inFlight;
+    if(!success){
+        qWarning() << "[MqttPublishQueue]Publish Failed, message id:" << tok.get_message_id();
+    }
+    drain();
+}
+
+MqttPublishQueue::Stats MqttPublishQueue::stats() const{
+    QMutexLocker locker(&mMutex);
+    return mStats;
+}
+
+double MqttPublishQueue::topicLatencyMs(const std::string &topic) const{
+    QMutexLocker locker(&mMutex);
+    const auto topicLatency = mTopicLatencyMs.find(topic);
+    return topicLatency == mTopicLatencyMs.end() ? 0 : topicLatency->second;
+}
@@ -0,0 +1,96 @@
+#ifndef MQTTPUBLISHQUEUE_H
+#define MQTTPUBLISHQUEUE_H
+
+#include <QtGlobal>
+#include <QMutex>
+#include <mqtt/async_client.h>
+#include <chrono>
+#include <list>
+#include <unordered_map>
+
+/// Bounded, non-blocking publish queue in front of the paho async client.
+///
+/// Messages are published asynchronously with at most maxInFlight outstanding acks, so a slow
+/// broker ack never blocks the caller. Topics in Coalesced mode keep only their latest
+/// unpublished payload (latest-value-wins), which is what teleop control topics want.
+///
+/// A full queue never gives up a QoS 1+ message: the newest QoS 0 message is dropped to make room,
+/// and a QoS 1+ message is rejected when there is none left to drop.
+class MqttPublishQueue : public virtual mqtt::iaction_listener
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode {
+        Queued,     ///< Every message is delivered in order
+        Coalesced,  ///< A newer message replaces any unpublished message on the same topic
+    };
+
+    struct Stats {
+        quint64 published{0};
+        quint64 failed{0};
+        quint64 dropped{0};         ///< QoS 0 messages given up because the queue was full
+        quint64 rejected{0};        ///< QoS 1+ messages refused because the queue was full of them
+        quint64 coalesced{0};
+        int queueDepth{0};
+        int maxQueueDepth{0};
+        int inFlight{0};
+        double lastLatencyMs{0};
+        double avgLatencyMs{0};     ///< Exponential moving average, origin to broker ack
+    };
+
+    MqttPublishQueue(mqtt::async_client_ptr client, int maxDepth = 64, int maxInFlight = 8);
+
+    void setTopicOptions(const std::string &topic, int qos, Mode mode);
+    /// Thread safe. Never blocks on the network. Latency is measured from origin to broker ack.
+    ///     @return false: the queue was full and the message was dropped or rejected
+    bool enqueue(const std::string &topic, mqtt::binary payload, Clock::time_point origin = Clock::now());
+    /// Publishes queued messages up to the in-flight limit. Called again on every ack and on reconnect.
+    void drain();
+    Stats stats() const;
+    /// Average origin to ack latency for one topic, 0 if nothing has been acked yet
+    double topicLatencyMs(const std::string &topic) const;
+
+    void on_failure(const mqtt::token& tok) override;
+    void on_success(const mqtt::token& tok) override;
+
+private:
+    struct TopicOptions {
+        int qos{1};
+        Mode mode{Mode::Queued};
+    };
+
+    struct Pending {
+        std::string topic;
+        mqtt::binary payload;
+        Clock::time_point origin;
+        int qos{1};
+    };
+
+    /// Carried as the paho token user context until the ack arrives
+    struct InFlight {
+        std::string topic;
+        Clock::time_point origin;
+    };
+
+    const TopicOptions &_topicOptions(const std::string &topic) const;
+    /// Drops the newest queued QoS 0 message, false if every queued message is QoS 1+
+    bool _dropNewestQos0();
+    /// Call before the pending message is moved out of or removed from the queue
+    void _forgetCoalesced(std::list<Pending>::iterator pending);
+    void _completed(const mqtt::token& tok, bool success);
+
+    mqtt::async_client_ptr mClient;
+    const int mMaxDepth;
+    const int mMaxInFlight;
+
+    mutable QMutex mMutex;
+    std::list<Pending> mQueue;
+    std::unordered_map<std::string, std::list<Pending>::iterator> mCoalescedPending;
+    std::unordered_map<std::string, TopicOptions> mTopicOptions;
+    std::unordered_map<std::string, double> mTopicLatencyMs;
+    TopicOptions mDefaultOptions;
+    Stats mStats;
+};
+
+#endif // MQTTPUBLISHQUEUE_H
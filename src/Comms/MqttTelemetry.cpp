@@ -0,0 +1,41 @@
+#include "MqttTelemetry.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QDebug>
+
+static void readDouble(const QJsonObject &object, const QString &key, double &value){
+    const QJsonValue jsonValue = object.value(key);
+    if(jsonValue.isDouble()){
+        value = jsonValue.toDouble();
+    }
+}
+
+bool MqttVehicleTelemetry::fromJson(const char *data, qsizetype size, MqttVehicleTelemetry &telemetry){
+    // fromRawData wraps the MQTT payload without copying it
+    QJsonParseError error;
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(QByteArray::fromRawData(data, size), &error);
+    if(error.error != QJsonParseError::NoError || !jsonDoc.isObject()){
+        qWarning() << "[MqttTelemetry]Failed to parse telemetry:" << error.errorString();
+        return false;
+    }
+    const QJsonObject root = jsonDoc.object();
+
+    const QJsonValue timestamp = root.value(QStringLiteral("Timestamp"));
+    if(timestamp.isDouble()){
+        telemetry.timestamp = timestamp.toInteger();
+    }
+
+    const QJsonObject oil = root.value(QStringLiteral("Oil")).toObject();
+    readDouble(oil, QStringLiteral("TotalOilQuantity"), telemetry.totalOilQuantity);
+    readDouble(oil, QStringLiteral("RemainingOilQuantity"), telemetry.remainingOilQuantity);
+    readDouble(oil, QStringLiteral("RemainingMileage"), telemetry.remainingMileage);
+    readDouble(oil, QStringLiteral("DrivingMileage"), telemetry.drivingMileage);
+
+    const QJsonObject electricity = root.value(QStringLiteral("Electricity")).toObject();
+    readDouble(electricity, QStringLiteral("RemainingElectricity"), telemetry.remainingElectricity);
+    readDouble(electricity, QStringLiteral("BatteryTemperature"), telemetry.batteryTemperature);
+
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef MQTTTELEMETRY_H
+#define MQTTTELEMETRY_H
+
+#include <QObject>
+#include <QMetaType>
+
+/// Vehicle telemetry published as JSON on <subTopic>:
+///   { "Timestamp": ..., "Oil": { "TotalOilQuantity": ..., ... }, "Electricity": { ... } }
+struct MqttVehicleTelemetry
+{
+    Q_GADGET
+    Q_PROPERTY(qint64 timestamp             MEMBER timestamp)
+    Q_PROPERTY(double totalOilQuantity      MEMBER totalOilQuantity)
+    Q_PROPERTY(double remainingOilQuantity  MEMBER remainingOilQuantity)
+    Q_PROPERTY(double remainingMileage      MEMBER remainingMileage)
+    Q_PROPERTY(double drivingMileage        MEMBER drivingMileage)
+    Q_PROPERTY(double remainingElectricity  MEMBER remainingElectricity)
+    Q_PROPERTY(double batteryTemperature    MEMBER batteryTemperature)
+
+public:
+    qint64 timestamp{0};
+    double totalOilQuantity{0};
+    double remainingOilQuantity{0};
+    double remainingMileage{0};
+    double drivingMileage{0};
+    double remainingElectricity{0};
+    double batteryTemperature{0};
+
+    /// Parses a telemetry payload in place. Missing fields keep their current value.
+    static bool fromJson(const char *data, qsizetype size, MqttVehicleTelemetry &telemetry);
+};
+Q_DECLARE_METATYPE(MqttVehicleTelemetry)
+
+#endif // MQTTTELEMETRY_H
@@ -0,0 +1,65 @@
+#include "MqttTelemetryModel.h"
+
+MqttTelemetryModel::MqttTelemetryModel(QObject *parent) : QObject(parent){
+    mFlushTimer.setSingleShot(true);
+    mFlushTimer.setInterval(kFlushIntervalMs);
+    connect(&mFlushTimer, &QTimer::timeout, this, &MqttTelemetryModel::_flush);
+}
+
+void MqttTelemetryModel::merge(const MqttVehicleTelemetry &telemetry){
+    {
+        QMutexLocker locker(&mMutex);
+        mPending = telemetry;
+    }
+    // Only the first message after a flush arms the timer, later ones just overwrite mPending
+    if(!mFlushScheduled.exchange(true)){
+        QMetaObject::invokeMethod(&mFlushTimer, [this](){ mFlushTimer.start(); }, Qt::QueuedConnection);
+    }
+}
+
+void MqttTelemetryModel::_flush(){
+    MqttVehicleTelemetry latest;
+    {
+        QMutexLocker locker(&mMutex);
+        latest = mPending;
+        mFlushScheduled = false;
+    }
+
+    const bool validChanged = !mValid;
+    const bool timestampChanged = mPublished.timestamp != latest.timestamp;
+    const bool totalOilQuantityChanged = mPublished.totalOilQuantity != latest.totalOilQuantity;
+    const bool remainingOilQuantityChanged = mPublished.remainingOilQuantity != latest.remainingOilQuantity;
+    const bool remainingMileageChanged = mPublished.remainingMileage != latest.remainingMileage;
+    const bool drivingMileageChanged = mPublished.drivingMileage != latest.drivingMileage;
+    const bool remainingElectricityChanged = mPublished.remainingElectricity != latest.remainingElectricity;
+    const bool batteryTemperatureChanged = mPublished.batteryTemperature != latest.batteryTemperature;
+
+    // Update everything before notifying so handlers never see a half applied message
+    mPublished = latest;
+    mValid = true;
+
+    if(validChanged){
+        emit this->validChanged();
+    }
+    if(timestampChanged){
+        emit this->timestampChanged();
+    }
+    if(totalOilQuantityChanged){
+        emit this->totalOilQuantityChanged();
+    }
+    if(remainingOilQuantityChanged){
+        emit this->remainingOilQuantityChanged();
+    }
+    if(remainingMileageChanged){
+        emit this->remainingMileageChanged();
+    }
+    if(drivingMileageChanged){
+        emit this->drivingMileageChanged();
+    }
+    if(remainingElectricityChanged){
+        emit this->remainingElectricityChanged();
+    }
+    if(batteryTemperatureChanged){
+        emit this->batteryTemperatureChanged();
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef MQTTTELEMETRYMODEL_H
+#define MQTTTELEMETRYMODEL_H
+
+#include <QObject>
+#include <QMutex>
+#include <QTimer>
+#include <atomic>
+#include "MqttTelemetry.h"
+
+/// Latest vehicle telemetry exposed to QML with one property per field.
+///
+/// merge() may be called from any thread at any rate. Merged values are published on the GUI
+/// thread at most once per display frame (kFlushIntervalMs) and only fields whose value
+/// actually changed emit their NOTIFY signal.
+class MqttTelemetryModel : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool    valid                 READ valid                 NOTIFY validChanged)
+    Q_PROPERTY(qint64  timestamp             READ timestamp             NOTIFY timestampChanged)
+    Q_PROPERTY(double  totalOilQuantity      READ totalOilQuantity      NOTIFY totalOilQuantityChanged)
+    Q_PROPERTY(double  remainingOilQuantity  READ remainingOilQuantity  NOTIFY remainingOilQuantityChanged)
+    Q_PROPERTY(double  remainingMileage      READ remainingMileage      NOTIFY remainingMileageChanged)
+    Q_PROPERTY(double  drivingMileage        READ drivingMileage        NOTIFY drivingMileageChanged)
+    Q_PROPERTY(double  remainingElectricity  READ remainingElectricity  NOTIFY remainingElectricityChanged)
+    Q_PROPERTY(double  batteryTemperature    READ batteryTemperature    NOTIFY batteryTemperatureChanged)
+
+public:
+    explicit MqttTelemetryModel(QObject *parent = nullptr);
+
+    /// Thread safe
+    void merge(const MqttVehicleTelemetry &telemetry);
+
+    bool valid() const { return mValid; }
+    qint64 timestamp() const { return mPublished.timestamp; }
+    double totalOilQuantity() const { return mPublished.totalOilQuantity; }
+    double remainingOilQuantity() const { return mPublished.remainingOilQuantity; }
+    double remainingMileage() const { return mPublished.remainingMileage; }
+    double drivingMileage() const { return mPublished.drivingMileage; }
+    double remainingElectricity() const { return mPublished.remainingElectricity; }
+    double batteryTemperature() const { return mPublished.batteryTemperature; }
+
+signals:
+    void validChanged();
+    void timestampChanged();
+    void totalOilQuantityChanged();
+    void remainingOilQuantityChanged();
+    void remainingMileageChanged();
+    void drivingMileageChanged();
+    void remainingElectricityChanged();
+    void batteryTemperatureChanged();
+
+private:
+    void _flush();
+
+    static constexpr int kFlushIntervalMs = 16;
+
+    QMutex mMutex;
+    MqttVehicleTelemetry mPending;
+    std::atomic_bool mFlushScheduled{false};
+    QTimer mFlushTimer;
+
+    // GUI thread only
+    MqttVehicleTelemetry mPublished;
+    bool mValid{false};
+};
+
+#endif // MQTTTELEMETRYMODEL_H
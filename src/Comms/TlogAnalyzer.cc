@@ -0,0 +1,421 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TlogAnalyzer.h"
+#include "LogReplayIndex.h"
+#include "MAVLinkLib.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(TlogAnalyzerLog, "qgc.comms.tloganalyzer")
+
+TlogAnalyzer::TlogAnalyzer(const QStringList &fields)
+{
+    for (const QString &field : fields) {
+        const QStringList parts = field.split(QLatin1Char('.'));
+        const mavlink_message_info_t *const info = (parts.count() == 2) ? mavlink_get_message_info_by_name(parts[0].toLatin1().constData()) : nullptr;
+        if (!info) {
+            qCWarning(TlogAnalyzerLog) << "Unknown message for field" << field;
+            continue;
+        }
+
+        const QByteArray fieldName = parts[1].toLatin1();
+        bool found = false;
+        for (unsigned int i = 0; i < info->num_fields; i++) {
+            const mavlink_field_info_t &fieldInfo = info->fields[i];
+            if (std::strcmp(fieldInfo.name, fieldName.constData()) != 0) {
+                continue;
+            }
+            if (fieldInfo.type == MAVLINK_TYPE_CHAR) {
+                qCWarning(TlogAnalyzerLog) << "Text fields can not be extracted as a time series" << field;
+                break;
+            }
+
+            (void) _selectors[info->msgid].append({ info->msgid, fieldInfo.wire_offset, fieldInfo.type, static_cast<int>(_fieldNames.count()) });
+            (void) _fieldNames.append(field);
+            found = true;
+            break;
+        }
+        if (!found) {
+            qCWarning(TlogAnalyzerLog) << "Field not extracted" << field;
+        }
+    }
+}
+
+bool TlogAnalyzer::analyze(const QString &logFilename)
+{
+    QFile file(logFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        _errorString = QStringLiteral("Unable to open %1: %2").arg(logFilename, file.errorString());
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar *const data = (size > 0) ? file.map(0, size) : nullptr;
+    if (!data) {
+        _errorString = QStringLiteral("Unable to map %1: %2").arg(logFilename, file.errorString());
+        return false;
+    }
+
+    const bool result = analyze(data, size);
+    (void) file.unmap(const_cast<uchar*>(data));
+
+    return result;
+}
+
+bool TlogAnalyzer::analyze(const uchar *data, qint64 size)
+{
+    _messageStats.clear();
+    _linkStats.clear();
+    _fieldSeries.clear();
+    _recordCount = 0;
+    _startTimeUSecs = 0;
+    _endTimeUSecs = 0;
+    _errorString.clear();
+
+    const quint64 nowUSecs = LogReplayIndex::currentTimeUSecs();
+    const qint64 chunkCount = qBound<qint64>(1, size / _minChunkBytes, QThread::idealThreadCount() * 4);
+
+    // Each chunk starts at the first valid record at or after its nominal start, and ends where the next one starts
+    QList<qint64> boundaries;
+    boundaries.reserve(chunkCount + 1);
+    (void) boundaries.append(0);
+    for (qint64 i = 1; i < chunkCount; i++) {
+        quint64 timestampUSecs;
+        qint64 frameOffset;
+        qint64 frameLength;
+        const qint64 recordOffset = LogReplayIndex::nextRecord(data, size, (size * i) / chunkCount, nowUSecs, timestampUSecs, frameOffset, frameLength);
+        (void) boundaries.append(qMax(boundaries.constLast(), (recordOffset < 0) ? size : recordOffset));
+    }
+    (void) boundaries.append(size);
+
+    QList<Chunk> chunks;
+    for (qint64 i = 0; i < chunkCount; i++) {
+        if (boundaries[i] < boundaries[i + 1]) {
+            (void) chunks.append({ boundaries[i], boundaries[i + 1] });
+        }
+    }
+
+    const QList<ChunkResult> results = QtConcurrent::blockingMapped<QList<ChunkResult>>(chunks, [this, data, size, nowUSecs](const Chunk &chunk) {
+        return _analyzeChunk(data, size, chunk, nowUSecs);
+    });
+
+    _merge(results);
+    qCDebug(TlogAnalyzerLog) << "Analyzed" << _recordCount << "records in" << chunks.count() << "chunks";
+
+    if (_recordCount == 0) {
+        _errorString = QStringLiteral("The log holds no MAVLink records");
+        return false;
+    }
+
+    return true;
+}
+
+TlogAnalyzer::ChunkResult TlogAnalyzer::_analyzeChunk(const uchar *data, qint64 size, const Chunk &chunk, quint64 nowUSecs) const
+{
+    ChunkResult result;
+    result.fieldTimeUSecs.resize(_fieldNames.count());
+    result.fieldValues.resize(_fieldNames.count());
+
+    qint64 offset = chunk.begin;
+    while (offset < chunk.end) {
+        quint64 timestampUSecs;
+        qint64 frameOffset;
+        qint64 frameLength;
+        const qint64 recordOffset = LogReplayIndex::nextRecord(data, size, offset, nowUSecs, timestampUSecs, frameOffset, frameLength);
+        if ((recordOffset < 0) || (recordOffset >= chunk.end)) {
+            break;
+        }
+        offset = frameOffset + frameLength;
+
+        // The frame is already CRC checked, so the header is read in place instead of through a channel parser
+        const uchar *const frame = data + frameOffset;
+        const bool mavlink2 = (frame[0] == MAVLINK_STX);
+        const uchar *const header = frame + 1;
+        const quint8 payloadLength = header[0];
+        const quint8 seq = mavlink2 ? header[3] : header[1];
+        const quint8 sysId = mavlink2 ? header[4] : header[2];
+        const quint8 compId = mavlink2 ? header[5] : header[3];
+        const quint32 msgId = mavlink2 ? (header[6] | (header[7] << 8) | (static_cast<quint32>(header[8]) << 16)) : header[4];
+        const uchar *const payload = frame + (mavlink2 ? (MAVLINK_CORE_HEADER_LEN + 1) : (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1));
+
+        if (result.records++ == 0) {
+            result.firstTimeUSecs = timestampUSecs;
+        }
+        result.lastTimeUSecs = timestampUSecs;
+
+        (void) result.countsPerSecond[msgId][timestampUSecs / 1000000]++;
+
+        const quint16 linkKey = static_cast<quint16>((sysId << 8) | compId);
+        auto link = result.links.find(linkKey);
+        if (link == result.links.end()) {
+            (void) result.links.insert(linkKey, { seq, seq, 1, 0 });
+        } else {
+            link->lost += static_cast<quint8>(seq - static_cast<quint8>(link->lastSeq + 1));
+            link->lastSeq = seq;
+            link->received++;
+        }
+
+        const auto selectors = _selectors.constFind(msgId);
+        if (selectors != _selectors.cend()) {
+            // MAVLink 2 drops trailing zero bytes from the payload, restore them before reading fields
+            uchar fullPayload[MAVLINK_MAX_PAYLOAD_LEN] = {};
+            (void) std::memcpy(fullPayload, payload, payloadLength);
+            for (const FieldSelector &selector : selectors.value()) {
+                (void) result.fieldTimeUSecs[selector.seriesIndex].append(timestampUSecs);
+                (void) result.fieldValues[selector.seriesIndex].append(_fieldValue(fullPayload, selector.wireOffset, selector.type));
+            }
+        }
+    }
+
+    return result;
+}
+
+void TlogAnalyzer::_merge(const QList<ChunkResult> &results)
+{
+    QHash<quint32, QHash<quint64, quint32>> countsPerSecond;
+    QHash<quint16, SeqState> links;
+    QList<QList<quint64>> fieldTimeUSecs(_fieldNames.count());
+    QList<QList<double>> fieldValues(_fieldNames.count());
+
+    for (const ChunkResult &result : results) {
+        if (result.records == 0) {
+            continue;
+        }
+        if (_recordCount == 0) {
+            _startTimeUSecs = result.firstTimeUSecs;
+        }
+        _endTimeUSecs = result.lastTimeUSecs;
+        _recordCount += result.records;
+
+        for (auto msg = result.countsPerSecond.cbegin(); msg != result.countsPerSecond.cend(); ++msg) {
+            QHash<quint64, quint32> &counts = countsPerSecond[msg.key()];
+            for (auto second = msg.value().cbegin(); second != msg.value().cend(); ++second) {
+                counts[second.key()] += second.value();
+            }
+        }
+
+        // Sequence gaps which straddle a chunk boundary are only visible once the chunks are joined
+        for (auto chunkLink = result.links.cbegin(); chunkLink != result.links.cend(); ++chunkLink) {
+            auto link = links.find(chunkLink.key());
+            if (link == links.end()) {
+                (void) links.insert(chunkLink.key(), chunkLink.value());
+            } else {
+                link->lost += chunkLink->lost + static_cast<quint8>(chunkLink->firstSeq - static_cast<quint8>(link->lastSeq + 1));
+                link->lastSeq = chunkLink->lastSeq;
+                link->received += chunkLink->received;
+            }
+        }
+
+        for (qsizetype i = 0; i < _fieldNames.count(); i++) {
+            fieldTimeUSecs[i].append(result.fieldTimeUSecs[i]);
+            fieldValues[i].append(result.fieldValues[i]);
+        }
+    }
+
+    QList<quint32> msgIds = countsPerSecond.keys();
+    std::sort(msgIds.begin(), msgIds.end());
+    for (const quint32 msgId : msgIds) {
+        const QHash<quint64, quint32> &counts = countsPerSecond[msgId];
+
+        MessageStats stats;
+        stats.msgId = msgId;
+        const mavlink_message_info_t *const info = mavlink_get_message_info_by_id(msgId);
+        stats.name = info ? QString::fromLatin1(info->name) : QStringLiteral("MSG_%1").arg(msgId);
+        stats.rateHistogram.fill(0, kRateBinCount);
+
+        quint64 firstSecond = std::numeric_limits<quint64>::max();
+        quint64 lastSecond = 0;
+        for (auto second = counts.cbegin(); second != counts.cend(); ++second) {
+            firstSecond = qMin(firstSecond, second.key());
+            lastSecond = qMax(lastSecond, second.key());
+            stats.count += second.value();
+            stats.maxRateHz = qMax(stats.maxRateHz, second.value());
+            stats.rateHistogram[_rateBin(second.value())]++;
+        }
+
+        // Seconds inside the message's span where it did not arrive at all
+        const quint64 spanSecs = lastSecond - firstSecond + 1;
+        stats.rateHistogram[0] += static_cast<quint32>(spanSecs - counts.count());
+        stats.meanRateHz = static_cast<double>(stats.count) / spanSecs;
+
+        (void) _messageStats.append(stats);
+    }
+
+    QList<quint16> linkKeys = links.keys();
+    std::sort(linkKeys.begin(), linkKeys.end());
+    for (const quint16 linkKey : linkKeys) {
+        const SeqState &link = links[linkKey];
+        (void) _linkStats.append({ static_cast<quint8>(linkKey >> 8), static_cast<quint8>(linkKey & 0xFF), link.received, link.lost });
+    }
+
+    for (qsizetype i = 0; i < _fieldNames.count(); i++) {
+        FieldSeries series;
+        series.name = _fieldNames[i];
+        series.timeSecs.reserve(fieldTimeUSecs[i].count());
+        for (const quint64 timeUSecs : fieldTimeUSecs[i]) {
+            (void) series.timeSecs.append((static_cast<qint64>(timeUSecs - _startTimeUSecs)) / 1e6);
+        }
+        series.values = fieldValues[i];
+        (void) _fieldSeries.append(series);
+    }
+}
+
+double TlogAnalyzer::_fieldValue(const uchar *payload, quint32 wireOffset, int type)
+{
+    const uchar *const field = payload + wireOffset;
+
+    switch (type) {
+    case MAVLINK_TYPE_UINT8_T:
+        return *field;
+    case MAVLINK_TYPE_INT8_T:
+        return static_cast<int8_t>(*field);
+    case MAVLINK_TYPE_UINT16_T: {
+        uint16_t value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return value;
+    }
+    case MAVLINK_TYPE_INT16_T: {
+        int16_t value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return value;
+    }
+    case MAVLINK_TYPE_UINT32_T: {
+        uint32_t value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return value;
+    }
+    case MAVLINK_TYPE_INT32_T: {
+        int32_t value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return value;
+    }
+    case MAVLINK_TYPE_UINT64_T: {
+        uint64_t value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return static_cast<double>(value);
+    }
+    case MAVLINK_TYPE_INT64_T: {
+        int64_t value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return static_cast<double>(value);
+    }
+    case MAVLINK_TYPE_FLOAT: {
+        float value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return value;
+    }
+    case MAVLINK_TYPE_DOUBLE: {
+        double value;
+        (void) std::memcpy(&value, field, sizeof(value));
+        return value;
+    }
+    default:
+        return 0;
+    }
+}
+
+int TlogAnalyzer::_rateBin(quint32 rateHz)
+{
+    const auto bin = std::upper_bound(std::cbegin(kRateBinUpperHz), std::cend(kRateBinUpperHz), static_cast<double>(rateHz));
+    return static_cast<int>(std::distance(std::cbegin(kRateBinUpperHz), bin));
+}
+
+bool TlogAnalyzer::writeJson(const QString &outputFilename) const
+{
+    QJsonArray binsJson;
+    for (const double upperHz : kRateBinUpperHz) {
+        binsJson.append(upperHz);
+    }
+
+    QJsonArray messagesJson;
+    for (const MessageStats &stats : _messageStats) {
+        QJsonArray histogramJson;
+        for (const quint32 seconds : stats.rateHistogram) {
+            histogramJson.append(static_cast<qint64>(seconds));
+        }
+        messagesJson.append(QJsonObject{
+            { "id", static_cast<qint64>(stats.msgId) },
+            { "name", stats.name },
+            { "count", static_cast<qint64>(stats.count) },
+            { "meanRateHz", stats.meanRateHz },
+            { "maxRateHz", static_cast<qint64>(stats.maxRateHz) },
+            { "rateHistogram", histogramJson },
+        });
+    }
+
+    QJsonArray linksJson;
+    for (const LinkStats &link : _linkStats) {
+        linksJson.append(QJsonObject{
+            { "sysId", link.sysId },
+            { "compId", link.compId },
+            { "received", static_cast<qint64>(link.received) },
+            { "lost", static_cast<qint64>(link.lost) },
+        });
+    }
+
+    QJsonObject seriesJson;
+    for (const FieldSeries &series : _fieldSeries) {
+        seriesJson.insert(series.name, QJsonObject{
+            { "time", QJsonArray::fromVariantList(QVariantList(series.timeSecs.cbegin(), series.timeSecs.cend())) },
+            { "value", QJsonArray::fromVariantList(QVariantList(series.values.cbegin(), series.values.cend())) },
+        });
+    }
+
+    const QJsonObject root{
+        { "records", static_cast<qint64>(_recordCount) },
+        { "startTimeUSecs", static_cast<qint64>(_startTimeUSecs) },
+        { "durationSecs", static_cast<qint64>(_endTimeUSecs - _startTimeUSecs) / 1e6 },
+        { "rateBinUpperHz", binsJson },
+        { "messages", messagesJson },
+        { "links", linksJson },
+        { "series", seriesJson },
+    };
+
+    QSaveFile file(outputFilename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(TlogAnalyzerLog) << "Unable to write" << outputFilename << file.errorString();
+        return false;
+    }
+    (void) file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+
+    return file.commit();
+}
+
+int TlogAnalyzer::runCommandLine(const QString &logFilename, const QString &fields, const QString &outputFilename)
+{
+    TlogAnalyzer analyzer(fields.split(QLatin1Char(','), Qt::SkipEmptyParts));
+    if (!analyzer.analyze(logFilename)) {
+        qCWarning(TlogAnalyzerLog) << analyzer.errorString();
+        return 1;
+    }
+
+    const QFileInfo logFileInfo(logFilename);
+    const QString jsonFilename = outputFilename.isEmpty() ? logFileInfo.dir().filePath(logFileInfo.completeBaseName() + QStringLiteral(".json")) : outputFilename;
+    if (!analyzer.writeJson(jsonFilename)) {
+        return 1;
+    }
+
+    qCInfo(TlogAnalyzerLog) << "Wrote" << jsonFilename << "from" << analyzer.recordCount() << "records";
+
+    return 0;
+}
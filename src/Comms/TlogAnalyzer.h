@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+Q_DECLARE_LOGGING_CATEGORY(TlogAnalyzerLog)
+
+/// Batch statistics for a telemetry log, without replaying it through a link or a Vehicle.
+///
+/// The log is memory mapped and cut into chunks which are decoded in parallel on the global thread pool.
+/// Chunk boundaries are moved forward to the next CRC valid record using the same walk LogReplayLink
+/// uses, so no frame is split or counted twice. Per chunk results are merged in file order.
+class TlogAnalyzer
+{
+    friend class TlogAnalyzerTest;
+
+public:
+    /// Upper bounds of the message rate histogram bins in Hz, the last bin is open ended
+    static constexpr double kRateBinUpperHz[] = { 1, 2, 5, 10, 20, 50, 100 };
+    static constexpr int kRateBinCount = (sizeof(kRateBinUpperHz) / sizeof(kRateBinUpperHz[0])) + 1;
+
+    struct MessageStats {
+        quint32         msgId = 0;
+        QString         name;
+        quint64         count = 0;
+        double          meanRateHz = 0;
+        quint32         maxRateHz = 0;
+        QList<quint32>  rateHistogram;  ///< Seconds of log time spent in each rate bin
+    };
+
+    struct LinkStats {
+        quint8  sysId = 0;
+        quint8  compId = 0;
+        quint64 received = 0;
+        quint64 lost = 0;               ///< From gaps in the MAVLink sequence numbers
+    };
+
+    /// Columnar time series for one selected field
+    struct FieldSeries {
+        QString         name;           ///< MESSAGE.field
+        QList<double>   timeSecs;       ///< Seconds since the start of the log
+        QList<double>   values;
+    };
+
+    /// @param fields Message fields to extract as time series, in MESSAGE.field form. Array fields yield their first element.
+    explicit TlogAnalyzer(const QStringList &fields = {});
+
+    /// @return false if the log can not be read or holds no records
+    bool analyze(const QString &logFilename);
+    bool analyze(const uchar *data, qint64 size);
+
+    /// Writes the results as JSON, time series are stored as parallel time and value arrays
+    bool writeJson(const QString &outputFilename) const;
+
+    const QList<MessageStats> &messageStats() const { return _messageStats; }
+    const QList<LinkStats> &linkStats() const { return _linkStats; }
+    const QList<FieldSeries> &fieldSeries() const { return _fieldSeries; }
+    quint64 recordCount() const { return _recordCount; }
+    quint64 startTimeUSecs() const { return _startTimeUSecs; }
+    quint64 endTimeUSecs() const { return _endTimeUSecs; }
+    const QString &errorString() const { return _errorString; }
+
+    /// Entry point for the --analyze-tlog command line option
+    ///     @param fields Comma separated MESSAGE.field list
+    ///     @param outputFilename Defaults to the log filename with a .json suffix
+    /// @return Process exit code
+    static int runCommandLine(const QString &logFilename, const QString &fields, const QString &outputFilename);
+
+private:
+    struct FieldSelector {
+        quint32     msgId;
+        quint32     wireOffset;
+        int         type;
+        int         seriesIndex;
+    };
+
+    struct SeqState {
+        quint8  firstSeq;
+        quint8  lastSeq;
+        quint64 received;
+        quint64 lost;
+    };
+
+    struct Chunk {
+        qint64 begin;
+        qint64 end;
+    };
+
+    struct ChunkResult {
+        QHash<quint32, QHash<quint64, quint32>> countsPerSecond;    ///< msgid -> second of log time -> count
+        QHash<quint16, SeqState>                links;              ///< (sysid << 8) | compid
+        QList<QList<quint64>>                   fieldTimeUSecs;     ///< Absolute record times, per series
+        QList<QList<double>>                    fieldValues;
+        quint64                                 records = 0;
+        quint64                                 firstTimeUSecs = 0;
+        quint64                                 lastTimeUSecs = 0;
+    };
+
+    ChunkResult _analyzeChunk(const uchar *data, qint64 size, const Chunk &chunk, quint64 nowUSecs) const;
+    void _merge(const QList<ChunkResult> &results);
+    static double _fieldValue(const uchar *payload, quint32 wireOffset, int type);
+    static int _rateBin(quint32 rateHz);
+
+    QHash<quint32, QList<FieldSelector>> _selectors;
+    QStringList _fieldNames;
+
+    QList<MessageStats> _messageStats;
+    QList<LinkStats> _linkStats;
+    QList<FieldSeries> _fieldSeries;
+    quint64 _recordCount = 0;
+    quint64 _startTimeUSecs = 0;
+    quint64 _endTimeUSecs = 0;
+    QString _errorString;
+
+    static constexpr qint64 kMinChunkBytes = 1024 * 1024;
+    qint64 _minChunkBytes = kMinChunkBytes;
+};
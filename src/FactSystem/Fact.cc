@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "Fact.h"
+#include "FactGroup.h"
 #include "FactValueSliderListModel.h"
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
@@ -24,6 +25,7 @@ Fact::Fact(QObject* parent)
     , _deferredValueChangeSignal(false)
     , _valueSliderModel         (nullptr)
     , _ignoreQGCRebootRequired  (false)
+    , _factGroup                (nullptr)
 {    
     FactMetaData* metaData = new FactMetaData(_type, this);
     setMetaData(metaData);
@@ -42,6 +44,7 @@ Fact::Fact(int componentId, QString name, FactMetaData::ValueType_t type, QObjec
     , _deferredValueChangeSignal(false)
     , _valueSliderModel         (nullptr)
     , _ignoreQGCRebootRequired  (false)
+    , _factGroup                (nullptr)
 {
     FactMetaData* metaData = new FactMetaData(_type, this);
     setMetaData(metaData);
@@ -60,6 +63,7 @@ Fact::Fact(const QString& settingsGroup, FactMetaData* metaData, QObject* parent
     , _deferredValueChangeSignal(false)
     , _valueSliderModel         (nullptr)
     , _ignoreQGCRebootRequired  (false)
+    , _factGroup                (nullptr)
 {
     qgcApp()->toolbox()->corePlugin()->adjustSettingMetaData(settingsGroup, *metaData);
     setMetaData(metaData, true /* setDefaultFromMetaData */);
@@ -69,6 +73,7 @@ Fact::Fact(const QString& settingsGroup, FactMetaData* metaData, QObject* parent
 
 Fact::Fact(const Fact& other, QObject* parent)
     : QObject(parent)
+    , _factGroup(nullptr)
 {
     *this = other;
 
@@ -108,7 +113,7 @@ void Fact::forceSetRawValue(const QVariant& value)
         
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
             _rawValue.setValue(typedValue);
-            _sendValueChangedSignal(cookedValue());
+            _sendValueChangedSignal();
             //-- Must be in this order
             emit _containerRawValueChanged(rawValue());
             emit rawValueChanged(_rawValue);
@@ -127,7 +132,7 @@ void Fact::setRawValue(const QVariant& value)
         if (_metaData->convertAndValidateRaw(value, true /* convertOnly */, typedValue, errorString)) {
             if (typedValue != _rawValue) {
                 _rawValue.setValue(typedValue);
-                _sendValueChangedSignal(cookedValue());
+                _sendValueChangedSignal();
                 //-- Must be in this order
                 emit _containerRawValueChanged(rawValue());
                 emit rawValueChanged(_rawValue);
@@ -177,7 +182,7 @@ void Fact::_containerSetRawValue(const QVariant& value)
 {
     if(_rawValue != value) {
         _rawValue = value;
-        _sendValueChangedSignal(cookedValue());
+        _sendValueChangedSignal();
         emit rawValueChanged(_rawValue);
     }
 
@@ -667,13 +672,19 @@ void Fact::setSendValueChangedSignals (bool sendValueChangedSignals)
     }
 }
 
-void Fact::_sendValueChangedSignal(QVariant value)
+void Fact::_sendValueChangedSignal(void)
 {
     if (_sendValueChangedSignals) {
-        emit valueChanged(value);
+        emit valueChanged(cookedValue());
         _deferredValueChangeSignal = false;
-    } else {
+        if (_factGroup) {
+            FactGroup::_valueChangedSignalCount++;
+        }
+    } else if (!_deferredValueChangeSignal) {
         _deferredValueChangeSignal = true;
+        if (_factGroup) {
+            _factGroup->_factDirty(this);
+        }
     }
 }
 
@@ -682,6 +693,18 @@ void Fact::sendDeferredValueChangedSignal(void)
     if (_deferredValueChangeSignal) {
         _deferredValueChangeSignal = false;
         emit valueChanged(cookedValue());
+        if (_factGroup) {
+            FactGroup::_valueChangedSignalCount++;
+        }
+    }
+}
+
+void Fact::_setTelemetryRawValue(const QVariant& typedValue)
+{
+    if (typedValue != _rawValue) {
+        _rawValue = typedValue;
+        _sendValueChangedSignal();
+        emit rawValueChanged(_rawValue);
     }
 }
 
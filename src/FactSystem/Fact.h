@@ -13,8 +13,11 @@
 #include <QtCore/QString>
 #include <QtCore/QVariant>
 
+#include <type_traits>
+
 #include "FactMetaData.h"
 
+class FactGroup;
 class FactValueSliderListModel;
 
 /// @brief A Fact is used to hold a single value within the system.
@@ -149,6 +152,47 @@ public:
     void clearDeferredValueChangeSignal(void) { _deferredValueChangeSignal = false; }
     void sendDeferredValueChangedSignal(void);
 
+    /// Fast path for values decoded from telemetry. The value is converted straight to the raw type of the Fact
+    /// without going through meta data validation, and the cooked value is only computed once a valueChanged
+    /// signal is actually sent. Facts with string or custom types go through setRawValue.
+    template<typename T>
+    void setTelemetryValue(T value)
+    {
+        static_assert(std::is_arithmetic_v<T>, "setTelemetryValue requires an arithmetic type");
+
+        switch (_type) {
+        case FactMetaData::valueTypeInt8:
+        case FactMetaData::valueTypeInt16:
+        case FactMetaData::valueTypeInt32:
+            _setTelemetryRawValue(QVariant(static_cast<int>(value)));
+            break;
+        case FactMetaData::valueTypeInt64:
+            _setTelemetryRawValue(QVariant(static_cast<qlonglong>(value)));
+            break;
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeUint32:
+            _setTelemetryRawValue(QVariant(static_cast<uint>(value)));
+            break;
+        case FactMetaData::valueTypeUint64:
+            _setTelemetryRawValue(QVariant(static_cast<qulonglong>(value)));
+            break;
+        case FactMetaData::valueTypeFloat:
+            _setTelemetryRawValue(QVariant(static_cast<float>(value)));
+            break;
+        case FactMetaData::valueTypeDouble:
+        case FactMetaData::valueTypeElapsedTimeInSeconds:
+            _setTelemetryRawValue(QVariant(static_cast<double>(value)));
+            break;
+        case FactMetaData::valueTypeBool:
+            _setTelemetryRawValue(QVariant(static_cast<bool>(value)));
+            break;
+        default:
+            setRawValue(QVariant::fromValue(value));
+            break;
+        }
+    }
+
     // C++ methods
 
     /// Sets and sends new value to vehicle even if value is the same
@@ -198,7 +242,8 @@ private:
     
 protected:
     QString _variantToString(const QVariant& variant, int decimalPlaces) const;
-    void _sendValueChangedSignal(QVariant value);
+    void _sendValueChangedSignal(void);
+    void _setTelemetryRawValue(const QVariant& typedValue);
 
     QString                     _name;
     int                         _componentId;
@@ -209,6 +254,9 @@ protected:
     bool                        _deferredValueChangeSignal;
     FactValueSliderListModel*   _valueSliderModel;
     bool                        _ignoreQGCRebootRequired;
+    FactGroup*                  _factGroup;                 ///< Group which flushes deferred signals, nullptr if none
+
+    friend class FactGroup;
 
     static constexpr const char* kMissingMetadata = "Meta data pointer missing";
 };
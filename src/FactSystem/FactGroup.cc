@@ -9,15 +9,28 @@
 
 
 #include "FactGroup.h"
+#include "QGCLoggingCategory.h"
 
+#include <QtCore/QCoreApplication>
 #include <QtQml/QQmlEngine>
 
+#include <utility>
+
+QGC_LOGGING_CATEGORY(FactGroupLog, "FactGroupLog")
+
+QPointer<QTimer>            FactGroup::_frameTimer;
+QList<QPointer<FactGroup>>  FactGroup::_dirtyGroups;
+QElapsedTimer               FactGroup::_statsTimer;
+quint64                     FactGroup::_statsSignalCount        = 0;
+quint64                     FactGroup::_statsFlushCount         = 0;
+quint64                     FactGroup::_valueChangedSignalCount = 0;
+quint64                     FactGroup::_flushCount              = 0;
+
 FactGroup::FactGroup(int updateRateMsecs, const QString& metaDataFile, QObject* parent, bool ignoreCamelCase)
     : QObject(parent)
     , _updateRateMSecs(updateRateMsecs)
     , _ignoreCamelCase(ignoreCamelCase)
 {
-    _setupTimer();
     _nameToFactMetaDataMap = FactMetaData::createMapFromJsonFile(metaDataFile, this);
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
 }
@@ -27,7 +40,6 @@ FactGroup::FactGroup(int updateRateMsecs, QObject* parent, bool ignoreCamelCase)
     , _updateRateMSecs(updateRateMsecs)
     , _ignoreCamelCase(ignoreCamelCase)
 {
-    _setupTimer();
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
 }
 
@@ -37,16 +49,6 @@ void FactGroup::_loadFromJsonArray(const QJsonArray jsonArray)
     _nameToFactMetaDataMap = FactMetaData::createMapFromJsonArray(jsonArray, defineMap, this);
 }
 
-void FactGroup::_setupTimer()
-{
-    if (_updateRateMSecs > 0) {
-        connect(&_updateTimer, &QTimer::timeout, this, &FactGroup::_updateAllValues);
-        _updateTimer.setSingleShot(false);
-        _updateTimer.setInterval(_updateRateMSecs);
-        _updateTimer.start();
-    }
-}
-
 bool FactGroup::factExists(const QString& name)
 {
     if (name.contains(".")) {
@@ -124,6 +126,7 @@ void FactGroup::_addFact(Fact* fact, const QString& name)
     }
 
     fact->setSendValueChangedSignals(_updateRateMSecs == 0);
+    fact->_factGroup = this;
     if (_nameToFactMetaDataMap.contains(name)) {
         fact->setMetaData(_nameToFactMetaDataMap[name], true /* setDefaultFromMetaData */);
     }
@@ -147,27 +150,88 @@ void FactGroup::_addFactGroup(FactGroup* factGroup, const QString& name)
 
 void FactGroup::_updateAllValues(void)
 {
-    for(Fact* fact: _nameToFactMap) {
-        fact->sendDeferredValueChangedSignal();
+    // Signal handlers may dirty more Facts while we are flushing, those are picked up by this same pass
+    for (qsizetype i = 0; i < _dirtyFacts.count(); i++) {
+        _dirtyFacts[i]->sendDeferredValueChangedSignal();
     }
+    _dirtyFacts.clear();
 }
 
 void FactGroup::setLiveUpdates(bool liveUpdates)
 {
-    if (_updateTimer.interval() == 0) {
+    if (_updateRateMSecs == 0) {
         return;
     }
 
-    if (liveUpdates) {
-        _updateTimer.stop();
-    } else {
-        _updateTimer.start();
-    }
     for(Fact* fact: _nameToFactMap) {
         fact->setSendValueChangedSignals(liveUpdates);
     }
+    if (liveUpdates) {
+        // Anything still waiting on the frame clock would otherwise show stale until the next change
+        _updateAllValues();
+    }
 }
 
+void FactGroup::_factDirty(Fact* fact)
+{
+    _dirtyFacts.append(fact);
+    if (_dirty) {
+        return;
+    }
+
+    _dirty = true;
+    _dirtyGroups.append(this);
+
+    if (!_frameTimer) {
+        _frameTimer = new QTimer(QCoreApplication::instance());
+        _frameTimer->setTimerType(Qt::PreciseTimer);
+        _frameTimer->setInterval(kFrameIntervalMSecs);
+        (void) connect(_frameTimer.data(), &QTimer::timeout, &FactGroup::_frameTick);
+    }
+    if (!_frameTimer->isActive()) {
+        _frameTimer->start();
+        if (!_statsTimer.isValid()) {
+            _statsTimer.start();
+        }
+    }
+}
+
+void FactGroup::_flush(void)
+{
+    _dirty = false;
+    _lastFlushTimer.start();
+    _flushCount++;
+    _updateAllValues();
+}
+
+void FactGroup::_frameTick(void)
+{
+    // Flushing can dirty groups again, those go on the fresh list and wait for the next frame
+    const QList<QPointer<FactGroup>> dirtyGroups = std::exchange(_dirtyGroups, {});
+    for (const QPointer<FactGroup>& factGroup: dirtyGroups) {
+        if (!factGroup || !factGroup->_dirty) {
+            continue;
+        }
+        if (factGroup->_lastFlushTimer.isValid() && (factGroup->_lastFlushTimer.elapsed() < factGroup->_updateRateMSecs)) {
+            _dirtyGroups.append(factGroup);
+        } else {
+            factGroup->_flush();
+        }
+    }
+
+    const qint64 statsMSecs = _statsTimer.elapsed();
+    if (statsMSecs >= 1000) {
+        qCDebug(FactGroupLog) << "valueChanged signals/sec" << ((_valueChangedSignalCount - _statsSignalCount) * 1000 / statsMSecs)
+                              << "group flushes/sec" << ((_flushCount - _statsFlushCount) * 1000 / statsMSecs);
+        _statsSignalCount = _valueChangedSignalCount;
+        _statsFlushCount = _flushCount;
+        _statsTimer.start();
+    }
+
+    if (_dirtyGroups.isEmpty()) {
+        _frameTimer->stop();
+    }
+}
 
 QString FactGroup::_camelCase(const QString& text)
 {
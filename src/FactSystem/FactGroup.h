@@ -11,15 +11,24 @@
 
 #include <QtCore/QStringList>
 #include <QtCore/QMap>
-#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QJsonArray>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QPointer>
+#include <QtCore/QTimer>
 
 #include "Fact.h"
 #include "MAVLinkLib.h"
 
+Q_DECLARE_LOGGING_CATEGORY(FactGroupLog)
+
 class Vehicle;
 
 /// Used to group Facts together into an object hierarachy.
+///
+/// Groups with an update rate defer the valueChanged signals of their Facts. Setting a value only marks the Fact
+/// dirty; all dirty groups are then flushed from a single application wide frame clock, at most once per update
+/// rate per group. The frame clock only runs while something is dirty.
 class FactGroup : public QObject
 {
     Q_OBJECT
@@ -54,12 +63,21 @@ public:
     /// Allows a FactGroup to parse incoming messages and fill in values
     virtual void handleMessage(Vehicle* vehicle, mavlink_message_t& message);
 
+    /// @return Total number of valueChanged signals sent by Facts which belong to a FactGroup
+    static quint64 valueChangedSignalCount(void) { return _valueChangedSignalCount; }
+
+    /// @return Total number of deferred group flushes
+    static quint64 flushCount(void) { return _flushCount; }
+
+    static constexpr int kFrameIntervalMSecs = 16;  ///< Frame clock interval, about one frame at 60Hz
+
 signals:
     void factNamesChanged           (void);
     void factGroupNamesChanged      (void);
     void telemetryAvailableChanged  (bool telemetryAvailable);
 
 protected slots:
+    /// Sends the deferred valueChanged signals of all dirty Facts
     virtual void _updateAllValues(void);
 
 protected:
@@ -76,10 +94,25 @@ protected:
     QStringList                     _factNames;
 
 private:
-    void    _setupTimer (void);
     QString _camelCase  (const QString& text);
-
-    bool    _ignoreCamelCase    = false;
-    QTimer  _updateTimer;
-    bool    _telemetryAvailable = false;
+    void    _factDirty  (Fact* fact);
+    void    _flush      (void);
+
+    static void _frameTick(void);
+
+    bool            _ignoreCamelCase    = false;
+    bool            _telemetryAvailable = false;
+    bool            _dirty              = false;    ///< true: group is waiting on the frame clock
+    QList<Fact*>    _dirtyFacts;
+    QElapsedTimer   _lastFlushTimer;
+
+    static QPointer<QTimer>             _frameTimer;
+    static QList<QPointer<FactGroup>>   _dirtyGroups;
+    static QElapsedTimer                _statsTimer;
+    static quint64                      _statsSignalCount;
+    static quint64                      _statsFlushCount;
+    static quint64                      _valueChangedSignalCount;
+    static quint64                      _flushCount;
+
+    friend class Fact;
 };
@@ -0,0 +1,101 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterIndexWaitList.h"
+
+#include <QtCore/QtAlgorithms>
+
+void ParameterIndexWaitList::reset(int paramCount)
+{
+    _size = qMax(0, paramCount);
+    _waitingCount = _size;
+
+    const int wordCount = (_size + _bitsPerWord - 1) / _bitsPerWord;
+    _waitingBits.fill(~Q_UINT64_C(0), wordCount);
+    if ((_size % _bitsPerWord) != 0) {
+        _waitingBits.last() = (Q_UINT64_C(1) << (_size % _bitsPerWord)) - 1;
+    }
+    _retryCounts.fill(0, _size);
+}
+
+void ParameterIndexWaitList::clear(void)
+{
+    _waitingBits.fill(0);
+    _waitingCount = 0;
+}
+
+bool ParameterIndexWaitList::contains(int paramIndex) const
+{
+    if ((paramIndex < 0) || (paramIndex >= _size)) {
+        return false;
+    }
+
+    return (_waitingBits[paramIndex / _bitsPerWord] >> (paramIndex % _bitsPerWord)) & 1;
+}
+
+bool ParameterIndexWaitList::remove(int paramIndex)
+{
+    if (!contains(paramIndex)) {
+        return false;
+    }
+
+    _waitingBits[paramIndex / _bitsPerWord] &= ~(Q_UINT64_C(1) << (paramIndex % _bitsPerWord));
+    _waitingCount--;
+
+    return true;
+}
+
+int ParameterIndexWaitList::retryCount(int paramIndex) const
+{
+    return ((paramIndex >= 0) && (paramIndex < _size)) ? _retryCounts[paramIndex] : 0;
+}
+
+int ParameterIndexWaitList::bumpRetryCount(int paramIndex)
+{
+    if ((paramIndex < 0) || (paramIndex >= _size)) {
+        return 0;
+    }
+
+    return ++_retryCounts[paramIndex];
+}
+
+int ParameterIndexWaitList::nextWaiting(int paramIndex) const
+{
+    if (_waitingCount == 0) {
+        return -1;
+    }
+
+    paramIndex = qMax(0, paramIndex);
+    int word = paramIndex / _bitsPerWord;
+    if (word >= _waitingBits.count()) {
+        return -1;
+    }
+
+    // Mask off the bits below the starting index in the first word
+    quint64 bits = _waitingBits[word] & (~Q_UINT64_C(0) << (paramIndex % _bitsPerWord));
+    while (bits == 0) {
+        if (++word >= _waitingBits.count()) {
+            return -1;
+        }
+        bits = _waitingBits[word];
+    }
+
+    return (word * _bitsPerWord) + static_cast<int>(qCountTrailingZeroBits(bits));
+}
+
+QList<int> ParameterIndexWaitList::waitingIndices(void) const
+{
+    QList<int> indices;
+    indices.reserve(_waitingCount);
+    for (int paramIndex = nextWaiting(0); paramIndex != -1; paramIndex = nextWaiting(paramIndex + 1)) {
+        indices.append(paramIndex);
+    }
+
+    return indices;
+}
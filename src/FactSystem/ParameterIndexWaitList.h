@@ -0,0 +1,49 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+
+/// Parameter indices of one component which are still outstanding from the index based load, along with the
+/// retry count for each of them.
+///
+/// Waiting indices are kept as a bitmap, so checking off a PARAM_VALUE is constant time and walking the
+/// missing indices for a retry batch skips over everything already received a word at a time.
+class ParameterIndexWaitList
+{
+public:
+    /// Marks every index in [0, paramCount) as waiting and zeros all retry counts
+    void        reset           (int paramCount);
+    /// Nothing waiting
+    void        clear           (void);
+
+    bool        contains        (int paramIndex) const;
+    /// @return true: index was waiting
+    bool        remove          (int paramIndex);
+    int         count           (void) const { return _waitingCount; }
+
+    int         retryCount      (int paramIndex) const;
+    /// @return New retry count for the index
+    int         bumpRetryCount  (int paramIndex);
+
+    /// @return First waiting index at or after paramIndex, -1 if there is none
+    int         nextWaiting     (int paramIndex) const;
+
+    /// @return All waiting indices in ascending order, for logging
+    QList<int>  waitingIndices  (void) const;
+
+private:
+    static constexpr int _bitsPerWord = 64;
+
+    QList<quint64>  _waitingBits;
+    QList<quint8>   _retryCounts;
+    int             _size           = 0;
+    int             _waitingCount   = 0;
+};
@@ -25,6 +25,7 @@
 
 #include <QtCore/QEasingCurve>
 #include <QtCore/QFile>
+#include <QtCore/QSaveFile>
 #include <QtCore/QVariantAnimation>
 #include <QtCore/QStandardPaths>
 #include <QtQml/qqml.h>
@@ -307,14 +308,11 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
     // If we've never seen this component id before, setup the index wait lists.
     if (!_waitingReadParamIndexMap.contains(componentId)) {
         // Add all indices to the wait list, parameter index is 0-based
-        for (int waitingIndex=0; waitingIndex<parameterCount; waitingIndex++) {
-            // This will add the new component id, as well as the the new waiting index and set the retry count for that index to 0
-            _waitingReadParamIndexMap[componentId][waitingIndex] = 0;
-        }
+        _waitingReadParamIndexMap[componentId].reset(parameterCount);
 
         // The read and write waiting lists for this component are initialized the empty
-        _waitingReadParamNameMap[componentId] = QMap<QString, int>();
-        _waitingWriteParamNameMap[componentId] = QMap<QString, int>();
+        _waitingReadParamNameMap[componentId] = QHash<QString, int>();
+        _waitingWriteParamNameMap[componentId] = QHash<QString, int>();
 
         qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Seeing component for first time - paramcount:" << parameterCount;
     }
@@ -326,15 +324,14 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
     }
 
     // Remove this parameter from the waiting lists
-    if (_waitingReadParamIndexMap[componentId].contains(parameterIndex)) {
-        _waitingReadParamIndexMap[componentId].remove(parameterIndex);
+    if (_waitingReadParamIndexMap[componentId].remove(parameterIndex)) {
         _indexBatchQueue.removeOne(parameterIndex);
         _fillIndexBatchQueue(false /* waitingParamTimeout */);
     }
     _waitingReadParamNameMap[componentId].remove(parameterName);
     _waitingWriteParamNameMap[componentId].remove(parameterName);
     if (_waitingReadParamIndexMap[componentId].count()) {
-        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap:" << _waitingReadParamIndexMap[componentId];
+        qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap:" << _waitingReadParamIndexMap[componentId].waitingIndices();
     }
     if (_waitingReadParamNameMap[componentId].count()) {
         qCDebug(ParameterManagerVerbose2Log) << _logVehiclePrefix(componentId) << "_waitingReadParamNameMap" << _waitingReadParamNameMap[componentId];
@@ -388,22 +385,9 @@ void ParameterManager::_handleParamValue(int componentId, QString parameterName,
 
     _updateProgressBar();
 
-    Fact* fact = nullptr;
-    if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-        fact = _mapCompId2FactMap[componentId][parameterName];
-    } else {
-        qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
-
-        fact = new Fact(componentId, parameterName, mavTypeToFactType(mavParamType), this);
-        FactMetaData* factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(parameterName, fact->type());
-        fact->setMetaData(factMetaData);
-
-        _mapCompId2FactMap[componentId][parameterName] = fact;
-
-        // We need to know when the fact value changes so we can update the vehicle
-        connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
-
-        emit factAdded(componentId, fact);
+    Fact* fact = _findFact(componentId, parameterName);
+    if (!fact) {
+        fact = _addFact(componentId, parameterName, mavTypeToFactType(mavParamType));
     }
 
     fact->_containerSetRawValue(parameterValue);
@@ -555,10 +539,8 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
             // Add/Update all indices to the wait list, parameter index is 0-based
             if(componentId != MAV_COMP_ID_ALL && componentId != cid)
                 continue;
-            for (int waitingIndex = 0; waitingIndex < _paramCountMap[cid]; waitingIndex++) {
-                // This will add a new waiting index if needed and set the retry count for that index to 0
-                _waitingReadParamIndexMap[cid][waitingIndex] = 0;
-            }
+            // This will add a new waiting index if needed and set the retry count for that index to 0
+            _waitingReadParamIndexMap[cid].reset(_paramCountMap[cid]);
         }
         MAVLinkProtocol*        mavlink = qgcApp()->toolbox()->mavlinkProtocol();
         mavlink_message_t       msg;
@@ -627,14 +609,7 @@ void ParameterManager::refreshParametersPrefix(int componentId, const QString& n
 
 bool ParameterManager::parameterExists(int componentId, const QString& paramName)
 {
-    bool ret = false;
-
-    componentId = _actualComponentId(componentId);
-    if (_mapCompId2FactMap.contains(componentId)) {
-        ret = _mapCompId2FactMap[componentId].contains(_remapParamNameToVersion(paramName));
-    }
-
-    return ret;
+    return _findFact(_actualComponentId(componentId), _remapParamNameToVersion(paramName)) != nullptr;
 }
 
 Fact* ParameterManager::getParameter(int componentId, const QString& paramName)
@@ -642,23 +617,50 @@ Fact* ParameterManager::getParameter(int componentId, const QString& paramName)
     componentId = _actualComponentId(componentId);
 
     QString mappedParamName = _remapParamNameToVersion(paramName);
-    if (!_mapCompId2FactMap.contains(componentId) || !_mapCompId2FactMap[componentId].contains(mappedParamName)) {
+    Fact* fact = _findFact(componentId, mappedParamName);
+    if (!fact) {
         qgcApp()->reportMissingParameter(componentId, mappedParamName);
         return &_defaultFact;
     }
 
-    return _mapCompId2FactMap[componentId][mappedParamName];
+    return fact;
 }
 
 QStringList ParameterManager::parameterNames(int componentId)
 {
-    QStringList names;
+    QStringList names = _mapCompId2FactMap.value(_actualComponentId(componentId)).keys();
+    names.sort();
 
-    for(const QString &paramName: _mapCompId2FactMap[_actualComponentId(componentId)].keys()) {
-        names << paramName;
+    return names;
+}
+
+Fact* ParameterManager::_findFact(int componentId, const QString& paramName) const
+{
+    const auto compIt = _mapCompId2FactMap.constFind(componentId);
+    if (compIt == _mapCompId2FactMap.constEnd()) {
+        return nullptr;
     }
 
-    return names;
+    return compIt->value(paramName, nullptr);
+}
+
+Fact* ParameterManager::_addFact(int componentId, const QString& paramName, FactMetaData::ValueType_t type)
+{
+    qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << paramName;
+
+    Fact* fact = new Fact(componentId, paramName, type, this);
+    FactMetaData* factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(paramName, fact->type());
+    fact->setMetaData(factMetaData);
+
+    // Keyed by the Fact's own name so the hash and the Fact share the string data
+    _mapCompId2FactMap[componentId].insert(fact->name(), fact);
+
+    // We need to know when the fact value changes so we can update the vehicle
+    connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
+
+    emit factAdded(componentId, fact);
+
+    return fact;
 }
 
 /// Requests missing index based parameters from the vehicle.
@@ -681,12 +683,13 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
     }
 
     for(int componentId: _waitingReadParamIndexMap.keys()) {
-        if (_waitingReadParamIndexMap[componentId].count()) {
-            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << _waitingReadParamIndexMap[componentId].count();
-            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << _waitingReadParamIndexMap[componentId];
+        ParameterIndexWaitList& waitList = _waitingReadParamIndexMap[componentId];
+        if (waitList.count()) {
+            qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap count" << waitList.count();
+            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "_waitingReadParamIndexMap" << waitList.waitingIndices();
         }
 
-        for(int paramIndex: _waitingReadParamIndexMap[componentId].keys()) {
+        for (int paramIndex = waitList.nextWaiting(0); paramIndex != -1; paramIndex = waitList.nextWaiting(paramIndex + 1)) {
             if (_indexBatchQueue.contains(paramIndex)) {
                 // Don't add more than once
                 continue;
@@ -696,17 +699,17 @@ bool ParameterManager::_fillIndexBatchQueue(bool waitingParamTimeout)
                 break;
             }
 
-            _waitingReadParamIndexMap[componentId][paramIndex]++;   // Bump retry count
-            if (_disableAllRetries || _waitingReadParamIndexMap[componentId][paramIndex] > _maxInitialLoadRetrySingleParam) {
+            const int retryCount = waitList.bumpRetryCount(paramIndex);
+            if (_disableAllRetries || retryCount > _maxInitialLoadRetrySingleParam) {
                 // Give up on this index
                 _failedReadParamIndexMap[componentId] << paramIndex;
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
-                _waitingReadParamIndexMap[componentId].remove(paramIndex);
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Giving up on (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
+                (void) waitList.remove(paramIndex);
             } else {
                 // Retry again
                 _indexBatchQueue.append(paramIndex);
                 _readParameterRaw(componentId, "", paramIndex);
-                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << _waitingReadParamIndexMap[componentId][paramIndex] << ")";
+                qCDebug(ParameterManagerLog) << _logVehiclePrefix(componentId) << "Read re-request for (paramIndex:" << paramIndex << "retryCount:" << retryCount << ")";
             }
         }
     }
@@ -880,18 +883,152 @@ void ParameterManager::_sendParamSetToVehicle(int componentId, const QString& pa
 
 void ParameterManager::_writeLocalParamCache(int vehicleId, int componentId)
 {
-    CacheMapName2ParamTypeVal cacheMap;
+    const QHash<QString, Fact*>& factMap = _mapCompId2FactMap[componentId];
 
-    for (const QString& paramName: _mapCompId2FactMap[componentId].keys()) {
-        const Fact *fact = _mapCompId2FactMap[componentId][paramName];
-        cacheMap[paramName] = ParamTypeVal(fact->type(), fact->rawValue());
+    // The crc is computed in name order, same as the vehicle does
+    QStringList paramNames = factMap.keys();
+    paramNames.sort();
+
+    QList<ParamCacheEntry> entries;
+    entries.reserve(paramNames.count());
+    for (const QString& paramName: paramNames) {
+        const Fact* fact = factMap[paramName];
+        entries.append({ paramName, fact->type(), fact->rawValue() });
+    }
+
+    QSaveFile cacheFile(parameterCacheFile(vehicleId, componentId));
+    if (!cacheFile.open(QIODevice::WriteOnly)) {
+        qCWarning(ParameterManagerLog) << "Unable to write parameter cache" << cacheFile.fileName() << cacheFile.errorString();
+        return;
+    }
+
+    QDataStream ds(&cacheFile);
+    ds.setByteOrder(QDataStream::LittleEndian);
+    ds << _paramCacheMagic << _paramCacheVersion << _paramCacheCrc(entries) << static_cast<quint32>(entries.count());
+
+    for (const ParamCacheEntry& entry: entries) {
+        const QByteArray name = entry.name.toLatin1();
+
+        quint32 valueBits = 0;
+        switch (entry.type) {
+        case FactMetaData::valueTypeFloat:
+        {
+            const float value = entry.rawValue.toFloat();
+            memcpy(&valueBits, &value, sizeof(valueBits));
+        }
+            break;
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeUint32:
+            valueBits = entry.rawValue.toUInt();
+            break;
+        case FactMetaData::valueTypeInt8:
+        case FactMetaData::valueTypeInt16:
+        case FactMetaData::valueTypeInt32:
+            valueBits = static_cast<quint32>(entry.rawValue.toInt());
+            break;
+        default:
+            qCWarning(ParameterManagerLog) << "Parameter type not supported by cache" << entry.name << entry.type;
+            cacheFile.cancelWriting();
+            return;
+        }
+
+        ds << static_cast<quint8>(entry.type) << static_cast<quint8>(name.length());
+        (void) ds.writeRawData(name.constData(), name.length());
+        ds << valueBits;
     }
 
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (!cacheFile.commit()) {
+        qCWarning(ParameterManagerLog) << "Unable to write parameter cache" << cacheFile.fileName() << cacheFile.errorString();
+    }
+}
+
+bool ParameterManager::_readLocalParamCache(const QString& fileName, quint32& crc, QList<ParamCacheEntry>* entries)
+{
+    QFile cacheFile(fileName);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
 
     QDataStream ds(&cacheFile);
-    ds << cacheMap;
+    ds.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    quint32 count = 0;
+    ds >> magic >> version >> crc >> count;
+    if ((ds.status() != QDataStream::Ok) || (magic != _paramCacheMagic) || (version != _paramCacheVersion)) {
+        qCDebug(ParameterManagerLog) << "Ignoring invalid parameter cache" << fileName;
+        return false;
+    }
+
+    if (!entries) {
+        return true;
+    }
+
+    entries->clear();
+    entries->reserve(count);
+    char name[MAVLINK_MSG_PARAM_VALUE_FIELD_PARAM_ID_LEN];
+    for (quint32 i = 0; i < count; i++) {
+        quint8 type = 0;
+        quint8 nameLength = 0;
+        quint32 valueBits = 0;
+
+        ds >> type >> nameLength;
+        if ((nameLength > sizeof(name)) || (ds.readRawData(name, nameLength) != nameLength)) {
+            return false;
+        }
+        ds >> valueBits;
+        if (ds.status() != QDataStream::Ok) {
+            return false;
+        }
+
+        // Raw values are rebuilt with the same variant types a PARAM_VALUE produces, the crc runs over their bytes
+        QVariant rawValue;
+        switch (type) {
+        case FactMetaData::valueTypeFloat:
+        {
+            float value;
+            memcpy(&value, &valueBits, sizeof(value));
+            rawValue = QVariant(value);
+        }
+            break;
+        case FactMetaData::valueTypeUint32:
+            rawValue = QVariant(valueBits);
+            break;
+        case FactMetaData::valueTypeUint8:
+        case FactMetaData::valueTypeUint16:
+        case FactMetaData::valueTypeInt8:
+        case FactMetaData::valueTypeInt16:
+        case FactMetaData::valueTypeInt32:
+            rawValue = QVariant(static_cast<int>(valueBits));
+            break;
+        default:
+            return false;
+        }
+
+        entries->append({ QString::fromLatin1(name, nameLength), static_cast<FactMetaData::ValueType_t>(type), rawValue });
+    }
+
+    return true;
+}
+
+quint32 ParameterManager::_paramCacheCrc(const QList<ParamCacheEntry>& entries)
+{
+    uint32_t crc32_value = 0;
+
+    for (const ParamCacheEntry& entry: entries) {
+        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(entry.name, entry.type)->volatileValue()) {
+            // Does not take part in CRC
+            qCDebug(ParameterManagerLog) << "Volatile parameter" << entry.name;
+        } else {
+            const void *vdat = entry.rawValue.constData();
+            crc32_value = QGC::crc32((const uint8_t *)qPrintable(entry.name), entry.name.length(),  crc32_value);
+            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(entry.type), crc32_value);
+        }
+    }
+
+    return crc32_value;
 }
 
 QDir ParameterManager::parameterCacheDir()
@@ -902,57 +1039,51 @@ QDir ParameterManager::parameterCacheDir()
 
 QString ParameterManager::parameterCacheFile(int vehicleId, int componentId)
 {
-    return parameterCacheDir().filePath(QString("%1_%2.v2").arg(vehicleId).arg(componentId));
+    return parameterCacheDir().filePath(QString("%1_%2.v3").arg(vehicleId).arg(componentId));
 }
 
 void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVariant hash_value)
 {
     qCInfo(ParameterManagerLog) << "Attemping load from cache";
 
+    const QString cacheFileName = parameterCacheFile(vehicleId, componentId);
+    const bool debugCacheFailure = ParameterManagerDebugCacheFailureLog().isDebugEnabled();
+
+    // The crc the cache was written with is in the header, so a mismatch is found without reading the parameters
     uint32_t crc32_value = 0;
-    /* The datastructure of the cache table */
-    CacheMapName2ParamTypeVal cacheMap;
-    QFile cacheFile(parameterCacheFile(vehicleId, componentId));
-    if (!cacheFile.exists()) {
+    QList<ParamCacheEntry> entries;
+    if (!_readLocalParamCache(cacheFileName, crc32_value, nullptr)) {
         /* no local cache, just wait for them to come in*/
         return;
     }
-    cacheFile.open(QIODevice::ReadOnly);
-
-    /* Deserialize the parameter cache table */
-    QDataStream ds(&cacheFile);
-    ds >> cacheMap;
-
-    /* compute the crc of the local cache to check against the remote */
-
-    for (const QString& name: cacheMap.keys()) {
-        const ParamTypeVal&             paramTypeVal    = cacheMap[name];
-        const FactMetaData::ValueType_t fact_type       = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-
-        if (_vehicle->compInfoManager()->compInfoParam(MAV_COMP_ID_AUTOPILOT1)->factMetaDataForName(name, fact_type)->volatileValue()) {
-            // Does not take part in CRC
-            qCDebug(ParameterManagerLog) << "Volatile parameter" << name;
-        } else {
-            const void *vdat = paramTypeVal.second.constData();
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            crc32_value = QGC::crc32((const uint8_t *)qPrintable(name), name.length(),  crc32_value);
-            crc32_value = QGC::crc32((const uint8_t *)vdat, FactMetaData::typeToSize(fact_type), crc32_value);
-        }
+    const bool crcMatch = (crc32_value == hash_value.toUInt());
+    if ((crcMatch || debugCacheFailure) && !_readLocalParamCache(cacheFileName, crc32_value, &entries)) {
+        qCWarning(ParameterManagerLog) << "Parameter cache is corrupt" << qPrintable(cacheFileName);
+        return;
     }
 
     /* if the two param set hashes match, just load from the disk */
-    if (crc32_value == hash_value.toUInt()) {
-        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
-
-        int count = cacheMap.count();
-        int index = 0;
-        for (const QString& name: cacheMap.keys()) {
-            const ParamTypeVal& paramTypeVal = cacheMap[name];
-            const FactMetaData::ValueType_t fact_type = static_cast<FactMetaData::ValueType_t>(paramTypeVal.first);
-            const MAV_PARAM_TYPE mavParamType = factTypeToMavType(fact_type);
-            _handleParamValue(componentId, name, count, index++, mavParamType, paramTypeVal.second);
+    if (crcMatch) {
+        qCInfo(ParameterManagerLog) << "Parameters loaded from cache" << qPrintable(cacheFileName);
+
+        // Restore all the Facts in one pass instead of replaying each one through _handleParamValue
+        for (const ParamCacheEntry& entry: entries) {
+            Fact* fact = _findFact(componentId, entry.name);
+            if (!fact) {
+                fact = _addFact(componentId, entry.name, entry.type);
+            }
+            fact->_containerSetRawValue(entry.rawValue);
         }
 
+        if (!_paramCountMap.contains(componentId)) {
+            _paramCountMap[componentId] = entries.count();
+            _totalParamCount += entries.count();
+        }
+        _waitingReadParamIndexMap[componentId].clear();
+        (void) _waitingReadParamNameMap[componentId];
+        (void) _waitingWriteParamNameMap[componentId];
+        _checkInitialLoadComplete();
+
         SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
         if (sharedLink) {
             mavlink_param_set_t     p;
@@ -995,12 +1126,12 @@ void ParameterManager::_tryCacheHashLoad(int vehicleId, int componentId, QVarian
 
         ani->start(QAbstractAnimation::DeleteWhenStopped);
     } else {
-        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(QFileInfo(cacheFile).absoluteFilePath());
-        if (ParameterManagerDebugCacheFailureLog().isDebugEnabled()) {
+        qCInfo(ParameterManagerLog) << "Parameters cache match failed" << qPrintable(cacheFileName);
+        if (debugCacheFailure) {
             _debugCacheCRC[componentId] = true;
-            _debugCacheMap[componentId] = cacheMap;
-            for (const QString& name: cacheMap.keys()) {
-                _debugCacheParamSeen[componentId][name] = false;
+            for (const ParamCacheEntry& entry: entries) {
+                _debugCacheMap[componentId][entry.name] = ParamTypeVal(entry.type, entry.rawValue);
+                _debugCacheParamSeen[componentId][entry.name] = false;
             }
             qgcApp()->showAppMessage(tr("Parameter cache CRC match failed"));
         }
@@ -1081,8 +1212,11 @@ void ParameterManager::writeParametersToStream(QTextStream& stream)
     stream << "# Vehicle-Id Component-Id Name Value Type\n";
 
     for (int componentId: _mapCompId2FactMap.keys()) {
-        for (const QString &paramName: _mapCompId2FactMap[componentId].keys()) {
-            Fact* fact = _mapCompId2FactMap[componentId][paramName];
+        const QHash<QString, Fact*>& factMap = _mapCompId2FactMap[componentId];
+        QStringList paramNames = factMap.keys();
+        paramNames.sort();
+        for (const QString &paramName: paramNames) {
+            Fact* fact = factMap.value(paramName);
             if (fact) {
                 stream << _vehicle->id() << "\t" << componentId << "\t" << paramName << "\t" << fact->rawValueStringFullPrecision() << "\t" << QString("%1").arg(factTypeToMavType(fact->type())) << "\n";
             } else {
@@ -1598,22 +1732,9 @@ bool ParameterManager::_parseParamFile(const QString& filename)
                                               ptype == AP_PARAM_INT32 ? FactMetaData::valueTypeInt32 :
                                               FactMetaData::valueTypeFloat);
 
-        Fact* fact = nullptr;
-        if (_mapCompId2FactMap.contains(componentId) && _mapCompId2FactMap[componentId].contains(parameterName)) {
-            fact = _mapCompId2FactMap[componentId][parameterName];
-        } else {
-            qCDebug(ParameterManagerVerbose1Log) << _logVehiclePrefix(componentId) << "Adding new fact" << parameterName;
-
-            fact = new Fact(componentId, parameterName, factType, this);
-            FactMetaData* factMetaData = _vehicle->compInfoManager()->compInfoParam(componentId)->factMetaDataForName(parameterName, fact->type());
-            fact->setMetaData(factMetaData);
-
-            _mapCompId2FactMap[componentId][parameterName] = fact;
-
-            // We need to know when the fact value changes so we can update the vehicle
-            connect(fact, &Fact::_containerRawValueChanged, this, &ParameterManager::_factRawValueUpdated);
-
-            emit factAdded(componentId, fact);
+        Fact* fact = _findFact(componentId, parameterName);
+        if (!fact) {
+            fact = _addFact(componentId, parameterName, factType);
         }
         fact->_containerSetRawValue(parameterValue);
     }
@@ -1622,9 +1743,9 @@ Success:
     /* Create empty waiting lists as we have all parameters */
     _paramCountMap[componentId] = num_params;
     _totalParamCount += num_params;
-    _waitingReadParamIndexMap[componentId] = QMap<int, int>();
-    _waitingReadParamNameMap[componentId] = QMap<QString, int>();
-    _waitingWriteParamNameMap[componentId] = QMap<QString, int>();
+    _waitingReadParamIndexMap[componentId].clear();
+    _waitingReadParamNameMap[componentId] = QHash<QString, int>();
+    _waitingWriteParamNameMap[componentId] = QHash<QString, int>();
     _checkInitialLoadComplete();
     _setLoadProgress(0.0);
     return true;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtCore/QDir>
 #include <QtCore/QTimer>
@@ -19,6 +20,7 @@
 #include "Fact.h"
 #include "FactMetaData.h"
 #include "MAVLinkLib.h"
+#include "ParameterIndexWaitList.h"
 
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose1Log)
 Q_DECLARE_LOGGING_CATEGORY(ParameterManagerVerbose2Log)
@@ -33,6 +35,7 @@ class ParameterManager : public QObject
     Q_OBJECT
 
     friend class ParameterEditorController;
+    friend class ParameterManagerTest;
 
 public:
     /// @param uas Uas which this set of facts is associated with
@@ -110,6 +113,12 @@ private slots:
     void    _factRawValueUpdated                (const QVariant& rawValue);
 
 private:
+    struct ParamCacheEntry {
+        QString                     name;
+        FactMetaData::ValueType_t   type;
+        QVariant                    rawValue;
+    };
+
     void    _handleParamValue                   (int componentId, QString parameterName, int parameterCount, int parameterIndex, MAV_PARAM_TYPE mavParamType, QVariant parameterValue);
     void    _factRawValueUpdateWorker           (int componentId, const QString& name, FactMetaData::ValueType_t valueType, const QVariant& rawValue);
     void    _waitingParamTimeout                (void);
@@ -120,6 +129,9 @@ private:
     void    _sendParamSetToVehicle              (int componentId, const QString& paramName, FactMetaData::ValueType_t valueType, const QVariant& value);
     void    _writeLocalParamCache               (int vehicleId, int componentId);
     void    _tryCacheHashLoad                   (int vehicleId, int componentId, QVariant hash_value);
+    quint32 _paramCacheCrc                      (const QList<ParamCacheEntry>& entries);
+    Fact*   _findFact                           (int componentId, const QString& paramName) const;
+    Fact*   _addFact                            (int componentId, const QString& paramName, FactMetaData::ValueType_t type);
     void    _loadMetaData                       (void);
     void    _clearMetaData                      (void);
     QString _remapParamNameToVersion            (const QString& paramName);
@@ -135,10 +147,16 @@ private:
 
     static QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool failOk = false);
 
+    /// Reads a parameter cache file written by _writeLocalParamCache
+    ///     @param[out] crc PARAM_HASH crc the cache was written with
+    ///     @param[out] entries Cached parameters sorted by name, nullptr to only read the crc
+    /// @return false: file missing or not a valid cache
+    static bool _readLocalParamCache(const QString& fileName, quint32& crc, QList<ParamCacheEntry>* entries);
+
     Vehicle*            _vehicle;
     MAVLinkProtocol*    _mavlink;
 
-    QMap<int /* comp id */, QMap<QString /* parameter name */, Fact*>> _mapCompId2FactMap;
+    QMap<int /* comp id */, QHash<QString /* parameter name */, Fact*>> _mapCompId2FactMap;
 
     double      _loadProgress;                  ///< Parameter load progess, [0.0,1.0]
     bool        _parametersReady;               ///< true: parameter load complete
@@ -169,16 +187,19 @@ private:
     int                 _initialRequestRetryCount;              ///< Current retry count for request list
     static const int    _maxInitialLoadRetrySingleParam = 5;    ///< Maximum retries for initial index based load of a single param
     static const int    _maxReadWriteRetry = 5;                 ///< Maximum retries read/write
+
+    static constexpr quint32 _paramCacheMagic   = 0x43505147;   ///< "QGPC"
+    static constexpr quint16 _paramCacheVersion = 3;
     bool                _disableAllRetries;                     ///< true: Don't retry any requests (used for testing)
 
     bool        _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
     QList<int>  _indexBatchQueue;       ///< The current queue of index re-requests
 
-    QMap<int, int>                  _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
-    QMap<int, QMap<int, int> >      _waitingReadParamIndexMap;  ///< Key: Component id, Value: Map { Key: parameter index still waiting for, Value: retry count }
-    QMap<int, QMap<QString, int> >  _waitingReadParamNameMap;   ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
-    QMap<int, QMap<QString, int> >  _waitingWriteParamNameMap;  ///< Key: Component id, Value: Map { Key: parameter name still waiting for, Value: retry count }
-    QMap<int, QList<int> >          _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
+    QMap<int, int>                      _paramCountMap;             ///< Key: Component id, Value: count of parameters in this component
+    QMap<int, ParameterIndexWaitList>   _waitingReadParamIndexMap;  ///< Key: Component id, Value: parameter indices still waiting for, with retry counts
+    QMap<int, QHash<QString, int> >     _waitingReadParamNameMap;   ///< Key: Component id, Value: Hash { Key: parameter name still waiting for, Value: retry count }
+    QMap<int, QHash<QString, int> >     _waitingWriteParamNameMap;  ///< Key: Component id, Value: Hash { Key: parameter name still waiting for, Value: retry count }
+    QMap<int, QList<int> >              _failedReadParamIndexMap;   ///< Key: Component id, Value: failed parameter index
 
     int _totalParamCount;                       ///< Number of parameters across all components
     int _waitingWriteParamBatchCount = 0;       ///< Number of parameters which are batched up waiting on write responses
@@ -67,6 +67,7 @@ Item {
     property rect   _centerViewport:        Qt.rect(0, 0, width, height)
     property real   _rightPanelWidth:       ScreenTools.defaultFontPixelWidth * 30
     property var    _mapControl:            mapControl
+    property var    _mqttTelemetry:         QGroundControl.mqttManager.telemetry
 
     property real   _fullItemZorder:    0
     property real   _pipItemZorder:     QGroundControl.zOrderWidgets
@@ -127,34 +128,34 @@ Item {
                 Text {
                     id: totalOilQuantityId
                     color: "#FFFFFF"
-                    text: qsTr("全部油量: 0L")
+                    text: qsTr("全部油量: %1L").arg(_mqttTelemetry.totalOilQuantity)
                 }
                 Text {
                     id: remainingOilQuantityId
                     color: "#FFFFFF"
-                    text: qsTr("剩余油量: 0%")
+                    text: qsTr("剩余油量: %1%").arg(_mqttTelemetry.remainingOilQuantity)
                 }
                 Text {
                     id: remainingMileageId
                     color: "#FFFFFF"
-                    text: qsTr("剩余里程: 0Km")
+                    text: qsTr("剩余里程: %1Km").arg(_mqttTelemetry.remainingMileage)
                 }
                 Text {
                     id: drivingMileageId
                     color: "#FFFFFF"
-                    text: qsTr("行驶里程: 0Km")
+                    text: qsTr("行驶里程: %1Km").arg(_mqttTelemetry.drivingMileage)
                 }
                 Row{
                     spacing: 5
                     Text {
                         id: remainingElectricityId
                         color: "#FFFFFF"
-                        text: qsTr("剩余电量: 0%")
+                        text: qsTr("剩余电量: %1%").arg(_mqttTelemetry.remainingElectricity)
                     }
                     Image {
                         id: remainingElectricityImgId
                         anchors.verticalCenter: parent.verticalCenter
-                        visible: false
+                        visible: _mqttTelemetry.valid && _mqttTelemetry.remainingElectricity < 20
                         width: 16
                         height: 16
                         source: "qrc:/qmlimages/Yield.svg"
@@ -166,17 +167,22 @@ Item {
                         id: batteryTemperatureId
                         anchors.verticalCenter: parent.verticalCenter
                         color: "#FFFFFF"
-                        text: qsTr("电池温度: 0°")
+                        text: qsTr("电池温度: %1°").arg(_mqttTelemetry.batteryTemperature)
                     }
                     Image {
                         id: batteryTemperatureImgId
                         anchors.verticalCenter: parent.verticalCenter
-                        visible: false
+                        visible: _mqttTelemetry.valid && _mqttTelemetry.batteryTemperature > 60
                         width: 16
                         height: 16
                         source: "qrc:/qmlimages/Yield.svg"
                     }
                 }
+                Text {
+                    id: joystickLatencyId
+                    color: "#FFFFFF"
+                    text: qsTr("摇杆延迟: %1ms").arg(QGroundControl.mqttManager.joystickLatency.toFixed(0))
+                }
                 Item {
                     width: 10
                     height: 10
@@ -224,38 +230,25 @@ Item {
         }
 
         Connections {
-            target: QGroundControl.mqttManager
-            function onUpdateMessage(data){
-                totalOilQuantityId.text = "全部油量: %1L".arg(data["Oil"]["TotalOilQuantity"])
-                remainingOilQuantityId.text = "剩余油量: %1%".arg(data["Oil"]["RemainingOilQuantity"])
-                remainingMileageId.text = "剩余里程: %1Km".arg(data["Oil"]["RemainingMileage"])
-                drivingMileageId.text = "行驶里程: %1Km".arg(data["Oil"]["DrivingMileage"])
-                remainingElectricityId.text = "剩余电量: %1%".arg(data["Electricity"]["RemainingElectricity"])
-                batteryTemperatureId.text = "电池温度: %1°".arg(data["Electricity"]["BatteryTemperature"])
-
-                // BatteryEMERGENCY.svg
-                if(data["Electricity"]["RemainingElectricity"] < 20){
-                    remainingElectricityImgId.visible = true
-                    if(!remainingElectricityWarn){
-                        mainWindow.showMessageDialog("警告", "电池电量过低！")
-                        remainingElectricityWarn = true
-                    }
-                }else{
-                    remainingElectricityImgId.visible = false
+            target: _mqttTelemetry
+            function onRemainingElectricityChanged() {
+                if (_mqttTelemetry.remainingElectricity < 20 && !remainingElectricityWarn) {
+                    mainWindow.showMessageDialog("警告", "电池电量过低！")
+                    remainingElectricityWarn = true
                 }
-
-                if(data["Electricity"]["BatteryTemperature"] > 60){
-                    batteryTemperatureImgId.visible = true
-                    if(!batteryTemperatureWarn){
-                        mainWindow.showMessageDialog("警告", "电池温度过高！")
-                        batteryTemperatureWarn = true
-                    }
-                }else{
-                    batteryTemperatureImgId.visible = false
+            }
+            function onBatteryTemperatureChanged() {
+                if (_mqttTelemetry.batteryTemperature > 60 && !batteryTemperatureWarn) {
+                    mainWindow.showMessageDialog("警告", "电池温度过高！")
+                    batteryTemperatureWarn = true
                 }
             }
-            function onUpdateLidar(data){
-                lidarImgId.source = data["Lidar"]
+        }
+
+        Connections {
+            target: QGroundControl.mqttManager
+            function onUpdateLidar(sequence){
+                lidarImgId.source = "image://MqttLidar/" + sequence
             }
         }
 
@@ -287,6 +280,7 @@ Item {
             Image {
                 id: lidarImgId
                 anchors.fill: parent
+                cache: false
             }
         }
 
@@ -296,11 +296,11 @@ FlightMap {
     MapItemView {
         model: QGroundControl.adsbVehicleManager.adsbVehicles
         delegate: VehicleMapItem {
-            coordinate:     object.coordinate
-            altitude:       object.altitude
-            callsign:       object.callsign
-            heading:        object.heading
-            alert:          object.alert
+            coordinate:     model.coordinate
+            altitude:       model.altitude
+            callsign:       model.callsign
+            heading:        model.heading
+            alert:          model.alert
             map:            _root
             size:           pipMode ? ScreenTools.defaultFontPixelHeight : ScreenTools.defaultFontPixelHeight * 2.5
             z:              QGroundControl.zOrderVehicles
@@ -413,8 +413,8 @@ Item {
             mapControl:     _root.mapControl
             z:              _zorderDragHandle
             visible:        !_circleMode
-            onDragStart:    _isVertexBeingDragged = true
-            onDragStop:     { _isVertexBeingDragged = false; mapPolygon.verifyClockwiseWinding() }
+            onDragStart:    { _isVertexBeingDragged = true; mapPolygon.vertexDrag = true }
+            onDragStop:     { _isVertexBeingDragged = false; mapPolygon.vertexDrag = false; mapPolygon.verifyClockwiseWinding() }
 
             property int polygonVertex
 
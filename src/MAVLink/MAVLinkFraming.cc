@@ -0,0 +1,104 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFraming.h"
+
+#include <QtCore/QtAlgorithms>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QGC_MAVLINK_FRAMING_SSE2
+#endif
+
+namespace MAVLinkFraming
+{
+
+qsizetype findNextStx(const uint8_t *data, qsizetype size)
+{
+    qsizetype index = 0;
+
+#ifdef QGC_MAVLINK_FRAMING_SSE2
+    const __m128i stx1 = _mm_set1_epi8(static_cast<char>(MAVLINK_STX_MAVLINK1));
+    const __m128i stx2 = _mm_set1_epi8(static_cast<char>(MAVLINK_STX));
+    for (; (index + 16) <= size; index += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, stx1), _mm_cmpeq_epi8(chunk, stx2));
+        const int mask = _mm_movemask_epi8(matches);
+        if (mask != 0) {
+            return index + qCountTrailingZeroBits(static_cast<quint32>(mask));
+        }
+    }
+#endif
+
+    for (; index < size; index++) {
+        if ((data[index] == MAVLINK_STX) || (data[index] == MAVLINK_STX_MAVLINK1)) {
+            return index;
+        }
+    }
+
+    return size;
+}
+
+bool parseNext(mavlink_channel_t channel, const uint8_t *data, qsizetype size, qsizetype &position, mavlink_message_t &message, mavlink_status_t &status)
+{
+    const mavlink_status_t *const channelStatus = mavlink_get_channel_status(channel);
+
+    while (position < size) {
+        if ((channelStatus->parse_state == MAVLINK_PARSE_STATE_IDLE) || (channelStatus->parse_state == MAVLINK_PARSE_STATE_UNINIT)) {
+            position += findNextStx(data + position, size - position);
+            if (position >= size) {
+                break;
+            }
+        }
+
+        if (mavlink_parse_char(channel, data[position++], &message, &status)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+qsizetype frameLength(const uint8_t *data, qsizetype size)
+{
+    qsizetype headerLength = 0;
+    qsizetype signatureLength = 0;
+    uint32_t msgid = 0;
+
+    if ((size >= (MAVLINK_CORE_HEADER_LEN + 1)) && (data[0] == MAVLINK_STX)) {
+        headerLength = MAVLINK_CORE_HEADER_LEN + 1;
+        if (data[2] & MAVLINK_IFLAG_SIGNED) {
+            signatureLength = MAVLINK_SIGNATURE_BLOCK_LEN;
+        }
+        msgid = static_cast<uint32_t>(data[7]) | (static_cast<uint32_t>(data[8]) << 8) | (static_cast<uint32_t>(data[9]) << 16);
+    } else if ((size >= (MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1)) && (data[0] == MAVLINK_STX_MAVLINK1)) {
+        headerLength = MAVLINK_CORE_HEADER_MAVLINK1_LEN + 1;
+        msgid = data[5];
+    } else {
+        return 0;
+    }
+
+    const qsizetype payloadLength = data[1];
+    const qsizetype length = headerLength + payloadLength + MAVLINK_NUM_CHECKSUM_BYTES + signatureLength;
+    if (size < length) {
+        return 0;
+    }
+
+    // Same CRC the channel parser checks, the STX byte is not covered
+    const mavlink_msg_entry_t *const entry = mavlink_get_msg_entry(msgid);
+    uint16_t crc = crc_calculate(data + 1, static_cast<uint16_t>(headerLength - 1 + payloadLength));
+    crc_accumulate(entry ? entry->crc_extra : 0, &crc);
+
+    const uint8_t *const checksum = data + headerLength + payloadLength;
+    const uint16_t frameCrc = static_cast<uint16_t>(checksum[0] | (checksum[1] << 8));
+
+    return (crc == frameCrc) ? length : 0;
+}
+
+} // namespace MAVLinkFraming
@@ -0,0 +1,36 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QtGlobal>
+
+#include "MAVLinkLib.h"
+
+/// Buffer-at-a-time front end to the MAVLink channel parser.
+///
+/// While a channel's parser is idle every byte that is not a start-of-frame marker is discarded by
+/// mavlink_parse_char anyway, so those runs are skipped with a vectorized scan instead of being fed
+/// through the state machine one byte at a time. Frame bodies still go through mavlink_parse_char so
+/// CRC, signing and per-channel statistics behave exactly as before.
+namespace MAVLinkFraming
+{
+    /// @return Index of the first MAVLink 1 or 2 STX byte in data, or size if there is none
+    qsizetype findNextStx(const uint8_t *data, qsizetype size);
+
+    /// Parses data starting at position until one message completes.
+    ///     @param[in,out] position Updated to the byte following the completed message, or to size
+    /// @return true if message holds a newly decoded message
+    bool parseNext(mavlink_channel_t channel, const uint8_t *data, qsizetype size, qsizetype &position, mavlink_message_t &message, mavlink_status_t &status);
+
+    /// Checks for a complete frame with a valid CRC starting at data[0], without touching any channel state.
+    /// Used to walk frames in files where the frame boundaries are known to be close together.
+    /// @return Frame length including the signature, or 0 if there is no valid frame at data
+    qsizetype frameLength(const uint8_t *data, qsizetype size);
+} // namespace MAVLinkFraming
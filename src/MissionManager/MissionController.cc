@@ -33,6 +33,7 @@
 #include "QGC.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QHash>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 
@@ -60,8 +61,12 @@ MissionController::MissionController(PlanMasterController* masterController, QOb
     // The follow is used to compress multiple recalc calls in a row to into a single call.
     connect(this, &MissionController::_recalcMissionFlightStatusSignal, this, &MissionController::_recalcMissionFlightStatus,   Qt::QueuedConnection);
     connect(this, &MissionController::_recalcFlightPathSegmentsSignal,  this, &MissionController::_recalcFlightPathSegments,    Qt::QueuedConnection);
+    connect(this, &MissionController::_recalcMissionFlightStatusItemsSignal, this, &MissionController::_recalcMissionFlightStatusItems, Qt::QueuedConnection);
+    connect(this, &MissionController::_updateFlightPathLinesSignal,     this, &MissionController::_updateFlightPathLines,       Qt::QueuedConnection);
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::_recalcMissionFlightStatusSignal));
+    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::_recalcMissionFlightStatusItemsSignal));
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::_recalcFlightPathSegmentsSignal));
+    qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::_updateFlightPathLinesSignal));
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&MissionController::recalcTerrainProfile));
 }
 
@@ -869,26 +874,27 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
     }
 
     // Fix up the DO_JUMP commands jump sequence number by finding the item with the matching doJumpId
+    QHash<int, int> doJumpIdToSequenceNumber;
+    for (int i=0; i<visualItems->count(); i++) {
+        if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
+            SimpleMissionItem* targetItem = visualItems->value<SimpleMissionItem*>(i);
+            // First item with the id wins
+            if (!doJumpIdToSequenceNumber.contains(targetItem->missionItem().doJumpId())) {
+                doJumpIdToSequenceNumber[targetItem->missionItem().doJumpId()] = targetItem->sequenceNumber();
+            }
+        }
+    }
     for (int i=0; i<visualItems->count(); i++) {
         if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
             SimpleMissionItem* doJumpItem = visualItems->value<SimpleMissionItem*>(i);
             if (doJumpItem->command() == MAV_CMD_DO_JUMP) {
-                bool found = false;
                 int findDoJumpId = static_cast<int>(doJumpItem->missionItem().param1());
-                for (int j=0; j<visualItems->count(); j++) {
-                    if (visualItems->value<VisualMissionItem*>(j)->isSimpleItem()) {
-                        SimpleMissionItem* targetItem = visualItems->value<SimpleMissionItem*>(j);
-                        if (targetItem->missionItem().doJumpId() == findDoJumpId) {
-                            doJumpItem->missionItem().setParam1(targetItem->sequenceNumber());
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-                if (!found) {
+                auto it = doJumpIdToSequenceNumber.constFind(findDoJumpId);
+                if (it == doJumpIdToSequenceNumber.constEnd()) {
                     errorString = tr("Could not find doJumpId: %1").arg(findDoJumpId);
                     return false;
                 }
+                doJumpItem->missionItem().setParam1(it.value());
             }
         }
     }
@@ -1179,14 +1185,21 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.second, &VisualMissionItem::coordinateChanged,     segment,    &FlightPathSegment::setCoordinate2);
     connect(pair.second, &VisualMissionItem::amslEntryAltChanged,   segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_flightStatusItemChanged);
 
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    // Segment altitudes belong to the items at either end of the segment
+    VisualMissionItem* firstItem    = pair.first;
+    VisualMissionItem* secondItem   = pair.second;
+    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       [this, firstItem, secondItem]() { _setFlightStatusDirty(firstItem); _setFlightStatusDirty(secondItem); });
+    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       [this, secondItem]() { _setFlightStatusDirty(secondItem); });
     connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
 
+    connect(segment,    &FlightPathSegment::coordinate1Changed,         this,       &MissionController::_updateFlightPathLinesSignal);
+    connect(segment,    &FlightPathSegment::coordinate2Changed,         this,       &MissionController::_updateFlightPathLinesSignal);
+    connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::_updateFlightPathLinesSignal);
+
     return segment;
 }
 
@@ -1274,6 +1287,9 @@ void MissionController::_recalcFlightPathSegments(void)
     _directionArrows.clear();
     _incompleteComplexItemLines.clearAndDeleteContents();
 
+    // Segments listed here may be deleted below, _updateFlightPathLines repopulates it from the new segments
+    _terrainCollisionSegments.clear();
+
     // Mission Settings item needs to start with no segment
     lastFlyThroughVI->clearSimpleFlighPathSegment();
 
@@ -1443,12 +1459,59 @@ void MissionController::_recalcFlightPathSegments(void)
     }
 
     emit waypointPathChanged();
+    emit _updateFlightPathLinesSignal();
     emit recalcTerrainProfile();
     if (signalSplitSegmentChanged) {
         emit splitSegmentChanged();
     }
 }
 
+/// Rebuilds the plan view line geometry from the current simple flight path segments. Segments which share an end point are
+/// joined into a single polyline so the map draws a handful of lines instead of one MapPolyline per segment, which does not
+/// scale to plans with thousands of items. Segments which collide with terrain are left out of the lines and listed separately
+/// so they can still be drawn highlighted.
+void MissionController::_updateFlightPathLines(void)
+{
+    QVariantList    lines;
+    QVariantList    currentLine;
+    QGeoCoordinate  lastCoord;
+    QObjectList     collisionSegments;
+
+    if (!_flyView) {
+        for (int i=0; i<_simpleFlightPathSegments.count(); i++) {
+            FlightPathSegment* segment = _simpleFlightPathSegments.value<FlightPathSegment*>(i);
+            const QGeoCoordinate coord1 = segment->coordinate1();
+            const QGeoCoordinate coord2 = segment->coordinate2();
+
+            if (!coord1.isValid() || !coord2.isValid()) {
+                continue;
+            }
+            if (segment->terrainCollision()) {
+                collisionSegments.append(segment);
+                continue;
+            }
+
+            if (currentLine.isEmpty() || coord1 != lastCoord) {
+                if (currentLine.count() > 1) {
+                    lines.append(QVariant::fromValue(currentLine));
+                }
+                currentLine.clear();
+                currentLine.append(QVariant::fromValue(coord1));
+            }
+            currentLine.append(QVariant::fromValue(coord2));
+            lastCoord = coord2;
+        }
+        if (currentLine.count() > 1) {
+            lines.append(QVariant::fromValue(currentLine));
+        }
+    }
+
+    (void) _terrainCollisionSegments.swapObjectList(collisionSegments);
+
+    _flightPathLines = lines;
+    emit flightPathLinesChanged();
+}
+
 void MissionController::_updateBatteryInfo(int waypointIndex)
 {
     if (_missionFlightStatus.mAhBattery != 0) {
@@ -1515,8 +1578,7 @@ void MissionController::_recalcMissionFlightStatus()
         return;
     }
 
-    bool                firstCoordinateItem =           true;
-    VisualMissionItem*  lastFlyThroughVI =   qobject_cast<VisualMissionItem*>(_visualItems->get(0));
+    VisualMissionItem*  firstItem = qobject_cast<VisualMissionItem*>(_visualItems->get(0));
 
     bool homePositionValid = _settingsItem->coordinate().isValid();
 
@@ -1527,201 +1589,351 @@ void MissionController::_recalcMissionFlightStatus()
     // both relative altitude.
 
     // No values for first item
-    lastFlyThroughVI->setAltDifference(0);
-    lastFlyThroughVI->setAzimuth(0);
-    lastFlyThroughVI->setDistance(0);
-    lastFlyThroughVI->setDistanceFromStart(0);
+    firstItem->setAltDifference(0);
+    firstItem->setAzimuth(0);
+    firstItem->setDistance(0);
+    firstItem->setDistanceFromStart(0);
 
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
     _resetMissionFlightStatus();
 
-    bool   linkStartToHome =            false;
-    bool   foundRTL =                   false;
-    double totalHorizontalDistance =    0;
+    // A full recalc covers any pending item changes
+    _flightStatusDirtyFirst = _flightStatusDirtyLast = -1;
+
+    FlightStatusWalk_t walk;
+    walk.firstCoordinateItem =      true;
+    walk.lastFlyThroughIndex =      0;
+    walk.linkStartToHome =          false;
+    walk.foundRTL =                 false;
+    walk.totalHorizontalDistance =  0;
 
+    // The walk state prior to each item is kept so a change to a single item can restart the walk from that item
+    _flightStatusSteps.resize(_visualItems->count() + 1);
     for (int i=0; i<_visualItems->count(); i++) {
-        VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
-        SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
-        ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
+        walk.missionFlightStatus = _missionFlightStatus;
+        _flightStatusSteps[i].before = walk;
+        _walkMissionFlightStatusItem(i, walk, _flightStatusSteps[i], homePositionValid);
+    }
+    walk.missionFlightStatus = _missionFlightStatus;
+    _flightStatusSteps.last().before = walk;
+
+    _finishMissionFlightStatus(walk, homePositionValid, 0, _visualItems->count() - 1);
+}
+
+/// Recalculates the flight status starting from the first changed item. The walk stops as soon as it has passed the
+/// changed items and its state matches the cached state again. The remainder of the mission is then only affected by
+/// the change in the running totals, which are shifted instead of recalculated.
+void MissionController::_recalcMissionFlightStatusItems(void)
+{
+    int firstIndex = _flightStatusDirtyFirst;
+    int lastIndex = _flightStatusDirtyLast;
+    _flightStatusDirtyFirst = _flightStatusDirtyLast = -1;
+
+    if (firstIndex < 0) {
+        // Already handled by a full recalc
+        return;
+    }
+
+    const int itemCount = _visualItems->count();
+
+    // Battery change point tracking depends on the whole mission so it always needs a full walk
+    if (firstIndex == 0 || firstIndex >= itemCount || _flightStatusSteps.count() != itemCount + 1 || _flightStatusSteps[0].before.missionFlightStatus.mAhBattery != 0) {
+        _recalcMissionFlightStatus();
+        return;
+    }
+    lastIndex = qMin(lastIndex, itemCount - 1);
+
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatusItems" << firstIndex << lastIndex;
 
-        if (simpleItem && simpleItem->mavCommand() == MAV_CMD_NAV_RETURN_TO_LAUNCH) {
-            foundRTL = true;
+    bool homePositionValid = _settingsItem->coordinate().isValid();
+
+    FlightStatusWalk_t walk = _flightStatusSteps[firstIndex].before;
+    _missionFlightStatus = walk.missionFlightStatus;
+
+    int index = firstIndex;
+    for (; index<itemCount; index++) {
+        walk.missionFlightStatus = _missionFlightStatus;
+
+        // The last fly through item must be unchanged as well since the next segment starts from it
+        if (index > lastIndex && (walk.lastFlyThroughIndex < firstIndex || walk.lastFlyThroughIndex > lastIndex) && _flightStatusWalkConverged(walk, _flightStatusSteps[index].before)) {
+            break;
         }
 
-        // Assume the worst
-        item->setAzimuth(0);
-        item->setDistance(0);
-        item->setDistanceFromStart(0);
+        _flightStatusSteps[index].before = walk;
+        _walkMissionFlightStatusItem(index, walk, _flightStatusSteps[index], homePositionValid);
+    }
 
-        // Gimbal states reflect the state AFTER executing the item
+    if (index < itemCount) {
+        const FlightStatusWalk_t    cachedWalk      = _flightStatusSteps[index].before;
+        const double                horizontalDelta = walk.totalHorizontalDistance - cachedWalk.totalHorizontalDistance;
+        MissionFlightStatus_t       delta;
 
-        // ROI commands cancel out previous gimbal yaw/pitch
-        if (simpleItem) {
-            switch (simpleItem->command()) {
-            case MAV_CMD_NAV_ROI:
-            case MAV_CMD_DO_SET_ROI_LOCATION:
-            case MAV_CMD_DO_SET_ROI_WPNEXT_OFFSET:
-            case MAV_CMD_DO_GIMBAL_MANAGER_PITCHYAW:
-                _missionFlightStatus.gimbalYaw      = qQNaN();
-                _missionFlightStatus.gimbalPitch    = qQNaN();
-                break;
-            default:
-                break;
+        delta.totalDistance     = walk.missionFlightStatus.totalDistance    - cachedWalk.missionFlightStatus.totalDistance;
+        delta.totalTime         = walk.missionFlightStatus.totalTime        - cachedWalk.missionFlightStatus.totalTime;
+        delta.hoverDistance     = walk.missionFlightStatus.hoverDistance    - cachedWalk.missionFlightStatus.hoverDistance;
+        delta.hoverTime         = walk.missionFlightStatus.hoverTime        - cachedWalk.missionFlightStatus.hoverTime;
+        delta.cruiseDistance    = walk.missionFlightStatus.cruiseDistance   - cachedWalk.missionFlightStatus.cruiseDistance;
+        delta.cruiseTime        = walk.missionFlightStatus.cruiseTime       - cachedWalk.missionFlightStatus.cruiseTime;
+
+        qCDebug(MissionControllerLog) << "_recalcMissionFlightStatusItems converged at" << index << "horizontal delta" << horizontalDelta;
+
+        for (int i=index; i<=itemCount; i++) {
+            FlightStatusWalk_t& before = _flightStatusSteps[i].before;
+
+            before.totalHorizontalDistance              += horizontalDelta;
+            before.missionFlightStatus.totalDistance    += delta.totalDistance;
+            before.missionFlightStatus.totalTime        += delta.totalTime;
+            before.missionFlightStatus.hoverDistance    += delta.hoverDistance;
+            before.missionFlightStatus.hoverTime        += delta.hoverTime;
+            before.missionFlightStatus.cruiseDistance   += delta.cruiseDistance;
+            before.missionFlightStatus.cruiseTime       += delta.cruiseTime;
+
+            if (i < itemCount && horizontalDelta != 0 && _flightStatusSteps[i].setsDistanceFromStart) {
+                VisualMissionItem* item = _visualItems->value<VisualMissionItem*>(i);
+                item->setDistanceFromStart(item->distanceFromStart() + horizontalDelta);
             }
         }
 
-        // Look for specific gimbal changes
-        double gimbalYaw = item->specifiedGimbalYaw();
-        if (!qIsNaN(gimbalYaw) || _planViewSettings->showGimbalOnlyWhenSet()->rawValue().toBool()) {
-            _missionFlightStatus.gimbalYaw = gimbalYaw;
-        }
-        double gimbalPitch = item->specifiedGimbalPitch();
-        if (!qIsNaN(gimbalPitch) || _planViewSettings->showGimbalOnlyWhenSet()->rawValue().toBool()) {
-            _missionFlightStatus.gimbalPitch = gimbalPitch;
-        }
-
-        // We don't need to do any more processing if:
-        //  Mission Settings Item
-        //  We are after an RTL command
-        if (i != 0 && !foundRTL) {
-            // We must set the mission flight status prior to querying for any values from the item. This is because things like
-            // current speed, gimbal, vtol state  impact the values.
-            item->setMissionFlightStatus(_missionFlightStatus);
-
-            // Link back to home if first item is takeoff and we have home position
-            if (firstCoordinateItem && simpleItem && (simpleItem->mavCommand() == MAV_CMD_NAV_TAKEOFF || simpleItem->mavCommand() == MAV_CMD_NAV_VTOL_TAKEOFF)) {
-                if (homePositionValid) {
-                    linkStartToHome = true;
-                    if (_controllerVehicle->multiRotor() || _controllerVehicle->vtol()) {
-                        // We have to special case takeoff, assuming vehicle takes off straight up to specified altitude
-                        double azimuth, distance, altDifference;
-                        _calcPrevWaypointValues(_settingsItem, simpleItem, &azimuth, &distance, &altDifference);
-                        double takeoffTime = qAbs(altDifference) / _appSettings->offlineEditingAscentSpeed()->rawValue().toDouble();
-                        _addHoverTime(takeoffTime, 0, -1);
-                    }
+        walk = _flightStatusSteps.last().before;
+        _missionFlightStatus = walk.missionFlightStatus;
+    } else {
+        walk.missionFlightStatus = _missionFlightStatus;
+        _flightStatusSteps.last().before = walk;
+    }
+
+    _finishMissionFlightStatus(walk, homePositionValid, firstIndex, index - 1);
+}
+
+/// Updates the flight status walk with the specified visual item
+///     @param step Updated with the values the item contributes to the mission wide min/max values
+void MissionController::_walkMissionFlightStatusItem(int visualItemIndex, FlightStatusWalk_t& walk, FlightStatusStep_t& step, bool homePositionValid)
+{
+    VisualMissionItem*  item =              qobject_cast<VisualMissionItem*>(_visualItems->get(visualItemIndex));
+    SimpleMissionItem*  simpleItem =        qobject_cast<SimpleMissionItem*>(item);
+    ComplexMissionItem* complexItem =       qobject_cast<ComplexMissionItem*>(item);
+    VisualMissionItem*  lastFlyThroughVI =  qobject_cast<VisualMissionItem*>(_visualItems->get(walk.lastFlyThroughIndex));
+
+    step.maxTelemetryDistance =     0;
+    step.minAMSLAltitude =          qQNaN();
+    step.maxAMSLAltitude =          qQNaN();
+    step.setsDistanceFromStart =    false;
+
+    if (simpleItem && simpleItem->mavCommand() == MAV_CMD_NAV_RETURN_TO_LAUNCH) {
+        walk.foundRTL = true;
+    }
+
+    // Assume the worst
+    item->setAzimuth(0);
+    item->setDistance(0);
+    item->setDistanceFromStart(0);
+
+    // Gimbal states reflect the state AFTER executing the item
+
+    // ROI commands cancel out previous gimbal yaw/pitch
+    if (simpleItem) {
+        switch (simpleItem->command()) {
+        case MAV_CMD_NAV_ROI:
+        case MAV_CMD_DO_SET_ROI_LOCATION:
+        case MAV_CMD_DO_SET_ROI_WPNEXT_OFFSET:
+        case MAV_CMD_DO_GIMBAL_MANAGER_PITCHYAW:
+            _missionFlightStatus.gimbalYaw      = qQNaN();
+            _missionFlightStatus.gimbalPitch    = qQNaN();
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Look for specific gimbal changes
+    double gimbalYaw = item->specifiedGimbalYaw();
+    if (!qIsNaN(gimbalYaw) || _planViewSettings->showGimbalOnlyWhenSet()->rawValue().toBool()) {
+        _missionFlightStatus.gimbalYaw = gimbalYaw;
+    }
+    double gimbalPitch = item->specifiedGimbalPitch();
+    if (!qIsNaN(gimbalPitch) || _planViewSettings->showGimbalOnlyWhenSet()->rawValue().toBool()) {
+        _missionFlightStatus.gimbalPitch = gimbalPitch;
+    }
+
+    // We don't need to do any more processing if:
+    //  Mission Settings Item
+    //  We are after an RTL command
+    if (visualItemIndex != 0 && !walk.foundRTL) {
+        // We must set the mission flight status prior to querying for any values from the item. This is because things like
+        // current speed, gimbal, vtol state  impact the values.
+        item->setMissionFlightStatus(_missionFlightStatus);
+
+        // Link back to home if first item is takeoff and we have home position
+        if (walk.firstCoordinateItem && simpleItem && (simpleItem->mavCommand() == MAV_CMD_NAV_TAKEOFF || simpleItem->mavCommand() == MAV_CMD_NAV_VTOL_TAKEOFF)) {
+            if (homePositionValid) {
+                walk.linkStartToHome = true;
+                if (_controllerVehicle->multiRotor() || _controllerVehicle->vtol()) {
+                    // We have to special case takeoff, assuming vehicle takes off straight up to specified altitude
+                    double azimuth, distance, altDifference;
+                    _calcPrevWaypointValues(_settingsItem, simpleItem, &azimuth, &distance, &altDifference);
+                    double takeoffTime = qAbs(altDifference) / _appSettings->offlineEditingAscentSpeed()->rawValue().toDouble();
+                    _addHoverTime(takeoffTime, 0, -1);
                 }
             }
+        }
 
-            _addTimeDistance(_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor, 0, 0, item->additionalTimeDelay(), 0, -1);
+        _addTimeDistance(_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor, 0, 0, item->additionalTimeDelay(), 0, -1);
 
-            if (item->specifiesCoordinate()) {
+        if (item->specifiesCoordinate()) {
 
-                // Keep track of the min/max AMSL altitude for entire mission so we can calculate altitude percentages in terrain status display
-                if (simpleItem) {
-                    double amslAltitude = item->amslEntryAlt();
-                    _minAMSLAltitude = std::fmin(_minAMSLAltitude, amslAltitude);
-                    _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, amslAltitude);
-                } else {
-                    // Complex item
-                    double complexMinAMSLAltitude = complexItem->minAMSLAltitude();
-                    double complexMaxAMSLAltitude = complexItem->maxAMSLAltitude();
-                    _minAMSLAltitude = std::fmin(_minAMSLAltitude, complexMinAMSLAltitude);
-                    _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, complexMaxAMSLAltitude);
-                }
+            // Keep track of the min/max AMSL altitude for entire mission so we can calculate altitude percentages in terrain status display
+            if (simpleItem) {
+                step.minAMSLAltitude = step.maxAMSLAltitude = item->amslEntryAlt();
+            } else {
+                // Complex item
+                step.minAMSLAltitude = complexItem->minAMSLAltitude();
+                step.maxAMSLAltitude = complexItem->maxAMSLAltitude();
+            }
 
-                if (!item->isStandaloneCoordinate()) {
-                    firstCoordinateItem = false;
+            if (!item->isStandaloneCoordinate()) {
+                walk.firstCoordinateItem = false;
 
-                    // Update vehicle yaw assuming direction to next waypoint and/or mission item change
-                    if (simpleItem) {
-                        double newVehicleYaw = simpleItem->specifiedVehicleYaw();
-                        if (qIsNaN(newVehicleYaw)) {
-                            // No specific vehicle yaw set. Current vehicle yaw is determined from flight path segment direction.
-                            if (simpleItem != lastFlyThroughVI) {
-                                _missionFlightStatus.vehicleYaw = lastFlyThroughVI->exitCoordinate().azimuthTo(simpleItem->coordinate());
-                            }
-                        } else {
-                            _missionFlightStatus.vehicleYaw = newVehicleYaw;
+                // Update vehicle yaw assuming direction to next waypoint and/or mission item change
+                if (simpleItem) {
+                    double newVehicleYaw = simpleItem->specifiedVehicleYaw();
+                    if (qIsNaN(newVehicleYaw)) {
+                        // No specific vehicle yaw set. Current vehicle yaw is determined from flight path segment direction.
+                        if (simpleItem != lastFlyThroughVI) {
+                            _missionFlightStatus.vehicleYaw = lastFlyThroughVI->exitCoordinate().azimuthTo(simpleItem->coordinate());
                         }
-                        simpleItem->setMissionVehicleYaw(_missionFlightStatus.vehicleYaw);
+                    } else {
+                        _missionFlightStatus.vehicleYaw = newVehicleYaw;
                     }
+                    simpleItem->setMissionVehicleYaw(_missionFlightStatus.vehicleYaw);
+                }
 
-                    if (lastFlyThroughVI != _settingsItem || linkStartToHome) {
-                        // This is a subsequent waypoint or we are forcing the first waypoint back to home
-                        double azimuth, distance, altDifference;
+                if (lastFlyThroughVI != _settingsItem || walk.linkStartToHome) {
+                    // This is a subsequent waypoint or we are forcing the first waypoint back to home
+                    double azimuth, distance, altDifference;
 
-                        _calcPrevWaypointValues(item, lastFlyThroughVI, &azimuth, &distance, &altDifference);
-                        totalHorizontalDistance += distance;
-                        item->setAltDifference(altDifference);
-                        item->setAzimuth(azimuth);
-                        item->setDistance(distance);
-                        item->setDistanceFromStart(totalHorizontalDistance);
+                    _calcPrevWaypointValues(item, lastFlyThroughVI, &azimuth, &distance, &altDifference);
+                    walk.totalHorizontalDistance += distance;
+                    item->setAltDifference(altDifference);
+                    item->setAzimuth(azimuth);
+                    item->setDistance(distance);
+                    item->setDistanceFromStart(walk.totalHorizontalDistance);
+                    step.setsDistanceFromStart = true;
 
-                        _missionFlightStatus.maxTelemetryDistance = qMax(_missionFlightStatus.maxTelemetryDistance, _calcDistanceToHome(item, _settingsItem));
+                    step.maxTelemetryDistance = qMax(step.maxTelemetryDistance, _calcDistanceToHome(item, _settingsItem));
 
-                        // Calculate time/distance
-                        double hoverTime = distance / _missionFlightStatus.hoverSpeed;
-                        double cruiseTime = distance / _missionFlightStatus.cruiseSpeed;
-                        _addTimeDistance(_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor, hoverTime, cruiseTime, 0, distance, item->sequenceNumber());
-                    }
+                    // Calculate time/distance
+                    double hoverTime = distance / _missionFlightStatus.hoverSpeed;
+                    double cruiseTime = distance / _missionFlightStatus.cruiseSpeed;
+                    _addTimeDistance(_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor, hoverTime, cruiseTime, 0, distance, item->sequenceNumber());
+                }
 
-                    if (complexItem) {
-                        // Add in distance/time inside complex items as well
-                        double distance = complexItem->complexDistance();
-                        _missionFlightStatus.maxTelemetryDistance = qMax(_missionFlightStatus.maxTelemetryDistance, complexItem->greatestDistanceTo(complexItem->exitCoordinate()));
+                if (complexItem) {
+                    // Add in distance/time inside complex items as well
+                    double distance = complexItem->complexDistance();
+                    step.maxTelemetryDistance = qMax(step.maxTelemetryDistance, complexItem->greatestDistanceTo(complexItem->exitCoordinate()));
 
-                        double hoverTime = distance / _missionFlightStatus.hoverSpeed;
-                        double cruiseTime = distance / _missionFlightStatus.cruiseSpeed;
-                        _addTimeDistance(_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor, hoverTime, cruiseTime, 0, distance, item->sequenceNumber());
+                    double hoverTime = distance / _missionFlightStatus.hoverSpeed;
+                    double cruiseTime = distance / _missionFlightStatus.cruiseSpeed;
+                    _addTimeDistance(_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor, hoverTime, cruiseTime, 0, distance, item->sequenceNumber());
 
-                        totalHorizontalDistance += distance;
-                    }
+                    walk.totalHorizontalDistance += distance;
+                }
 
+                _missionFlightStatus.maxTelemetryDistance = qMax(_missionFlightStatus.maxTelemetryDistance, step.maxTelemetryDistance);
 
-                    lastFlyThroughVI = item;
-                }
+                walk.lastFlyThroughIndex = visualItemIndex;
             }
         }
+    }
 
-        // Speed, VTOL states changes are processed last since they take affect on the next item
+    // Speed, VTOL states changes are processed last since they take affect on the next item
 
-        double newSpeed = item->specifiedFlightSpeed();
-        if (!qIsNaN(newSpeed)) {
-            if (_controllerVehicle->multiRotor()) {
+    double newSpeed = item->specifiedFlightSpeed();
+    if (!qIsNaN(newSpeed)) {
+        if (_controllerVehicle->multiRotor()) {
+            _missionFlightStatus.hoverSpeed = newSpeed;
+        } else if (_controllerVehicle->vtol()) {
+            if (_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor) {
                 _missionFlightStatus.hoverSpeed = newSpeed;
-            } else if (_controllerVehicle->vtol()) {
-                if (_missionFlightStatus.vtolMode == QGCMAVLink::VehicleClassMultiRotor) {
-                    _missionFlightStatus.hoverSpeed = newSpeed;
-                } else {
-                    _missionFlightStatus.cruiseSpeed = newSpeed;
-                }
             } else {
                 _missionFlightStatus.cruiseSpeed = newSpeed;
             }
-            _missionFlightStatus.vehicleSpeed = newSpeed;
+        } else {
+            _missionFlightStatus.cruiseSpeed = newSpeed;
         }
+        _missionFlightStatus.vehicleSpeed = newSpeed;
+    }
 
-        // Update VTOL state
-        if (simpleItem && _controllerVehicle->vtol()) {
-            switch (simpleItem->command()) {
-            case MAV_CMD_NAV_TAKEOFF:       // This will do a fixed wing style takeoff
-            case MAV_CMD_NAV_VTOL_TAKEOFF:  // Vehicle goes straight up and then transitions to FW
-            case MAV_CMD_NAV_LAND:
-                _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassFixedWing;
-                break;
-            case MAV_CMD_NAV_VTOL_LAND:
+    // Update VTOL state
+    if (simpleItem && _controllerVehicle->vtol()) {
+        switch (simpleItem->command()) {
+        case MAV_CMD_NAV_TAKEOFF:       // This will do a fixed wing style takeoff
+        case MAV_CMD_NAV_VTOL_TAKEOFF:  // Vehicle goes straight up and then transitions to FW
+        case MAV_CMD_NAV_LAND:
+            _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassFixedWing;
+            break;
+        case MAV_CMD_NAV_VTOL_LAND:
+            _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassMultiRotor;
+            break;
+        case MAV_CMD_DO_VTOL_TRANSITION:
+        {
+            int transitionState = simpleItem->missionItem().param1();
+            if (transitionState == MAV_VTOL_STATE_MC) {
                 _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassMultiRotor;
-                break;
-            case MAV_CMD_DO_VTOL_TRANSITION:
-            {
-                int transitionState = simpleItem->missionItem().param1();
-                if (transitionState == MAV_VTOL_STATE_MC) {
-                    _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassMultiRotor;
-                } else if (transitionState == MAV_VTOL_STATE_FW) {
-                    _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassFixedWing;
-                }
-            }
-                break;
-            default:
-                break;
+            } else if (transitionState == MAV_VTOL_STATE_FW) {
+                _missionFlightStatus.vtolMode = QGCMAVLink::VehicleClassFixedWing;
             }
         }
+            break;
+        default:
+            break;
+        }
     }
+}
+
+/// @return true if the walk state which affects the items following it matches the cached state. The running totals
+/// are not compared since they only shift the values of the following items.
+bool MissionController::_flightStatusWalkConverged(const FlightStatusWalk_t& walk, const FlightStatusWalk_t& cachedWalk)
+{
+    const MissionFlightStatus_t& status = walk.missionFlightStatus;
+    const MissionFlightStatus_t& cachedStatus = cachedWalk.missionFlightStatus;
+
+    return walk.lastFlyThroughIndex == cachedWalk.lastFlyThroughIndex &&
+            walk.firstCoordinateItem == cachedWalk.firstCoordinateItem &&
+            walk.linkStartToHome == cachedWalk.linkStartToHome &&
+            walk.foundRTL == cachedWalk.foundRTL &&
+            status.vtolMode == cachedStatus.vtolMode &&
+            QGC::fuzzyCompare(status.cruiseSpeed, cachedStatus.cruiseSpeed) &&
+            QGC::fuzzyCompare(status.hoverSpeed, cachedStatus.hoverSpeed) &&
+            QGC::fuzzyCompare(status.vehicleSpeed, cachedStatus.vehicleSpeed) &&
+            QGC::fuzzyCompare(status.vehicleYaw, cachedStatus.vehicleYaw) &&
+            QGC::fuzzyCompare(status.gimbalYaw, cachedStatus.gimbalYaw) &&
+            QGC::fuzzyCompare(status.gimbalPitch, cachedStatus.gimbalPitch);
+}
+
+/// Completes the flight status from the final walk state and signals the new values
+///     @param firstChangedIndex First visual item index which was walked
+///     @param lastChangedIndex Last visual item index which was walked
+void MissionController::_finishMissionFlightStatus(const FlightStatusWalk_t& walk, bool homePositionValid, int firstChangedIndex, int lastChangedIndex)
+{
+    VisualMissionItem* lastFlyThroughVI = qobject_cast<VisualMissionItem*>(_visualItems->get(walk.lastFlyThroughIndex));
+
+    double previousMinAMSLAltitude = _minAMSLAltitude;
+    double previousMaxAMSLAltitude = _maxAMSLAltitude;
+
+    _missionFlightStatus.maxTelemetryDistance = 0;
+    _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
+    for (int i=0; i<_visualItems->count(); i++) {
+        const FlightStatusStep_t& step = _flightStatusSteps[i];
+        _missionFlightStatus.maxTelemetryDistance = qMax(_missionFlightStatus.maxTelemetryDistance, step.maxTelemetryDistance);
+        _minAMSLAltitude = std::fmin(_minAMSLAltitude, step.minAMSLAltitude);
+        _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, step.maxAMSLAltitude);
+    }
+
     lastFlyThroughVI->setMissionVehicleYaw(_missionFlightStatus.vehicleYaw);
 
     // Add the information for the final segment back to home
-    if (foundRTL && lastFlyThroughVI != _settingsItem && homePositionValid) {
+    if (walk.foundRTL && lastFlyThroughVI != _settingsItem && homePositionValid) {
         double azimuth, distance, altDifference;
         _calcPrevWaypointValues(lastFlyThroughVI, _settingsItem, &azimuth, &distance, &altDifference);
 
@@ -1736,7 +1948,7 @@ void MissionController::_recalcMissionFlightStatus()
         _missionFlightStatus.batteryChangePoint = 0;
     }
 
-    if (linkStartToHome) {
+    if (walk.linkStartToHome) {
         // Home position is taken into account for min/max values
         _minAMSLAltitude = std::fmin(_minAMSLAltitude, _settingsItem->plannedHomePositionAltitude()->rawValue().toDouble());
         _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, _settingsItem->plannedHomePositionAltitude()->rawValue().toDouble());
@@ -1754,9 +1966,15 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
+    // Altitude percentages are relative to the mission min/max so all items need updating if those changed
+    if (!QGC::fuzzyCompare(_minAMSLAltitude, previousMinAMSLAltitude) || !QGC::fuzzyCompare(_maxAMSLAltitude, previousMaxAMSLAltitude)) {
+        firstChangedIndex = 0;
+        lastChangedIndex = _visualItems->count() - 1;
+    }
+
     // Walk the list again calculating altitude percentages
     double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    for (int i=firstChangedIndex; i<=lastChangedIndex; i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1784,6 +2002,26 @@ void MissionController::_recalcMissionFlightStatus()
     emit recalcTerrainProfile();
 }
 
+/// Marks the visual item as needing a flight status recalc
+void MissionController::_setFlightStatusDirty(VisualMissionItem* visualItem)
+{
+    int index = _visualItems ? _visualItems->indexOf(visualItem) : -1;
+    if (index < 0) {
+        // Unknown item, recalc everything
+        index = 0;
+    }
+
+    _flightStatusDirtyFirst = _flightStatusDirtyFirst == -1 ? index : qMin(_flightStatusDirtyFirst, index);
+    _flightStatusDirtyLast = qMax(_flightStatusDirtyLast, index);
+
+    emit _recalcMissionFlightStatusItemsSignal();
+}
+
+void MissionController::_flightStatusItemChanged(void)
+{
+    _setFlightStatusDirty(qobject_cast<VisualMissionItem*>(sender()));
+}
+
 // This will update the sequence numbers to be sequential starting from 0
 void MissionController::_recalcSequence(void)
 {
@@ -1804,6 +2042,43 @@ void MissionController::_recalcSequence(void)
     _inRecalcSequence = false;
 }
 
+/// Updates the sequence numbers of the items starting at the specified index. The items prior to the index as well as
+/// the items following the first one already numbered correctly must have ascending sequence numbers.
+void MissionController::_recalcSequenceFrom(int visualItemIndex)
+{
+    if (_inRecalcSequence || visualItemIndex <= 0) {
+        return;
+    }
+
+    _inRecalcSequence = true;
+    int sequenceNumber = _visualItems->value<VisualMissionItem*>(visualItemIndex - 1)->lastSequenceNumber() + 1;
+    for (int i=visualItemIndex; i<_visualItems->count(); i++) {
+        VisualMissionItem* item = _visualItems->value<VisualMissionItem*>(i);
+        if (item->sequenceNumber() == sequenceNumber) {
+            // Everything from here on is already in sequence
+            break;
+        }
+        item->setSequenceNumber(sequenceNumber);
+        sequenceNumber = item->lastSequenceNumber() + 1;
+    }
+    _inRecalcSequence = false;
+}
+
+void MissionController::_itemLastSequenceNumberChanged(void)
+{
+    if (_inRecalcSequence) {
+        return;
+    }
+
+    // Only the items following the changed item need to be renumbered
+    int index = _visualItems->indexOf(sender());
+    if (index < 0) {
+        _recalcSequence();
+    } else {
+        _recalcSequenceFrom(index + 1);
+    }
+}
+
 // This will update the child item hierarchy
 void MissionController::_recalcChildItems(void)
 {
@@ -1870,6 +2145,10 @@ void MissionController::_recalcAllWithCoordinate(const QGeoCoordinate& coordinat
     }
     _recalcSequence();
     _recalcChildItems();
+
+    // Items were added or removed so the cached flight status walk no longer lines up with the visual items
+    _flightStatusSteps.clear();
+
     emit _recalcFlightPathSegmentsSignal();
     _updateTimer.start(UPDATE_TIMEOUT);
 }
@@ -1940,14 +2219,14 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     setDirty(false);
 
     connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_flightStatusItemChanged);
+    connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_itemLastSequenceNumberChanged);
 
     if (visualItem->isSimpleItem()) {
         // We need to track commandChanged on simple item since recalc has special handling for takeoff command
@@ -1960,10 +2239,10 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_flightStatusItemChanged);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_flightStatusItemChanged);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_flightStatusItemChanged);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_flightStatusItemChanged);
             connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
         } else {
             qWarning() << "ComplexMissionItem not found";
@@ -77,6 +77,8 @@ public:
     Q_PROPERTY(QmlObjectListModel*  visualItems                     READ visualItems                    NOTIFY visualItemsChanged)
     Q_PROPERTY(QmlObjectListModel*  simpleFlightPathSegments        READ simpleFlightPathSegments       CONSTANT)                               ///< Used by Plan view only for interactive editing
     Q_PROPERTY(QVariantList         waypointPath                    READ waypointPath                   NOTIFY waypointPathChanged)             ///< Used by Fly view only for static display
+    Q_PROPERTY(QVariantList         flightPathLines                 READ flightPathLines                NOTIFY flightPathLinesChanged)          ///< Used by Plan view: simpleFlightPathSegments joined into polylines, one per run of connected segments
+    Q_PROPERTY(QmlObjectListModel*  terrainCollisionSegments        READ terrainCollisionSegments       CONSTANT)                               ///< Used by Plan view: segments from simpleFlightPathSegments which collide with terrain
     Q_PROPERTY(QmlObjectListModel*  directionArrows                 READ directionArrows                CONSTANT)
     Q_PROPERTY(QmlObjectListModel*  incompleteComplexItemLines      READ incompleteComplexItemLines     CONSTANT)                               ///< Segments which are not yet completed.
     Q_PROPERTY(QStringList          complexMissionItemNames         READ complexMissionItemNames        NOTIFY complexMissionItemNamesChanged)
@@ -227,6 +229,8 @@ public:
     QmlObjectListModel* directionArrows             (void) { return &_directionArrows; }
     QmlObjectListModel* incompleteComplexItemLines  (void) { return &_incompleteComplexItemLines; }
     QVariantList        waypointPath                (void) { return _waypointPath; }
+    QVariantList        flightPathLines             (void) { return _flightPathLines; }
+    QmlObjectListModel* terrainCollisionSegments    (void) { return &_terrainCollisionSegments; }
     QStringList         complexMissionItemNames     (void) const;
     QGeoCoordinate      plannedHomePosition         (void) const;
     VisualMissionItem*  currentPlanViewItem         (void) const { return _currentPlanViewItem; }
@@ -265,6 +269,7 @@ public:
 signals:
     void visualItemsChanged                 (void);
     void waypointPathChanged                (void);
+    void flightPathLinesChanged             (void);
     void splitSegmentChanged                (void);
     void newItemsFromVehicle                (void);
     void missionDistanceChanged             (double missionDistance);
@@ -300,7 +305,9 @@ signals:
     void maxAMSLAltitudeChanged             (double maxAMSLAltitude);
     void recalcTerrainProfile               (void);
     void _recalcMissionFlightStatusSignal   (void);
+    void _recalcMissionFlightStatusItemsSignal(void);
     void _recalcFlightPathSegmentsSignal    (void);
+    void _updateFlightPathLinesSignal       (void);
     void globalAltitudeModeChanged          (void);
 
 private slots:
@@ -309,7 +316,11 @@ private slots:
     void _inProgressChanged                     (bool inProgress);
     void _currentMissionIndexChanged            (int sequenceNumber);
     void _recalcFlightPathSegments              (void);
+    void _updateFlightPathLines                 (void);
     void _recalcMissionFlightStatus             (void);
+    void _recalcMissionFlightStatusItems        (void);
+    void _flightStatusItemChanged               (void);
+    void _itemLastSequenceNumberChanged         (void);
     void _updateContainsItems                   (void);
     void _progressPctChanged                    (double progressPct);
     void _visualItemsDirtyChanged               (bool dirty);
@@ -322,8 +333,28 @@ private slots:
     void _takeoffItemNotRequiredChanged         (void);
 
 private:
+    /// Running state of the flight status walk over the visual items
+    typedef struct {
+        MissionFlightStatus_t       missionFlightStatus;
+        double                      totalHorizontalDistance;
+        int                         lastFlyThroughIndex;    ///< Visual item index of the last fly through item
+        bool                        firstCoordinateItem;
+        bool                        linkStartToHome;
+        bool                        foundRTL;
+    } FlightStatusWalk_t;
+
+    /// Flight status walk cache entry for a single visual item
+    typedef struct {
+        FlightStatusWalk_t          before;                 ///< Walk state prior to processing the item
+        double                      maxTelemetryDistance;   ///< Greatest distance to home reached by the item
+        double                      minAMSLAltitude;        ///< NaN for no altitude
+        double                      maxAMSLAltitude;        ///< NaN for no altitude
+        bool                        setsDistanceFromStart;  ///< true: item was given a distance from start
+    } FlightStatusStep_t;
+
     void                    _init                               (void);
     void                    _recalcSequence                     (void);
+    void                    _recalcSequenceFrom                 (int visualItemIndex);
     void                    _recalcChildItems                   (void);
     void                    _recalcAllWithCoordinate            (const QGeoCoordinate& coordinate);
     void                    _recalcROISpecialVisuals            (void);
@@ -344,6 +375,9 @@ private:
     void                    _scanForAdditionalSettings          (QmlObjectListModel* visualItems, PlanMasterController* masterController);
     void                    _setPlannedHomePositionFromFirstCoordinate(const QGeoCoordinate& clickCoordinate);
     void                    _resetMissionFlightStatus           (void);
+    void                    _walkMissionFlightStatusItem        (int visualItemIndex, FlightStatusWalk_t& walk, FlightStatusStep_t& step, bool homePositionValid);
+    void                    _finishMissionFlightStatus          (const FlightStatusWalk_t& walk, bool homePositionValid, int firstChangedIndex, int lastChangedIndex);
+    void                    _setFlightStatusDirty               (VisualMissionItem* visualItem);
     void                    _addHoverTime                       (double hoverTime, double hoverDistance, int waypointIndex);
     void                    _addCruiseTime                      (double cruiseTime, double cruiseDistance, int wayPointIndex);
     void                    _updateBatteryInfo                  (int waypointIndex);
@@ -360,6 +394,7 @@ private:
     void                    _firstItemAdded                     (void);
 
     static double           _calcDistanceToHome                 (VisualMissionItem* currentItem, VisualMissionItem* homeItem);
+    static bool             _flightStatusWalkConverged          (const FlightStatusWalk_t& walk, const FlightStatusWalk_t& cachedWalk);
     static double           _normalizeLat                       (double lat);
     static double           _normalizeLon                       (double lon);
     static bool             _convertToMissionItems              (QmlObjectListModel* visualMissionItems, QList<MissionItem*>& rgMissionItems, QObject* missionItemParent);
@@ -374,6 +409,8 @@ private:
     PlanViewSettings*           _planViewSettings =             nullptr;
     QmlObjectListModel          _simpleFlightPathSegments;
     QVariantList                _waypointPath;
+    QVariantList                _flightPathLines;
+    QmlObjectListModel          _terrainCollisionSegments;
     QmlObjectListModel          _directionArrows;
     QmlObjectListModel          _incompleteComplexItemLines;
     FlightPathSegmentHashTable  _flightPathSegmentHashTable;
@@ -381,6 +418,9 @@ private:
     bool                        _itemsRequested =               false;
     bool                        _inRecalcSequence =             false;
     MissionFlightStatus_t       _missionFlightStatus;
+    QList<FlightStatusStep_t>   _flightStatusSteps;                                 ///< One entry per visual item plus the final walk state, empty if invalid
+    int                         _flightStatusDirtyFirst =       -1;                 ///< First visual item index needing flight status recalc, -1 for none
+    int                         _flightStatusDirtyLast =        -1;
     AppSettings*                _appSettings =                  nullptr;
     double                      _progressPct =                  0;
     int                         _currentPlanViewSeqNum =        -1;
@@ -421,4 +461,6 @@ private:
     static constexpr const char* _jsonMavAutopilotKey =           "MAV_AUTOPILOT";
 
     static constexpr int   _missionFileVersion =            2;
+
+    friend class MissionControllerTest;
 };
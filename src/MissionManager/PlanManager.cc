@@ -13,8 +13,12 @@
 #include "MAVLinkProtocol.h"
 #include "QGCApplication.h"
 #include "MissionCommandTree.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
 #include "QGCLoggingCategory.h"
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
 PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
@@ -34,6 +38,8 @@ PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
     _ackTimeoutTimer->setSingleShot(true);
 
     connect(_ackTimeoutTimer, &QTimer::timeout, this, &PlanManager::_ackTimeout);
+
+    _transferClock.start();
 }
 
 PlanManager::~PlanManager()
@@ -56,6 +62,7 @@ void PlanManager::_writeMissionItemsWorker(void)
     }
 
     _retryCount = 0;
+    _setTransferWindow();
     _setTransactionInProgress(TransactionWrite);
     _connectToMavlink();
     _writeMissionCount();
@@ -137,6 +144,7 @@ void PlanManager::loadFromVehicle(void)
     }
 
     _retryCount = 0;
+    _setTransferWindow();
     _setTransactionInProgress(TransactionRead);
     _connectToMavlink();
     _requestList();
@@ -148,6 +156,8 @@ void PlanManager::_requestList(void)
     qCDebug(PlanManagerLog) << QStringLiteral("_requestList %1 _planType:_retryCount").arg(_planTypeString()) << _planType << _retryCount;
 
     _itemIndicesToRead.clear();
+    _missionRequestMSecs.clear();
+    _missionRequestsResent.clear();
     _clearMissionItems();
 
     SharedLinkInterfacePtr  sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
@@ -193,6 +203,9 @@ void PlanManager::_ackTimeout(void)
         if (_retryCount > _maxRetryCount) {
             _sendError(MaxRetryExceeded, tr("Mission read failed, maximum retries exceeded."));
             _finishTransaction(false);
+        } else if (_transferWindow > 1) {
+            // Retries are counted per request
+            _retryMissionItemWindow();
         } else {
             _retryCount++;
             qCDebug(PlanManagerLog) << tr("Retrying %1 MISSION_REQUEST retry Count").arg(_planTypeString()) << _retryCount;
@@ -247,7 +260,7 @@ void PlanManager::_startAckTimeout(AckType_t ack)
     switch (ack) {
     case AckMissionItem:
         // We are actively trying to get the mission item, so we don't want to wait as long.
-        _ackTimeoutTimer->setInterval(_retryTimeoutMilliseconds);
+        _ackTimeoutTimer->setInterval(_missionItemRetryTimeoutMSecs());
         break;
     case AckNone:
         // FALLTHROUGH
@@ -290,7 +303,14 @@ bool PlanManager::_checkForExpectedAck(AckType_t receivedAck)
 void PlanManager::_readTransactionComplete(void)
 {
     qCDebug(PlanManagerLog) << "_readTransactionComplete read sequence complete";
-    
+
+    if (_transferWindow > 1) {
+        // Items in a windowed read arrive in whatever order the replies come back
+        std::sort(_missionItems.begin(), _missionItems.end(), [](const MissionItem* a, const MissionItem* b) {
+            return a->sequenceNumber() < b->sequenceNumber();
+        });
+    }
+
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         mavlink_message_t       message;
@@ -342,7 +362,12 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
             _itemIndicesToRead << i;
         }
         _missionItemCountToRead = missionCount.count;
-        _requestNextMissionItem();
+        _itemsReadCount = 0;
+        if (_transferWindow > 1) {
+            _requestMissionItemWindow();
+        } else {
+            _requestNextMissionItem();
+        }
     }
 }
 
@@ -355,6 +380,73 @@ void PlanManager::_requestNextMissionItem(void)
 
     qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
 
+    _sendMissionRequest(_itemIndicesToRead[0]);
+    _startAckTimeout(AckMissionItem);
+}
+
+/// Keeps up to _transferWindow requests in flight, lowest sequence numbers first
+void PlanManager::_requestMissionItemWindow(void)
+{
+    for (int i=0; i<_itemIndicesToRead.count() && _missionRequestMSecs.count() < _transferWindow; i++) {
+        const int sequenceNumber = _itemIndicesToRead[i];
+        if (!_missionRequestMSecs.contains(sequenceNumber)) {
+            _sendMissionRequest(sequenceNumber);
+        }
+    }
+    _startMissionItemWindowTimeout();
+}
+
+/// Sends again the requests which have gone unanswered for a full retry timeout since they were last sent
+void PlanManager::_retryMissionItemWindow(void)
+{
+    const qint64 nowMSecs = _transferClock.elapsed();
+    const int retryTimeoutMSecs = _missionItemRetryTimeoutMSecs();
+
+    QList<int> sequenceNumbers;
+    for (auto it = _missionRequestMSecs.cbegin(); it != _missionRequestMSecs.cend(); ++it) {
+        if ((nowMSecs - it.value()) >= retryTimeoutMSecs) {
+            sequenceNumbers.append(it.key());
+        }
+    }
+    std::sort(sequenceNumbers.begin(), sequenceNumbers.end());
+
+    qCDebug(PlanManagerLog) << QStringLiteral("_retryMissionItemWindow %1 sequenceNumbers:").arg(_planTypeString()) << sequenceNumbers;
+
+    for (const int sequenceNumber : sequenceNumbers) {
+        if (_missionRequestsResent.value(sequenceNumber) > _maxRetryCount) {
+            _sendError(MaxRetryExceeded, tr("Mission read failed, maximum retries exceeded."));
+            _finishTransaction(false);
+            return;
+        }
+    }
+
+    for (const int sequenceNumber : sequenceNumbers) {
+        _sendMissionRequest(sequenceNumber);
+    }
+    _startMissionItemWindowTimeout();
+}
+
+/// Times out when the oldest unanswered request has waited a full retry timeout. A reply to one request must not push
+/// back the timeout of the others.
+void PlanManager::_startMissionItemWindowTimeout(void)
+{
+    qint64 oldestSentMSecs = _transferClock.elapsed();
+    for (const qint64 sentMSecs : std::as_const(_missionRequestMSecs)) {
+        oldestSentMSecs = qMin(oldestSentMSecs, sentMSecs);
+    }
+
+    _startAckTimeout(AckMissionItem);
+    const qint64 remainingMSecs = (oldestSentMSecs + _missionItemRetryTimeoutMSecs()) - _transferClock.elapsed();
+    _ackTimeoutTimer->start(static_cast<int>(qMax<qint64>(0, remainingMSecs)));
+}
+
+void PlanManager::_sendMissionRequest(int sequenceNumber)
+{
+    if (_missionRequestMSecs.contains(sequenceNumber)) {
+        _missionRequestsResent[sequenceNumber]++;
+    }
+    _missionRequestMSecs[sequenceNumber] = _transferClock.elapsed();
+
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         mavlink_message_t       message;
@@ -365,11 +457,41 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  sequenceNumber,
                                                   _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
-    _startAckTimeout(AckMissionItem);
+}
+
+/// Updates the round trip estimate from the reply to a read request
+void PlanManager::_missionRequestAnswered(int sequenceNumber)
+{
+    auto it = _missionRequestMSecs.find(sequenceNumber);
+    if (it == _missionRequestMSecs.end()) {
+        return;
+    }
+
+    // There is no telling which send a reply to a resent request belongs to, so those are not sampled
+    if (!_missionRequestsResent.remove(sequenceNumber)) {
+        const double roundTripMSecs = _transferClock.elapsed() - it.value();
+        if (qFuzzyIsNull(_smoothedRoundTripMSecs)) {
+            _smoothedRoundTripMSecs = roundTripMSecs;
+        } else {
+            _smoothedRoundTripMSecs = ((7.0 * _smoothedRoundTripMSecs) + roundTripMSecs) / 8.0;
+        }
+    }
+    _missionRequestMSecs.erase(it);
+}
+
+/// Waiting less than a round trip for an item only sends duplicate requests, twice the smoothed round trip leaves room for jitter
+int PlanManager::_missionItemRetryTimeoutMSecs(void) const
+{
+    return qMax(_retryTimeoutMilliseconds, qRound(2.0 * _smoothedRoundTripMSecs));
+}
+
+void PlanManager::_setTransferWindow(void)
+{
+    _transferWindow = qMax(1, qgcApp()->toolbox()->settingsManager()->appSettings()->missionTransferWindow()->rawValue().toInt());
 }
 
 void PlanManager::_handleMissionItem(const mavlink_message_t& message)
@@ -439,6 +561,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
+        _missionRequestAnswered(seq);
 
         MissionItem* item = new MissionItem(seq,
                                             command,
@@ -463,15 +586,28 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     } else {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 mission item received item index which was not requested, disregrarding:").arg(_planTypeString()) << seq;
         // We have to put the ack timeout back since it was removed above
-        _startAckTimeout(AckMissionItem);
+        if (_transferWindow > 1) {
+            _startMissionItemWindowTimeout();
+        } else {
+            _startAckTimeout(AckMissionItem);
+        }
         return;
     }
 
-    emit progressPctChanged((double)seq / (double)_missionItemCountToRead);
-    
+    _itemsReadCount++;
+    if (_transferWindow > 1) {
+        // Replies don't arrive in sequence order, so progress comes from how many are in
+        emit progressPctChanged((double)_itemsReadCount / (double)_missionItemCountToRead);
+    } else {
+        emit progressPctChanged((double)seq / (double)_missionItemCountToRead);
+    }
+
     _retryCount = 0;
     if (_itemIndicesToRead.count() == 0) {
+        qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 read complete window:smoothedRoundTripMSecs").arg(_planTypeString()) << _transferWindow << _smoothedRoundTripMSecs;
         _readTransactionComplete();
+    } else if (_transferWindow > 1) {
+        _requestMissionItemWindow();
     } else {
         _requestNextMissionItem();
     }
@@ -512,14 +648,19 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
         return;
     }
 
-    emit progressPctChanged((double)missionRequestSeq / (double)_writeMissionItems.count());
-
     _lastMissionRequest = missionRequestSeq;
     if (!_itemIndicesToWrite.contains(missionRequestSeq)) {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequence number requested which has already been sent, sending again:").arg(_planTypeString()) << missionRequestSeq;
     } else {
         _itemIndicesToWrite.removeOne(missionRequestSeq);
     }
+
+    if (_transferWindow > 1) {
+        // A vehicle may request ahead, so progress comes from how many items have been sent
+        emit progressPctChanged((double)(_writeMissionItems.count() - _itemIndicesToWrite.count()) / (double)_writeMissionItems.count());
+    } else {
+        emit progressPctChanged((double)missionRequestSeq / (double)_writeMissionItems.count());
+    }
     
     MissionItem* item = _writeMissionItems[missionRequestSeq];
     qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
@@ -808,6 +949,8 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
 
     _itemIndicesToRead.clear();
     _itemIndicesToWrite.clear();
+    _missionRequestMSecs.clear();
+    _missionRequestsResent.clear();
 
     // First thing we do is clear the transaction. This way inProgesss is off when we signal transaction complete.
     TransactionType_t currentTransactionType = _transactionInProgress;
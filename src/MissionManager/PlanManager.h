@@ -11,6 +11,9 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QLoggingCategory>
 
 #include "MissionItem.h"
@@ -22,10 +25,17 @@ Q_DECLARE_LOGGING_CATEGORY(PlanManagerLog)
 
 /// The PlanManager class is the base class for the Mission, GeoFence and Rally Point managers. All of which use the
 /// new mavlink v2 mission protocol.
+///
+/// Reads normally request one item at a time. With AppSettings::missionTransferWindow above 1 up to that many
+/// MISSION_REQUEST_INT are kept in flight. Each request times out on its own, measured from when it was last sent, and
+/// only the requests which timed out are sent again. Writes are driven by the vehicle's requests, which are answered in
+/// whatever order they arrive.
 class PlanManager : public QObject
 {
     Q_OBJECT
 
+    friend class MissionManagerTest;
+
 public:
     PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType);
     ~PlanManager();
@@ -114,6 +124,13 @@ protected:
     void _handleMissionRequest(const mavlink_message_t& message);
     void _handleMissionAck(const mavlink_message_t& message);
     void _requestNextMissionItem(void);
+    void _requestMissionItemWindow(void);
+    void _retryMissionItemWindow(void);
+    void _startMissionItemWindowTimeout(void);
+    void _sendMissionRequest(int sequenceNumber);
+    void _missionRequestAnswered(int sequenceNumber);
+    int  _missionItemRetryTimeoutMSecs(void) const;
+    void _setTransferWindow(void);
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -144,6 +161,12 @@ protected:
     QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be requested from vehicle
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
     int                 _missionItemCountToRead;///< Count of all mission items to read
+    int                 _transferWindow =       1;  ///< Maximum MISSION_REQUEST_INT in flight during a read
+    QHash<int, qint64>  _missionRequestMSecs;       ///< Unanswered read requests, sequence number -> time last sent
+    QHash<int, int>     _missionRequestsResent;     ///< Unanswered read requests which have been sent more than once, sequence number -> resend count
+    QElapsedTimer       _transferClock;
+    double              _smoothedRoundTripMSecs = 0;///< Smoothed request to item time, 0 until the first sample
+    int                 _itemsReadCount =       0;  ///< Number of items received in the current read
 
     QList<MissionItem*> _missionItems;          ///< Set of mission items on vehicle
     QList<MissionItem*> _writeMissionItems;     ///< Set of mission items currently being written to vehicle
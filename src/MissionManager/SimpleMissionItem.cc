@@ -591,11 +591,43 @@ void SimpleMissionItem::_rebuildComboBoxFacts(void)
 
 void SimpleMissionItem::_rebuildFacts(void)
 {
+    if (!_editorFactsBuilt) {
+        // Nothing is showing the editor for this item yet
+        return;
+    }
+
     _rebuildTextFieldFacts();
     _rebuildNaNFacts();
     _rebuildComboBoxFacts();
 }
 
+void SimpleMissionItem::_buildEditorFacts(void)
+{
+    // Fly view items never show an editor so their param meta data is not set up
+    if (!_editorFactsBuilt && !_flyView) {
+        _editorFactsBuilt = true;
+        _rebuildFacts();
+    }
+}
+
+QmlObjectListModel* SimpleMissionItem::textFieldFacts(void)
+{
+    _buildEditorFacts();
+    return &_textFieldFacts;
+}
+
+QmlObjectListModel* SimpleMissionItem::nanFacts(void)
+{
+    _buildEditorFacts();
+    return &_nanFacts;
+}
+
+QmlObjectListModel* SimpleMissionItem::comboboxFacts(void)
+{
+    _buildEditorFacts();
+    return &_comboboxFacts;
+}
+
 bool SimpleMissionItem::friendlyEditAllowed(void) const
 {
     const MissionCommandUIInfo* uiInfo = MissionCommandTree::instance()->getUIInfo(_controllerVehicle, _previousVTOLMode, static_cast<MAV_CMD>(command()));
@@ -639,7 +671,7 @@ void SimpleMissionItem::setDirty(bool dirty)
 {
     if (!_homePositionSpecialCase || (_dirty != dirty)) {
         _dirty = dirty;
-        if (!dirty) {
+        if (!dirty && _cameraSection) {
             _cameraSection->setDirty(false);
             _speedSection->setDirty(false);
         }
@@ -861,7 +893,8 @@ void SimpleMissionItem::setSequenceNumber(int sequenceNumber)
 
 double SimpleMissionItem::specifiedFlightSpeed(void)
 {
-    if (_speedSection->specifyFlightSpeed()) {
+    // Sections which have not been created yet can't be specifying anything
+    if (_speedSection && _speedSection->specifyFlightSpeed()) {
         return _speedSection->flightSpeed()->rawValue().toDouble();
     } else {
         return missionItem().specifiedFlightSpeed();
@@ -870,12 +903,12 @@ double SimpleMissionItem::specifiedFlightSpeed(void)
 
 double SimpleMissionItem::specifiedGimbalYaw(void)
 {
-    return _cameraSection->available() ? _cameraSection->specifiedGimbalYaw() : missionItem().specifiedGimbalYaw();
+    return (_cameraSection && _cameraSection->available()) ? _cameraSection->specifiedGimbalYaw() : missionItem().specifiedGimbalYaw();
 }
 
 double SimpleMissionItem::specifiedGimbalPitch(void)
 {
-    return _cameraSection->available() ? _cameraSection->specifiedGimbalPitch() : missionItem().specifiedGimbalPitch();
+    return (_cameraSection && _cameraSection->available()) ? _cameraSection->specifiedGimbalPitch() : missionItem().specifiedGimbalPitch();
 }
 
 double SimpleMissionItem::specifiedVehicleYaw(void)
@@ -894,6 +927,19 @@ bool SimpleMissionItem::scanForSections(QmlObjectListModel* visualItems, int sca
 {
     bool sectionFound = false;
 
+    if (!_cameraSection) {
+        // Sections are only available on waypoints and only ever pick up the non-coordinate items which follow them.
+        // Don't create the sections just to find out there is nothing for them.
+        if (static_cast<MAV_CMD>(command()) != MAV_CMD_NAV_WAYPOINT || scanIndex >= visualItems->count()) {
+            return false;
+        }
+        SimpleMissionItem* nextItem = visualItems->value<SimpleMissionItem*>(scanIndex);
+        if (!nextItem || nextItem->specifiesCoordinate()) {
+            return false;
+        }
+        _createOptionalSections();
+    }
+
     if (_cameraSection->available()) {
         sectionFound |= _cameraSection->scanForSection(visualItems, scanIndex);
     }
@@ -904,19 +950,41 @@ bool SimpleMissionItem::scanForSections(QmlObjectListModel* visualItems, int sca
     return sectionFound;
 }
 
+CameraSection* SimpleMissionItem::cameraSection(void)
+{
+    _createOptionalSections();
+    return _cameraSection;
+}
+
+SpeedSection* SimpleMissionItem::speedSection(void)
+{
+    _createOptionalSections();
+    return _speedSection;
+}
+
 void SimpleMissionItem::_updateOptionalSections(void)
 {
-    // Remove previous sections
+    // Sections are created on first use. Only existing sections need to be rebuilt for the new command.
     if (_cameraSection) {
         _cameraSection->deleteLater();
         _cameraSection = nullptr;
-    }
-    if (_speedSection) {
         _speedSection->deleteLater();
         _speedSection = nullptr;
+
+        _createOptionalSections();
+
+        emit cameraSectionChanged(_cameraSection);
+        emit speedSectionChanged(_speedSection);
     }
 
-    // Add new sections
+    emit lastSequenceNumberChanged(lastSequenceNumber());
+}
+
+void SimpleMissionItem::_createOptionalSections(void)
+{
+    if (_cameraSection) {
+        return;
+    }
 
     _cameraSection = new CameraSection(_masterController, this);
     _speedSection = new SpeedSection(_masterController, this);
@@ -925,6 +993,10 @@ void SimpleMissionItem::_updateOptionalSections(void)
         _speedSection->setAvailable(true);
     }
 
+    _applySectionDefaults();
+    _cameraSection->setDirty(false);
+    _speedSection->setDirty(false);
+
     connect(_cameraSection, &CameraSection::dirtyChanged,                   this, &SimpleMissionItem::_sectionDirtyChanged);
     connect(_cameraSection, &CameraSection::itemCountChanged,               this, &SimpleMissionItem::_updateLastSequenceNumber);
     connect(_cameraSection, &CameraSection::availableChanged,               this, &SimpleMissionItem::specifiedGimbalYawChanged);
@@ -935,10 +1007,6 @@ void SimpleMissionItem::_updateOptionalSections(void)
     connect(_speedSection,  &SpeedSection::dirtyChanged,                this, &SimpleMissionItem::_sectionDirtyChanged);
     connect(_speedSection,  &SpeedSection::itemCountChanged,            this, &SimpleMissionItem::_updateLastSequenceNumber);
     connect(_speedSection,  &SpeedSection::specifiedFlightSpeedChanged, this, &SimpleMissionItem::specifiedFlightSpeedChanged);
-
-    emit cameraSectionChanged(_cameraSection);
-    emit speedSectionChanged(_speedSection);
-    emit lastSequenceNumberChanged(lastSequenceNumber());
 }
 
 int SimpleMissionItem::lastSequenceNumber(void) const
@@ -965,8 +1033,10 @@ void SimpleMissionItem::appendMissionItems(QList<MissionItem*>& items, QObject*
     items.append(new MissionItem(missionItem(), missionItemParent));
     seqNum++;
 
-    _cameraSection->appendSectionItems(items, missionItemParent, seqNum);
-    _speedSection->appendSectionItems(items, missionItemParent, seqNum);
+    if (_cameraSection) {
+        _cameraSection->appendSectionItems(items, missionItemParent, seqNum);
+        _speedSection->appendSectionItems(items, missionItemParent, seqNum);
+    }
 }
 
 void SimpleMissionItem::applyNewAltitude(double newAltitude)
@@ -992,15 +1062,26 @@ void SimpleMissionItem::setMissionFlightStatus(MissionController::MissionFlightS
     VisualMissionItem::setMissionFlightStatus(missionFlightStatus);
 
     // If speed and/or gimbal are not specifically set on this item. Then use the flight status values as initial defaults should a user turn them on.
-    if (_speedSection->available() && !_speedSection->specifyFlightSpeed() && !QGC::fuzzyCompare(_speedSection->flightSpeed()->rawValue().toDouble(), missionFlightStatus.vehicleSpeed)) {
-        _speedSection->flightSpeed()->setRawValue(missionFlightStatus.vehicleSpeed);
+    // Sections which don't exist yet pick these up when they are created.
+    _sectionDefaultFlightSpeed  = missionFlightStatus.vehicleSpeed;
+    _sectionDefaultGimbalYaw    = missionFlightStatus.gimbalYaw;
+    _sectionDefaultGimbalPitch  = missionFlightStatus.gimbalPitch;
+    if (_cameraSection) {
+        _applySectionDefaults();
+    }
+}
+
+void SimpleMissionItem::_applySectionDefaults(void)
+{
+    if (_speedSection->available() && !_speedSection->specifyFlightSpeed() && !qIsNaN(_sectionDefaultFlightSpeed) && !QGC::fuzzyCompare(_speedSection->flightSpeed()->rawValue().toDouble(), _sectionDefaultFlightSpeed)) {
+        _speedSection->flightSpeed()->setRawValue(_sectionDefaultFlightSpeed);
     }
     if (_cameraSection->available() && !_cameraSection->specifyGimbal()) {
-        if (!qIsNaN(missionFlightStatus.gimbalYaw) && !QGC::fuzzyCompare(_cameraSection->gimbalYaw()->rawValue().toDouble(), missionFlightStatus.gimbalYaw)) {
-            _cameraSection->gimbalYaw()->setRawValue(missionFlightStatus.gimbalYaw);
+        if (!qIsNaN(_sectionDefaultGimbalYaw) && !QGC::fuzzyCompare(_cameraSection->gimbalYaw()->rawValue().toDouble(), _sectionDefaultGimbalYaw)) {
+            _cameraSection->gimbalYaw()->setRawValue(_sectionDefaultGimbalYaw);
         }
-        if (!qIsNaN(missionFlightStatus.gimbalPitch) && !QGC::fuzzyCompare(_cameraSection->gimbalPitch()->rawValue().toDouble(), missionFlightStatus.gimbalPitch)) {
-            _cameraSection->gimbalPitch()->setRawValue(missionFlightStatus.gimbalPitch);
+        if (!qIsNaN(_sectionDefaultGimbalPitch) && !QGC::fuzzyCompare(_cameraSection->gimbalPitch()->rawValue().toDouble(), _sectionDefaultGimbalPitch)) {
+            _cameraSection->gimbalPitch()->setRawValue(_sectionDefaultGimbalPitch);
         }
     }
 }
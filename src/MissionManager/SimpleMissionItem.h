@@ -78,12 +78,13 @@ public:
     bool            showLoiterRadius    (void) const;
     double          loiterRadius        (void) const;
 
-    CameraSection*  cameraSection       (void) { return _cameraSection; }
-    SpeedSection*   speedSection        (void) { return _speedSection; }
+    /// Sections are created on first access, items loaded without camera/speed commands never pay for them
+    CameraSection*  cameraSection       (void);
+    SpeedSection*   speedSection        (void);
 
-    QmlObjectListModel* textFieldFacts  (void) { return &_textFieldFacts; }
-    QmlObjectListModel* nanFacts        (void) { return &_nanFacts; }
-    QmlObjectListModel* comboboxFacts   (void) { return &_comboboxFacts; }
+    QmlObjectListModel* textFieldFacts  (void);
+    QmlObjectListModel* nanFacts        (void);
+    QmlObjectListModel* comboboxFacts   (void);
 
     void setRawEdit(bool rawEdit);
     void setAltitudeMode(QGroundControlQmlGlobal::AltMode altitudeMode);
@@ -171,6 +172,9 @@ private:
     void _connectSignals        (void);
     void _setupMetaData         (void);
     void _updateOptionalSections(void);
+    void _createOptionalSections(void);
+    void _applySectionDefaults  (void);
+    void _buildEditorFacts      (void);
     void _rebuildNaNFacts       (void);
     void _rebuildComboBoxFacts  (void);
 
@@ -181,6 +185,12 @@ private:
     QGeoCoordinate  _mapCenterHint;
     SpeedSection*   _speedSection =             nullptr;
     CameraSection*  _cameraSection =             nullptr;
+    bool            _editorFactsBuilt =         false;  ///< Editor fact lists are only built once the editor asks for them
+
+    // Flight status values used as the initial section settings, held here until the sections are created
+    double          _sectionDefaultFlightSpeed =    qQNaN();
+    double          _sectionDefaultGimbalYaw =      qQNaN();
+    double          _sectionDefaultGimbalPitch =    qQNaN();
 
     bool _syncingHeadingDegreesAndParam4 = false;   ///< true: already in a sync signal, prevents signal loop
 
@@ -21,8 +21,13 @@
 #include "QGCLoggingCategory.h"
 
 #include <QtGui/QPolygonF>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QJsonArray>
 #include <QtCore/QLineF>
+#include <QtCore/QThread>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(SurveyComplexItemLog, "SurveyComplexItemLog")
 
@@ -60,6 +65,7 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
 
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::isValidChanged,             this, &SurveyComplexItem::_updateWizardMode);
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::traceModeChanged,           this, &SurveyComplexItem::_updateWizardMode);
+    connect(&_transectsJobWatcher,      &QFutureWatcher<Transects_t>::finished,     this, &SurveyComplexItem::_transectsJobFinished);
 
     if (!kmlOrShpFile.isEmpty()) {
         _surveyAreaPolygon.loadKMLOrSHPFile(kmlOrShpFile);
@@ -68,8 +74,16 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     setDirty(false);
 }
 
+SurveyComplexItem::~SurveyComplexItem()
+{
+    // The job works on its own copy of the parameters, so there is no need to wait for it
+    _transectsJob.cancel();
+}
+
 void SurveyComplexItem::save(QJsonArray&  planItems)
 {
+    _finishTransectsJob();
+
     QJsonObject saveObject;
 
     _saveCommon(saveObject);
@@ -348,39 +362,38 @@ bool SurveyComplexItem::_loadV3(const QJsonObject& complexObject, int sequenceNu
 }
 
 /// Reverse the order of the transects. First transect becomes last and so forth.
-void SurveyComplexItem::_reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects)
+///     @param transectCoords Entry and exit coordinate of each transect, one after the other
+void SurveyComplexItem::_reverseTransectOrder(QList<QGeoCoordinate>& transectCoords)
 {
-    QList<QList<QGeoCoordinate>> rgReversedTransects;
-    for (int i=transects.count() - 1; i>=0; i--) {
-        rgReversedTransects.append(transects[i]);
-    }
-    transects = rgReversedTransects;
+    // Reversing the whole array reverses the transects and the points within them, so flip the points back
+    std::reverse(transectCoords.begin(), transectCoords.end());
+    _reverseInternalTransectPoints(transectCoords);
 }
 
 /// Reverse the order of all points withing each transect, First point becomes last and so forth.
-void SurveyComplexItem::_reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects)
+///     @param transectCoords Entry and exit coordinate of each transect, one after the other
+void SurveyComplexItem::_reverseInternalTransectPoints(QList<QGeoCoordinate>& transectCoords)
 {
-    for (int i=0; i<transects.count(); i++) {
-        QList<QGeoCoordinate> rgReversedCoords;
-        QList<QGeoCoordinate>& rgOriginalCoords = transects[i];
-        for (int j=rgOriginalCoords.count()-1; j>=0; j--) {
-            rgReversedCoords.append(rgOriginalCoords[j]);
-        }
-        transects[i] = rgReversedCoords;
+    for (qsizetype i=0; i+1<transectCoords.count(); i+=2) {
+        transectCoords.swapItemsAt(i, i + 1);
     }
 }
 
 /// Reorders the transects such that the first transect is the shortest distance to the specified coordinate
 /// and the first point within that transect is the shortest distance to the specified coordinate.
 ///     @param distanceCoord Coordinate to measure distance against
-///     @param transects Transects to test and reorder
-void SurveyComplexItem::_optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects)
+///     @param transectCoords Entry and exit coordinate of each transect to test and reorder
+void SurveyComplexItem::_optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QGeoCoordinate>& transectCoords)
 {
+    if (transectCoords.count() < 2) {
+        return;
+    }
+
     double rgTransectDistance[4];
-    rgTransectDistance[0] = transects.first().first().distanceTo(distanceCoord);
-    rgTransectDistance[1] = transects.first().last().distanceTo(distanceCoord);
-    rgTransectDistance[2] = transects.last().first().distanceTo(distanceCoord);
-    rgTransectDistance[3] = transects.last().last().distanceTo(distanceCoord);
+    rgTransectDistance[0] = transectCoords[0].distanceTo(distanceCoord);
+    rgTransectDistance[1] = transectCoords[1].distanceTo(distanceCoord);
+    rgTransectDistance[2] = transectCoords[transectCoords.count() - 2].distanceTo(distanceCoord);
+    rgTransectDistance[3] = transectCoords.last().distanceTo(distanceCoord);
 
     int shortestIndex = 0;
     double shortestDistance = rgTransectDistance[0];
@@ -393,11 +406,11 @@ void SurveyComplexItem::_optimizeTransectsForShortestDistance(const QGeoCoordina
 
     if (shortestIndex > 1) {
         // We need to reverse the order of segments
-        _reverseTransectOrder(transects);
+        _reverseTransectOrder(transectCoords);
     }
     if (shortestIndex & 1) {
         // We need to reverse the points within each segment
-        _reverseInternalTransectPoints(transects);
+        _reverseInternalTransectPoints(transectCoords);
     }
 }
 
@@ -426,32 +439,32 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QGeoCoordinate>& transectCoords)
 {
-    if (transects.count() == 0) {
+    if (transectCoords.count() == 0) {
         return;
     }
 
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
     if (reversePoints) {
         qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Reverse Points";
-        _reverseInternalTransectPoints(transects);
+        _reverseInternalTransectPoints(transectCoords);
     }
     if (reverseTransects) {
         qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Reverse Transects";
-        _reverseTransectOrder(transects);
+        _reverseTransectOrder(transectCoords);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transectCoords.first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -526,50 +539,89 @@ void SurveyComplexItem::_intersectLinesWithRect(const QList<QLineF>& lineList, c
     }
 }
 
-void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines)
+void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines, const QPromise<Transects_t>* promise)
 {
     resultLines.clear();
 
-    for (int i=0; i<lineList.count(); i++) {
-        const QLineF& line = lineList[i];
-        QList<QPointF> intersections;
-
-        // Intersect the line with all the polygon edges
-        for (int j=0; j<polygon.count()-1; j++) {
-            QPointF intersectPoint;
-            QLineF polygonLine = QLineF(polygon[j], polygon[j+1]);
-
-            auto intersect = line.intersects(polygonLine, &intersectPoint);
-            if (intersect == QLineF::BoundedIntersection) {
-                if (!intersections.contains(intersectPoint)) {
-                    intersections.append(intersectPoint);
-                }
+    const auto intersectRange = [&lineList, &polygon, promise](qsizetype first, qsizetype last, QList<QLineF>& lines) {
+        for (qsizetype i=first; i<last; i++) {
+            if (promise && promise->isCanceled()) {
+                return;
+            }
+            QLineF resultLine;
+            if (_intersectLineWithPolygon(lineList[i], polygon, resultLine)) {
+                lines.append(resultLine);
             }
         }
+    };
 
-        // We now have one or more intersection points all along the same line. Find the two
-        // which are furthest away from each other to form the transect.
-        if (intersections.count() > 1) {
-            QPointF firstPoint;
-            QPointF secondPoint;
-            double currentMaxDistance = 0;
-
-            for (int i=0; i<intersections.count(); i++) {
-                for (int j=0; j<intersections.count(); j++) {
-                    QLineF lineTest(intersections[i], intersections[j]);
-                    \
-                    double newMaxDistance = lineTest.length();
-                    if (newMaxDistance > currentMaxDistance) {
-                        firstPoint = intersections[i];
-                        secondPoint = intersections[j];
-                        currentMaxDistance = newMaxDistance;
-                    }
-                }
-            }
+    // Every line is tested against every polygon edge, so large fields with finely traced boundaries are split across the pool
+    const qsizetype chunkCount = qBound<qsizetype>(1, lineList.count() / _minTransectLinesPerChunk, QThread::idealThreadCount() * 4);
+    if (chunkCount == 1) {
+        intersectRange(0, lineList.count(), resultLines);
+        return;
+    }
 
-            resultLines += QLineF(firstPoint, secondPoint);
+    QList<qsizetype> chunkStarts;
+    chunkStarts.reserve(chunkCount);
+    const qsizetype chunkSize = (lineList.count() + chunkCount - 1) / chunkCount;
+    for (qsizetype start=0; start<lineList.count(); start+=chunkSize) {
+        chunkStarts.append(start);
+    }
+
+    const QList<QList<QLineF>> chunkLines = QtConcurrent::blockingMapped<QList<QList<QLineF>>>(chunkStarts, [&lineList, chunkSize, &intersectRange](qsizetype start) {
+        QList<QLineF> lines;
+        intersectRange(start, qMin(start + chunkSize, lineList.count()), lines);
+        return lines;
+    });
+
+    resultLines.reserve(lineList.count());
+    for (const QList<QLineF>& lines : chunkLines) {
+        resultLines.append(lines);
+    }
+}
+
+/// Intersects the line with all the polygon edges
+///     @param resultLine Set to the transect between the two intersections which are furthest apart
+///     @return false: Line intersects the polygon at less than two distinct points
+bool SurveyComplexItem::_intersectLineWithPolygon(const QLineF& line, const QPolygonF& polygon, QLineF& resultLine)
+{
+    // All the intersections are on the line, so the two furthest apart are the ones with the smallest and largest
+    // projection onto it. Tracking those avoids comparing every pair of intersections.
+    const QPointF direction = line.p2() - line.p1();
+    QPointF minPoint;
+    QPointF maxPoint;
+    double minProjection = 0;
+    double maxProjection = 0;
+    int minEdge = -1;
+    int maxEdge = -1;
+
+    for (int j=0; j<polygon.count()-1; j++) {
+        QPointF intersectPoint;
+        if (line.intersects(QLineF(polygon[j], polygon[j+1]), &intersectPoint) != QLineF::BoundedIntersection) {
+            continue;
+        }
+
+        const double projection = QPointF::dotProduct(intersectPoint - line.p1(), direction);
+        if ((minEdge < 0) || (projection < minProjection)) {
+            minPoint = intersectPoint;
+            minProjection = projection;
+            minEdge = j;
+        }
+        if ((maxEdge < 0) || (projection > maxProjection)) {
+            maxPoint = intersectPoint;
+            maxProjection = projection;
+            maxEdge = j;
         }
     }
+
+    if ((minEdge < 0) || (minPoint == maxPoint)) {
+        return false;
+    }
+
+    // The transect starts at whichever end was hit first walking the polygon edges
+    resultLine = (minEdge <= maxEdge) ? QLineF(minPoint, maxPoint) : QLineF(maxPoint, minPoint);
+    return true;
 }
 
 /// Adjust the line segments such that they are all going the same direction with respect to going from P1->P2
@@ -629,51 +681,168 @@ double SurveyComplexItem::_turnaroundDistance(void) const
 
 void SurveyComplexItem::_rebuildTransectsPhase1(void)
 {
-    _rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-    if (_refly90DegreesFact.rawValue().toBool()) {
-        _rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
+    // A synchronous rebuild supersedes whatever is still being built in the background
+    _cancelTransectsJob();
+
+    if (_ignoreRecalc) {
+        return;
     }
+
+    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
+    _clearLoadedMissionItems();
+
+    _transects = _buildTransects(_transectParams());
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+bool SurveyComplexItem::_rebuildTransectsPhase1InBackground(void)
 {
-    if (_ignoreRecalc) {
+    // Only worth it while the polygon is being edited. Everything else expects the transects to be ready on return.
+    if (!_surveyAreaEditActive() || (_surveyAreaPolygon.count() < 3)) {
+        return false;
+    }
+
+    _clearLoadedMissionItems();
+
+    // Only the latest edit matters, anything still running for an earlier one is thrown away
+    _transectsJob.cancel();
+    _transectsJob = QtConcurrent::run(&SurveyComplexItem::_buildTransectsJob, _transectParams());
+    _transectsJobPending = true;
+    _transectsJobWatcher.setFuture(_transectsJob);
+
+    return true;
+}
+
+void SurveyComplexItem::_transectsJobFinished(void)
+{
+    _applyTransectsJobResult();
+}
+
+bool SurveyComplexItem::_surveyAreaEditActive(void) const
+{
+    return _surveyAreaPolygon.centerDrag() || _surveyAreaPolygon.vertexDrag() || _surveyAreaPolygon.traceMode();
+}
+
+void SurveyComplexItem::_cancelTransectsJob(void)
+{
+    if (_transectsJobPending) {
+        _transectsJobPending = false;
+        _transectsJob.cancel();
+    }
+}
+
+/// Waits for the background rebuild of the latest edit and applies it. Only for save and upload, which need the
+/// transects of the latest edit. Everything else picks up the result from _transectsJobFinished.
+void SurveyComplexItem::_finishTransectsJob(void)
+{
+    if (_transectsJobPending) {
+        _transectsJob.waitForFinished();
+        _applyTransectsJobResult();
+    }
+}
+
+void SurveyComplexItem::_applyTransectsJobResult(void)
+{
+    if (!_transectsJobPending || _transectsJob.isCanceled() || (_transectsJob.resultCount() == 0)) {
         return;
     }
+    _transectsJobPending = false;
 
-    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
+    _transects = _transectsJob.result();
+    _rebuildTransectsPhase2();
+}
+
+void SurveyComplexItem::_clearLoadedMissionItems(void)
+{
     if (_loadedMissionItemsParent) {
         _loadedMissionItems.clear();
         _loadedMissionItemsParent->deleteLater();
         _loadedMissionItemsParent = nullptr;
     }
+}
 
-    if (_surveyAreaPolygon.count() < 3) {
-        return;
+SurveyComplexItem::TransectParams_t SurveyComplexItem::_transectParams(void) const
+{
+    TransectParams_t params;
+
+    params.polygon                  = _surveyAreaPolygon.coordinateList();
+    params.gridAngle                = _gridAngleFact.rawValue().toDouble();
+    params.gridSpacing              = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    params.entryPoint               = _entryPoint;
+    params.refly90Degrees           = _refly90DegreesFact.rawValue().toBool();
+    params.flyAlternateTransects    = _flyAlternateTransectsFact.rawValue().toBool();
+    params.hoverAndCapture          = triggerCamera() && hoverAndCaptureEnabled();
+    params.triggerDistance          = triggerDistance();
+    params.turnAroundDistance       = _turnAroundDistanceFact.rawValue().toDouble();
+
+    return params;
+}
+
+void SurveyComplexItem::_buildTransectsJob(QPromise<Transects_t>& promise, const TransectParams_t& params)
+{
+    Transects_t transects = _buildTransects(params, &promise);
+    if (!promise.isCanceled()) {
+        promise.addResult(std::move(transects));
+    }
+}
+
+SurveyComplexItem::Transects_t SurveyComplexItem::_buildTransects(const TransectParams_t& params, const QPromise<Transects_t>* promise)
+{
+    Transects_t transects;
+
+    if (params.polygon.count() < 3) {
+        return transects;
     }
 
     // Convert polygon to NED
 
-    QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
+    const QGeoCoordinate tangentOrigin = params.polygon.first();
+    qCDebug(SurveyComplexItemLog) << "_buildTransects Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+
+    QPolygonF polygon;
+    polygon.reserve(params.polygon.count() + 1);
+    for (int i=0; i<params.polygon.count(); i++) {
         double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
         if (i == 0) {
             // This avoids a nan calculation that comes out of convertGeoToNed
             x = y = 0;
         } else {
-            QGCGeo::convertGeoToNed(vertex, tangentOrigin, y, x, down);
+            QGCGeo::convertGeoToNed(params.polygon[i], tangentOrigin, y, x, down);
         }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
+        polygon << QPointF(x, y);
     }
+    polygon << polygon.first();
 
-    // Generate transects
+    for (const bool refly : { false, true }) {
+        if (refly && (!params.refly90Degrees || transects.isEmpty())) {
+            break;
+        }
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+        const QList<QLineF> lines = _buildTransectLines(params, polygon, refly, promise);
+        if (promise && promise->isCanceled()) {
+            return Transects_t();
+        }
+
+        // Convert from NED to Geo
+        QList<QGeoCoordinate> transectCoords;
+        transectCoords.reserve(lines.count() * 2);
+        for (const QLineF& line : lines) {
+            QGeoCoordinate coord;
+            QGCGeo::convertNedToGeo(line.p1().y(), line.p1().x(), 0, tangentOrigin, coord);
+            transectCoords.append(coord);
+            QGCGeo::convertNedToGeo(line.p2().y(), line.p2().x(), 0, tangentOrigin, coord);
+            transectCoords.append(coord);
+        }
+
+        _appendTransectPass(params, refly, transectCoords, transects);
+    }
+
+    return transects;
+}
+
+QList<QLineF> SurveyComplexItem::_buildTransectLines(const TransectParams_t& params, const QPolygonF& polygon, bool refly, const QPromise<Transects_t>* promise)
+{
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
     if (gridSpacing < 0.5) {
         // We can't let gridSpacing get too small otherwise we will end up with too many transects.
         // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
@@ -683,19 +852,10 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
 
     gridAngle = _clampGridAngle90(gridAngle);
     gridAngle += refly ? 90 : 0;
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Clamped grid angle" << gridAngle;
-
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 gridSpacing:gridAngle:refly" << gridSpacing << gridAngle << refly;
+    qCDebug(SurveyComplexItemLog) << "_buildTransectLines gridSpacing:gridAngle:refly" << gridSpacing << gridAngle << refly;
 
     // Convert polygon to bounding rect
 
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Polygon";
-    QPolygonF polygon;
-    for (int i=0; i<polygonPoints.count(); i++) {
-        qCDebug(SurveyComplexItemLog) << "Vertex" << polygonPoints[i];
-        polygon << polygonPoints[i];
-    }
-    polygon << polygonPoints[0];
     QRectF boundingRect = polygon.boundingRect();
     QPointF boundingCenter = boundingRect.center();
     qCDebug(SurveyComplexItemLog) << "Bounding rect" << boundingRect.topLeft().x() << boundingRect.topLeft().y() << boundingRect.bottomRight().x() << boundingRect.bottomRight().y();
@@ -712,6 +872,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     double halfWidth = maxWidth / 2.0;
     double transectX = boundingCenter.x() - halfWidth;
     double transectXMax = transectX + maxWidth;
+    lineList.reserve(static_cast<qsizetype>(maxWidth / gridSpacing) + 1);
     while (transectX < transectXMax) {
         double transectYTop = boundingCenter.y() - halfWidth;
         double transectYBottom = boundingCenter.y() + halfWidth;
@@ -723,7 +884,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     // Now intersect the lines with the polygon
     QList<QLineF> intersectLines;
 #if 1
-    _intersectLinesWithPolygon(lineList, polygon, intersectLines);
+    _intersectLinesWithPolygon(lineList, polygon, intersectLines, promise);
 #else
     // This is handy for debugging grid problems, not for release
     intersectLines = lineList;
@@ -733,7 +894,6 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -747,106 +907,84 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     // Make sure all lines are going the same direction. Polygon intersection leads to lines which
     // can be in varied directions depending on the order of the intesecting sides.
     QList<QLineF> resultLines;
+    resultLines.reserve(intersectLines.count());
     _adjustLineDirection(intersectLines, resultLines);
 
-    // Convert from NED to Geo
-    QList<QList<QGeoCoordinate>> transects;
-    for (const QLineF& line : resultLines) {
-        QGeoCoordinate          coord;
-        QList<QGeoCoordinate>   transect;
-
-        QGCGeo::convertNedToGeo(line.p1().y(), line.p1().x(), 0, tangentOrigin, coord);
-        transect.append(coord);
-        QGCGeo::convertNedToGeo(line.p2().y(), line.p2().x(), 0, tangentOrigin, coord);
-        transect.append(coord);
-
-        transects.append(transect);
-    }
+    return resultLines;
+}
 
-    _adjustTransectsToEntryPointLocation(transects);
+void SurveyComplexItem::_appendTransectPass(const TransectParams_t& params, bool refly, QList<QGeoCoordinate>& transectCoords, Transects_t& transects)
+{
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transectCoords);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(transects.last().last().coord, transectCoords);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
-        QList<QList<QGeoCoordinate>> alternatingTransects;
-        for (int i=0; i<transects.count(); i++) {
-            if (!(i & 1)) {
-                alternatingTransects.append(transects[i]);
-            }
+    const qsizetype transectCount = transectCoords.count() / 2;
+
+    if (params.flyAlternateTransects) {
+        QList<QGeoCoordinate> alternatingCoords;
+        alternatingCoords.reserve(transectCoords.count());
+        for (qsizetype i=0; i<transectCount; i+=2) {
+            alternatingCoords.append(transectCoords[i * 2]);
+            alternatingCoords.append(transectCoords[(i * 2) + 1]);
         }
-        for (int i=transects.count()-1; i>0; i--) {
+        for (qsizetype i=transectCount-1; i>0; i--) {
             if (i & 1) {
-                alternatingTransects.append(transects[i]);
+                alternatingCoords.append(transectCoords[i * 2]);
+                alternatingCoords.append(transectCoords[(i * 2) + 1]);
             }
         }
-        transects = alternatingTransects;
+        transectCoords = alternatingCoords;
     }
 
     // Adjust to lawnmower pattern
-    bool reverseVertices = false;
-    for (int i=0; i<transects.count(); i++) {
+    for (qsizetype i=1; i<transectCount; i+=2) {
         // We must reverse the vertices for every other transect in order to make a lawnmower pattern
-        QList<QGeoCoordinate> transectVertices = transects[i];
-        if (reverseVertices) {
-            reverseVertices = false;
-            QList<QGeoCoordinate> reversedVertices;
-            for (int j=transectVertices.count()-1; j>=0; j--) {
-                reversedVertices.append(transectVertices[j]);
-            }
-            transectVertices = reversedVertices;
-        } else {
-            reverseVertices = true;
-        }
-        transects[i] = transectVertices;
+        transectCoords.swapItemsAt(i * 2, (i * 2) + 1);
     }
 
-    // Convert to CoordInfo transects and append to _transects
-    for (const QList<QGeoCoordinate>& transect : transects) {
-        QGeoCoordinate                                  coord;
-        QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
-        TransectStyleComplexItem::CoordInfo_t           coordInfo;
+    // Convert to CoordInfo transects and append to transects
+    transects.reserve(transects.count() + transectCount);
+    for (qsizetype i=0; i<transectCount; i++) {
+        const QGeoCoordinate& entryCoord = transectCoords[i * 2];
+        const QGeoCoordinate& exitCoord = transectCoords[(i * 2) + 1];
+        QList<TransectStyleComplexItem::CoordInfo_t> coordInfoTransect;
 
-        coordInfo = { transect[0], CoordTypeSurveyEntry };
-        coordInfoTransect.append(coordInfo);
-        coordInfo = { transect[1], CoordTypeSurveyExit };
-        coordInfoTransect.append(coordInfo);
+        coordInfoTransect.append(CoordInfo_t{ entryCoord, CoordTypeSurveyEntry });
+        coordInfoTransect.append(CoordInfo_t{ exitCoord, CoordTypeSurveyExit });
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
-            double transectLength = transect[0].distanceTo(transect[1]);
-            double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+        if (params.hoverAndCapture) {
+            double transectLength = entryCoord.distanceTo(exitCoord);
+            double transectAzimuth = entryCoord.azimuthTo(exitCoord);
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
-                for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
-                    TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
-                    coordInfoTransect.insert(1 + i, coordInfo);
+                for (int j=0; j<cInnerHoverPoints; j++) {
+                    QGeoCoordinate hoverCoord = entryCoord.atDistanceAndAzimuth(params.triggerDistance * (j + 1), transectAzimuth);
+                    coordInfoTransect.insert(1 + j, CoordInfo_t{ hoverCoord, CoordTypeInteriorHoverTrigger });
                 }
             }
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnAroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
 
-            double azimuth = transect[0].azimuthTo(transect[1]);
-            turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
+            double azimuth = entryCoord.azimuthTo(exitCoord);
+            turnaroundCoord = entryCoord.atDistanceAndAzimuth(-params.turnAroundDistance, azimuth);
             turnaroundCoord.setAltitude(qQNaN());
-            TransectStyleComplexItem::CoordInfo_t coordInfo = { turnaroundCoord, CoordTypeTurnaround };
-            coordInfoTransect.prepend(coordInfo);
+            coordInfoTransect.prepend(CoordInfo_t{ turnaroundCoord, CoordTypeTurnaround });
 
-            azimuth = transect.last().azimuthTo(transect[transect.count() - 2]);
-            turnaroundCoord = transect.last().atDistanceAndAzimuth(-turnAroundDistance, azimuth);
+            azimuth = exitCoord.azimuthTo(entryCoord);
+            turnaroundCoord = exitCoord.atDistanceAndAzimuth(-params.turnAroundDistance, azimuth);
             turnaroundCoord.setAltitude(qQNaN());
-            coordInfo = { turnaroundCoord, CoordTypeTurnaround };
-            coordInfoTransect.append(coordInfo);
+            coordInfoTransect.append(CoordInfo_t{ turnaroundCoord, CoordTypeTurnaround });
         }
 
-        _transects.append(coordInfoTransect);
+        transects.append(coordInfoTransect);
     }
 }
 
@@ -1075,7 +1213,6 @@ bool SurveyComplexItem::_VertexIsReflex(const QPolygonF& polygon, QList<QPointF>
     return area > 0;
 
 }
-#endif
 
 void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint)
 {
@@ -1257,6 +1394,7 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
     }
     qCDebug(SurveyComplexItemLog) << "_transects.size() " << _transects.size();
 }
+#endif
 
 void SurveyComplexItem::_recalcCameraShots(void)
 {
@@ -12,7 +12,9 @@
 #include "TransectStyleComplexItem.h"
 #include "SettingsFact.h"
 
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QPromise>
 
 Q_DECLARE_LOGGING_CATEGORY(SurveyComplexItemLog)
 
@@ -27,6 +29,7 @@ public:
     /// @param flyView true: Created for use in the Fly View, false: Created for use in the Plan View
     /// @param kmlOrShpFile Polygon comes from this file, empty for default polygon
     SurveyComplexItem(PlanMasterController* masterController, bool flyView, const QString& kmlOrShpFile);
+    ~SurveyComplexItem();
 
     Q_PROPERTY(Fact*            gridAngle              READ gridAngle              CONSTANT)
     Q_PROPERTY(Fact*            flyAlternateTransects  READ flyAlternateTransects  CONSTANT)
@@ -88,6 +91,7 @@ signals:
 
 private slots:
     void _updateWizardMode              (void);
+    void _transectsJobFinished          (void);
 
     // Overrides from TransectStyleComplexItem
     void _rebuildTransectsPhase1        (void) final;
@@ -101,21 +105,58 @@ private:
         CameraTriggerHoverAndCapture
     };
 
-    QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
+    /// Copy of everything transect generation reads from the item, so the transects can be built on another thread
+    typedef struct {
+        QList<QGeoCoordinate>   polygon;
+        double                  gridAngle;
+        double                  gridSpacing;
+        int                     entryPoint;
+        bool                    refly90Degrees;
+        bool                    flyAlternateTransects;
+        bool                    hoverAndCapture;
+        double                  triggerDistance;
+        double                  turnAroundDistance;
+    } TransectParams_t;
+
+    typedef QList<QList<CoordInfo_t>> Transects_t;
+
+    // Overrides from TransectStyleComplexItem
+    bool _rebuildTransectsPhase1InBackground(void) final;
+    void _finishTransectsPhase1InBackground(void) final { _finishTransectsJob(); }
+
+    TransectParams_t _transectParams(void) const;
+    void _clearLoadedMissionItems(void);
+    void _cancelTransectsJob(void);
+    /// The survey area is being dragged or traced, so edits come in faster than transects can be built
+    bool _surveyAreaEditActive(void) const;
+    void _finishTransectsJob(void);
+    void _applyTransectsJobResult(void);
+
+    /// Builds the transects for both passes, safe to call from any thread
+    ///     @param promise Checked for cancellation while building, nullptr if the build can't be cancelled
+    static Transects_t _buildTransects(const TransectParams_t& params, const QPromise<Transects_t>* promise = nullptr);
+    static void _buildTransectsJob(QPromise<Transects_t>& promise, const TransectParams_t& params);
+    /// Orders the coordinates of one pass for flight and appends them to transects as CoordInfo
+    static void _appendTransectPass(const TransectParams_t& params, bool refly, QList<QGeoCoordinate>& transectCoords, Transects_t& transects);
+    /// Generates the NED entry/exit line of each transect for one pass, all going the same direction
+    static QList<QLineF> _buildTransectLines(const TransectParams_t& params, const QPolygonF& polygon, bool refly, const QPromise<Transects_t>* promise);
+
+    static QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
     void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
-    void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
-    void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
+    static void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines, const QPromise<Transects_t>* promise = nullptr);
+    static bool _intersectLineWithPolygon(const QLineF& line, const QPolygonF& polygon, QLineF& resultLine);
+    static void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
     bool _nextTransectCoord(const QList<QGeoCoordinate>& transectPoints, int pointIndex, QGeoCoordinate& coord);
     bool _appendMissionItemsWorker(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, bool hasRefly, bool buildRefly);
-    void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
+    static void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QGeoCoordinate>& transectCoords);
     qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
     qreal _dp(QPointF pt1, QPointF pt2);
     void _swapPoints(QList<QPointF>& points, int index1, int index2);
-    void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
-    void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
-    void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseTransectOrder(QList<QGeoCoordinate>& transectCoords);
+    static void _reverseInternalTransectPoints(QList<QGeoCoordinate>& transectCoords);
+    static void _adjustTransectsToEntryPointLocation(int entryPoint, QList<QGeoCoordinate>& transectCoords);
     bool _gridAngleIsNorthSouthTransects();
-    double _clampGridAngle90(double gridAngle);
+    static double _clampGridAngle90(double gridAngle);
     bool _imagesEverywhere(void) const;
     bool _triggerCamera(void) const;
     bool _hasTurnaround(void) const;
@@ -124,16 +165,14 @@ private:
     bool _loadV3(const QJsonObject& complexObject, int sequenceNumber, QString& errorString);
     bool _loadV4V5(const QJsonObject& complexObject, int sequenceNumber, QString& errorString, int version, bool forPresets);
     void _saveCommon(QJsonObject& complexObject);
-    void _rebuildTransectsPhase1Worker(bool refly);
-    void _rebuildTransectsPhase1WorkerSinglePolygon(bool refly);
-    /// Adds to the _transects array from one polygon
-    void _rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint);
 
 #if 0
     // Splitting polygons is not supported since this code would get stuck in a infinite loop
     // Code is left here in case someone wants to try to resurrect it
 
     void _rebuildTransectsPhase1WorkerSplitPolygons(bool refly);
+    /// Adds to the _transects array from one polygon
+    void _rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint);
 
     // Decompose polygon into list of convex sub polygons
     void _PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons);
@@ -149,6 +188,12 @@ private:
     SettingsFact    _splitConcavePolygonsFact;
     int             _entryPoint;
 
+    QFuture<Transects_t>        _transectsJob;
+    QFutureWatcher<Transects_t> _transectsJobWatcher;
+    bool                        _transectsJobPending = false;  ///< _transectsJob holds the latest edit and its result has not been applied
+
+    static constexpr int _minTransectLinesPerChunk = 64;
+
     static constexpr const char* _jsonGridAngleKey =          "angle";
     static constexpr const char* _jsonEntryPointKey =         "entryLocation";
 
@@ -179,4 +224,6 @@ private:
     static constexpr const char* _jsonV3Refly90DegreesKey =               "refly90Degrees";
     static constexpr const char* _jsonFlyAlternateTransectsKey =          "flyAlternateTransects";
     static constexpr const char* _jsonSplitConcavePolygonsKey =           "splitConcavePolygons";
+
+    friend class SurveyComplexItemTest;
 };
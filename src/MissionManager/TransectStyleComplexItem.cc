@@ -388,12 +388,21 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         return;
     }
 
+    if (_rebuildTransectsPhase1InBackground()) {
+        // The derived class calls _rebuildTransectsPhase2 once the new transects are ready
+        return;
+    }
+
     _transects.clear();
+    _rebuildTransectsPhase1();
+    _rebuildTransectsPhase2();
+}
+
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
 
-    _rebuildTransectsPhase1();
-
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
     switch (_cameraCalc.distanceMode()) {
@@ -1108,6 +1117,8 @@ void TransectStyleComplexItem::_handleHoverAndCaptureEnabled(QVariant enabled)
 
 void TransectStyleComplexItem::appendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
 {
+    _finishTransectsPhase1InBackground();
+
     if (_loadedMissionItems.count()) {
         // We have mission items from the loaded plan, use those
         _appendLoadedMissionItems(items, missionItemParent);
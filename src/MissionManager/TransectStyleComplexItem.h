@@ -136,6 +136,12 @@ protected slots:
 
 protected:
     virtual void _rebuildTransectsPhase1    (void) = 0; ///< Rebuilds the _transects array
+    /// Starts rebuilding the _transects array away from the GUI thread
+    ///     @return false: transects must be rebuilt synchronously through _rebuildTransectsPhase1
+    virtual bool _rebuildTransectsPhase1InBackground(void) { return false; }
+    /// Waits for a rebuild started by _rebuildTransectsPhase1InBackground and applies it, called before mission items
+    /// are built for upload. Getters keep returning the last applied transects.
+    virtual void _finishTransectsPhase1InBackground(void) { }
     virtual void _recalcCameraShots         (void) = 0;
 
     void    _save                           (QJsonObject& saveObject);
@@ -153,6 +159,7 @@ protected:
     void    _buildAndAppendMissionItems     (QList<MissionItem*>& items, QObject* missionItemParent);
     void    _appendLoadedMissionItems       (QList<MissionItem*>& items, QObject* missionItemParent);
     void    _recalcComplexDistance          (void);
+    void    _rebuildTransectsPhase2         (void); ///< Rebuilds the flight path, visuals and stats from the _transects array
 
     int                 _sequenceNumber = 0;
     QGeoCoordinate      _coordinate;
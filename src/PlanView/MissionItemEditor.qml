@@ -278,6 +278,7 @@ Rectangle {
         anchors.top:        topRowLayout.bottom
         source:             missionItem.editorQml
         visible:            _currentItem
+        active:             _currentItem    // Only the selected item pays for its editor
 
         property var    masterController:   _masterController
         property real   availableWidth:     _root.width - (anchors.margins * 2) ///< How wide the editor should be
@@ -418,10 +418,23 @@ Item {
                 }
             }
 
-            // Add lines between waypoints
+            // Add lines between waypoints. Connected segments are drawn as a single polyline.
+            MapItemView {
+                model: _missionController.flightPathLines
+
+                delegate: MapPolyline {
+                    path:       modelData
+                    line.width: 3
+                    line.color: QGroundControl.globalPalette.mapMissionTrajectory
+                    z:          QGroundControl.zOrderWaypointLines
+                    opacity:    _editingLayer == _layerMission ||  _editingLayer == _layerUTMSP  ? 1 : editorMap._nonInteractiveOpacity
+                }
+            }
+
+            // Segments which collide with terrain
             MissionLineView {
                 showSpecialVisual:  _missionController.isROIBeginCurrentItem
-                model:              _missionController.simpleFlightPathSegments
+                model:              _missionController.terrainCollisionSegments
                 opacity:            _editingLayer == _layerMission ||  _editingLayer == _layerUTMSP  ? 1 : editorMap._nonInteractiveOpacity
             }
 
@@ -272,6 +272,7 @@ void QGCApplication::init()
 #endif
 
     qmlRegisterUncreatableType<GimbalController>    ("QGroundControl.Vehicle", 1, 0, "GimbalController",     "Reference only");
+    qmlRegisterUncreatableType<MqttTelemetryModel>  ("QGroundControl",         1, 0, "MqttTelemetryModel",   "Reference only");
 
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
     qmlRegisterUncreatableType<MAVLinkChartController>("QGroundControl",             1, 0, "MAVLinkChart", "Reference only");
@@ -337,6 +338,10 @@ void QGCApplication::_initForNormalAppBoot()
     // Image provider for Optical Flow
     _qmlAppEngine->addImageProvider(qgcImageProviderId, new QGCImageProvider());
 
+    // Image provider for binary lidar frames received over MQTT
+    _qmlAppEngine->addImageProvider(QLatin1String(MqttLidarImageProvider::kProviderId),
+                                    new MqttLidarImageProvider(_toolbox->mqttManager()->lidarFrameBuffer()));
+
     VideoManager::instance()->init();
     LidarManager::instance()->init();
 
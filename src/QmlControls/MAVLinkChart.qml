@@ -114,6 +114,18 @@ ChartView {
                 Layout.alignment:   Qt.AlignVCenter
             }
         }
+        QGCButton {
+            text:                   qsTr("Export")
+            anchors.verticalCenter: parent.verticalCenter
+            onClicked: {
+                var filename = chartController.exportSeries()
+                if (filename !== "") {
+                    mainWindow.showMessageDialog(qsTr("Export"), qsTr("Chart data saved to %1").arg(filename))
+                } else {
+                    mainWindow.showMessageDialog(qsTr("Export"), qsTr("Unable to save chart data"))
+                }
+            }
+        }
         ColumnLayout {
             anchors.verticalCenter: parent.verticalCenter
             Repeater {
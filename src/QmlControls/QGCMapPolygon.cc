@@ -378,6 +378,14 @@ void QGCMapPolygon::setCenterDrag(bool centerDrag)
     }
 }
 
+void QGCMapPolygon::setVertexDrag(bool vertexDrag)
+{
+    if (vertexDrag != _vertexDrag) {
+        _vertexDrag = vertexDrag;
+        emit vertexDragChanged(vertexDrag);
+    }
+}
+
 void QGCMapPolygon::setInteractive(bool interactive)
 {
     if (_interactive != interactive) {
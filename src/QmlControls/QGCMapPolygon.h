@@ -38,6 +38,7 @@ public:
     Q_PROPERTY(bool                 dirty           READ dirty          WRITE setDirty          NOTIFY dirtyChanged)
     Q_PROPERTY(QGeoCoordinate       center          READ center         WRITE setCenter         NOTIFY centerChanged)
     Q_PROPERTY(bool                 centerDrag      READ centerDrag     WRITE setCenterDrag     NOTIFY centerDragChanged)
+    Q_PROPERTY(bool                 vertexDrag      READ vertexDrag     WRITE setVertexDrag     NOTIFY vertexDragChanged)   ///< A vertex is being dragged
     Q_PROPERTY(bool                 interactive     READ interactive    WRITE setInteractive    NOTIFY interactiveChanged)
     Q_PROPERTY(bool                 isValid         READ isValid                                NOTIFY isValidChanged)
     Q_PROPERTY(bool                 empty           READ empty                                  NOTIFY isEmptyChanged)
@@ -108,6 +109,7 @@ public:
     void            setDirty    (bool dirty);
     QGeoCoordinate  center      (void) const { return _center; }
     bool            centerDrag  (void) const { return _centerDrag; }
+    bool            vertexDrag  (void) const { return _vertexDrag; }
     bool            interactive (void) const { return _interactive; }
     bool            isValid     (void) const { return _polygonModel.count() >= 3; }
     bool            empty       (void) const { return _polygonModel.count() == 0; }
@@ -123,6 +125,7 @@ public:
     void setPath        (const QVariantList& path);
     void setCenter      (QGeoCoordinate newCenter);
     void setCenterDrag  (bool centerDrag);
+    void setVertexDrag  (bool vertexDrag);
     void setInteractive (bool interactive);
     void setTraceMode   (bool traceMode);
     void setShowAltColor(bool showAltColor);
@@ -137,6 +140,7 @@ signals:
     void cleared            (void);
     void centerChanged      (QGeoCoordinate center);
     void centerDragChanged  (bool centerDrag);
+    void vertexDragChanged  (bool vertexDrag);
     void interactiveChanged (bool interactive);
     bool isValidChanged     (void);
     bool isEmptyChanged     (void);
@@ -162,6 +166,7 @@ private:
     bool                _dirty =                false;
     QGeoCoordinate      _center;
     bool                _centerDrag =           false;
+    bool                _vertexDrag =           false;
     bool                _ignoreCenterUpdates =  false;
     bool                _interactive =          false;
     bool                _resetActive =          false;
@@ -0,0 +1,115 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCHotTileCache.h"
+#include "QGCCacheTile.h"
+
+QGCHotTileCache::QGCHotTileCache(qint64 maxBytes)
+    : _maxBytes(qMax<qint64>(0, maxBytes))
+{
+
+}
+
+void QGCHotTileCache::setMaxBytes(qint64 maxBytes)
+{
+    _maxBytes = qMax<qint64>(0, maxBytes);
+
+    const qint64 budget = _shardBudget();
+    for (Shard &shard : _shards) {
+        QMutexLocker lock(&shard.mutex);
+        _evict(shard, budget);
+    }
+}
+
+QGCCacheTile *QGCHotTileCache::find(const QString &hash)
+{
+    if (_maxBytes == 0) {
+        return nullptr;
+    }
+
+    Shard &shard = _shard(hash);
+    QMutexLocker lock(&shard.mutex);
+
+    const auto it = shard.index.constFind(hash);
+    if (it == shard.index.constEnd()) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it.value());
+    _hits.fetch_add(1, std::memory_order_relaxed);
+
+    const Entry &entry = shard.lru.front();
+    return new QGCCacheTile(entry.hash, entry.img, entry.format, entry.type);
+}
+
+void QGCHotTileCache::insert(const QGCCacheTile &tile)
+{
+    const qint64 budget = _shardBudget();
+    const qint64 cost = tile.img().size() + (tile.hash().size() * static_cast<qint64>(sizeof(QChar))) + kEntryOverhead;
+    if (tile.img().isEmpty() || (cost > budget)) {
+        return;
+    }
+
+    Shard &shard = _shard(tile.hash());
+    QMutexLocker lock(&shard.mutex);
+
+    const auto it = shard.index.constFind(tile.hash());
+    if (it != shard.index.constEnd()) {
+        shard.bytes -= it.value()->cost;
+        shard.lru.erase(it.value());
+        (void) shard.index.erase(it);
+    }
+
+    shard.lru.push_front(Entry{tile.hash(), tile.img(), tile.format(), tile.type(), cost});
+    shard.index.insert(tile.hash(), shard.lru.begin());
+    shard.bytes += cost;
+    _insertions.fetch_add(1, std::memory_order_relaxed);
+
+    _evict(shard, budget);
+}
+
+void QGCHotTileCache::clear()
+{
+    for (Shard &shard : _shards) {
+        QMutexLocker lock(&shard.mutex);
+        shard.lru.clear();
+        shard.index.clear();
+        shard.bytes = 0;
+    }
+}
+
+/// Must be called with the shard locked
+void QGCHotTileCache::_evict(Shard &shard, qint64 budget)
+{
+    while ((shard.bytes > budget) && !shard.lru.empty()) {
+        const Entry &oldest = shard.lru.back();
+        shard.bytes -= oldest.cost;
+        (void) shard.index.remove(oldest.hash);
+        shard.lru.pop_back();
+        _evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+QGCHotTileCache::Stats QGCHotTileCache::stats() const
+{
+    Stats stats;
+    stats.hits = _hits.load(std::memory_order_relaxed);
+    stats.misses = _misses.load(std::memory_order_relaxed);
+    stats.insertions = _insertions.load(std::memory_order_relaxed);
+    stats.evictions = _evictions.load(std::memory_order_relaxed);
+
+    for (const Shard &shard : _shards) {
+        QMutexLocker lock(&shard.mutex);
+        stats.bytes += shard.bytes;
+        stats.tiles += static_cast<qint64>(shard.lru.size());
+    }
+
+    return stats;
+}
@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <array>
+#include <atomic>
+#include <list>
+
+class QGCCacheTile;
+class QGCHotTileCacheTest;
+
+/// Byte budgeted LRU of encoded tiles which sits in front of the tile cache database.
+///
+/// Keyed by the UrlFactory::getTileHash() hash. The budget is split across independently locked
+/// shards so the map view, the database readers and the downloader rarely contend. Tile data is
+/// implicitly shared, a hit costs no copy of the image.
+class QGCHotTileCache
+{
+    friend class QGCHotTileCacheTest;
+
+public:
+    struct Stats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 insertions = 0;
+        quint64 evictions = 0;
+        qint64 bytes = 0;
+        qint64 tiles = 0;
+    };
+
+    explicit QGCHotTileCache(qint64 maxBytes = 0);
+
+    /// A budget of 0 disables the cache
+    void setMaxBytes(qint64 maxBytes);
+    qint64 maxBytes() const { return _maxBytes; }
+
+    /// @return A new tile owned by the caller, nullptr on a miss
+    QGCCacheTile *find(const QString &hash);
+    void insert(const QGCCacheTile &tile);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    struct Entry {
+        QString hash;
+        QByteArray img;
+        QString format;
+        QString type;
+        qint64 cost = 0;
+    };
+
+    struct Shard {
+        mutable QMutex mutex;
+        std::list<Entry> lru;   ///< Most recently used first
+        QHash<QString, std::list<Entry>::iterator> index;
+        qint64 bytes = 0;
+    };
+
+    Shard &_shard(const QString &hash) { return _shards[qHash(hash) % kShardCount]; }
+    qint64 _shardBudget() const { return _maxBytes / kShardCount; }
+    void _evict(Shard &shard, qint64 budget);
+
+    static constexpr int kShardCount = 16;
+    static constexpr qint64 kEntryOverhead = 128;    ///< Approximate list node, hash node and string headers
+
+    std::array<Shard, kShardCount> _shards;
+    std::atomic<qint64> _maxBytes = 0;
+    std::atomic<quint64> _hits = 0;
+    std::atomic<quint64> _misses = 0;
+    std::atomic<quint64> _insertions = 0;
+    std::atomic<quint64> _evictions = 0;
+};
@@ -52,6 +52,8 @@ QGCMapEngine::QGCMapEngine(QObject *parent)
     (void) qRegisterMetaType<QGCCacheTile>("QGCCacheTile");
 
     (void) connect(m_worker, &QGCCacheWorker::updateTotals, this, &QGCMapEngine::_updateTotals);
+
+    m_worker->setHotTileCache(&m_hotTiles);
 }
 
 QGCMapEngine::~QGCMapEngine()
@@ -60,6 +62,9 @@ QGCMapEngine::~QGCMapEngine()
     m_worker->stop();
     m_worker->wait();
 
+    const QGCHotTileCache::Stats stats = m_hotTiles.stats();
+    qCDebug(QGCMapEngineLog) << "Hot tile cache hits:" << stats.hits << "misses:" << stats.misses << "evictions:" << stats.evictions;
+
     // qCDebug(QGCMapEngineLog) << Q_FUNC_INFO << this;
 }
 
@@ -71,6 +76,7 @@ QGCMapEngine *QGCMapEngine::instance()
 void QGCMapEngine::init(const QString &databasePath)
 {
     m_worker->setDatabaseFile(databasePath);
+    m_hotTiles.setMaxBytes(static_cast<qint64>(QGeoFileTileCacheQGC::getMaxHotTileCacheSetting()) * pow(1024, 2));
 
     QGCMapTask* const task = new QGCMapTask(QGCMapTask::taskInit);
     (void) addTask(task);
@@ -78,6 +84,39 @@ void QGCMapEngine::init(const QString &databasePath)
 
 bool QGCMapEngine::addTask(QGCMapTask *task)
 {
+    switch (task->type()) {
+    case QGCMapTask::taskFetchTile:
+    {
+        QGCFetchTileTask* const fetchTask = static_cast<QGCFetchTileTask*>(task);
+        QGCCacheTile* const tile = m_hotTiles.find(fetchTask->hash());
+        if (tile) {
+            // Delivered from the event loop like a database result, the requester is still being constructed
+            (void) QMetaObject::invokeMethod(fetchTask, [fetchTask, tile]() {
+                fetchTask->setTileFetched(tile);
+                fetchTask->deleteLater();
+            }, Qt::QueuedConnection);
+            return true;
+        }
+        break;
+    }
+    case QGCMapTask::taskCacheTile:
+    {
+        // Only tiles the map view asked for, an offline download would just flush the working set
+        const QGCCacheTile* const tile = static_cast<QGCSaveTileTask*>(task)->tile();
+        if (tile->tileSet() == UINT64_MAX) {
+            m_hotTiles.insert(*tile);
+        }
+        break;
+    }
+    case QGCMapTask::taskDeleteTileSet:
+    case QGCMapTask::taskReset:
+    case QGCMapTask::taskImport:
+        m_hotTiles.clear();
+        break;
+    default:
+        break;
+    }
+
     return m_worker->enqueueTask(task);
 }
 
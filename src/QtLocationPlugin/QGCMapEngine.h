@@ -22,6 +22,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
 
+#include "QGCHotTileCache.h"
+
 Q_DECLARE_LOGGING_CATEGORY(QGCMapEngineLog)
 
 class QGCMapTask;
@@ -38,6 +40,8 @@ public:
     void init(const QString &databasePath);
     bool addTask(QGCMapTask *task);
 
+    QGCHotTileCache::Stats hotTileStats() const { return m_hotTiles.stats(); }
+
     static QGCMapEngine *instance();
 
 signals:
@@ -49,6 +53,7 @@ private slots:
 
 private:
     QGCCacheWorker *m_worker = nullptr;
+    QGCHotTileCache m_hotTiles;
     bool m_prunning = false;
 };
 
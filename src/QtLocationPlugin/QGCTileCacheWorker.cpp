@@ -18,6 +18,7 @@
 
 #include "QGCTileCacheWorker.h"
 #include "QGCCachedTileSet.h"
+#include "QGCHotTileCache.h"
 #include "QGCMapTasks.h"
 #include "QGCMapUrlEngine.h"
 #include "QGCLoggingCategory.h"
@@ -26,6 +27,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QFile>
 #include <QtCore/QSettings>
+#include <QtCore/QUrl>
 #include <QtSql/QSqlDatabase>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
@@ -48,7 +50,12 @@ QGCCacheWorker::~QGCCacheWorker()
 void QGCCacheWorker::stop()
 {
     QMutexLocker lock(&_taskQueueMutex);
-    qDeleteAll(_taskQueue);
+    for (QQueue<QGCMapTask*> &queue : _taskQueues) {
+        qDeleteAll(queue);
+        queue.clear();
+    }
+    qDeleteAll(_readQueue);
+    _readQueue.clear();
     lock.unlock();
 
     if(this->isRunning()) {
@@ -64,9 +71,14 @@ bool QGCCacheWorker::enqueueTask(QGCMapTask *task)
         return false;
     }
 
-    // TODO: Prepend Stop Task Instead?
     QMutexLocker lock(&_taskQueueMutex);
-    _taskQueue.enqueue(task);
+    if ((task->type() == QGCMapTask::taskFetchTile) && _readersActive) {
+        _readQueue.enqueue(task);
+        lock.unlock();
+        _readWaitc.wakeOne();
+        return true;
+    }
+    _taskQueues[_taskPriority(task)].enqueue(task);
     lock.unlock();
 
     if (isRunning()) {
@@ -78,6 +90,60 @@ bool QGCCacheWorker::enqueueTask(QGCMapTask *task)
     return true;
 }
 
+QGCCacheWorker::TaskPriority QGCCacheWorker::_taskPriority(QGCMapTask *task)
+{
+    switch (task->type()) {
+    case QGCMapTask::taskInit:
+    case QGCMapTask::taskFetchTile:
+    case QGCMapTask::taskFetchTileSets:
+        return PriorityHigh;
+    case QGCMapTask::taskCacheTile:
+        // Tiles without a set were requested by the map view, the rest belong to an offline download
+        return (static_cast<QGCSaveTileTask*>(task)->tile()->tileSet() == UINT64_MAX) ? PriorityNormal : PriorityLow;
+    case QGCMapTask::taskCreateTileSet:
+    case QGCMapTask::taskRenameTileSet:
+        return PriorityNormal;
+    default:
+        // Deletes, resets and imports stay in order behind any bulk saves already queued
+        return PriorityLow;
+    }
+}
+
+/// Must be called with _taskQueueMutex locked
+QGCMapTask *QGCCacheWorker::_dequeueTask()
+{
+    for (QQueue<QGCMapTask*> &queue : _taskQueues) {
+        if (!queue.isEmpty()) {
+            return queue.dequeue();
+        }
+    }
+
+    return nullptr;
+}
+
+/// Must be called with _taskQueueMutex locked
+bool QGCCacheWorker::_nextTaskIsSave() const
+{
+    for (const QQueue<QGCMapTask*> &queue : _taskQueues) {
+        if (!queue.isEmpty()) {
+            return (queue.head()->type() == QGCMapTask::taskCacheTile);
+        }
+    }
+
+    return false;
+}
+
+/// Must be called with _taskQueueMutex locked
+qsizetype QGCCacheWorker::_queuedTaskCount() const
+{
+    qsizetype count = 0;
+    for (const QQueue<QGCMapTask*> &queue : _taskQueues) {
+        count += queue.count();
+    }
+
+    return count;
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::run()
@@ -92,19 +158,34 @@ QGCCacheWorker::run()
     if (_valid) {
         if (_connectDB()) {
             _deleteBingNoTileTiles();
+            _startReaders();
         }
     }
 
     QMutexLocker lock(&_taskQueueMutex);
     while (true) {
-        if (!_taskQueue.isEmpty()) {
-            QGCMapTask* const task = _taskQueue.dequeue();
+        QGCMapTask* const task = _dequeueTask();
+        if (task) {
+            // Consecutive saves are committed together, a download produces them far faster than
+            // individual transactions can be synced to disk
+            QList<QGCMapTask*> batch = { task };
+            if (task->type() == QGCMapTask::taskCacheTile) {
+                while ((batch.count() < kMaxSaveBatch) && _nextTaskIsSave()) {
+                    batch.append(_dequeueTask());
+                }
+            }
             lock.unlock();
-            _runTask(task);
+            if (batch.count() > 1) {
+                _runSaveBatch(batch);
+            } else {
+                _runTask(task);
+            }
             lock.relock();
-            task->deleteLater();
+            for (QGCMapTask* const done : batch) {
+                done->deleteLater();
+            }
 
-            const qsizetype count = _taskQueue.count();
+            const qsizetype count = _queuedTaskCount();
             if (count > 100) {
                 _updateTimeout = kLongTimeout;
             } else if (count < 25) {
@@ -120,16 +201,119 @@ QGCCacheWorker::run()
             }
         } else {
             (void) _waitc.wait(lock.mutex(), 5000);
-            if (_taskQueue.isEmpty()) {
+            if ((_queuedTaskCount() == 0) && _readQueue.isEmpty()) {
                 break;
             }
         }
     }
     lock.unlock();
 
+    _stopReaders();
     _disconnectDB();
 }
 
+void QGCCacheWorker::_runSaveBatch(const QList<QGCMapTask*> &batch)
+{
+    const bool transaction = _valid && _db && _db->transaction();
+    for (QGCMapTask* const task : batch) {
+        _saveTile(task);
+    }
+    if (transaction && !_db->commit()) {
+        qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (commit tile batch):" << _db->lastError().text();
+    }
+    qCDebug(QGCTileCacheWorkerLog) << "_runSaveBatch() saved" << batch.count() << "tiles";
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_startReaders()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    if (_readersActive) {
+        return;
+    }
+    _stopReadersRequested = false;
+    lock.unlock();
+
+    const int readerCount = qBound(1, QThread::idealThreadCount() / 2, kMaxReaders);
+    for (int i = 0; i < readerCount; i++) {
+        QThread* const reader = QThread::create([this, i]() { _runReader(i); });
+        reader->setObjectName(QStringLiteral("QGCTileCacheReader%1").arg(i));
+        reader->start(QThread::HighPriority);
+        _readers.append(reader);
+    }
+
+    lock.relock();
+    _readersActive = true;
+    // Fetches which arrived while there were no readers were queued for this thread, hand them over
+    QQueue<QGCMapTask*> &highQueue = _taskQueues[PriorityHigh];
+    for (auto it = highQueue.begin(); it != highQueue.end();) {
+        if ((*it)->type() == QGCMapTask::taskFetchTile) {
+            _readQueue.enqueue(*it);
+            it = highQueue.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    lock.unlock();
+    _readWaitc.wakeAll();
+}
+
+/// Readers finish any queued fetches before exiting. Fetches arriving afterwards are served by this thread.
+void
+QGCCacheWorker::_stopReaders()
+{
+    QMutexLocker lock(&_taskQueueMutex);
+    if (!_readersActive) {
+        return;
+    }
+    _readersActive = false;
+    _stopReadersRequested = true;
+    lock.unlock();
+    _readWaitc.wakeAll();
+
+    for (QThread* const reader : std::as_const(_readers)) {
+        (void) reader->wait();
+        delete reader;
+    }
+    _readers.clear();
+}
+
+void
+QGCCacheWorker::_runReader(int index)
+{
+    const QString session = QStringLiteral("%1%2").arg(kReadSession).arg(index);
+    {
+        // Shared cache is enabled process wide by the export and import sessions. It would serialize the
+        // readers on table locks, so every reader asks for a private cache explicitly.
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", session);
+        db.setDatabaseName(QUrl::fromLocalFile(_databasePath).toString() + QStringLiteral("?cache=private"));
+        db.setConnectOptions("QSQLITE_OPEN_URI;QSQLITE_OPEN_READONLY");
+        if (!db.open()) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (reader open db):" << db.lastError();
+        }
+
+        QMutexLocker lock(&_taskQueueMutex);
+        while (true) {
+            while (_readQueue.isEmpty() && !_stopReadersRequested) {
+                (void) _readWaitc.wait(lock.mutex());
+            }
+            if (_readQueue.isEmpty()) {
+                break;
+            }
+            QGCMapTask* const task = _readQueue.dequeue();
+            lock.unlock();
+            _getTile(task, db);
+            task->deleteLater();
+            lock.relock();
+        }
+        lock.unlock();
+
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(session);
+}
+
 void QGCCacheWorker::_runTask(QGCMapTask *task)
 {
     switch (task->type()) {
@@ -139,7 +323,7 @@ void QGCCacheWorker::_runTask(QGCMapTask *task)
         _saveTile(task);
         break;
     case QGCMapTask::taskFetchTile:
-        _getTile(task);
+        _getTile(task, *_db);
         break;
     case QGCMapTask::taskFetchTileSets:
         _getTileSets(task);
@@ -285,22 +469,26 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 
 //-----------------------------------------------------------------------------
 void
-QGCCacheWorker::_getTile(QGCMapTask* mtask)
+QGCCacheWorker::_getTile(QGCMapTask* mtask, QSqlDatabase& db)
 {
     if(!_testTask(mtask)) {
         return;
     }
     bool found = false;
     QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
-    QSqlQuery query(*_db);
-    QString s = QString("SELECT tile, format, type FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
-    if(query.exec(s)) {
+    QSqlQuery query(db);
+    query.prepare("SELECT tile, format, type FROM Tiles WHERE hash = ?");
+    query.addBindValue(task->hash());
+    if(query.exec()) {
         if(query.next()) {
             const QByteArray& arrray   = query.value(0).toByteArray();
             const QString& format  = query.value(1).toString();
             const QString& type = query.value(2).toString();
             qCDebug(QGCTileCacheWorkerLog) << "_getTile() (Found in DB) HASH:" << task->hash();
             QGCCacheTile* tile = new QGCCacheTile(task->hash(), arrray, format, type);
+            if(_hotTileCache) {
+                _hotTileCache->insert(*tile);
+            }
             task->setTileFetched(tile);
             found = true;
         }
@@ -667,6 +855,7 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
         return;
     }
     QGCResetTask* task = static_cast<QGCResetTask*>(mtask);
+    _stopReaders();
     QSqlQuery query(*_db);
     QString s;
     s = QString("DROP TABLE Tiles");
@@ -678,6 +867,9 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
     s = QString("DROP TABLE TilesDownload");
     query.exec(s);
     _valid = _createDB(*_db);
+    if(_valid) {
+        _startReaders();
+    }
     task->setResetCompleted();
 }
 
@@ -692,6 +884,7 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
     //-- If replacing, simply copy over it
     if(task->replace()) {
         //-- Close and delete old database
+        _stopReaders();
         _disconnectDB();
         QFile file(_databasePath);
         file.remove();
@@ -701,7 +894,9 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
         _init();
         if(_valid) {
             task->setProgress(50);
-            _connectDB();
+            if(_connectDB()) {
+                _startReaders();
+            }
         }
         task->setProgress(100);
     } else {
@@ -1010,8 +1205,15 @@ QGCCacheWorker::_connectDB()
 {
     _db.reset(new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kSession)));
     _db->setDatabaseName(_databasePath);
-    _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     _valid = _db->open();
+    if (_valid) {
+        // WAL lets the reader connections run concurrently with this writer connection
+        QSqlQuery query(*_db);
+        if (!query.exec("PRAGMA journal_mode=WAL")) {
+            qCWarning(QGCTileCacheWorkerLog) << "Map Cache SQL error (enable WAL):" << query.lastError().text();
+        }
+        (void) query.exec("PRAGMA synchronous=NORMAL");
+    }
     return _valid;
 }
 
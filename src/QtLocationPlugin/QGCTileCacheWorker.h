@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
@@ -25,21 +27,35 @@
 #include <QtCore/QThread>
 #include <QtCore/QWaitCondition>
 
+#include <array>
+#include <atomic>
+
 Q_DECLARE_LOGGING_CATEGORY(QGCTileCacheWorkerLog)
 
 class QGCMapTask;
 class QGCCachedTileSet;
+class QGCHotTileCache;
 class QSqlDatabase;
-
+class QGCTileCacheWorkerTest;
+
+/// Serves all QGCMapTasks against the tile cache database.
+///
+/// The database runs in WAL mode so reads never wait on writes. Tile fetches are served in parallel by
+/// a small pool of reader threads, each with its own read-only connection. Everything else runs on this
+/// thread through the single writer connection, highest priority first, with consecutive tile saves
+/// committed as one transaction. Interactive work therefore never queues behind a bulk download.
 class QGCCacheWorker : public QThread
 {
     Q_OBJECT
 
+    friend class QGCTileCacheWorkerTest;
 public:
     explicit QGCCacheWorker(QObject *parent = nullptr);
     ~QGCCacheWorker();
 
     void setDatabaseFile(const QString &path) { _databasePath = path; }
+    /// Tiles read from the database are added to cache, which must outlive the worker
+    void setHotTileCache(QGCHotTileCache *cache) { _hotTileCache = cache; }
 
 public slots:
     bool enqueueTask(QGCMapTask *task);
@@ -52,10 +68,26 @@ protected:
     void run() final;
 
 private:
+    enum TaskPriority {
+        PriorityHigh,       ///< Interactive requests the UI is waiting on
+        PriorityNormal,     ///< Tiles cached while browsing the map, tile set edits
+        PriorityLow,        ///< Offline set downloads and other bulk jobs
+        PriorityCount
+    };
+
+    static TaskPriority _taskPriority(QGCMapTask *task);
+    QGCMapTask *_dequeueTask();
+    bool _nextTaskIsSave() const;
+    qsizetype _queuedTaskCount() const;
+    void _runSaveBatch(const QList<QGCMapTask*> &batch);
     void _runTask(QGCMapTask *task);
 
+    void _startReaders();
+    void _stopReaders();
+    void _runReader(int index);
+
     void _saveTile(QGCMapTask *task);
-    void _getTile(QGCMapTask *task);
+    void _getTile(QGCMapTask *task, QSqlDatabase &db);
     void _getTileSets(QGCMapTask *task);
     void _createTileSet(QGCMapTask *task);
     void _getTileDownloadList(QGCMapTask *task);
@@ -82,9 +114,15 @@ private:
 
     std::shared_ptr<QSqlDatabase> _db = nullptr;
     QMutex _taskQueueMutex;
-    QQueue<QGCMapTask*> _taskQueue;
+    std::array<QQueue<QGCMapTask*>, PriorityCount> _taskQueues;
     QWaitCondition _waitc;
+    QQueue<QGCMapTask*> _readQueue;     ///< Tile fetches waiting for a reader
+    QWaitCondition _readWaitc;
+    QList<QThread*> _readers;
+    bool _readersActive = false;        ///< Protected by _taskQueueMutex
+    bool _stopReadersRequested = false; ///< Protected by _taskQueueMutex
     QString _databasePath;
+    QGCHotTileCache *_hotTileCache = nullptr;
     quint32 _defaultCount = 0;
     quint32 _totalCount = 0;
     quint64 _defaultSet = UINT64_MAX;
@@ -98,6 +136,9 @@ private:
     static QByteArray _bingNoTileImage;
     static constexpr const char *kSession = "QGeoTileWorkerSession";
     static constexpr const char *kExportSession = "QGeoTileExportSession";
+    static constexpr const char *kReadSession = "QGeoTileReadSession";
+    static constexpr int kMaxReaders = 4;
+    static constexpr int kMaxSaveBatch = 64;
     static constexpr int kShortTimeout = 2;
     static constexpr int kLongTimeout = 5;
 };
@@ -97,6 +97,11 @@ quint32 QGeoFileTileCacheQGC::getMaxDiskCacheSetting()
     return qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxCacheDiskSize()->rawValue().toUInt();
 }
 
+quint32 QGeoFileTileCacheQGC::getMaxHotTileCacheSetting()
+{
+    return qgcApp()->toolbox()->settingsManager()->mapsSettings()->maxCacheHotTileSize()->rawValue().toUInt();
+}
+
 void QGeoFileTileCacheQGC::cacheTile(const QString &type, int x, int y, int z, const QByteArray &image, const QString &format, qulonglong set)
 {
     const QString hash = UrlFactory::getTileHash(type, x, y, z);
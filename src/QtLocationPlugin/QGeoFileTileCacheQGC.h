@@ -25,6 +25,7 @@ public:
     ~QGeoFileTileCacheQGC();
 
     static quint32 getMaxDiskCacheSetting();
+    static quint32 getMaxHotTileCacheSetting();
     static void cacheTile(const QString &type, int x, int y, int z, const QByteArray &image, const QString &format, qulonglong set = UINT64_MAX);
     static void cacheTile(const QString &type, const QString &hash, const QByteArray &image, const QString &format, qulonglong set = UINT64_MAX);
     static QGCFetchTileTask *createFetchTileTask(const QString &type, int x, int y, int z);
@@ -95,6 +95,14 @@ QString QGCMapEngineManager::tileSizeStr() const
     return qgcApp()->bigSizeToString(_imageSet.tileSize + _elevationSet.tileSize);
 }
 
+QString QGCMapEngineManager::hotTileStatsStr() const
+{
+    const QGCHotTileCache::Stats stats = getQGCMapEngine()->hotTileStats();
+    const quint64 lookups = stats.hits + stats.misses;
+    const double hitRate = (lookups > 0) ? (100.0 * static_cast<double>(stats.hits) / static_cast<double>(lookups)) : 0.0;
+    return tr("%1% hits, %2 tiles, %3").arg(hitRate, 0, 'f', 1).arg(stats.tiles).arg(qgcApp()->bigSizeToString(static_cast<quint64>(stats.bytes)));
+}
+
 void QGCMapEngineManager::loadTileSets()
 {
     if (_tileSets->count() > 0) {
@@ -298,6 +306,8 @@ void QGCMapEngineManager::taskError(QGCMapTask::TaskType type, const QString &er
 
 void QGCMapEngineManager::_updateTotals(quint32 totaltiles, quint64 totalsize, quint32 defaulttiles, quint64 defaultsize)
 {
+    emit hotTileStatsChanged();
+
     for (qsizetype i = 0; i < _tileSets->count(); i++) {
         QGCCachedTileSet* const set = qobject_cast<QGCCachedTileSet*>(_tileSets->get(i));
         if (set && set->defaultSet()) {
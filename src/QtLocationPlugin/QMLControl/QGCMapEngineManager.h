@@ -45,6 +45,7 @@ class QGCMapEngineManager : public QObject
     Q_PROPERTY(QStringList          elevationProviderList   READ elevationProviderList              CONSTANT)
     Q_PROPERTY(quint64              tileCount       READ tileCount                                  NOTIFY tileCountChanged)
     Q_PROPERTY(quint64              tileSize        READ tileSize                                   NOTIFY tileSizeChanged)
+    Q_PROPERTY(QString              hotTileStatsStr READ hotTileStatsStr                            NOTIFY hotTileStatsChanged)
 
 public:
     QGCMapEngineManager(QObject *parent = nullptr);
@@ -83,6 +84,7 @@ public:
     QString errorMessage() const { return _errorMessage; }
     QString tileCountStr() const;
     QString tileSizeStr() const;
+    QString hotTileStatsStr() const;
     quint64 tileCount() const { return (_imageSet.tileCount + _elevationSet.tileCount); }
     quint64 tileSize() const { return (_imageSet.tileSize + _elevationSet.tileSize); }
 
@@ -98,6 +100,7 @@ signals:
     void actionProgressChanged();
     void errorMessageChanged();
     void fetchElevationChanged();
+    void hotTileStatsChanged();
     void freeDiskSpaceChanged();
     void importActionChanged();
     void importReplaceChanged();
@@ -42,6 +42,9 @@ DECLARE_SETTINGSFACT(AutoConnectSettings, udpListenPort)
 DECLARE_SETTINGSFACT(AutoConnectSettings, udpTargetHostIP)
 DECLARE_SETTINGSFACT(AutoConnectSettings, udpTargetHostPort)
 DECLARE_SETTINGSFACT(AutoConnectSettings, nmeaUdpPort)
+DECLARE_SETTINGSFACT(AutoConnectSettings, joystickSerialPort)
+DECLARE_SETTINGSFACT(AutoConnectSettings, joystickUsbVendorId)
+DECLARE_SETTINGSFACT(AutoConnectSettings, joystickUsbProductId)
 
 DECLARE_SETTINGSFACT_NO_FUNC(AutoConnectSettings, autoConnectPixhawk)
 {
@@ -37,4 +37,7 @@ public:
     DEFINE_SETTINGFACT(udpTargetHostIP)
     DEFINE_SETTINGFACT(udpTargetHostPort)
     DEFINE_SETTINGFACT(nmeaUdpPort)
+    DEFINE_SETTINGFACT(joystickSerialPort)
+    DEFINE_SETTINGFACT(joystickUsbVendorId)
+    DEFINE_SETTINGFACT(joystickUsbProductId)
 };
@@ -14,6 +14,8 @@
 
 #include <QtCore/QTimer>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(TerrainQueryLog, "qgc.terrain.terrainquery")
 QGC_LOGGING_CATEGORY(TerrainQueryVerboseLog, "qgc.terrain.terrainquery.verbose")
 
@@ -248,6 +250,11 @@ void TerrainPathQuery::_pathHeights(bool success, double distanceBetween, double
     pathHeightInfo.distanceBetween = distanceBetween;
     pathHeightInfo.finalDistanceBetween = finalDistanceBetween;
     pathHeightInfo.heights = heights;
+    if (!heights.isEmpty()) {
+        const auto [minHeight, maxHeight] = std::minmax_element(heights.cbegin(), heights.cend());
+        pathHeightInfo.minHeight = *minHeight;
+        pathHeightInfo.maxHeight = *maxHeight;
+    }
     emit terrainDataReceived(success, pathHeightInfo);
     if (_autoDelete) {
         deleteLater();
@@ -259,11 +266,11 @@ void TerrainPathQuery::_pathHeights(bool success, double distanceBetween, double
 TerrainPolyPathQuery::TerrainPolyPathQuery(bool autoDelete, QObject *parent)
     : QObject(parent)
     , _autoDelete(autoDelete)
-    , _pathQuery(new TerrainPathQuery(false, this))
+    , _terrainQuery(new TerrainOfflineQuery(this))
 {
     // qCDebug(TerrainQueryLog) << Q_FUNC_INFO << this;
 
-    (void) connect(_pathQuery, &TerrainPathQuery::terrainDataReceived, this, &TerrainPolyPathQuery::_terrainDataReceived);
+    (void) connect(_terrainQuery, &TerrainQueryInterface::polyPathHeightsReceived, this, &TerrainPolyPathQuery::_polyPathHeights);
 }
 
 TerrainPolyPathQuery::~TerrainPolyPathQuery()
@@ -286,30 +293,15 @@ void TerrainPolyPathQuery::requestData(const QList<QGeoCoordinate> &polyPath)
 {
     qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "count" << polyPath.count();
 
-    _rgCoords = polyPath;
-    _curIndex = 0;
-    _pathQuery->requestData(_rgCoords[0], _rgCoords[1]);
+    _terrainQuery->requestPolyPathHeights(polyPath);
 }
 
-void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo)
+void TerrainPolyPathQuery::_polyPathHeights(bool success, const QList<TerrainPathQuery::PathHeightInfo_t> &rgPathHeightInfo)
 {
-    qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "success:_curIndex" << success << _curIndex;
-
-    if (!success) {
-        _rgPathHeightInfo.clear();
-        emit terrainDataReceived(false, _rgPathHeightInfo);
-        return;
-    }
-
-    (void) _rgPathHeightInfo.append(pathHeightInfo);
+    qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "success:count" << success << rgPathHeightInfo.count();
 
-    if (++_curIndex >= (_rgCoords.count() - 1)) {
-        qCDebug(TerrainQueryLog) << Q_FUNC_INFO << "complete";
-        emit terrainDataReceived(true, _rgPathHeightInfo);
-        if (_autoDelete) {
-            deleteLater();
-        }
-    } else {
-        _pathQuery->requestData(_rgCoords[_curIndex], _rgCoords[_curIndex + 1]);
+    emit terrainDataReceived(success, rgPathHeightInfo);
+    if (success && _autoDelete) {
+        deleteLater();
     }
 }
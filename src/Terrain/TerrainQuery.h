@@ -122,11 +122,7 @@ public:
     ///     @param coordinates to query
     void requestData(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord);
 
-    struct PathHeightInfo_t {
-        double distanceBetween;        ///< Distance between each height value
-        double finalDistanceBetween;   ///< Distance between final two height values
-        QList<double> heights;                ///< Terrain heights along path
-    };
+    using PathHeightInfo_t = TerrainQuery::PathHeightInfo_t;
 
 signals:
     /// Signalled when terrain data comes back from server
@@ -153,6 +149,7 @@ public:
     ~TerrainPolyPathQuery();
 
     /// Async terrain query for terrain heights for the paths between each specified QGeoCoordinate.
+    /// All segments are profiled together, see TerrainTileManager::addPolyPathQuery.
     /// When the query is done, the terrainData() signal is emitted.
     ///     @param polyPath List of QGeoCoordinate
     void requestData(const QVariantList &polyPath);
@@ -163,12 +160,9 @@ signals:
     void terrainDataReceived(bool success, const QList<TerrainPathQuery::PathHeightInfo_t> &rgPathHeightInfo);
 
 private slots:
-    void _terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t &pathHeightInfo);
+    void _polyPathHeights(bool success, const QList<TerrainPathQuery::PathHeightInfo_t> &rgPathHeightInfo);
 
 private:
     bool _autoDelete = false;
-    int _curIndex = 0;
-    QList<QGeoCoordinate> _rgCoords;
-    QList<TerrainPathQuery::PathHeightInfo_t> _rgPathHeightInfo;
-    TerrainPathQuery *_pathQuery = nullptr;
+    TerrainQueryInterface *_terrainQuery = nullptr;
 };
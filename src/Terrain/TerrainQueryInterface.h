@@ -12,6 +12,7 @@
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QList>
 #include <QtCore/QObject>
+#include <QtCore/QtNumeric>
 #include <QtNetwork/QNetworkReply>
 
 class QGeoCoordinate;
@@ -25,13 +26,22 @@ namespace TerrainQuery
         QueryModeNone,
         QueryModeCoordinates,
         QueryModePath,
-        QueryModeCarpet
+        QueryModeCarpet,
+        QueryModePolyPath
     };
 
     enum class State {
         Idle,
         Downloading,
     };
+
+    struct PathHeightInfo_t {
+        double distanceBetween = 0.;        ///< Distance between each height value
+        double finalDistanceBetween = 0.;   ///< Distance between final two height values
+        double minHeight = qQNaN();         ///< Lowest terrain height along path
+        double maxHeight = qQNaN();         ///< Highest terrain height along path
+        QList<double> heights;              ///< Terrain heights along path
+    };
 }
 
 /// Base class for offline/online terrain queries
@@ -60,14 +70,21 @@ public:
     ///     @param statsOnly true: Return only stats, no carpet data
     virtual void requestCarpetHeights(const QGeoCoordinate &swCoord, const QGeoCoordinate &neCoord, bool statsOnly);
 
+    /// Requests terrain heights along each segment of the specified polyline.
+    /// Signals: polyPathHeights
+    ///     @param polyPath at least two coordinates
+    virtual void requestPolyPathHeights(const QList<QGeoCoordinate> &polyPath);
+
     void signalCoordinateHeights(bool success, const QList<double> &heights);
     void signalPathHeights(bool success, double distanceBetween, double finalDistanceBetween, const QList<double> &heights);
     void signalCarpetHeights(bool success, double minHeight, double maxHeight, const QList<QList<double>> &carpet);
+    void signalPolyPathHeights(bool success, const QList<TerrainQuery::PathHeightInfo_t> &rgPathHeightInfo);
 
 signals:
     void coordinateHeightsReceived(bool success, const QList<double> &heights);
     void pathHeightsReceived(bool success, double distanceBetween, double finalDistanceBetween, const QList<double> &heights);
     void carpetHeightsReceived(bool success, double minHeight, double maxHeight, const QList<QList<double>> &carpet);
+    void polyPathHeightsReceived(bool success, const QList<TerrainQuery::PathHeightInfo_t> &rgPathHeightInfo);
 
 protected:
     virtual void _requestFailed();
@@ -87,6 +104,7 @@ public:
 
     void requestCoordinateHeights(const QList<QGeoCoordinate> &coordinates) override;
     void requestPathHeights(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord) override;
+    void requestPolyPathHeights(const QList<QGeoCoordinate> &polyPath) override;
 };
 
 /*===========================================================================*/
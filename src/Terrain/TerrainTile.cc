@@ -10,25 +10,35 @@
 #include "TerrainTile.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QtMath>
 #include <QtCore/QtNumeric>
 #include <QtPositioning/QGeoCoordinate>
 
+#include <cstring>
+
 QGC_LOGGING_CATEGORY(TerrainTileLog, "qgc.terrain.terraintile");
 
 TerrainTile::TerrainTile(const QByteArray &byteArray)
-    : _tileInfo(*reinterpret_cast<const TileInfo_t*>(byteArray.constData()))
+    : _data(byteArray)
 {
     // qCDebug(TerrainTileLog) << Q_FUNC_INFO << this;
 
     constexpr int cTileHeaderBytes = static_cast<int>(sizeof(TileInfo_t));
-    const int cTileBytesAvailable = byteArray.size();
+    const qsizetype cTileBytesAvailable = _data.size();
 
     if (cTileBytesAvailable < cTileHeaderBytes) {
         qCWarning(TerrainTileLog) << "Terrain tile binary data too small for TileInfo_s header";
         return;
     }
+    (void) memcpy(&_tileInfo, _data.constData(), cTileHeaderBytes);
 
-    const int cTileDataBytes = static_cast<int>(sizeof(int16_t)) * _tileInfo.gridSizeLat * _tileInfo.gridSizeLon;
+    if ((_tileInfo.gridSizeLat <= 0) || (_tileInfo.gridSizeLon <= 0)) {
+        qCWarning(TerrainTileLog) << this << "Tile grid is empty";
+        return;
+    }
+
+    const qsizetype cTileDataBytes = static_cast<qsizetype>(sizeof(int16_t)) * _tileInfo.gridSizeLat * _tileInfo.gridSizeLon;
     if (cTileBytesAvailable < cTileHeaderBytes + cTileDataBytes) {
         qCWarning(TerrainTileLog) << "Terrain tile binary data too small for tile data";
         return;
@@ -49,18 +59,8 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
     qCDebug(TerrainTileLog) << this << "TileInfo: min, max, avg:" << _tileInfo.minElevation << _tileInfo.maxElevation << _tileInfo.avgElevation;
     qCDebug(TerrainTileLog) << this << "TileInfo: cell size:" << _cellSizeLat << _cellSizeLon;
 
-    _elevationData.resize(_tileInfo.gridSizeLat);
-    for (int k = 0; k < _tileInfo.gridSizeLat; k++) {
-        _elevationData[k].resize(_tileInfo.gridSizeLon);
-    }
-
-    int valueIndex = 0;
-    const int16_t* const pTileData = reinterpret_cast<const int16_t*>(&reinterpret_cast<const uint8_t*>(byteArray.constData())[cTileHeaderBytes]);
-    for (int i = 0; i < _tileInfo.gridSizeLat; i++) {
-        for (int j = 0; j < _tileInfo.gridSizeLon; j++) {
-            _elevationData[i][j] = pTileData[valueIndex++];
-        }
-    }
+    // The header is 48 bytes so the grid stays 2-byte aligned in both heap and mapped buffers
+    _elevationData = reinterpret_cast<const int16_t*>(_data.constData() + cTileHeaderBytes);
 
     _isValid = true;
 }
@@ -68,6 +68,27 @@ TerrainTile::TerrainTile(const QByteArray &byteArray)
 TerrainTile::~TerrainTile()
 {
     // qCDebug(TerrainTileLog) << Q_FUNC_INFO << this;
+
+    // Drop the reference to the mapping before it is unmapped
+    _data.clear();
+}
+
+TerrainTile *TerrainTile::fromMappedFile(const QString &path)
+{
+    std::unique_ptr<QFile> file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    uchar* const mapped = file->map(0, file->size());
+    if (!mapped) {
+        qCWarning(TerrainTileLog) << "Unable to map terrain tile" << path << file->errorString();
+        return nullptr;
+    }
+
+    TerrainTile* const tile = new TerrainTile(QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file->size()));
+    tile->_mappedFile = std::move(file);
+    return tile;
 }
 
 double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
@@ -80,8 +101,8 @@ double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
     const double latDeltaSw = coordinate.latitude() - _tileInfo.swLat;
     const double lonDeltaSw = coordinate.longitude() - _tileInfo.swLon;
 
-    const int16_t latIndex = qFloor(latDeltaSw / _cellSizeLat);
-    const int16_t lonIndex = qFloor(lonDeltaSw / _cellSizeLon);
+    const int latIndex = qFloor(latDeltaSw / _cellSizeLat);
+    const int lonIndex = qFloor(lonDeltaSw / _cellSizeLon);
 
     const bool latIndexInvalid = (latIndex < 0) || (latIndex > (_tileInfo.gridSizeLat - 1));
     const bool lonIndexInvalid = (lonIndex < 0) || (lonIndex > (_tileInfo.gridSizeLon - 1));
@@ -91,14 +112,7 @@ double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
         return qQNaN();
     }
 
-    if ((latIndex >= _elevationData.size()) || (lonIndex >= _elevationData[latIndex].size())) {
-        qCWarning(TerrainTileLog).noquote() << this << "Internal error: _elevationData size inconsistent _tileInfo << coordinate" << coordinate
-            << "\n\t_tillIndo.gridSizeLat:" << _tileInfo.gridSizeLat << "_tileInfo.gridSizeLon:" << _tileInfo.gridSizeLon
-            << "\n\t_data.size():" << _elevationData.size() << "_elevationData[latIndex].size():" << _elevationData[latIndex].size();
-        return qQNaN();
-    }
-
-    const int16_t elevation = _elevationData[latIndex][lonIndex];
+    const int16_t elevation = _value(latIndex, lonIndex);
     if (elevation < _tileInfo.minElevation) {
         qCWarning(TerrainTileLog) << this << "Warning: elevation read is below min elevation in tile:" << elevation << "<" << _tileInfo.minElevation;
     } else if (elevation > _tileInfo.maxElevation) {
@@ -109,3 +123,68 @@ double TerrainTile::elevation(const QGeoCoordinate &coordinate) const
 
     return static_cast<double>(elevation);
 }
+
+void TerrainTile::elevations(const double *latitudes, const double *longitudes, qsizetype count, double *elevations, Interpolation interpolation) const
+{
+    if (!_isValid) {
+        qCWarning(TerrainTileLog) << this << "Request for elevations, but tile is invalid.";
+        for (qsizetype i = 0; i < count; i++) {
+            elevations[i] = qQNaN();
+        }
+        return;
+    }
+
+    const double swLat = _tileInfo.swLat;
+    const double swLon = _tileInfo.swLon;
+    const double neLat = _tileInfo.neLat;
+    const double neLon = _tileInfo.neLon;
+    const double invCellLat = 1.0 / _cellSizeLat;
+    const double invCellLon = 1.0 / _cellSizeLon;
+    const double maxRow = _tileInfo.gridSizeLat - 1;
+    const double maxCol = _tileInfo.gridSizeLon - 1;
+    const int rowStride = _tileInfo.gridSizeLon;
+    const int16_t* const grid = _elevationData;
+
+    if (interpolation == Interpolation::Nearest) {
+        // Same cell selection as elevation(), without the per coordinate logging
+        for (qsizetype i = 0; i < count; i++) {
+            const int row = qFloor((latitudes[i] - swLat) / _cellSizeLat);
+            const int col = qFloor((longitudes[i] - swLon) / _cellSizeLon);
+            if ((row < 0) || (row > maxRow) || (col < 0) || (col > maxCol)) {
+                elevations[i] = qQNaN();
+                continue;
+            }
+            elevations[i] = grid[(row * rowStride) + col];
+        }
+        return;
+    }
+
+    // Branch-light loop over plain arrays so the compiler can keep the interpolation in registers
+    for (qsizetype i = 0; i < count; i++) {
+        const double lat = latitudes[i];
+        const double lon = longitudes[i];
+        if ((lat < swLat) || (lat > neLat) || (lon < swLon) || (lon > neLon)) {
+            elevations[i] = qQNaN();
+            continue;
+        }
+
+        // Grid values are cell centered, clamping holds the edge values across the outer half cell
+        const double row = qBound(0.0, ((lat - swLat) * invCellLat) - 0.5, maxRow);
+        const double col = qBound(0.0, ((lon - swLon) * invCellLon) - 0.5, maxCol);
+        const int row0 = static_cast<int>(row);
+        const int col0 = static_cast<int>(col);
+        const int row1 = qMin(row0 + 1, static_cast<int>(maxRow));
+        const int col1 = qMin(col0 + 1, static_cast<int>(maxCol));
+        const double rowFrac = row - row0;
+        const double colFrac = col - col0;
+
+        const double v00 = grid[(row0 * rowStride) + col0];
+        const double v01 = grid[(row0 * rowStride) + col1];
+        const double v10 = grid[(row1 * rowStride) + col0];
+        const double v11 = grid[(row1 * rowStride) + col1];
+
+        const double south = v00 + ((v01 - v00) * colFrac);
+        const double north = v10 + ((v11 - v10) * colFrac);
+        elevations[i] = south + ((north - south) * rowFrac);
+    }
+}
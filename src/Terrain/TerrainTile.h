@@ -9,24 +9,42 @@
 
 #pragma once
 
+#include <QtCore/QByteArray>
 #include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 
+#include <memory>
+
+class QFile;
 class QGeoCoordinate;
 class TerrainTileTest;
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileLog)
 
+/// Elevation grid for one terrain tile.
+///
+/// The serialized tile (TileInfo_t header followed by a row-major int16_t grid, south row first) is
+/// used in place without unpacking, so a tile can be backed directly by a memory-mapped cache file.
 class TerrainTile
 {
     friend class TerrainTileTest;
 
 public:
+    /// How elevations() resolves a coordinate to a height
+    enum class Interpolation {
+        Nearest,    ///< Value of the grid cell holding the coordinate, same as elevation()
+        Bilinear    ///< Interpolated between cell centers
+    };
+
     /// Constructor from serialized elevation data (either from file or web)
     ///    @param document
     explicit TerrainTile(const QByteArray &byteArray);
     virtual ~TerrainTile();
 
+    /// Maps a tile previously written with the serialized format
+    ///    @return nullptr if the file can not be mapped, otherwise a tile which may still be invalid
+    static TerrainTile *fromMappedFile(const QString &path);
+
     /// Check whether valid data is loaded
     ///    @return true if data is valid
     bool isValid() const { return _isValid; }
@@ -36,6 +54,12 @@ public:
     ///    @return elevation
     double elevation(const QGeoCoordinate &coordinate) const;
 
+    /// Elevations for a batch of coordinates. Coordinates outside the tile produce NaN.
+    ///    @param latitudes, longitudes count values each
+    ///    @param[out] elevations count values
+    ///    @param interpolation Bilinear treats each grid value as the sample at its cell center
+    void elevations(const double *latitudes, const double *longitudes, qsizetype count, double *elevations, Interpolation interpolation = Interpolation::Nearest) const;
+
     /// Accessor for the minimum elevation of the tile
     ///    @return minimum elevation
     double minElevation() const { return (_isValid ? static_cast<double>(_tileInfo.minElevation) : qQNaN()); }
@@ -48,6 +72,12 @@ public:
     ///    @return average elevation
     double avgElevation() const { return (_isValid ? _tileInfo.avgElevation : qQNaN()); }
 
+    /// Serialized tile data, suitable for writing to the tile cache
+    const QByteArray &data() const { return _data; }
+
+    /// Memory accounted to this tile by the tile cache
+    qsizetype byteSize() const { return _data.size(); }
+
 protected:
     struct TileInfo_t {
         double  swLat, swLon, neLat, neLon;
@@ -57,9 +87,13 @@ protected:
     } Q_PACKED;
 
 private:
+    int16_t _value(int latIndex, int lonIndex) const { return _elevationData[(latIndex * _tileInfo.gridSizeLon) + lonIndex]; }
+
     TileInfo_t _tileInfo{};
-    QList<QList<int16_t>> _elevationData;   ///< 2D elevation data array
-    double _cellSizeLat = 0.0;              ///< data grid size in latitude direction
-    double _cellSizeLon = 0.0;              ///< data grid size in longitude direction
-    bool _isValid = false;                  ///< data loaded is valid
+    QByteArray _data;                           ///< Serialized tile, owns or references the grid
+    std::unique_ptr<QFile> _mappedFile;         ///< Keeps a memory-mapped _data alive
+    const int16_t *_elevationData = nullptr;    ///< Row-major grid inside _data
+    double _cellSizeLat = 0.0;                  ///< data grid size in latitude direction
+    double _cellSizeLon = 0.0;                  ///< data grid size in longitude direction
+    bool _isValid = false;                      ///< data loaded is valid
 };
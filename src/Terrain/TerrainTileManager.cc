@@ -18,11 +18,20 @@
 #include "SettingsManager.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
 #include <QtLocation/private/qgeotilespec_p.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkProxy>
 #include <QtNetwork/QNetworkRequest>
 
+#include <limits>
+#include <numeric>
+#include <utility>
+
 QGC_LOGGING_CATEGORY(TerrainTileManagerLog, "qgc.terrain.terraintilemanager")
 
 Q_GLOBAL_STATIC(TerrainTileManager, _terrainTileManager)
@@ -34,10 +43,19 @@ TerrainTileManager *TerrainTileManager::instance()
 
 TerrainTileManager::TerrainTileManager(QObject *parent)
     : QObject(parent)
+    , _tiles(kMaxTileCacheBytes)
     , _networkManager(new QNetworkAccessManager(this))
 {
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
 
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/TerrainTiles");
+    if (QDir::root().mkpath(cacheDir)) {
+        _tileCacheDir = cacheDir;
+        (void) QtConcurrent::run(&TerrainTileManager::_pruneTileCacheDir, _tileCacheDir);
+    } else {
+        qCWarning(TerrainTileManagerLog) << "Could not create terrain tile cache directory:" << cacheDir;
+    }
+
 #if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
     QNetworkProxy proxy = _networkManager->proxy();
     proxy.setType(QNetworkProxy::DefaultProxy);
@@ -47,8 +65,6 @@ TerrainTileManager::TerrainTileManager(QObject *parent)
 
 TerrainTileManager::~TerrainTileManager()
 {
-    qDeleteAll(_tiles);
-
     // qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << this;
 }
 
@@ -56,36 +72,52 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>
 {
     error = false;
 
-    const QString elevationProviderName = qgcApp()->toolbox()->settingsManager()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
-    const SharedMapProvider provider = UrlFactory::getMapProviderFromProviderType(elevationProviderName);
-    for (const QGeoCoordinate &coordinate: coordinates) {
-        const QString tileHash = UrlFactory::getTileHash(
-            provider->getMapName(),
-            provider->long2tileX(coordinate.longitude(), 1),
-            provider->lat2tileY(coordinate.latitude(), 1),
-            1
-        );
+    const SharedMapProvider provider = _elevationProvider();
+
+    QList<double> latitudes;
+    QList<double> longitudes;
+    altitudes.reserve(altitudes.count() + coordinates.count());
+
+    qsizetype index = 0;
+    while (index < coordinates.count()) {
+        const QGeoCoordinate &coordinate = coordinates[index];
+        const int tileX = provider->long2tileX(coordinate.longitude(), 1);
+        const int tileY = provider->lat2tileY(coordinate.latitude(), 1);
+        const QString tileHash = UrlFactory::getTileHash(provider->getMapName(), tileX, tileY, 1);
         qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "hash:coordinate" << tileHash << coordinate;
 
-        TerrainTile* const tile = _getCachedTile(tileHash);
+        const SharedTerrainTile tile = _getCachedTile(tileHash);
         if (tile) {
-            const double elevation = tile->elevation(coordinate);
-            if (qIsNaN(elevation)) {
-                error = true;
-                qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
-            } else {
-                qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning elevation from tile cache" << elevation;
+            // Paths mostly stay within a tile for many points, look them all up in one batch
+            latitudes.clear();
+            longitudes.clear();
+            qsizetype runEnd = index;
+            while (runEnd < coordinates.count()) {
+                const QGeoCoordinate &runCoordinate = coordinates[runEnd];
+                if ((provider->long2tileX(runCoordinate.longitude(), 1) != tileX) || (provider->lat2tileY(runCoordinate.latitude(), 1) != tileY)) {
+                    break;
+                }
+                latitudes.append(runCoordinate.latitude());
+                longitudes.append(runCoordinate.longitude());
+                runEnd++;
             }
-            altitudes.push_back(elevation);
+
+            const qsizetype first = altitudes.count();
+            altitudes.resize(first + latitudes.count());
+            tile->elevations(latitudes.constData(), longitudes.constData(), latitudes.count(), altitudes.data() + first, _interpolation);
+
+            for (qsizetype i = first; i < altitudes.count(); i++) {
+                if (qIsNaN(altitudes[i])) {
+                    error = true;
+                    qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "Internal Error: missing elevation in tile cache";
+                    break;
+                }
+            }
+            qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "returning" << latitudes.count() << "elevations from tile cache";
+
+            index = runEnd;
         } else if (_state != TerrainQuery::State::Downloading) {
-            QGeoTileSpec spec;
-            spec.setX(provider->long2tileX(coordinate.longitude(), 1));
-            spec.setY(provider->lat2tileY(coordinate.latitude(), 1));
-            spec.setZoom(1);
-            spec.setMapId(provider->getMapId());
-            const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
-            QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
-            (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
+            _requestTile(provider, tileX, tileY, tileHash);
             _state = TerrainQuery::State::Downloading;
             // TODO: Batch Downloading?
             return false;
@@ -163,7 +195,177 @@ void TerrainTileManager::addPathQuery(TerrainQueryInterface *terrainQueryInterfa
     terrainQueryInterface->signalPathHeights((coordinates.count() == altitudes.count()), distanceBetween, finalDistanceBetween, altitudes);
 }
 
+void TerrainTileManager::addPolyPathQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &polyPath)
+{
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "count" << polyPath.count();
+
+    if (polyPath.count() < 2) {
+        qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "poly path requires at least two coordinates";
+        terrainQueryInterface->signalPolyPathHeights(false, QList<TerrainQuery::PathHeightInfo_t>());
+        return;
+    }
+
+    const SharedMapProvider provider = _elevationProvider();
+
+    QList<qsizetype> segmentIndices(polyPath.count() - 1);
+    std::iota(segmentIndices.begin(), segmentIndices.end(), 0);
+
+    // Sampling a long polyline is dominated by the geodesic distance math, so each segment is done on the pool
+    const QList<PathSamples_t> segments = QtConcurrent::blockingMapped<QList<PathSamples_t>>(segmentIndices, [&polyPath, &provider](qsizetype index) {
+        PathSamples_t samples;
+        _samplePath(polyPath[index], polyPath[index + 1], samples.latitudes, samples.longitudes, samples.distanceBetween, samples.finalDistanceBetween);
+        samples.tileKeys.reserve(samples.latitudes.count());
+        for (qsizetype i = 0; i < samples.latitudes.count(); i++) {
+            const quint64 tileKey = _tileKey(provider->long2tileX(samples.longitudes[i], 1), provider->lat2tileY(samples.latitudes[i], 1));
+            (void) samples.tileKeys.append(tileKey);
+            (void) samples.uniqueTileKeys.insert(tileKey);
+        }
+        return samples;
+    });
+
+    // Each tile is needed by many segments, only look it up or download it once
+    QSet<quint64> tileKeys;
+    for (const PathSamples_t &samples : segments) {
+        tileKeys.unite(samples.uniqueTileKeys);
+    }
+
+    QSet<QString> missingTileHashes;
+    for (const quint64 tileKey : std::as_const(tileKeys)) {
+        const QString tileHash = _tileHash(provider, tileKey);
+        if (!_getCachedTile(tileHash)) {
+            (void) missingTileHashes.insert(tileHash);
+            _requestTile(provider, static_cast<int>(tileKey >> 32), static_cast<int>(static_cast<quint32>(tileKey)), tileHash);
+        }
+    }
+
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "segments:tiles:missing" << segments.count() << tileKeys.count() << missingTileHashes.count();
+
+    if (!missingTileHashes.isEmpty()) {
+        QueuedRequestInfo_t queuedRequestInfo = {
+            terrainQueryInterface,
+            TerrainQuery::QueryMode::QueryModePolyPath,
+            0,
+            0,
+            polyPath
+        };
+        queuedRequestInfo.polyPathSegments = segments;
+        queuedRequestInfo.missingTileHashes = missingTileHashes;
+        _requestQueue.enqueue(queuedRequestInfo);
+        return;
+    }
+
+    _signalPolyPathHeights(terrainQueryInterface, segments);
+}
+
+void TerrainTileManager::_signalPolyPathHeights(TerrainQueryInterface *terrainQueryInterface, const QList<PathSamples_t> &segments)
+{
+    const SharedMapProvider provider = _elevationProvider();
+
+    QSet<quint64> tileKeys;
+    for (const PathSamples_t &samples : segments) {
+        tileKeys.unite(samples.uniqueTileKeys);
+    }
+
+    // Resolve every tile up front so the workers only read. Holding the tiles keeps them alive even if loading
+    // pushes them out of the bounded cache.
+    QHash<quint64, SharedTerrainTile> tiles;
+    tiles.reserve(tileKeys.count());
+    QSet<QString> missingTileHashes;
+    for (const quint64 tileKey : std::as_const(tileKeys)) {
+        const QString tileHash = _tileHash(provider, tileKey);
+        const SharedTerrainTile tile = _getCachedTile(tileHash);
+        if (tile) {
+            tiles[tileKey] = tile;
+        } else {
+            // Evicted before it could be persisted, download it again
+            (void) missingTileHashes.insert(tileHash);
+            _requestTile(provider, static_cast<int>(tileKey >> 32), static_cast<int>(static_cast<quint32>(tileKey)), tileHash);
+        }
+    }
+
+    if (!missingTileHashes.isEmpty()) {
+        qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "re-queueing for missing tiles" << missingTileHashes.count();
+        QueuedRequestInfo_t queuedRequestInfo = {
+            terrainQueryInterface,
+            TerrainQuery::QueryMode::QueryModePolyPath,
+            0,
+            0,
+            {}
+        };
+        queuedRequestInfo.polyPathSegments = segments;
+        queuedRequestInfo.missingTileHashes = missingTileHashes;
+        _requestQueue.enqueue(queuedRequestInfo);
+        return;
+    }
+
+    const TerrainTile::Interpolation interpolation = _interpolation;
+    const QList<TerrainQuery::PathHeightInfo_t> rgPathHeightInfo = QtConcurrent::blockingMapped<QList<TerrainQuery::PathHeightInfo_t>>(segments, [&tiles, interpolation](const PathSamples_t &samples) {
+        TerrainQuery::PathHeightInfo_t pathHeightInfo;
+        pathHeightInfo.distanceBetween = samples.distanceBetween;
+        pathHeightInfo.finalDistanceBetween = samples.finalDistanceBetween;
+        pathHeightInfo.heights.resize(samples.latitudes.count());
+
+        // Consecutive samples almost always share a tile, hand each run to the tile as one batch
+        qsizetype runStart = 0;
+        while (runStart < samples.tileKeys.count()) {
+            const quint64 tileKey = samples.tileKeys[runStart];
+            qsizetype runEnd = runStart + 1;
+            while ((runEnd < samples.tileKeys.count()) && (samples.tileKeys[runEnd] == tileKey)) {
+                runEnd++;
+            }
+            tiles.value(tileKey)->elevations(samples.latitudes.constData() + runStart, samples.longitudes.constData() + runStart, runEnd - runStart, pathHeightInfo.heights.data() + runStart, interpolation);
+            runStart = runEnd;
+        }
+
+        double minHeight = std::numeric_limits<double>::max();
+        double maxHeight = std::numeric_limits<double>::lowest();
+        for (const double height : std::as_const(pathHeightInfo.heights)) {
+            minHeight = qMin(minHeight, height);
+            maxHeight = qMax(maxHeight, height);
+            if (qIsNaN(height)) {
+                minHeight = maxHeight = qQNaN();
+                break;
+            }
+        }
+        pathHeightInfo.minHeight = minHeight;
+        pathHeightInfo.maxHeight = maxHeight;
+
+        return pathHeightInfo;
+    });
+
+    for (const TerrainQuery::PathHeightInfo_t &pathHeightInfo : rgPathHeightInfo) {
+        if (qIsNaN(pathHeightInfo.minHeight)) {
+            qCWarning(TerrainTileManagerLog) << Q_FUNC_INFO << "signalling failure due to internal error";
+            terrainQueryInterface->signalPolyPathHeights(false, QList<TerrainQuery::PathHeightInfo_t>());
+            return;
+        }
+    }
+
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "all segments taken from cached data" << rgPathHeightInfo.count();
+    terrainQueryInterface->signalPolyPathHeights(true, rgPathHeightInfo);
+}
+
 QList<QGeoCoordinate> TerrainTileManager::_pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween)
+{
+    QList<double> latitudes;
+    QList<double> longitudes;
+    _samplePath(fromCoord, toCoord, latitudes, longitudes, distanceBetween, finalDistanceBetween);
+
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve(latitudes.count());
+    for (qsizetype i = 0; i < latitudes.count(); i++) {
+        (void) coordinates.append(QGeoCoordinate(latitudes[i], longitudes[i]));
+    }
+
+    // We always want the last one to be the endpoint
+    coordinates.last() = toCoord;
+
+    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "fromCoord:toCoord:distanceBetween:finalDisanceBetween:coordCount" << fromCoord << toCoord << distanceBetween << finalDistanceBetween << coordinates.count();
+
+    return coordinates;
+}
+
+void TerrainTileManager::_samplePath(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, QList<double> &latitudes, QList<double> &longitudes, double &distanceBetween, double &finalDistanceBetween)
 {
     const double lat = fromCoord.latitude();
     const double lon = fromCoord.longitude();
@@ -171,27 +373,54 @@ QList<QGeoCoordinate> TerrainTileManager::_pathQueryToCoords(const QGeoCoordinat
     const double latDiff = toCoord.latitude() - lat;
     const double lonDiff = toCoord.longitude() - lon;
 
-    QList<QGeoCoordinate> coordinates;
+    latitudes.clear();
+    longitudes.clear();
     if (steps == 0) {
-        (void) coordinates.append(fromCoord);
-        (void) coordinates.append(toCoord);
-        distanceBetween = finalDistanceBetween = coordinates[0].distanceTo(coordinates[1]);
-    } else {
-        for (int i = 0; i <= steps; i++) {
-            const double latStep = lat + ((latDiff * static_cast<double>(i)) / static_cast<double>(steps));
-            const double lonStep = lon + ((lonDiff * static_cast<double>(i)) / static_cast<double>(steps));
-            (void) coordinates.append(QGeoCoordinate(latStep, lonStep));
-        }
+        latitudes = { lat, toCoord.latitude() };
+        longitudes = { lon, toCoord.longitude() };
+        distanceBetween = finalDistanceBetween = fromCoord.distanceTo(toCoord);
+        return;
+    }
 
-        // We always have one too many and we always want the last one to be the endpoint
-        coordinates.last() = toCoord;
-        distanceBetween = coordinates[0].distanceTo(coordinates[1]);
-        finalDistanceBetween = coordinates[coordinates.count() - 2].distanceTo(coordinates.last());
+    latitudes.reserve(steps + 1);
+    longitudes.reserve(steps + 1);
+    for (int i = 0; i < steps; i++) {
+        (void) latitudes.append(lat + ((latDiff * static_cast<double>(i)) / static_cast<double>(steps)));
+        (void) longitudes.append(lon + ((lonDiff * static_cast<double>(i)) / static_cast<double>(steps)));
     }
+    (void) latitudes.append(toCoord.latitude());
+    (void) longitudes.append(toCoord.longitude());
 
-    qCDebug(TerrainTileManagerLog) << Q_FUNC_INFO << "fromCoord:toCoord:distanceBetween:finalDisanceBetween:coordCount" << fromCoord << toCoord << distanceBetween << finalDistanceBetween << coordinates.count();
+    distanceBetween = QGeoCoordinate(latitudes[0], longitudes[0]).distanceTo(QGeoCoordinate(latitudes[1], longitudes[1]));
+    finalDistanceBetween = QGeoCoordinate(latitudes[steps - 1], longitudes[steps - 1]).distanceTo(toCoord);
+}
 
-    return coordinates;
+TerrainTileManager::SharedMapProvider TerrainTileManager::_elevationProvider()
+{
+    const QString elevationProviderName = qgcApp()->toolbox()->settingsManager()->flightMapSettings()->elevationMapProvider()->rawValue().toString();
+    return UrlFactory::getMapProviderFromProviderType(elevationProviderName);
+}
+
+QString TerrainTileManager::_tileHash(const SharedMapProvider &provider, quint64 tileKey)
+{
+    return UrlFactory::getTileHash(provider->getMapName(), static_cast<int>(tileKey >> 32), static_cast<int>(static_cast<quint32>(tileKey)), 1);
+}
+
+void TerrainTileManager::_requestTile(const SharedMapProvider &provider, int tileX, int tileY, const QString &hash)
+{
+    if (_pendingTileHashes.contains(hash)) {
+        return;
+    }
+
+    QGeoTileSpec spec;
+    spec.setX(tileX);
+    spec.setY(tileY);
+    spec.setZoom(1);
+    spec.setMapId(provider->getMapId());
+    const QNetworkRequest request = QGeoTileFetcherQGC::getNetworkRequest(spec.mapId(), spec.x(), spec.y(), spec.zoom());
+    QGeoTiledMapReplyQGC* const reply = new QGeoTiledMapReplyQGC(_networkManager, request, spec, this);
+    (void) connect(reply, &QGeoTiledMapReplyQGC::finished, this, &TerrainTileManager::_terrainDone);
+    (void) _pendingTileHashes.insert(hash);
 }
 
 void TerrainTileManager::_tileFailed()
@@ -206,6 +435,9 @@ void TerrainTileManager::_tileFailed()
         case TerrainQuery::QueryMode::QueryModePath:
             requestInfo.terrainQueryInterface->signalPathHeights(false, requestInfo.distanceBetween, requestInfo.finalDistanceBetween, noAltitudes);
             break;
+        case TerrainQuery::QueryMode::QueryModePolyPath:
+            requestInfo.terrainQueryInterface->signalPolyPathHeights(false, QList<TerrainQuery::PathHeightInfo_t>());
+            break;
         default:
             continue;
         }
@@ -216,8 +448,6 @@ void TerrainTileManager::_tileFailed()
 
 void TerrainTileManager::_terrainDone()
 {
-    _state = TerrainQuery::State::Idle;
-
     QGeoTiledMapReplyQGC* const reply = qobject_cast<QGeoTiledMapReplyQGC*>(QObject::sender());
     if (!reply) {
         qCWarning(TerrainTileManagerLog) << "Elevation tile fetched but invalid reply data type.";
@@ -227,6 +457,13 @@ void TerrainTileManager::_terrainDone()
 
     const QByteArray responseBytes = reply->mapImageData();
     const QGeoTileSpec spec = reply->tileSpec();
+    const QString hash = UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
+    (void) _pendingTileHashes.remove(hash);
+
+    // Other tiles may still be in flight, only a reply to the last of them lets a new download start
+    if (_pendingTileHashes.isEmpty()) {
+        _state = TerrainQuery::State::Idle;
+    }
 
     if (reply->error() != QGeoTiledMapReplyQGC::NoError) {
         qCWarning(TerrainTileManagerLog) << "Elevation tile fetching returned error:" << reply->errorString();
@@ -242,14 +479,26 @@ void TerrainTileManager::_terrainDone()
 
     qCDebug(TerrainTileManagerLog) << "Received some bytes of terrain data:" << responseBytes.size();
 
-    const QString hash = UrlFactory::getTileHash(UrlFactory::getProviderTypeFromQtMapId(spec.mapId()), spec.x(), spec.y(), spec.zoom());
-    _cacheTile(responseBytes, hash);
+    // Queued poly path requests ask for a tile again if it is not in the cache, don't keep fetching a bad one
+    if (!_cacheTile(responseBytes, hash)) {
+        _tileFailed();
+        return;
+    }
 
     for (qsizetype i = _requestQueue.count() - 1; i >= 0; i--) {
         bool error;
         QList<double> altitudes;
         QueuedRequestInfo_t &requestInfo = _requestQueue[i];
 
+        if (requestInfo.queryMode == TerrainQuery::QueryMode::QueryModePolyPath) {
+            (void) requestInfo.missingTileHashes.remove(hash);
+            if (requestInfo.missingTileHashes.isEmpty()) {
+                const QueuedRequestInfo_t polyPathRequestInfo = _requestQueue.takeAt(i);
+                _signalPolyPathHeights(polyPathRequestInfo.terrainQueryInterface, polyPathRequestInfo.polyPathSegments);
+            }
+            continue;
+        }
+
         if (!getAltitudesForCoordinates(requestInfo.coordinates, altitudes, error)) {
             continue;
         }
@@ -283,39 +532,98 @@ void TerrainTileManager::_terrainDone()
     }
 }
 
-void TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
+QString TerrainTileManager::_tileFilePath(const QString &hash) const
 {
-    TerrainTile* const terrainTile = new TerrainTile(data);
-    if (terrainTile->isValid()) {
-        _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            (void) _tiles.insert(hash, terrainTile);
-        } else {
-            delete terrainTile;
-        }
-        _tilesMutex.unlock();
-    } else {
-        delete terrainTile;
+    return _tileCacheDir.isEmpty() ? QString() : QStringLiteral("%1/%2.bin").arg(_tileCacheDir, hash);
+}
+
+bool TerrainTileManager::_cacheTile(const QByteArray &data, const QString &hash)
+{
+    const SharedTerrainTile terrainTile = std::make_shared<const TerrainTile>(data);
+    if (!terrainTile->isValid()) {
         qCWarning(TerrainTileManagerLog) << "Received invalid tile";
+        return false;
     }
+
+    // Persist the serialized tile so it is available after a restart and without a network connection. A tile which
+    // is already on disk may be mapped by a reader, it is left alone rather than replaced underneath the mapping.
+    const QString filePath = _tileFilePath(hash);
+    if (!filePath.isEmpty() && !QFile::exists(filePath)) {
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || (file.write(data) != data.size()) || !file.commit()) {
+            qCWarning(TerrainTileManagerLog) << "Could not save terrain tile" << filePath << file.errorString();
+        } else if (++_tilesSavedSincePrune >= kTilesSavedPerPrune) {
+            _tilesSavedSincePrune = 0;
+            (void) QtConcurrent::run(&TerrainTileManager::_pruneTileCacheDir, _tileCacheDir);
+        }
+    }
+
+    QMutexLocker lock(&_tilesMutex);
+    if (!_tiles.contains(hash)) {
+        (void) _tiles.insert(hash, new SharedTerrainTile(terrainTile), terrainTile->byteSize());
+    }
+
+    return true;
 }
 
-TerrainTile *TerrainTileManager::_getCachedTile(const QString &hash)
+TerrainTileManager::SharedTerrainTile TerrainTileManager::_getCachedTile(const QString &hash)
 {
-    _tilesMutex.lock();
-    if (!_tiles.contains(hash)) {
-        _tilesMutex.unlock();
-        return nullptr;
+    QMutexLocker lock(&_tilesMutex);
+
+    // Hand out a reference taken under the lock, an insert on another thread may evict the cache entry at any time
+    const SharedTerrainTile* const cachedTile = _tiles.object(hash);
+    if (cachedTile) {
+        return *cachedTile;
     }
 
-    TerrainTile* const tile = _tiles[hash];
+    const QString filePath = _tileFilePath(hash);
+    if (filePath.isEmpty() || !QFile::exists(filePath)) {
+        return nullptr;
+    }
 
+    const SharedTerrainTile tile(TerrainTile::fromMappedFile(filePath));
+    if (!tile) {
+        return nullptr;
+    }
     if (!tile->isValid()) {
-        _tilesMutex.unlock();
+        qCWarning(TerrainTileManagerLog) << "Removing invalid cached terrain tile" << filePath;
+        (void) QFile::remove(filePath);
         return nullptr;
     }
 
-    _tilesMutex.unlock();
+    // Pruning goes by modification time, so a tile read back from disk counts as used
+    QFile touchFile(filePath);
+    if (touchFile.open(QIODevice::ReadWrite)) {
+        (void) touchFile.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    qCDebug(TerrainTileManagerLog) << "Mapped terrain tile from disk cache" << filePath;
+    (void) _tiles.insert(hash, new SharedTerrainTile(tile), tile->byteSize());
 
     return tile;
 }
+
+void TerrainTileManager::_pruneTileCacheDir(const QString &tileCacheDir)
+{
+    const QDir cacheDir(tileCacheDir);
+    const QFileInfoList entries = cacheDir.entryInfoList(QStringList(QStringLiteral("*.bin")), QDir::Files, QDir::Time);
+    const QDateTime oldest = QDateTime::currentDateTime().addDays(-kMaxTileDiskCacheAgeDays);
+
+    // Most recently used first, so everything past the size limit is older than what is kept. A tile which is mapped
+    // right now keeps working where the platform allows removing it, otherwise it stays until the next prune.
+    qint64 totalBytes = 0;
+    int removedCount = 0;
+    for (const QFileInfo &entry : entries) {
+        totalBytes += entry.size();
+        if ((entry.lastModified() < oldest) || (totalBytes > kMaxTileDiskCacheBytes)) {
+            totalBytes -= entry.size();
+            if (QFile::remove(entry.absoluteFilePath())) {
+                removedCount++;
+            }
+        }
+    }
+
+    if (removedCount > 0) {
+        qCDebug(TerrainTileManagerLog) << "Pruned" << removedCount << "tiles from the terrain tile disk cache";
+    }
+}
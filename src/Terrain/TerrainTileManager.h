@@ -10,16 +10,22 @@
 #pragma once
 
 #include "TerrainQueryInterface.h"
+#include "TerrainTile.h"
 
+#include <QtCore/QCache>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QQueue>
+#include <QtCore/QSet>
 #include <QtPositioning/QGeoCoordinate>
 
-class TerrainTile;
+#include <memory>
+
+class MapProvider;
 class QNetworkAccessManager;
 class UnitTestTerrainQuery;
+class TerrainQueryTest;
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainTileManagerLog)
 
@@ -28,6 +34,7 @@ class TerrainTileManager : public QObject
     Q_OBJECT
 
     friend class UnitTestTerrainQuery;
+    friend class TerrainQueryTest;
 public:
     explicit TerrainTileManager(QObject *parent = nullptr);
     ~TerrainTileManager();
@@ -42,15 +49,48 @@ public:
     void addCoordinateQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &coordinates);
     void addPathQuery(TerrainQueryInterface *terrainQueryInterface, const QGeoCoordinate &startPoint, const QGeoCoordinate &endPoint);
 
+    /// Profiles every segment of the polyline in one request. Sampling and height lookup are spread across the
+    /// global thread pool and each tile needed by any segment is downloaded once, with all missing tiles in flight together.
+    void addPolyPathQuery(TerrainQueryInterface *terrainQueryInterface, const QList<QGeoCoordinate> &polyPath);
+
+    /// Heights are taken from the grid cell holding each coordinate unless bilinear interpolation is asked for here
+    TerrainTile::Interpolation interpolation() const { return _interpolation; }
+    void setInterpolation(TerrainTile::Interpolation interpolation) { _interpolation = interpolation; }
+
 private slots:
     void _terrainDone();
 
 private:
+    using SharedMapProvider = std::shared_ptr<const MapProvider>;
+    using SharedTerrainTile = std::shared_ptr<const TerrainTile>;
+
+    /// Samples along one segment of a poly path query
+    struct PathSamples_t {
+        QList<double> latitudes;
+        QList<double> longitudes;
+        QList<quint64> tileKeys;                        ///< Tile holding each sample, see _tileKey
+        QSet<quint64> uniqueTileKeys;
+        double distanceBetween = 0.;
+        double finalDistanceBetween = 0.;
+    };
+
     /// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
     static QList<QGeoCoordinate> _pathQueryToCoords(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, double &distanceBetween, double &finalDistanceBetween);
+    /// Same spacing as _pathQueryToCoords, written to flat latitude/longitude lists
+    static void _samplePath(const QGeoCoordinate &fromCoord, const QGeoCoordinate &toCoord, QList<double> &latitudes, QList<double> &longitudes, double &distanceBetween, double &finalDistanceBetween);
+    static quint64 _tileKey(int tileX, int tileY) { return (static_cast<quint64>(static_cast<quint32>(tileX)) << 32) | static_cast<quint32>(tileY); }
+    static SharedMapProvider _elevationProvider();
+    static QString _tileHash(const SharedMapProvider &provider, quint64 tileKey);
     void _tileFailed();
-    void _cacheTile(const QByteArray &data, const QString &hash);
-    TerrainTile *_getCachedTile(const QString &hash);
+    void _requestTile(const SharedMapProvider &provider, int tileX, int tileY, const QString &hash);
+    bool _cacheTile(const QByteArray &data, const QString &hash);
+    /// The tile stays valid for as long as the caller holds on to it, even if the cache evicts it meanwhile
+    SharedTerrainTile _getCachedTile(const QString &hash);
+    QString _tileFilePath(const QString &hash) const;
+    /// Deletes tiles not used for kMaxTileDiskCacheAgeDays, then the least recently used ones until the directory is
+    /// within kMaxTileDiskCacheBytes
+    static void _pruneTileCacheDir(const QString &tileCacheDir);
+    void _signalPolyPathHeights(TerrainQueryInterface *terrainQueryInterface, const QList<PathSamples_t> &segments);
 
     struct QueuedRequestInfo_t {
         TerrainQueryInterface *terrainQueryInterface;
@@ -58,13 +98,24 @@ private:
         double distanceBetween;                         ///< Distance between each returned height
         double finalDistanceBetween;                    ///< Distance between for final height
         QList<QGeoCoordinate> coordinates;
+        QList<PathSamples_t> polyPathSegments;          ///< QueryModePolyPath only
+        QSet<QString> missingTileHashes;                ///< QueryModePolyPath only: tiles still being downloaded
     };
 
     QQueue<QueuedRequestInfo_t> _requestQueue;
     TerrainQuery::State _state = TerrainQuery::State::Idle;
 
     QMutex _tilesMutex;
-    QHash<QString, TerrainTile*> _tiles;
+    QCache<QString, SharedTerrainTile> _tiles;  ///< LRU bounded by kMaxTileCacheBytes of tile data
+    QString _tileCacheDir;                  ///< Tiles are persisted here and mapped back in on a cache miss
+    QSet<QString> _pendingTileHashes;       ///< Tiles with a download in flight
+    int _tilesSavedSincePrune = 0;
+    TerrainTile::Interpolation _interpolation = TerrainTile::Interpolation::Nearest;
+
+    static constexpr qsizetype kMaxTileCacheBytes = 32 * 1024 * 1024;
+    static constexpr qint64 kMaxTileDiskCacheBytes = 256LL * 1024 * 1024;
+    static constexpr int kMaxTileDiskCacheAgeDays = 90;
+    static constexpr int kTilesSavedPerPrune = 100;
 
     QNetworkAccessManager *_networkManager = nullptr;
 };
@@ -49,6 +49,33 @@ SettingsPage {
         }
     }
 
+    SettingsGroupLayout {
+        heading:            qsTr("Stick Controller")
+        headingDescription: qsTr("Only this serial port, or ports with this USB vendor id, are probed for a stick controller. Detection is off while both are unset.")
+        visible:            _autoConnectSettings.visible
+
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Serial Port")
+            fact:               _autoConnectSettings.joystickSerialPort
+            visible:            fact.visible
+        }
+
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("USB Vendor Id")
+            fact:               _autoConnectSettings.joystickUsbVendorId
+            visible:            fact.visible
+        }
+
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("USB Product Id")
+            fact:               _autoConnectSettings.joystickUsbProductId
+            visible:            fact.visible
+        }
+    }
+
     SettingsGroupLayout {
         heading: qsTr("Links")
 
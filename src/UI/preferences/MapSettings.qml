@@ -223,7 +223,15 @@ Item {
 
             LabelledFactTextField {
                 fact: _mapsSettings.maxCacheMemorySize
-            }    
+            }
+
+            LabelledFactTextField {
+                fact: _mapsSettings.maxCacheHotTileSize
+            }
+
+            QGCLabel {
+                text: qsTr("Hot tile cache: %1").arg(_mapEngineManager.hotTileStatsStr)
+            }
         }
 
         QGCFileDialog {
@@ -31,6 +31,13 @@ SettingsPage {
             visible:            fact.visible
         }
 
+        LabelledFactTextField {
+            Layout.fillWidth:   true
+            label:              qsTr("Mission Read Window")
+            fact:               _settingsManager.appSettings.missionTransferWindow
+            visible:            fact.visible
+        }
+
         LabelledFactTextField {
             Layout.fillWidth:   true
             label:              qsTr("VTOL TransitionDistance")
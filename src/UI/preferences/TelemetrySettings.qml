@@ -131,6 +131,15 @@ SettingsPage {
             visible:                    fact.visible
             enabled:                    _appSettings.forwardMavlink.rawValue
         }
+
+        LabelledFactTextField {
+            Layout.fillWidth:           true
+            textFieldPreferredWidth:    ScreenTools.defaultFontPixelWidth * 20
+            label:                      qsTr("Message ids (empty for all)")
+            fact:                       _appSettings.forwardMavlinkMessageIds
+            visible:                    fact.visible
+            enabled:                    _appSettings.forwardMavlink.rawValue
+        }
     }
 
     SettingsGroupLayout {
@@ -0,0 +1,466 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FTPDownloadFile.h"
+#include "QGC.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+
+QGC_LOGGING_CATEGORY(FTPDownloadFileLog, "qgc.vehicle.ftpdownloadfile")
+
+namespace {
+    constexpr quint32 kResumeMagic = 0x52505446;    // "FTPR"
+    constexpr quint32 kResumeVersion = 1;
+}
+
+FTPDownloadFileWriter::FTPDownloadFileWriter(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(FTPDownloadFileLog) << Q_FUNC_INFO << this;
+}
+
+FTPDownloadFileWriter::~FTPDownloadFileWriter()
+{
+    if (_file.isOpen()) {
+        _file.close();
+    }
+
+    // qCDebug(FTPDownloadFileLog) << Q_FUNC_INFO << this;
+}
+
+void FTPDownloadFileWriter::open(const QString &fileName, const QString &sourceId, quint32 fileSize, bool sizeTrusted)
+{
+    _writeFailed = false;
+    _fileName = fileName;
+    _sourceId = sourceId;
+
+    const QBitArray receivedBlocks = sizeTrusted ? _loadResumeInfo(fileSize) : QBitArray();
+    if (receivedBlocks.isEmpty()) {
+        (void) QFile::remove(FTPDownloadFile::resumeFileName(fileName));
+    }
+
+    _file.setFileName(FTPDownloadFile::partFileName(fileName));
+    const QIODevice::OpenMode openMode = receivedBlocks.isEmpty() ? (QIODevice::WriteOnly | QIODevice::Truncate) : QIODevice::ReadWrite;
+    if (!_file.open(openMode)) {
+        qCWarning(FTPDownloadFileLog) << "Unable to open" << _file.fileName() << _file.errorString();
+        emit opened(false, QBitArray());
+        return;
+    }
+
+    emit opened(true, receivedBlocks);
+}
+
+void FTPDownloadFileWriter::write(quint32 offset, const QByteArray &data)
+{
+    if (_writeFailed || !_file.isOpen()) {
+        return;
+    }
+
+    if (!_file.seek(offset) || (_file.write(data) != data.size())) {
+        qCWarning(FTPDownloadFileLog) << "Write failed" << _file.fileName() << offset << _file.errorString();
+        _writeFailed = true;
+    }
+}
+
+void FTPDownloadFileWriter::crc32()
+{
+    quint32 crc = 0;
+    if (_writeFailed || !_file.isOpen() || !_file.flush() || !_file.seek(0)) {
+        emit crc32Calculated(false, crc);
+        return;
+    }
+
+    char buffer[16 * 1024];
+    while (!_file.atEnd()) {
+        const qint64 cBytes = _file.read(buffer, sizeof(buffer));
+        if (cBytes < 0) {
+            qCWarning(FTPDownloadFileLog) << "Read failed" << _file.fileName() << _file.errorString();
+            emit crc32Calculated(false, 0);
+            return;
+        }
+        crc = QGC::crc32(reinterpret_cast<const quint8*>(buffer), static_cast<unsigned>(cBytes), crc);
+    }
+
+    emit crc32Calculated(true, crc);
+}
+
+void FTPDownloadFileWriter::close(int closeMode, quint32 fileSize, bool sizeTrusted, const QBitArray &receivedBlocks)
+{
+    // Closed before the part file could be opened, whatever is on disk belongs to an earlier download
+    if (!_file.isOpen()) {
+        emit closed(!_writeFailed);
+        return;
+    }
+
+    bool written = !_writeFailed && _file.flush();
+    _file.close();
+
+    if (written && (closeMode == FTPDownloadFile::Finished)) {
+        (void) QFile::remove(FTPDownloadFile::resumeFileName(_fileName));
+        (void) QFile::remove(_fileName);
+        if (!_file.rename(_fileName)) {
+            qCWarning(FTPDownloadFileLog) << "Unable to rename" << _file.fileName() << "to" << _fileName << _file.errorString();
+            written = false;
+            _removeFiles();
+        }
+    } else if (written && (closeMode == FTPDownloadFile::KeepPartial) && sizeTrusted && (receivedBlocks.count(true) > 0)) {
+        _saveResumeInfo(fileSize, receivedBlocks);
+    } else {
+        _removeFiles();
+    }
+
+    emit closed(written);
+}
+
+QBitArray FTPDownloadFileWriter::_loadResumeInfo(quint32 fileSize) const
+{
+    const QString partName = FTPDownloadFile::partFileName(_fileName);
+    if (!QFileInfo::exists(partName)) {
+        return QBitArray();
+    }
+
+    QFile file(FTPDownloadFile::resumeFileName(_fileName));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QBitArray();
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString resumeSourceId;
+    quint32 resumeFileSize = 0;
+    quint32 blockSize = 0;
+    QBitArray receivedBlocks;
+    stream >> magic >> version >> resumeSourceId >> resumeFileSize >> blockSize >> receivedBlocks;
+
+    if ((stream.status() != QDataStream::Ok) || (magic != kResumeMagic) || (version != kResumeVersion)) {
+        qCDebug(FTPDownloadFileLog) << "Ignoring unreadable resume information" << file.fileName();
+        return QBitArray();
+    }
+
+    const quint32 blockCount = (fileSize + FTPDownloadFile::kBlockSize - 1) / FTPDownloadFile::kBlockSize;
+    if ((resumeSourceId != _sourceId) || (resumeFileSize != fileSize) || (blockSize != FTPDownloadFile::kBlockSize) || (static_cast<quint32>(receivedBlocks.size()) != blockCount)) {
+        qCDebug(FTPDownloadFileLog) << "Resume information is for a different file" << file.fileName();
+        return QBitArray();
+    }
+
+    // The part file has to end where its last received block does, anything else means it was changed or
+    // replaced since the resume information was saved
+    qint64 expectedSize = 0;
+    for (quint32 block = blockCount; block > 0; block--) {
+        if (receivedBlocks.testBit(block - 1)) {
+            expectedSize = qMin(static_cast<qint64>(block) * FTPDownloadFile::kBlockSize, static_cast<qint64>(fileSize));
+            break;
+        }
+    }
+    if ((expectedSize == 0) || (QFileInfo(partName).size() != expectedSize)) {
+        qCDebug(FTPDownloadFileLog) << "Part file does not match its resume information" << partName << QFileInfo(partName).size() << expectedSize;
+        return QBitArray();
+    }
+
+    return receivedBlocks;
+}
+
+void FTPDownloadFileWriter::_saveResumeInfo(quint32 fileSize, const QBitArray &receivedBlocks)
+{
+    QSaveFile file(FTPDownloadFile::resumeFileName(_fileName));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(FTPDownloadFileLog) << "Unable to save resume information" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << kResumeMagic << kResumeVersion << _sourceId << fileSize << static_cast<quint32>(FTPDownloadFile::kBlockSize) << receivedBlocks;
+    if (!file.commit()) {
+        qCWarning(FTPDownloadFileLog) << "Unable to save resume information" << file.fileName() << file.errorString();
+        return;
+    }
+
+    qCDebug(FTPDownloadFileLog) << "Saved resume information for" << _fileName << receivedBlocks.count(true) << "of" << receivedBlocks.size() << "blocks";
+}
+
+void FTPDownloadFileWriter::_removeFiles()
+{
+    (void) QFile::remove(FTPDownloadFile::partFileName(_fileName));
+    (void) QFile::remove(FTPDownloadFile::resumeFileName(_fileName));
+}
+
+FTPDownloadFile::FTPDownloadFile(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(FTPDownloadFileLog) << Q_FUNC_INFO << this;
+}
+
+FTPDownloadFile::~FTPDownloadFile()
+{
+    if (!_writerThread) {
+        return;
+    }
+
+    // The download is being abandoned. Keep what was received and wait for the writer, nothing is left to stall.
+    (void) disconnect(_writer, nullptr, this, nullptr);
+    if (_state == Open) {
+        _flush();
+        (void) QMetaObject::invokeMethod(_writer, [writer = _writer, fileSize = _fileSize, sizeTrusted = _sizeTrusted, receivedBlocks = _receivedBlocks]() {
+            writer->close(KeepPartial, fileSize, sizeTrusted, receivedBlocks);
+        }, Qt::QueuedConnection);
+    }
+    (void) QMetaObject::invokeMethod(_writer, []() {
+        QThread::currentThread()->quit();
+    }, Qt::QueuedConnection);
+    (void) _writerThread->wait();
+
+    // qCDebug(FTPDownloadFileLog) << Q_FUNC_INFO << this;
+}
+
+void FTPDownloadFile::open(const QString &fileName, const QString &sourceId, uint32_t fileSize, bool sizeTrusted)
+{
+    if (_state != Closed) {
+        qCWarning(FTPDownloadFileLog) << "Already open" << _fileName;
+        (void) QMetaObject::invokeMethod(this, [this]() {
+            emit opened(false);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    _fileName = fileName;
+    _fileSize = fileSize;
+    _sizeTrusted = sizeTrusted;
+    _resumed = false;
+    _bytesReceived = 0;
+    _receivedBlocks = QBitArray(_blockCount());
+    _pendingData.clear();
+    _state = Opening;
+
+    _startWriter();
+    (void) QMetaObject::invokeMethod(_writer, [writer = _writer, fileName, sourceId, fileSize, sizeTrusted]() {
+        writer->open(fileName, sourceId, fileSize, sizeTrusted);
+    }, Qt::QueuedConnection);
+}
+
+void FTPDownloadFile::close(CloseMode closeMode)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    _flush();
+    _state = Closing;
+
+    (void) QMetaObject::invokeMethod(_writer, [writer = _writer, closeMode, fileSize = _fileSize, sizeTrusted = _sizeTrusted, receivedBlocks = _receivedBlocks]() {
+        writer->close(closeMode, fileSize, sizeTrusted, receivedBlocks);
+    }, Qt::QueuedConnection);
+}
+
+void FTPDownloadFile::calcCrc32()
+{
+    if (_state != Open) {
+        (void) QMetaObject::invokeMethod(this, [this]() {
+            emit crc32Calculated(false, 0);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    _flush();
+
+    (void) QMetaObject::invokeMethod(_writer, [writer = _writer]() {
+        writer->crc32();
+    }, Qt::QueuedConnection);
+}
+
+uint32_t FTPDownloadFile::write(uint32_t offset, const uint8_t *data, uint32_t size)
+{
+    if ((_state != Open) || (size == 0)) {
+        return 0;
+    }
+
+    // A short block marks the end of a file whose size is not known
+    if (!_sizeTrusted && (size < kBlockSize) && ((offset % kBlockSize) == 0) && ((offset + size) < _fileSize)) {
+        setFileSize(offset + size);
+    }
+
+    const uint32_t end = qMin(offset + size, _fileSize);
+    uint32_t newBytes = 0;
+
+    // Blocks the data only partly covers are left missing, they will be asked for again on their own
+    for (uint32_t block = (offset + kBlockSize - 1) / kBlockSize; (block * kBlockSize) < end; block++) {
+        const uint32_t blockOffset = block * kBlockSize;
+        const uint32_t blockBytes = _blockBytes(block);
+        if ((blockOffset + blockBytes) > end) {
+            break;
+        }
+        if (_receivedBlocks.testBit(block)) {
+            continue;
+        }
+
+        _receivedBlocks.setBit(block);
+        _bytesReceived += blockBytes;
+        newBytes += blockBytes;
+
+        if (!_pendingData.isEmpty() && ((_pendingOffset + static_cast<uint32_t>(_pendingData.size())) != blockOffset)) {
+            _flush();
+        }
+        if (_pendingData.isEmpty()) {
+            _pendingOffset = blockOffset;
+        }
+        (void) _pendingData.append(reinterpret_cast<const char*>(data + (blockOffset - offset)), blockBytes);
+        if (_pendingData.size() >= kFlushBytes) {
+            _flush();
+        }
+    }
+
+    return newBytes;
+}
+
+void FTPDownloadFile::setFileSize(uint32_t fileSize)
+{
+    if (fileSize == _fileSize) {
+        return;
+    }
+
+    qCDebug(FTPDownloadFileLog) << "File size changed from" << _fileSize << "to" << fileSize;
+
+    _fileSize = fileSize;
+    _receivedBlocks.resize(_blockCount());
+    _updateBytesReceived();
+}
+
+bool FTPDownloadFile::isReceived(uint32_t offset) const
+{
+    return (offset < _fileSize) && _receivedBlocks.testBit(offset / kBlockSize);
+}
+
+uint32_t FTPDownloadFile::firstMissingOffset(uint32_t offset) const
+{
+    for (uint32_t block = offset / kBlockSize; block < _blockCount(); block++) {
+        if (!_receivedBlocks.testBit(block)) {
+            return qMax(offset, block * kBlockSize);
+        }
+    }
+
+    return _fileSize;
+}
+
+QList<FTPDownloadFile::Range_t> FTPDownloadFile::missingRanges(uint32_t maxRangeSize) const
+{
+    QList<Range_t> ranges;
+
+    const uint32_t maxBlocks = qMax(1u, maxRangeSize / kBlockSize);
+    uint32_t block = 0;
+    while (block < _blockCount()) {
+        if (_receivedBlocks.testBit(block)) {
+            block++;
+            continue;
+        }
+
+        const uint32_t firstBlock = block;
+        while ((block < _blockCount()) && !_receivedBlocks.testBit(block) && ((block - firstBlock) < maxBlocks)) {
+            block++;
+        }
+
+        const uint32_t offset = firstBlock * kBlockSize;
+        (void) ranges.append({ offset, qMin(block * kBlockSize, _fileSize) - offset });
+    }
+
+    return ranges;
+}
+
+uint32_t FTPDownloadFile::_blockBytes(uint32_t block) const
+{
+    const uint32_t blockOffset = block * kBlockSize;
+    return qMin(kBlockSize, _fileSize - blockOffset);
+}
+
+void FTPDownloadFile::_updateBytesReceived()
+{
+    _bytesReceived = 0;
+    for (uint32_t block = 0; block < _blockCount(); block++) {
+        if (_receivedBlocks.testBit(block)) {
+            _bytesReceived += _blockBytes(block);
+        }
+    }
+}
+
+void FTPDownloadFile::_flush()
+{
+    if (_pendingData.isEmpty()) {
+        return;
+    }
+
+    (void) QMetaObject::invokeMethod(_writer, [writer = _writer, offset = _pendingOffset, data = _pendingData]() {
+        writer->write(offset, data);
+    }, Qt::QueuedConnection);
+
+    _pendingData.clear();
+}
+
+void FTPDownloadFile::_startWriter()
+{
+    // A new writer per download, the previous one is already on its way out
+    _writerThread = new QThread();
+    _writer = new FTPDownloadFileWriter();
+    _writer->moveToThread(_writerThread);
+    (void) connect(_writerThread, &QThread::finished, _writer, &QObject::deleteLater);
+    (void) connect(_writerThread, &QThread::finished, _writerThread, &QObject::deleteLater);
+
+    (void) connect(_writer, &FTPDownloadFileWriter::opened, this, &FTPDownloadFile::_writerOpened);
+    (void) connect(_writer, &FTPDownloadFileWriter::crc32Calculated, this, &FTPDownloadFile::crc32Calculated);
+    (void) connect(_writer, &FTPDownloadFileWriter::closed, this, &FTPDownloadFile::_writerClosed);
+
+#ifdef QT_DEBUG
+    _writerThread->setObjectName(QStringLiteral("FTPDownloadFile"));
+#endif
+
+    _writerThread->start();
+}
+
+/// Only called once the writer has answered its last request
+void FTPDownloadFile::_stopWriter()
+{
+    (void) disconnect(_writer, nullptr, this, nullptr);
+    _writerThread->quit();
+    _writerThread = nullptr;
+    _writer = nullptr;
+}
+
+void FTPDownloadFile::_writerOpened(bool success, const QBitArray &receivedBlocks)
+{
+    // Closed again before the writer got to it, closed follows
+    if (_state != Opening) {
+        return;
+    }
+
+    if (!success) {
+        _state = Closed;
+        _stopWriter();
+        emit opened(false);
+        return;
+    }
+
+    _state = Open;
+    if (!receivedBlocks.isEmpty()) {
+        _resumed = true;
+        _receivedBlocks = receivedBlocks;
+        _updateBytesReceived();
+        qCDebug(FTPDownloadFileLog) << "Resuming" << _fileName << "with" << _bytesReceived << "of" << _fileSize << "bytes";
+    }
+
+    emit opened(true);
+}
+
+void FTPDownloadFile::_writerClosed(bool written)
+{
+    _state = Closed;
+    _stopWriter();
+    emit closed(written);
+}
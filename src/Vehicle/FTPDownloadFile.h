@@ -0,0 +1,168 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkFTP.h"
+
+#include <QtCore/QBitArray>
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+class QThread;
+
+Q_DECLARE_LOGGING_CATEGORY(FTPDownloadFileLog)
+
+/// Owns the local files of a download on the writer thread. Every request is answered with a signal.
+class FTPDownloadFileWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FTPDownloadFileWriter(QObject *parent = nullptr);
+    ~FTPDownloadFileWriter();
+
+    /// Opens the part file, keeping its content if the resume information matches
+    void open(const QString &fileName, const QString &sourceId, quint32 fileSize, bool sizeTrusted);
+    void write(quint32 offset, const QByteArray &data);
+    void crc32();
+    /// Finished renames the part file to fileName, KeepPartial saves receivedBlocks as resume information
+    void close(int closeMode, quint32 fileSize, bool sizeTrusted, const QBitArray &receivedBlocks);
+
+signals:
+    /// @param receivedBlocks Blocks picked up from a previous partial download, empty if there was none
+    void opened(bool success, const QBitArray &receivedBlocks);
+    void crc32Calculated(bool success, quint32 crc);
+    void closed(bool written);
+
+private:
+    QBitArray _loadResumeInfo(quint32 fileSize) const;
+    void _saveResumeInfo(quint32 fileSize, const QBitArray &receivedBlocks);
+    void _removeFiles();
+
+    QFile _file;
+    QString _fileName;
+    QString _sourceId;
+    bool _writeFailed = false;
+};
+
+/// Local side of a MAVLink FTP download.
+///
+/// Blocks may arrive in any order and more than once. Each block is only written the first time it arrives, and a
+/// bitmap records which blocks are on disk. All file access happens on a writer thread which only runs while a download
+/// is open, so the GUI thread never waits on the disk: open, close and crc32 report back through signals. Data goes to
+/// a part file next to the destination, which only takes the destination name once the download finishes. If the
+/// download does not finish the bitmap is saved next to the part file, and the next download of the same file to the
+/// same place only asks for the blocks which are still missing.
+class FTPDownloadFile : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Range_t {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    enum CloseMode {
+        Finished,       ///< Download is done, move the part file to the destination
+        KeepPartial,    ///< Download failed, keep what was received so it can be resumed
+        Discard,        ///< Remove the part file
+    };
+
+    explicit FTPDownloadFile(QObject *parent = nullptr);
+    ~FTPDownloadFile();
+
+    /// Opens the local file, picking up from a previous partial download when there is one. Signals opened.
+    ///     @param sourceId     Identifies the file on the vehicle, a partial download of a different source is discarded
+    ///     @param fileSize     Size reported by the vehicle
+    ///     @param sizeTrusted  false if fileSize is only an upper bound. The file then ends at the first short block and
+    ///                         is never resumed.
+    void open(const QString &fileName, const QString &sourceId, uint32_t fileSize, bool sizeTrusted);
+
+    /// Closes the file once the pending writes are done. A file which could not be written is always removed.
+    /// Signals closed.
+    void close(CloseMode closeMode);
+
+    /// Records the data received at offset and queues the blocks which were not already received for writing
+    ///     @return Number of bytes which were not received before
+    uint32_t write(uint32_t offset, const uint8_t *data, uint32_t size);
+
+    /// Sets the actual size once the end of a file with an untrusted size is known
+    void setFileSize(uint32_t fileSize);
+
+    /// Calculates the CRC32 of the file as written once the pending writes are done, the same way the vehicle
+    /// calculates it for kCmdCalcFileCRC32. Signals crc32Calculated.
+    void calcCrc32();
+
+    bool     isOpen         () const { return (_state == Opening) || (_state == Open); }
+    bool     isClosing      () const { return _state == Closing; }
+    bool     sizeTrusted    () const { return _sizeTrusted; }
+    bool     resumed        () const { return _resumed; }       ///< Picked up from a previous partial download
+    uint32_t fileSize       () const { return _fileSize; }
+    uint32_t bytesReceived  () const { return _bytesReceived; }
+    bool     isComplete     () const { return _bytesReceived == _fileSize; }
+    bool     isReceived     (uint32_t offset) const;
+
+    /// @return Offset of the first missing block at or after offset, fileSize() if there is none
+    uint32_t firstMissingOffset(uint32_t offset) const;
+
+    /// @return The missing blocks, with each range at most maxRangeSize bytes
+    QList<Range_t> missingRanges(uint32_t maxRangeSize) const;
+
+    /// @return Location the file is written to until the download finishes
+    static QString partFileName(const QString &fileName) { return fileName + QStringLiteral(".part"); }
+    /// @return Location of the resume information for the file
+    static QString resumeFileName(const QString &fileName) { return fileName + QStringLiteral(".ftpresume"); }
+
+signals:
+    void opened(bool success);
+    void crc32Calculated(bool success, quint32 crc);
+    /// @param written false if the file could not be written
+    void closed(bool written);
+
+    static constexpr uint32_t kBlockSize = sizeof(MavlinkFTP::Request::data);
+
+private:
+    enum State {
+        Closed,
+        Opening,
+        Open,
+        Closing,
+    };
+
+    uint32_t _blockCount    (void) const { return (_fileSize + kBlockSize - 1) / kBlockSize; }
+    uint32_t _blockBytes    (uint32_t block) const;
+    void     _updateBytesReceived(void);
+    void     _flush         (void);
+    void     _startWriter   (void);
+    void     _stopWriter    (void);
+    void     _writerOpened  (bool success, const QBitArray &receivedBlocks);
+    void     _writerClosed  (bool written);
+
+    QThread *_writerThread = nullptr;               ///< Only running while a download is open
+    FTPDownloadFileWriter *_writer = nullptr;
+
+    QString _fileName;
+    State _state = Closed;
+    bool _sizeTrusted = true;
+    bool _resumed = false;
+    uint32_t _fileSize = 0;
+    uint32_t _bytesReceived = 0;
+    QBitArray _receivedBlocks;
+
+    QByteArray _pendingData;        ///< Contiguous blocks not yet handed to the writer
+    uint32_t _pendingOffset = 0;
+
+    static constexpr int kFlushBytes = 32 * 1024;
+};
@@ -10,22 +10,29 @@
 #include "FTPManager.h"
 #include "MAVLinkProtocol.h"
 #include "Vehicle.h"
+#include "QGC.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(FTPManagerLog, "FTPManagerLog")
 
 FTPManager::FTPManager(Vehicle* vehicle)
-    : QObject   (vehicle)
-    , _vehicle  (vehicle)
+    : QObject       (vehicle)
+    , _vehicle      (vehicle)
+    , _downloadFile (new FTPDownloadFile(this))
 {
     _ackOrNakTimeoutTimer.setSingleShot(true);
     // Mock link responds immediately if at all, speed up unit tests with faster timoue
     _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
+    connect(_downloadFile, &FTPDownloadFile::opened,            this, &FTPManager::_downloadFileOpened);
+    connect(_downloadFile, &FTPDownloadFile::crc32Calculated,   this, &FTPManager::_downloadFileCrc32Calculated);
+    connect(_downloadFile, &FTPDownloadFile::closed,            this, &FTPManager::_downloadFileClosed);
     
     // Make sure we don't have bad structure packing
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
@@ -35,15 +42,17 @@ bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QStr
 {
     qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "fromCompId:" << fromCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || _downloadFile->isClosing()) {
         qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
         return false;
     }
 
     static const StateFunctions_t rgDownloadStateMachine[] = {
         { &FTPManager::_openFileROBegin,            &FTPManager::_openFileROAckOrNak,           &FTPManager::_openFileROTimeout },
+        { &FTPManager::_openSessionsBegin,          &FTPManager::_openSessionsAckOrNak,         &FTPManager::_openSessionsTimeout },
         { &FTPManager::_burstReadFileBegin,         &FTPManager::_burstReadFileAckOrNak,        &FTPManager::_burstReadFileTimeout },
         { &FTPManager::_fillMissingBlocksBegin,     &FTPManager::_fillMissingBlocksAckOrNak,    &FTPManager::_fillMissingBlocksTimeout },
+        { &FTPManager::_verifyResumedFileBegin,     &FTPManager::_verifyResumedFileAckOrNak,    &FTPManager::_verifyResumedFileTimeout },
         { &FTPManager::_resetSessionsBegin,         &FTPManager::_resetSessionsAckOrNak,        &FTPManager::_resetSessionsTimeout },
         { &FTPManager::_downloadCompleteNoError,    nullptr,                                    nullptr },
     };
@@ -122,6 +131,8 @@ void FTPManager::cancelDownload()
 
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
+    _downloadState.waitingForFile = false;
+    _terminateExtraSessions();
     static const StateFunctions_t rgTerminateStateMachine[] = {
         { &FTPManager::_terminateSessionBegin,  &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
         { &FTPManager::_terminateComplete,      nullptr,                                    nullptr },
@@ -172,29 +183,88 @@ void FTPManager::_terminateSessionTimeout(void)
 
 void FTPManager::_terminateComplete(void)
 {
-    _downloadComplete("Aborted");
+    // Every session has been terminated by now
+    _downloadState.rgSessions.clear();
+    _downloadComplete("Aborted", true /* discardFile */);
 }
 
-/// Closes out a download session by writing the file and doing cleanup.
-///     @param errorMsg Error message, empty if no error
-void FTPManager::_downloadComplete(const QString& errorMsg)
+/// Closes out a download session by writing the file and doing cleanup. downloadComplete is signalled once the
+/// file is closed.
+///     @param errorMsg     Error message, empty if no error
+///     @param discardFile  true: throw away what was received instead of keeping it to resume from
+void FTPManager::_downloadComplete(const QString& errorMsg, bool discardFile)
 {
     qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
     
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
+    _downloadFilePath   = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
+    _downloadErrorMsg   = errorMsg;
 
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
     _currentStateMachineIndex = -1;
-    if (_downloadState.file.isOpen()) {
-        _downloadState.file.close();
-        if (!errorMsg.isEmpty()) {
-            _downloadState.file.remove();
+    _downloadState.waitingForFile = false;
+
+    if (!errorMsg.isEmpty()) {
+        // Don't leave our sessions open on the vehicle, the next download would find none available
+        for (const BurstSession_t& session: _downloadState.rgSessions) {
+            _sendTerminateSession(session.sessionId);
+        }
+    }
+    _downloadState.rgSessions.clear();
+
+    // A failed download keeps what was received so the next attempt can pick up from there
+    if (_downloadFile->isOpen()) {
+        FTPDownloadFile::CloseMode closeMode = FTPDownloadFile::Discard;
+        if (!discardFile) {
+            closeMode = errorMsg.isEmpty() ? FTPDownloadFile::Finished : FTPDownloadFile::KeepPartial;
         }
+        _downloadFile->close(closeMode);
+        return;
+    }
+
+    emit downloadComplete(_downloadFilePath, _downloadErrorMsg);
+}
+
+void FTPManager::_downloadFileOpened(bool success)
+{
+    if (!_downloadState.waitingForFile) {
+        return;
+    }
+    _downloadState.waitingForFile = false;
+
+    if (success) {
+        _advanceStateMachine();
+    } else {
+        qCDebug(FTPManagerLog) << "_downloadFileOpened: _downloadFile open failed";
+        _downloadComplete(tr("Download failed"));
+    }
+}
+
+void FTPManager::_downloadFileCrc32Calculated(bool success, quint32 crc)
+{
+    if (!_downloadState.waitingForFile) {
+        return;
+    }
+    _downloadState.waitingForFile = false;
+
+    if (!success) {
+        _verifyResumedFileFailed(tr("Download failed: Error saving file"));
+    } else if (crc != _downloadState.vehicleCRC32) {
+        qCDebug(FTPManagerLog) << "_downloadFileCrc32Calculated: CRC32 mismatch local:vehicle" << crc << _downloadState.vehicleCRC32;
+        _verifyResumedFileFailed(tr("Download failed: Resumed file does not match the vehicle"));
+    } else {
+        qCDebug(FTPManagerLog) << "_downloadFileCrc32Calculated: CRC32 match" << crc;
+        _advanceStateMachine();
+    }
+}
+
+void FTPManager::_downloadFileClosed(bool written)
+{
+    if (!written && _downloadErrorMsg.isEmpty()) {
+        _downloadErrorMsg = tr("Download failed: Error saving file");
     }
 
-    emit downloadComplete(downloadFilePath, errorMsg);
+    emit downloadComplete(_downloadFilePath, _downloadErrorMsg);
 }
 
 /// Closes out a list directory sequence
@@ -237,9 +307,15 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
-    // Ignore old/reordered packets (handle wrap-around properly)
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
-    if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+    if (_repliesTrackedBySession()) {
+        // Parallel bursts and pipelined reads are answered out of order, they are matched up by session and offset
+        // instead. Keep the next request clear of the sequence numbers the vehicle has used.
+        if ((uint16_t)(actualIncomingSeqNumber - _expectedIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+            _expectedIncomingSeqNumber = actualIncomingSeqNumber;
+        }
+    } else if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+        // Ignore old/reordered packets (handle wrap-around properly)
         qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << _expectedIncomingSeqNumber << actualIncomingSeqNumber
                                << "hdr.opcode:hdr.req_opcode" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode));
 
@@ -270,6 +346,16 @@ void FTPManager::_ackOrNakTimeout(void)
     (this->*_rgStateMachine[_currentStateMachineIndex].timeoutFn)();
 }
 
+bool FTPManager::_repliesTrackedBySession(void) const
+{
+    if (_currentStateMachineIndex == -1) {
+        return false;
+    }
+
+    const StateAckNakFn ackNakFn = _rgStateMachine[_currentStateMachineIndex].ackNakFn;
+    return (ackNakFn == &FTPManager::_burstReadFileAckOrNak) || (ackNakFn == &FTPManager::_fillMissingBlocksAckOrNak);
+}
+
 void FTPManager::_fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str)
 {
     strncpy((char *)&request->data[0], str.toStdString().c_str(), sizeof(request->data));
@@ -293,7 +379,7 @@ QString FTPManager::_errorMsgFromNak(const MavlinkFTP::Request* nak)
     return errorMsg;
 }
 
-void FTPManager::_openFileROBegin(void)
+void FTPManager::_sendOpenFileRO(void)
 {
     MavlinkFTP::Request request{};
     request.hdr.session = 0;
@@ -304,6 +390,11 @@ void FTPManager::_openFileROBegin(void)
     _sendRequestExpectAck(&request);
 }
 
+void FTPManager::_openFileROBegin(void)
+{
+    _sendOpenFileRO();
+}
+
 void FTPManager::_openFileROTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_openFileROTimeout";
@@ -335,44 +426,177 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
 
         _downloadState.sessionId        = ackOrNak->hdr.session;
         _downloadState.fileSize         = ackOrNak->openFileLength;
-        _downloadState.expectedOffset   = 0;
+        _downloadState.rgSessions.append({ _downloadState.sessionId, 0, 0, 0, false });
 
-        _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-        if (_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
-            _advanceStateMachine();
-        } else {
-            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
-            _downloadComplete(tr("Download failed"));
-        }
+        // A partial download of the same file from the same vehicle and component picks up where it left off
+        QString sourceId = QStringLiteral("%1:%2:%3").arg(_vehicle->id()).arg(_ftpCompId).arg(_downloadState.fullPathOnVehicle);
+        // Continues in _downloadFileOpened
+        _downloadState.waitingForFile = true;
+        _downloadFile->open(_downloadState.toDir.filePath(_downloadState.fileName), sourceId, _downloadState.fileSize, _downloadState.checksize);
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         qCDebug(FTPManagerLog) << "_handlOpenFileROAck: Nak -" << _errorMsgFromNak(ackOrNak);
         _downloadComplete(tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
     }
 }
 
-void FTPManager::_burstReadFileWorker(bool firstRequest)
+void FTPManager::_openSessionsWorker(void)
+{
+    // Another session only pays off while each session still gets a reasonable share of what is missing
+    uint32_t    bytesMissing    = _downloadFile->fileSize() - _downloadFile->bytesReceived();
+    int         sessionCount    = _downloadState.rgSessions.count();
+    if (!_downloadState.checksize || sessionCount >= _maxSessions || bytesMissing < (uint32_t)((sessionCount + 1) * _minSessionRangeBytes)) {
+        _advanceStateMachine();
+        return;
+    }
+
+    _sendOpenFileRO();
+}
+
+void FTPManager::_openSessionsBegin(void)
+{
+    _openSessionsWorker();
+}
+
+void FTPManager::_openSessionsAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdOpenFileRO) {
+        qCDebug(FTPManagerLog) << "_openSessionsAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_openSessionsAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        if (ackOrNak->hdr.size == sizeof(uint32_t) && ackOrNak->openFileLength == _downloadState.fileSize && !_burstSession(ackOrNak->hdr.session)) {
+            qCDebug(FTPManagerLog) << "_openSessionsAckOrNak: Ack - sessionId" << ackOrNak->hdr.session;
+            _downloadState.rgSessions.append({ ackOrNak->hdr.session, 0, 0, 0, false });
+            _openSessionsWorker();
+            return;
+        }
+
+        // The file changed under us or the vehicle handed back a session we already have
+        qCDebug(FTPManagerLog) << "_openSessionsAckOrNak: Ack unusable session - sessionId:openFileLength" << ackOrNak->hdr.session << ackOrNak->openFileLength;
+        if (!_burstSession(ackOrNak->hdr.session)) {
+            _sendTerminateSession(ackOrNak->hdr.session);
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        // Most vehicles only support a single session
+        qCDebug(FTPManagerLog) << "_openSessionsAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+    }
+
+    qCDebug(FTPManagerLog) << "_openSessionsAckOrNak: downloading with sessions" << _downloadState.rgSessions.count();
+    _advanceStateMachine();
+}
+
+void FTPManager::_openSessionsTimeout(void)
+{
+    qCDebug(FTPManagerLog) << "_openSessionsTimeout: downloading with sessions" << _downloadState.rgSessions.count();
+    _advanceStateMachine();
+}
+
+FTPManager::BurstSession_t* FTPManager::_burstSession(uint8_t sessionId)
+{
+    for (BurstSession_t& session: _downloadState.rgSessions) {
+        if (session.sessionId == sessionId) {
+            return &session;
+        }
+    }
+
+    return nullptr;
+}
+
+bool FTPManager::_burstSessionsComplete(void) const
+{
+    for (const BurstSession_t& session: _downloadState.rgSessions) {
+        if (!session.complete) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FTPManager::_burstSessionComplete(uint8_t sessionId)
+{
+    BurstSession_t* session = _burstSession(sessionId);
+    if (!session) {
+        return;
+    }
+
+    session->complete = true;
+    if (sessionId != _downloadState.sessionId) {
+        // The range is done, stop the vehicle from carrying on into the next one
+        _sendTerminateSession(sessionId);
+        for (int i=0; i<_downloadState.rgSessions.count(); i++) {
+            if (_downloadState.rgSessions[i].sessionId == sessionId) {
+                _downloadState.rgSessions.removeAt(i);
+                break;
+            }
+        }
+    }
+}
+
+void FTPManager::_burstReadFileWorker(BurstSession_t& session)
 {
-    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << _downloadState.expectedOffset << firstRequest << _downloadState.retryCount;
+    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at session:offset:retryCount" << session.sessionId << session.expectedOffset << _downloadState.retryCount;
 
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = session.sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
-    request.hdr.offset  = _downloadState.expectedOffset;
+    request.hdr.offset  = session.expectedOffset;
     request.hdr.size    = sizeof(request.data);
 
-    if (firstRequest) {
-        _downloadState.retryCount = 0;
-    } else {
-        // Must used same sequence number as previous request
-        _expectedIncomingSeqNumber -= 2;
-    }
-
     _sendRequestExpectAck(&request);
+    session.expectedSeqNumber = _expectedIncomingSeqNumber;
 }
 
 void FTPManager::_burstReadFileBegin(void)
 {
-    _burstReadFileWorker(true /* firstRequestr */);
+    _downloadState.retryCount = 0;
+
+    // Each session reads its own block aligned range. The first session reads the last range, which runs to the end of
+    // the file. The others are closed as soon as their range is done.
+    int         sessionCount    = _downloadState.rgSessions.count();
+    uint32_t    fileSize        = _downloadFile->fileSize();
+    uint32_t    blockCount      = (fileSize + FTPDownloadFile::kBlockSize - 1) / FTPDownloadFile::kBlockSize;
+    uint32_t    rangeSize       = ((blockCount + sessionCount - 1) / sessionCount) * FTPDownloadFile::kBlockSize;
+
+    QList<uint8_t> rgCompleteSessionIds;
+    for (int i=0; i<sessionCount; i++) {
+        BurstSession_t& session = _downloadState.rgSessions[i];
+        int             range   = (i == 0) ? sessionCount - 1 : i - 1;
+        uint32_t        start   = range * rangeSize;
+
+        session.endOffset       = (range == sessionCount - 1) ? fileSize : qMin(start + rangeSize, fileSize);
+        session.expectedOffset  = _downloadFile->firstMissingOffset(start);
+        session.complete        = false;
+        if (session.expectedOffset >= session.endOffset) {
+            rgCompleteSessionIds.append(session.sessionId);
+        }
+    }
+    for (uint8_t sessionId: rgCompleteSessionIds) {
+        _burstSessionComplete(sessionId);
+    }
+
+    if (_burstSessionsComplete()) {
+        _advanceStateMachine();
+    } else {
+        for (BurstSession_t& session: _downloadState.rgSessions) {
+            if (!session.complete) {
+                _burstReadFileWorker(session);
+            }
+        }
+    }
+
+    // Emit progress last, as cancel could be called in there
+    if (_downloadFile->bytesReceived() > 0) {
+        _emitDownloadProgress();
+    }
 }
 
 void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -383,74 +607,63 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+    BurstSession_t* session = _burstSession(ackOrNak->hdr.session);
+    if (!session || session->complete) {
+        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to unknown or complete session id" << ackOrNak->hdr.session;
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    uint8_t sessionId = session->sessionId;
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        if (ackOrNak->hdr.seqNumber < _expectedIncomingSeqNumber) {
-            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-            return;
-        }
-
-        qCDebug(FTPManagerLog) << QString("_burstReadFileAckOrNak: Ack offset(%1) size(%2) burstComplete(%3)").arg(ackOrNak->hdr.offset).arg(ackOrNak->hdr.size).arg(ackOrNak->hdr.burstComplete);
+        qCDebug(FTPManagerLog) << QString("_burstReadFileAckOrNak: Ack session(%1) offset(%2) size(%3) burstComplete(%4)").arg(sessionId).arg(ackOrNak->hdr.offset).arg(ackOrNak->hdr.size).arg(ackOrNak->hdr.burstComplete);
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (ackOrNak->hdr.offset > _downloadState.expectedOffset) {
-                // There is a hole in our data, record it as missing and continue on
-                MissingData_t missingData;
-                missingData.offset          = _downloadState.expectedOffset;
-                missingData.cBytesMissing   = ackOrNak->hdr.offset - _downloadState.expectedOffset;
-                _downloadState.rgMissingData.append(missingData);
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: adding missing data offset:cBytesMissing" << missingData.offset << missingData.cBytesMissing;
-            } else {
-                // Offset is past what we have already seen, disregard and wait for something usefule
-                _ackOrNakTimeoutTimer.start();
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ackOrNak->hdr.offset << _downloadState.expectedOffset;
-                return;
-            }
+        if (ackOrNak->hdr.offset > session->expectedOffset) {
+            // There is a hole in our data, it is filled in once the bursts are done
+            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: missing data offset:cBytesMissing" << session->expectedOffset << ackOrNak->hdr.offset - session->expectedOffset;
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
-            return;
-        }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-        _downloadState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
+        _downloadState.retryCount = 0;
+        (void) _downloadFile->write(ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size);
+        session->expectedOffset     = qMax(session->expectedOffset, ackOrNak->hdr.offset + ackOrNak->hdr.size);
+        session->expectedSeqNumber  = ackOrNak->hdr.seqNumber + 1;
 
-        if (ackOrNak->hdr.burstComplete) {
+        if (_downloadFile->sizeTrusted() && session->expectedOffset >= session->endOffset) {
+            _burstSessionComplete(sessionId);
+        } else if (ackOrNak->hdr.burstComplete) {
             // The current burst is done, request next one in offset sequence
-            _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-            _burstReadFileWorker(true /* firstRequest */);
+            _burstReadFileWorker(*session);
+        }
+
+        if (_burstSessionsComplete()) {
+            _ackOrNakTimeoutTimer.stop();
+            _advanceStateMachine();
         } else {
             // Still within a burst, next ack should come automatically
-            _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber + 1;
             _ackOrNakTimeoutTimer.start();
         }
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
-        }
+        _emitDownloadProgress();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
         if (errorCode == MavlinkFTP::kErrEOF) {
-            // Burst sequence has gone through the whole file
-            if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-                qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: EOF Nak"
-                    "with incorrect sequence nr actual:expected"
-                    << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-                /* We have received the EOF Nak but out of sequence, i.e. data is missing */
-                _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-                _burstReadFileWorker(true); /* Retry from last expected offset */
-            } else {
-                qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak EOF";
+            if (!_downloadFile->sizeTrusted()) {
+                if (ackOrNak->hdr.seqNumber != session->expectedSeqNumber) {
+                    // Without a size to go by the end of the file is only known once nothing before the EOF was lost
+                    qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: EOF Nak with incorrect sequence nr actual:expected" << ackOrNak->hdr.seqNumber << session->expectedSeqNumber;
+                    _burstReadFileWorker(*session);
+                    return;
+                }
+                _downloadFile->setFileSize(qMin(session->expectedOffset, _downloadFile->fileSize()));
+            }
+
+            // Burst sequence has gone through the whole file, anything lost is filled in next
+            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak EOF session" << sessionId;
+            _burstSessionComplete(sessionId);
+            if (_burstSessionsComplete()) {
+                _ackOrNakTimeoutTimer.stop();
                 _advanceStateMachine();
             }
         } else { /* Don't care is this is out of sequence */
@@ -466,9 +679,13 @@ void FTPManager::_burstReadFileTimeout(void)
         qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout retries exceeded");
         _downloadComplete(tr("Download failed"));
     } else {
-        // Try again
-        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _burstReadFileWorker(false /* firstReqeust */);
+        // Nothing came in on any session, have each unfinished one carry on from where it got to
+        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
+        for (BurstSession_t& session: _downloadState.rgSessions) {
+            if (!session.complete) {
+                _burstReadFileWorker(session);
+            }
+        }
     }
 }
 
@@ -561,36 +778,35 @@ void FTPManager::_listDirectoryTimeout(void)
     }
 }
 
-void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
+void FTPManager::_fillMissingBlocksWorker(void)
 {
-    if (_downloadState.rgMissingData.count()) {
-        MavlinkFTP::Request request{};
-        MissingData_t&      missingData = _downloadState.rgMissingData.first();
+    // Keep a window of reads outstanding instead of waiting out a round trip per missing block
+    while (_downloadState.fillRequests.count() < _readWindow && !_downloadState.rgFillOffsets.isEmpty()) {
+        uint32_t offset = _downloadState.rgFillOffsets.takeFirst();
+        if (offset >= _downloadFile->fileSize() || _downloadFile->isReceived(offset)) {
+            continue;
+        }
 
-        uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
+        MavlinkFTP::Request request{};
+        request.hdr.session = _downloadState.sessionId;
+        request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+        request.hdr.offset  = offset;
+        request.hdr.size    = qMin((uint32_t)sizeof(request.data), _downloadFile->fileSize() - offset);
 
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: offset:cBytesToRead" << offset << request.hdr.size;
 
-        request.hdr.session                 = _downloadState.sessionId;
-        request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
-        request.hdr.offset                  = missingData.offset;
-        request.hdr.size                    = cBytesToRead;
+        _sendRequestExpectAck(&request);
+        _downloadState.fillRequests[_expectedIncomingSeqNumber] = offset;
+    }
 
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
-        } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
-        }
-        _downloadState.expectedOffset = request.hdr.offset;
+    if (_downloadState.fillRequests.isEmpty()) {
+        _ackOrNakTimeoutTimer.stop();
 
-        _sendRequestExpectAck(&request);
-    } else {
         // We should have the full file now
-        if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
+        if (_downloadState.checksize == false || _downloadFile->isComplete()) {
             _advanceStateMachine();
         } else {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << _downloadState.bytesWritten << _downloadState.fileSize;
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesReceived:fileSize" << _downloadFile->bytesReceived() << _downloadFile->fileSize();
             _downloadComplete(tr("Download failed"));
         }
     }
@@ -598,7 +814,17 @@ void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
 
 void FTPManager::_fillMissingBlocksBegin(void)
 {
-    _fillMissingBlocksWorker(true /* firstRequest */);
+    _downloadState.retryCount   = 0;
+    _downloadState.fillAckCount = 0;
+    _downloadState.fillRequests.clear();
+    _downloadState.rgFillOffsets.clear();
+    for (const FTPDownloadFile::Range_t& range: _downloadFile->missingRanges(FTPDownloadFile::kBlockSize)) {
+        _downloadState.rgFillOffsets.append(range.offset);
+    }
+
+    qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: missingBlocks:readWindow" << _downloadState.rgFillOffsets.count() << _readWindow;
+
+    _fillMissingBlocksWorker();
 }
 
 void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -609,66 +835,61 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-        return;
-    }
     if (ackOrNak->hdr.session != _downloadState.sessionId) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
         return;
     }
+    auto fillRequest = _downloadState.fillRequests.find(ackOrNak->hdr.seqNumber);
+    if (fillRequest == _downloadState.fillRequests.end()) {
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to no outstanding read with sequence" << ackOrNak->hdr.seqNumber;
+        return;
+    }
 
-    _ackOrNakTimeoutTimer.stop();
+    uint32_t offset = fillRequest.value();
+    _downloadState.fillRequests.erase(fillRequest);
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
+        if (ackOrNak->hdr.offset != offset) {
             if (++_downloadState.retryCount > _maxRetry) {
                 qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
                 _downloadComplete(tr("Download failed"));
                 return;
             }
 
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
-            return;
-        }
-
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
-            return;
-        }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
+            // Ask for this offset again
+            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2) actual(%3)").arg(_downloadState.retryCount).arg(offset).arg(ackOrNak->hdr.offset);
+            _downloadState.rgFillOffsets.prepend(offset);
+        } else {
+            _downloadState.retryCount = 0;
+            (void) _downloadFile->write(ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size);
+
+            // A window's worth of reads answered without a loss earns one more read in flight
+            if (++_downloadState.fillAckCount >= _readWindow) {
+                _downloadState.fillAckCount = 0;
+                if (_readWindow < _maxReadWindow) {
+                    _readWindow++;
+                }
+            }
         }
 
         // Move on to fill in possible next hole
-        _fillMissingBlocksWorker(true /* firstReqeust */);
+        _ackOrNakTimeoutTimer.start();
+        _fillMissingBlocksWorker();
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
-        }
+        _emitDownloadProgress();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
-        if (errorCode == MavlinkFTP::kErrEOF) {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF";
-            if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
-                // We've successfully complete filling in all missing blocks
-                _advanceStateMachine();
-                return;
-            }
+        if (errorCode == MavlinkFTP::kErrEOF && !_downloadFile->sizeTrusted()) {
+            // The file ends before this block
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF offset" << offset;
+            _downloadFile->setFileSize(qMin(offset, _downloadFile->fileSize()));
+            _ackOrNakTimeoutTimer.start();
+            _fillMissingBlocksWorker();
+            return;
         }
 
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
@@ -682,12 +903,90 @@ void FTPManager::_fillMissingBlocksTimeout(void)
         qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
         _downloadComplete(tr("Download failed"));
     } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _fillMissingBlocksWorker(false /* firstReqeust */);
+        // Whatever is still outstanding was lost, back off and ask for it again
+        _readWindow = qMax(1, _readWindow / 2);
+        _downloadState.fillAckCount = 0;
+
+        QList<uint32_t> rgLostOffsets = _downloadState.fillRequests.values();
+        std::sort(rgLostOffsets.begin(), rgLostOffsets.end());
+        _downloadState.fillRequests.clear();
+        _downloadState.rgFillOffsets = rgLostOffsets + _downloadState.rgFillOffsets;
+
+        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) lost(%2) readWindow(%3)").arg(_downloadState.retryCount).arg(rgLostOffsets.count()).arg(_readWindow);
+        _fillMissingBlocksWorker();
+    }
+}
+
+void FTPManager::_verifyResumedFileBegin(void)
+{
+    // Only a file pieced together from more than one download can be out of step with the vehicle
+    if (!_downloadFile->resumed()) {
+        _advanceStateMachine();
+        return;
+    }
+
+    _downloadState.retryCount = 0;
+    _sendCalcFileCRC32();
+}
+
+void FTPManager::_sendCalcFileCRC32(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCalcFileCRC32;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_verifyResumedFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode != MavlinkFTP::kCmdCalcFileCRC32) {
+        qCDebug(FTPManagerLog) << "_verifyResumedFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_verifyResumedFileAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        if (ackOrNak->hdr.size != sizeof(uint32_t)) {
+            _verifyResumedFileFailed(tr("Download failed: Resumed file could not be verified"));
+        } else {
+            // Continues in _downloadFileCrc32Calculated once the local file has been read back
+            _downloadState.vehicleCRC32     = ackOrNak->openFileLength;
+            _downloadState.waitingForFile   = true;
+            _downloadFile->calcCrc32();
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_verifyResumedFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _verifyResumedFileFailed(tr("Download failed: Resumed file could not be verified"));
+    }
+}
+
+void FTPManager::_verifyResumedFileTimeout(void)
+{
+    if (++_downloadState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_verifyResumedFileTimeout retries exceeded");
+        _verifyResumedFileFailed(tr("Download failed: Resumed file could not be verified"));
+    } else {
+        qCDebug(FTPManagerLog) << QString("_verifyResumedFileTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
+        _sendCalcFileCRC32();
     }
 }
 
+/// A resumed file which doesn't check out is thrown away, the next download starts over
+void FTPManager::_verifyResumedFileFailed(const QString& errorMsg)
+{
+    _downloadComplete(errorMsg, true /* discardFile */);
+}
+
 void FTPManager::_resetSessionsBegin(void)
 {
     MavlinkFTP::Request request{};
@@ -729,13 +1028,17 @@ void FTPManager::_resetSessionsTimeout(void)
 void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
     _ackOrNakTimeoutTimer.start();
-    
+    _sendRequest(request);
+}
+
+void FTPManager::_sendRequest(MavlinkFTP::Request* request)
+{
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
         _expectedIncomingSeqNumber += 2;
 
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+        qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
 
         mavlink_message_t message;
         mavlink_msg_file_transfer_protocol_pack_chan(qgcApp()->toolbox()->mavlinkProtocol()->getSystemId(),
@@ -748,7 +1051,40 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
                                                      (uint8_t*)request);                                    // Payload
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     } else {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
+    }
+}
+
+/// Terminates a session without waiting for the ack
+void FTPManager::_sendTerminateSession(uint8_t sessionId)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
+    _sendRequest(&request);
+}
+
+void FTPManager::_terminateExtraSessions(void)
+{
+    for (const BurstSession_t& session: _downloadState.rgSessions) {
+        if (session.sessionId != _downloadState.sessionId) {
+            _sendTerminateSession(session.sessionId);
+        }
+    }
+
+    QList<BurstSession_t> rgSessions;
+    for (const BurstSession_t& session: _downloadState.rgSessions) {
+        if (session.sessionId == _downloadState.sessionId) {
+            rgSessions.append(session);
+        }
+    }
+    _downloadState.rgSessions = rgSessions;
+}
+
+void FTPManager::_emitDownloadProgress(void)
+{
+    if (_downloadFile->fileSize() != 0) {
+        emit commandProgress((float)(_downloadFile->bytesReceived()) / (float)_downloadFile->fileSize());
     }
 }
 
@@ -10,9 +10,11 @@
 #pragma once
 
 #include "MAVLinkFTP.h"
+#include "FTPDownloadFile.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QDir>
+#include <QtCore/QHash>
 #include <QtCore/QTimer>
 #include <QtCore/QLoggingCategory>
 
@@ -20,6 +22,13 @@ Q_DECLARE_LOGGING_CATEGORY(FTPManagerLog)
 
 class Vehicle;
 
+/// MAVLink FTP client.
+///
+/// Downloads of larger files open more than one session when the vehicle allows it, and each session bursts its own
+/// range of the file. Blocks lost along the way are then read back with a window of requests in flight, the window
+/// grows while the reads are answered and halves when they are lost. Received data goes through FTPDownloadFile, which
+/// writes on its own thread and lets a failed download be resumed. A resumed file is checked against the vehicle's
+/// CRC32 of the file before it is reported as downloaded.
 class FTPManager : public QObject
 {
     Q_OBJECT
@@ -80,36 +89,43 @@ private:
         StateTimeoutFn  timeoutFn;
     };
 
-    struct MissingData_t {
-        uint32_t offset;
-        uint32_t cBytesMissing;
+    struct BurstSession_t {
+        uint8_t     sessionId;
+        uint32_t    expectedOffset;         ///< offset which should be coming next in this session's burst
+        uint32_t    endOffset;              ///< end of the range this session reads
+        uint16_t    expectedSeqNumber;      ///< sequence number the next packet of the burst should have
+        bool        complete;
     };
 
     struct DownloadState_t {
-        uint8_t                 sessionId;
-        uint32_t                expectedOffset;         ///< offset which should be coming next
-        uint32_t                bytesWritten;
-        QList<MissingData_t>    rgMissingData;
+        uint8_t                 sessionId;              ///< Session opened first, it reads the last range and fills in missing blocks
+        QList<BurstSession_t>   rgSessions;             ///< Sessions reading disjoint ranges of the file in parallel
         QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
         QDir                    toDir;                  ///< Directory to download file to
         QString                 fileName;               ///< Filename (no path) for download file
         uint32_t                fileSize;               ///< Size of file being downloaded
-        QFile                   file;
+        QList<uint32_t>         rgFillOffsets;          ///< Missing blocks which have not been requested yet
+        QHash<uint16_t, uint32_t> fillRequests;         ///< Outstanding missing block reads, reply sequence number to offset
+        int                     fillAckCount;           ///< Missing block reads answered since the read window last changed
         int                     retryCount;
         bool                    checksize;
+        bool                    waitingForFile;         ///< Waiting for _downloadFile to finish opening or calculating the CRC32
+        uint32_t                vehicleCRC32;           ///< CRC32 of the file reported by the vehicle
 
         bool inProgress() const { return fileSize > 0; }
 
         void reset() {
             sessionId       = 0;
-            expectedOffset  = 0;
-            bytesWritten    = 0;
             retryCount      = 0;
             fileSize        = 0;
+            fillAckCount    = 0;
+            waitingForFile  = false;
+            vehicleCRC32    = 0;
             fullPathOnVehicle.clear();
             fileName.clear();
-            rgMissingData.clear();
-            file.close();
+            rgSessions.clear();
+            rgFillOffsets.clear();
+            fillRequests.clear();
         }
     };
 
@@ -140,22 +156,43 @@ private:
     void    _openFileROBegin            (void);
     void    _openFileROAckOrNak         (const MavlinkFTP::Request* ackOrNak);
     void    _openFileROTimeout          (void);
+    void    _openSessionsBegin          (void);
+    void    _openSessionsAckOrNak       (const MavlinkFTP::Request* ackOrNak);
+    void    _openSessionsTimeout        (void);
     void    _burstReadFileBegin         (void);
     void    _burstReadFileAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _burstReadFileTimeout       (void);
     void    _fillMissingBlocksBegin     (void);
     void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
     void    _fillMissingBlocksTimeout   (void);
+    void    _verifyResumedFileBegin     (void);
+    void    _verifyResumedFileAckOrNak  (const MavlinkFTP::Request* ackOrNak);
+    void    _verifyResumedFileTimeout   (void);
+    void    _verifyResumedFileFailed    (const QString& errorMsg);
     void    _resetSessionsBegin         (void);
     void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
+    void    _sendRequest                (MavlinkFTP::Request* request);
+    void    _sendOpenFileRO             (void);
+    void    _sendCalcFileCRC32          (void);
+    void    _sendTerminateSession       (uint8_t sessionId);
+    void    _terminateExtraSessions     (void);
     void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
-    void    _downloadComplete           (const QString& errorMsg);
+    void    _downloadComplete           (const QString& errorMsg, bool discardFile = false);
+    void    _downloadFileOpened         (bool success);
+    void    _downloadFileCrc32Calculated(bool success, quint32 crc);
+    void    _downloadFileClosed         (bool written);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
-    void    _fillMissingBlocksWorker    (bool firstRequest);
-    void    _burstReadFileWorker        (bool firstRequest);
+    void    _fillMissingBlocksWorker    (void);
+    void    _openSessionsWorker         (void);
+    void    _burstReadFileWorker        (BurstSession_t& session);
+    void    _burstSessionComplete       (uint8_t sessionId);
+    bool    _burstSessionsComplete      (void) const;
+    BurstSession_t* _burstSession       (uint8_t sessionId);
+    bool    _repliesTrackedBySession    (void) const;
+    void    _emitDownloadProgress       (void);
     void    _listDirectoryWorker        (bool firstRequest);
     bool    _parseURI                   (uint8_t fromCompId, const QString& uri, QString& parsedURI, uint8_t& compId);
     bool    _isListDirectoryStateMachine(void);
@@ -171,12 +208,20 @@ private:
     uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
     QList<StateFunctions_t> _rgStateMachine;
     DownloadState_t         _downloadState;
+    FTPDownloadFile*        _downloadFile;
+    QString                 _downloadFilePath;          ///< Reported by downloadComplete once _downloadFile is closed
+    QString                 _downloadErrorMsg;
     ListDirectoryState_t    _listDirectoryState;
     QTimer                  _ackOrNakTimeoutTimer;
     int                     _currentStateMachineIndex   = -1;
     uint16_t                _expectedIncomingSeqNumber  = 0;
+    int                     _readWindow                 = _initialReadWindow;  ///< Missing block reads kept outstanding, adapts to the loss seen
     
     static const int _ackOrNakTimeoutMsecs  = 1000;
     static const int _maxRetry              = 3;
+    static const int _maxSessions           = 3;            ///< Most sessions reading a file at once, if the vehicle allows it
+    static const int _minSessionRangeBytes  = 16 * 1024;    ///< Smallest range worth opening another session for
+    static const int _initialReadWindow     = 4;
+    static const int _maxReadWindow         = 16;
 };
 
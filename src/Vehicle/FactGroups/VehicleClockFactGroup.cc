@@ -23,14 +23,16 @@ VehicleClockFactGroup::VehicleClockFactGroup(QObject* parent)
     _currentTimeFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _currentUTCTimeFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _currentDateFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
+
+    // The clock is not driven by telemetry, so it needs its own tick. The strings only go out on the next group flush.
+    connect(&_clockTimer, &QTimer::timeout, this, &VehicleClockFactGroup::_updateClock);
+    _clockTimer.start(1000);
 }
 
-void VehicleClockFactGroup::_updateAllValues()
+void VehicleClockFactGroup::_updateClock()
 {
     _currentTimeFact.setRawValue(QTime::currentTime().toString());
     _currentUTCTimeFact.setRawValue(QDateTime::currentDateTimeUtc().time().toString());
     _currentDateFact.setRawValue(QDateTime::currentDateTime().toString(QLocale::system().dateFormat(QLocale::ShortFormat)));
     _setTelemetryAvailable(true);
-
-    FactGroup::_updateAllValues();
 }
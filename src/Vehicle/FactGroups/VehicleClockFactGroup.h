@@ -32,7 +32,7 @@ public:
 
 
 private slots:
-    void _updateAllValues() override;
+    void _updateClock();
 
 private:
     const QString _currentTimeFactName = QStringLiteral("currentTime");
@@ -42,4 +42,6 @@ private:
     Fact            _currentTimeFact;
     Fact            _currentUTCTimeFact;
     Fact            _currentDateFact;
+
+    QTimer          _clockTimer;
 };
@@ -61,14 +61,14 @@ void VehicleGPSFactGroup::_handleGpsRawInt(mavlink_message_t& message)
     mavlink_gps_raw_int_t gpsRawInt;
     mavlink_msg_gps_raw_int_decode(&message, &gpsRawInt);
 
-    lat()->setRawValue              (gpsRawInt.lat * 1e-7);
-    lon()->setRawValue              (gpsRawInt.lon * 1e-7);
-    mgrs()->setRawValue             (QGCGeo::convertGeoToMGRS(QGeoCoordinate(gpsRawInt.lat * 1e-7, gpsRawInt.lon * 1e-7)));
-    count()->setRawValue            (gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
-    hdop()->setRawValue             (gpsRawInt.eph == UINT16_MAX ? qQNaN() : gpsRawInt.eph / 100.0);
-    vdop()->setRawValue             (gpsRawInt.epv == UINT16_MAX ? qQNaN() : gpsRawInt.epv / 100.0);
-    courseOverGround()->setRawValue (gpsRawInt.cog == UINT16_MAX ? qQNaN() : gpsRawInt.cog / 100.0);
-    lock()->setRawValue             (gpsRawInt.fix_type);
+    lat()->setTelemetryValue              (gpsRawInt.lat * 1e-7);
+    lon()->setTelemetryValue              (gpsRawInt.lon * 1e-7);
+    mgrs()->setRawValue                   (QGCGeo::convertGeoToMGRS(QGeoCoordinate(gpsRawInt.lat * 1e-7, gpsRawInt.lon * 1e-7)));
+    count()->setTelemetryValue            (gpsRawInt.satellites_visible == 255 ? 0 : gpsRawInt.satellites_visible);
+    hdop()->setTelemetryValue             (gpsRawInt.eph == UINT16_MAX ? qQNaN() : gpsRawInt.eph / 100.0);
+    vdop()->setTelemetryValue             (gpsRawInt.epv == UINT16_MAX ? qQNaN() : gpsRawInt.epv / 100.0);
+    courseOverGround()->setTelemetryValue (gpsRawInt.cog == UINT16_MAX ? qQNaN() : gpsRawInt.cog / 100.0);
+    lock()->setTelemetryValue             (gpsRawInt.fix_type);
 }
 
 void VehicleGPSFactGroup::_handleHighLatency(mavlink_message_t& message)
@@ -86,10 +86,10 @@ void VehicleGPSFactGroup::_handleHighLatency(mavlink_message_t& message)
                 static_cast<double>(highLatency.altitude_amsl)
     };
 
-    lat()->setRawValue  (coordinate.latitude);
-    lon()->setRawValue  (coordinate.longitude);
-    mgrs()->setRawValue (QGCGeo::convertGeoToMGRS(QGeoCoordinate(coordinate.latitude, coordinate.longitude)));
-    count()->setRawValue(0);
+    lat()->setTelemetryValue  (coordinate.latitude);
+    lon()->setTelemetryValue  (coordinate.longitude);
+    mgrs()->setRawValue       (QGCGeo::convertGeoToMGRS(QGeoCoordinate(coordinate.latitude, coordinate.longitude)));
+    count()->setTelemetryValue(0);
 }
 
 void VehicleGPSFactGroup::_handleHighLatency2(mavlink_message_t& message)
@@ -97,10 +97,10 @@ void VehicleGPSFactGroup::_handleHighLatency2(mavlink_message_t& message)
     mavlink_high_latency2_t highLatency2;
     mavlink_msg_high_latency2_decode(&message, &highLatency2);
 
-    lat()->setRawValue  (highLatency2.latitude * 1e-7);
-    lon()->setRawValue  (highLatency2.longitude * 1e-7);
-    mgrs()->setRawValue (QGCGeo::convertGeoToMGRS(QGeoCoordinate(highLatency2.latitude * 1e-7, highLatency2.longitude * 1e-7)));
-    count()->setRawValue(0);
-    hdop()->setRawValue (highLatency2.eph == UINT8_MAX ? qQNaN() : highLatency2.eph / 10.0);
-    vdop()->setRawValue (highLatency2.epv == UINT8_MAX ? qQNaN() : highLatency2.epv / 10.0);
+    lat()->setTelemetryValue  (highLatency2.latitude * 1e-7);
+    lon()->setTelemetryValue  (highLatency2.longitude * 1e-7);
+    mgrs()->setRawValue       (QGCGeo::convertGeoToMGRS(QGeoCoordinate(highLatency2.latitude * 1e-7, highLatency2.longitude * 1e-7)));
+    count()->setTelemetryValue(0);
+    hdop()->setTelemetryValue (highLatency2.eph == UINT8_MAX ? qQNaN() : highLatency2.eph / 10.0);
+    vdop()->setTelemetryValue (highLatency2.epv == UINT8_MAX ? qQNaN() : highLatency2.epv / 10.0);
 }
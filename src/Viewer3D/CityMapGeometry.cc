@@ -12,6 +12,7 @@
 #include "SettingsManager.h"
 #include "OsmParser.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 
 CityMapGeometry::CityMapGeometry()
 {
@@ -61,6 +62,13 @@ bool CityMapGeometry::loadOsmMap()
         return false;
     }
 
+    // A mesh cached for this file at the current level height is mapped instead of parsing the file
+    if(_meshCache.open(_osmFilePath) && _meshCache.mapInfo().buildingLevelHeight == _osmParser->buildingLevelHeight()){
+        _osmParser->setMapFromCache(_meshCache.mapInfo());
+        return true;
+    }
+    _meshCache.close();
+
     _osmParser->parseOsmFile(_osmFilePath);
     return false;
 }
@@ -74,7 +82,25 @@ void CityMapGeometry::updateViewer()
     }
 
     if(_osmParser->mapLoaded()){
-        _vertexData = _osmParser->buildingToMesh();
+        if(_meshCache.isOpen() && _meshCache.mapInfo().buildingLevelHeight == _osmParser->buildingLevelHeight()){
+            _vertexData = _meshCache.vertexData();
+            _meshCache.close();
+        }else if(_osmParser->mapLoadedFromCache()){
+            // The level height changed since the cache was built, so the buildings have to be parsed again
+            clearViewer();
+            _meshCache.close();
+            _osmParser->parseOsmFile(_osmFilePath);
+            return;
+        }else{
+            _vertexData = _osmParser->buildingToMesh();
+
+            const QString osmFilePath = _osmFilePath;
+            const CityMapMeshCache::MapInfo_t mapInfo = _osmParser->mapInfo();
+            const QByteArray vertexData = _vertexData;
+            (void) QtConcurrent::run([osmFilePath, mapInfo, vertexData]() {
+                (void) CityMapMeshCache::write(osmFilePath, mapInfo, vertexData);
+            });
+        }
 
         int stride = 3 * sizeof(float);
         if(!_vertexData.isEmpty()){
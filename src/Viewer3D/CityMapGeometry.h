@@ -12,6 +12,8 @@
 #include <QtCore/QString>
 #include <QtQuick3D/QQuick3DGeometry>
 
+#include "CityMapMeshCache.h"
+
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
 class Viewer3DSettings;
@@ -53,6 +55,7 @@ private:
     QByteArray _vertexData;
     OsmParser *_osmParser;
     bool _mapLoadedFlag;
+    CityMapMeshCache _meshCache;    ///< Mapped mesh of the current file until updateViewer copies it into _vertexData
     Viewer3DSettings* _viewer3DSettings = nullptr;
 
 private slots:
@@ -0,0 +1,215 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CityMapMeshCache.h"
+#include "OsmParserThread.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+QGC_LOGGING_CATEGORY(CityMapMeshCacheLog, "qgc.viewer3d.citymapmeshcache")
+
+namespace {
+    constexpr quint32 kMeshCacheMagic = 0x4D434751;    // "QGCM"
+    constexpr quint32 kMeshCacheVersion = 1;
+
+    struct MeshCacheHeader_t {
+        quint32 magic;
+        quint32 version;
+        qint64  sourceSize;
+        qint64  sourceModifiedMSecs;
+        double  gpsRefLat;
+        double  gpsRefLon;
+        double  minLat;
+        double  minLon;
+        double  maxLat;
+        double  maxLon;
+        float   buildingLevelHeight;
+        quint32 reserved;
+        qint64  vertexDataSize;
+    };
+
+    // Keeps the vertex data which follows the header float aligned in the mapping
+    static_assert((sizeof(MeshCacheHeader_t) % sizeof(double)) == 0);
+
+    constexpr qint64 kVertexSize = 3 * sizeof(float);
+}
+
+CityMapMeshCache::~CityMapMeshCache()
+{
+    close();
+}
+
+QString CityMapMeshCache::_cacheDirPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/Viewer3DMeshCache");
+}
+
+QString CityMapMeshCache::cacheFilePath(const QString &osmFilePath)
+{
+    const QString sourcePath = QFileInfo(OsmParserThread::resolveFilePath(osmFilePath)).absoluteFilePath();
+    const QByteArray hash = QCryptographicHash::hash(sourcePath.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return _cacheDirPath() + QStringLiteral("/") + QString::fromLatin1(hash) + QStringLiteral(".mesh");
+}
+
+bool CityMapMeshCache::open(const QString &osmFilePath)
+{
+    close();
+
+    const QFileInfo source(OsmParserThread::resolveFilePath(osmFilePath));
+    if (!source.exists()) {
+        return false;
+    }
+
+    _file.setFileName(cacheFilePath(osmFilePath));
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    MeshCacheHeader_t header;
+    if (_file.read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) {
+        qCDebug(CityMapMeshCacheLog) << "Truncated mesh cache" << _file.fileName();
+        _file.close();
+        return false;
+    }
+
+    if ((header.magic != kMeshCacheMagic) || (header.version != kMeshCacheVersion)) {
+        qCDebug(CityMapMeshCacheLog) << "Mesh cache format mismatch" << _file.fileName();
+        _file.close();
+        return false;
+    }
+
+    if ((header.sourceSize != source.size()) || (header.sourceModifiedMSecs != source.lastModified().toMSecsSinceEpoch())) {
+        qCDebug(CityMapMeshCacheLog) << "Mesh cache is stale" << source.absoluteFilePath();
+        _file.close();
+        return false;
+    }
+
+    if ((header.vertexDataSize <= 0) || ((header.vertexDataSize % kVertexSize) != 0) || (header.vertexDataSize != (_file.size() - static_cast<qint64>(sizeof(header))))) {
+        qCWarning(CityMapMeshCacheLog) << "Mesh cache is corrupt" << _file.fileName();
+        _file.close();
+        return false;
+    }
+
+    _mappedData = _file.map(sizeof(header), header.vertexDataSize);
+    if (!_mappedData) {
+        qCWarning(CityMapMeshCacheLog) << "Unable to map mesh cache" << _file.fileName() << _file.errorString();
+        _file.close();
+        return false;
+    }
+
+    // A hit counts as use, prune() goes by modification time
+    QFile touchFile(_file.fileName());
+    if (touchFile.open(QIODevice::ReadWrite)) {
+        (void) touchFile.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    _vertexDataSize = header.vertexDataSize;
+    _mapInfo.gpsRef = QGeoCoordinate(header.gpsRefLat, header.gpsRefLon, 0);
+    _mapInfo.coordinateMin = QGeoCoordinate(header.minLat, header.minLon, 0);
+    _mapInfo.coordinateMax = QGeoCoordinate(header.maxLat, header.maxLon, 0);
+    _mapInfo.buildingLevelHeight = header.buildingLevelHeight;
+
+    qCDebug(CityMapMeshCacheLog) << "Mapped" << (_vertexDataSize / kVertexSize) << "vertices from" << _file.fileName();
+    return true;
+}
+
+void CityMapMeshCache::close()
+{
+    if (_mappedData) {
+        (void) _file.unmap(_mappedData);
+        _mappedData = nullptr;
+    }
+    _vertexDataSize = 0;
+    _mapInfo = MapInfo_t();
+
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
+
+QByteArray CityMapMeshCache::vertexData() const
+{
+    if (!_mappedData) {
+        return QByteArray();
+    }
+
+    // Qt Quick 3D uploads the vertices later on the render thread, so they must not point into a mapping which can go away
+    return QByteArray(reinterpret_cast<const char*>(_mappedData), _vertexDataSize);
+}
+
+bool CityMapMeshCache::write(const QString &osmFilePath, const MapInfo_t &mapInfo, const QByteArray &vertexData)
+{
+    const QFileInfo source(OsmParserThread::resolveFilePath(osmFilePath));
+    if (!source.exists() || vertexData.isEmpty() || ((vertexData.size() % kVertexSize) != 0)) {
+        return false;
+    }
+
+    const QString fileName = cacheFilePath(osmFilePath);
+    if (!QDir().mkpath(QFileInfo(fileName).absolutePath())) {
+        qCWarning(CityMapMeshCacheLog) << "Unable to create mesh cache directory for" << fileName;
+        return false;
+    }
+
+    MeshCacheHeader_t header{};
+    header.magic = kMeshCacheMagic;
+    header.version = kMeshCacheVersion;
+    header.sourceSize = source.size();
+    header.sourceModifiedMSecs = source.lastModified().toMSecsSinceEpoch();
+    header.gpsRefLat = mapInfo.gpsRef.latitude();
+    header.gpsRefLon = mapInfo.gpsRef.longitude();
+    header.minLat = mapInfo.coordinateMin.latitude();
+    header.minLon = mapInfo.coordinateMin.longitude();
+    header.maxLat = mapInfo.coordinateMax.latitude();
+    header.maxLon = mapInfo.coordinateMax.longitude();
+    header.buildingLevelHeight = mapInfo.buildingLevelHeight;
+    header.vertexDataSize = vertexData.size();
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(CityMapMeshCacheLog) << "Unable to write mesh cache" << fileName << file.errorString();
+        return false;
+    }
+
+    (void) file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    (void) file.write(vertexData);
+    if (!file.commit()) {
+        qCWarning(CityMapMeshCacheLog) << "Unable to write mesh cache" << fileName << file.errorString();
+        return false;
+    }
+
+    qCDebug(CityMapMeshCacheLog) << "Wrote" << (vertexData.size() / kVertexSize) << "vertices to" << fileName;
+
+    prune();
+
+    return true;
+}
+
+void CityMapMeshCache::prune()
+{
+    const QDir cacheDir(_cacheDirPath());
+    const QFileInfoList entries = cacheDir.entryInfoList(QStringList(QStringLiteral("*.mesh")), QDir::Files, QDir::Time);
+    const QDateTime oldest = QDateTime::currentDateTime().addDays(-kMaxAgeDays);
+
+    // Most recently used first, so everything past the size limit is older than what is kept
+    qint64 totalBytes = 0;
+    for (const QFileInfo &entry : entries) {
+        totalBytes += entry.size();
+        if ((entry.lastModified() < oldest) || (totalBytes > kMaxCacheBytes)) {
+            qCDebug(CityMapMeshCacheLog) << "Pruning mesh cache" << entry.absoluteFilePath();
+            totalBytes -= entry.size();
+            (void) QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
@@ -0,0 +1,71 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtPositioning/QGeoCoordinate>
+
+Q_DECLARE_LOGGING_CATEGORY(CityMapMeshCacheLog)
+
+/// Binary cache of the building mesh triangulated from an OSM file.
+///
+/// The file is a fixed size header followed by the raw xyz float vertex data in the layout CityMapGeometry hands to
+/// Qt Quick 3D, so a cache hit maps the file and copies the vertices out without parsing. Caches are machine local and
+/// written in native byte order. A cache goes stale when the OSM file changes size or modification time. The cache
+/// directory is pruned by age and total size each time a mesh is written.
+class CityMapMeshCache
+{
+public:
+    struct MapInfo_t {
+        QGeoCoordinate gpsRef;
+        QGeoCoordinate coordinateMin;
+        QGeoCoordinate coordinateMax;
+        float buildingLevelHeight = 0;  ///< Level height the mesh was built with
+    };
+
+    CityMapMeshCache() = default;
+    ~CityMapMeshCache();
+
+    /// Maps the cached mesh for the OSM file
+    ///     @return false if there is no cache or it is stale
+    bool open(const QString &osmFilePath);
+    /// Unmaps the file
+    void close();
+
+    bool isOpen() const { return (_mappedData != nullptr); }
+    const MapInfo_t &mapInfo() const { return _mapInfo; }
+
+    /// @return A copy of the mapped vertex data which stays valid after close()
+    QByteArray vertexData() const;
+
+    /// Writes the mesh for the OSM file, replacing any existing cache, then prunes the cache directory
+    static bool write(const QString &osmFilePath, const MapInfo_t &mapInfo, const QByteArray &vertexData);
+
+    /// Deletes meshes which have not been used for kMaxAgeDays, then the least recently used ones until the cache
+    /// directory is within kMaxCacheBytes
+    static void prune();
+
+    /// @return Location of the cache for the OSM file
+    static QString cacheFilePath(const QString &osmFilePath);
+
+    static constexpr qint64 kMaxCacheBytes = 512LL * 1024 * 1024;
+    static constexpr int kMaxAgeDays = 90;
+
+private:
+    static QString _cacheDirPath();
+
+    QFile _file;
+    uchar *_mappedData = nullptr;
+    qint64 _vertexDataSize = 0;
+    MapInfo_t _mapInfo;
+};
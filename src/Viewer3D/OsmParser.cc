@@ -9,19 +9,19 @@
 
 #include "OsmParser.h"
 #include "QGCApplication.h"
+#include "QGCLoggingCategory.h"
 #include "SettingsManager.h"
-#include "OsmParserThread.h"
 #include "earcut.hpp"
 
-typedef union {
-    uint array[3];
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QElapsedTimer>
 
-    struct {
-        uint x;
-        uint y;
-        uint z;
-    } axis;
-} vec3i;
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(OsmParserLog, "qgc.viewer3d.osmparser")
+
+// The mesh is handed to Qt Quick 3D as packed xyz floats
+static_assert(sizeof(QVector3D) == 3 * sizeof(float));
 
 OsmParser::OsmParser(QObject *parent)
     : QObject{parent}
@@ -40,6 +40,7 @@ OsmParser::OsmParser(QObject *parent)
 
     _gpsRefSet = false;
     _mapLoadedFlag = false;
+    _mapLoadedFromCacheFlag = false;
 
     setBuildingLevelHeight(_viewer3DSettings->buildingLevelHeight()->rawValue()); // meters
     connect(_viewer3DSettings->buildingLevelHeight(), &Fact::rawValueChanged, this, &OsmParser::setBuildingLevelHeight);
@@ -77,7 +78,7 @@ void OsmParser::osmParserFinished(bool isValid)
         }
         _mapLoadedFlag = true;
         emit mapChanged();
-        qDebug() << _osmParserWorker->mapBuildings.size() << " Buildings loaded!!!";
+        qCDebug(OsmParserLog) << _osmParserWorker->mapBuildings.size() << "buildings loaded";
     }
 }
 
@@ -87,95 +88,157 @@ void OsmParser::parseOsmFile(QString filePath)
     _osmParserWorker->mapBuildings.clear();
     _gpsRefSet = false;
     _mapLoadedFlag = false;
+    _mapLoadedFromCacheFlag = false;
     resetGpsRef();
 
     _osmParserWorker->start(filePath);
 }
 
-QByteArray OsmParser::buildingToMesh()
+void OsmParser::setMapFromCache(const CityMapMeshCache::MapInfo_t& mapInfo)
 {
-    QByteArray vertexData;
-    QMapIterator<uint64_t, OsmParserThread::BuildingType_t> ii(_osmParserWorker->mapBuildings);
+    _osmParserWorker->mapNodes.clear();
+    _osmParserWorker->mapBuildings.clear();
+    resetGpsRef();
 
-    for (auto ii = _osmParserWorker->mapBuildings.begin(), end = _osmParserWorker->mapBuildings.end(); ii != end; ++ii) {
-        float bld_height = 0;
-        // std::vector<std::array<float, 2> > bld_points;
-        // std::vector<std::vector<std::array<float, 2> > > polygon;
+    setGpsRef(mapInfo.gpsRef);
+    _coordinateMin = mapInfo.coordinateMin;
+    _coordinateMax = mapInfo.coordinateMax;
 
-        std::vector<std::array<float, 2> > all_bld_points;
-        std::vector<std::array<float, 2> > bld_points;
-        std::vector<std::vector<std::array<float, 2> > > polygon;
-        std::vector<QVector3D> triangulated_mesh;
+    _mapLoadedFlag = true;
+    _mapLoadedFromCacheFlag = true;
+    emit mapChanged();
+    qCDebug(OsmParserLog) << "Buildings loaded from the mesh cache";
+}
+
+CityMapMeshCache::MapInfo_t OsmParser::mapInfo()
+{
+    CityMapMeshCache::MapInfo_t info;
+    info.gpsRef = _osmParserWorker->gpsRefPoint;
+    info.coordinateMin = _osmParserWorker->coordinateMin;
+    info.coordinateMax = _osmParserWorker->coordinateMax;
+    info.buildingLevelHeight = _buildingLevelHeight;
+    return info;
+}
 
-        //        bld_height = (ii.value().height >= ii.value().levels * _buildingLevelHeight)?(ii.value().height):(ii.value().levels * _buildingLevelHeight);
+QByteArray OsmParser::buildingToMesh()
+{
+    QElapsedTimer timer;
+    timer.start();
 
-        if(ii.value().height > 0){
-            bld_height = ii.value().height;
-        }else if(ii.value().levels > 0){
-            bld_height = (float)(ii.value().levels) * _buildingLevelHeight;
-        }else{
-            continue;
-        }
+    QList<const OsmParserThread::BuildingType_t*> buildings;
+    buildings.reserve(_osmParserWorker->mapBuildings.size());
+    for (auto ii = _osmParserWorker->mapBuildings.cbegin(), end = _osmParserWorker->mapBuildings.cend(); ii != end; ++ii) {
+        buildings.append(&ii.value());
+    }
 
-        for(unsigned int jj=0; jj<ii.value().points_local.size(); jj++) {
-            bld_points.push_back({ii.value().points_local[jj].x(), ii.value().points_local[jj].y()});
-            all_bld_points.push_back({ii.value().points_local[jj].x(), ii.value().points_local[jj].y()});
-        }
-        polygon.push_back(bld_points);
+    // Contiguous runs of buildings are triangulated on the thread pool. Each run writes into its own vertex buffer,
+    // sized up front from the outline lengths, so the workers share nothing and the runs join in map order.
+    const qsizetype chunkCount = qBound<qsizetype>(1, buildings.size() / _minBuildingsPerChunk, QThread::idealThreadCount() * 4);
+    QList<std::pair<qsizetype, qsizetype> > chunks;
+    for(qsizetype i_c=0; i_c<chunkCount; i_c++) {
+        chunks.append({(buildings.size() * i_c) / chunkCount, (buildings.size() * (i_c + 1)) / chunkCount});
+    }
 
-        bld_points.clear();
-        for(unsigned int jj=0; jj<ii.value().points_local_inner.size(); jj++) {
-            bld_points.push_back({ii.value().points_local_inner[jj].x(), ii.value().points_local_inner[jj].y()});
-            all_bld_points.push_back({ii.value().points_local_inner[jj].x(), ii.value().points_local_inner[jj].y()});
-        }
-        if(bld_points.size() > 0){
-            polygon.push_back(bld_points);
+    const float levelHeight = _buildingLevelHeight;
+    const QList<std::vector<QVector3D> > meshes = QtConcurrent::blockingMapped<QList<std::vector<QVector3D> > >(chunks, [this, &buildings, levelHeight](const std::pair<qsizetype, qsizetype>& chunk) {
+        size_t estimatedVertices = 0;
+        for(qsizetype i_b=chunk.first; i_b<chunk.second; i_b++) {
+            // Roof and floor triangles plus two faced walls for every outline point
+            estimatedVertices += 18 * (buildings[i_b]->points_local.size() + buildings[i_b]->points_local_inner.size() + 2);
         }
 
-        std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon);
-
-        for(uint i_i=0; i_i<indices.size(); i_i+=3) {
-            // mesh for roof
-            uint n_idx = indices[i_i];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
-            n_idx = indices[i_i+1];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
-            n_idx = indices[i_i+2];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
-
-            // mesh for floor
-            n_idx = indices[i_i+2];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
-            n_idx = indices[i_i+1];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
-            n_idx = indices[i_i];
-            triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+        std::vector<QVector3D> triangulated_mesh;
+        triangulated_mesh.reserve(estimatedVertices);
+        TriangulationScratch_t scratch;
+        for(qsizetype i_b=chunk.first; i_b<chunk.second; i_b++) {
+            triangulateBuilding(*buildings[i_b], levelHeight, triangulated_mesh, scratch);
         }
+        return triangulated_mesh;
+    });
 
-        if(bld_height > 0) {
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local, bld_height, 0, 0); // mesh for wall outside
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local, bld_height, 1, 0);// mesh for wall inside
+    size_t vertexCount = 0;
+    for(const std::vector<QVector3D>& mesh : meshes) {
+        vertexCount += mesh.size();
+    }
 
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local_inner, bld_height, 0, 0); // mesh for wall outside
-            trianglateWallsExtrudedPolygon(triangulated_mesh, ii.value().points_local_inner, bld_height, 1, 0);// mesh for wall inside
+    QByteArray vertexData(vertexCount * sizeof(QVector3D), Qt::Initialization::Uninitialized);
+    char *p = vertexData.data();
+    for(const std::vector<QVector3D>& mesh : meshes) {
+        if(!mesh.empty()) {
+            memcpy(p, mesh.data(), mesh.size() * sizeof(QVector3D));
+            p += mesh.size() * sizeof(QVector3D);
         }
+    }
+
+    qCDebug(OsmParserLog) << buildings.size() << "buildings triangulated into" << vertexCount << "vertices in" << timer.elapsed() << "ms," << chunks.size() << "chunks";
+    return vertexData;
+}
+
+void OsmParser::triangulateBuilding(const OsmParserThread::BuildingType_t& building, float levelHeight, std::vector<QVector3D>& triangulated_mesh, TriangulationScratch_t& scratch)
+{
+    float bld_height = 0;
+
+    //        bld_height = (building.height >= building.levels * levelHeight)?(building.height):(building.levels * levelHeight);
+
+    if(building.height > 0){
+        bld_height = building.height;
+    }else if(building.levels > 0){
+        bld_height = (float)(building.levels) * levelHeight;
+    }else{
+        return;
+    }
+
+    std::vector<std::array<float, 2> >& all_bld_points = scratch.all_bld_points;
+    std::vector<std::vector<std::array<float, 2> > >& polygon = scratch.polygon;
+    all_bld_points.clear();
+    polygon.resize(building.points_local_inner.empty() ? 1 : 2);
 
-        QByteArray vertexData_tmp(triangulated_mesh.size() * 3 * sizeof(float), Qt::Initialization::Uninitialized);
-        float *p = reinterpret_cast<float *>(vertexData_tmp.data());
+    polygon[0].clear();
+    for(unsigned int jj=0; jj<building.points_local.size(); jj++) {
+        polygon[0].push_back({building.points_local[jj].x(), building.points_local[jj].y()});
+        all_bld_points.push_back({building.points_local[jj].x(), building.points_local[jj].y()});
+    }
 
-        for(uint i_m=0; i_m<triangulated_mesh.size(); i_m++) {
-            *p++ =  (float)triangulated_mesh[i_m].x(); *p++ =  (float)triangulated_mesh[i_m].y(); *p++ =  (float)triangulated_mesh[i_m].z();
+    if(!building.points_local_inner.empty()){
+        polygon[1].clear();
+        for(unsigned int jj=0; jj<building.points_local_inner.size(); jj++) {
+            polygon[1].push_back({building.points_local_inner[jj].x(), building.points_local_inner[jj].y()});
+            all_bld_points.push_back({building.points_local_inner[jj].x(), building.points_local_inner[jj].y()});
         }
+    }
 
-        ii.value().triangulated_mesh.insert(ii.value().triangulated_mesh.begin(), triangulated_mesh.begin(), triangulated_mesh.end());
-        vertexData.append(vertexData_tmp);
+    std::vector<uint32_t> indices = mapbox::earcut<uint32_t>(polygon);
+
+    for(uint i_i=0; i_i<indices.size(); i_i+=3) {
+        // mesh for roof
+        uint n_idx = indices[i_i];
+        triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
+        n_idx = indices[i_i+1];
+        triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
+        n_idx = indices[i_i+2];
+        triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], bld_height));
+
+        // mesh for floor
+        n_idx = indices[i_i+2];
+        triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+        n_idx = indices[i_i+1];
+        triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+        n_idx = indices[i_i];
+        triangulated_mesh.push_back(QVector3D(all_bld_points[n_idx][0], all_bld_points[n_idx][1], 0));
+    }
+
+    if(bld_height > 0) {
+        trianglateWallsExtrudedPolygon(triangulated_mesh, building.points_local, bld_height, 0, 0); // mesh for wall outside
+        trianglateWallsExtrudedPolygon(triangulated_mesh, building.points_local, bld_height, 1, 0);// mesh for wall inside
+
+        trianglateWallsExtrudedPolygon(triangulated_mesh, building.points_local_inner, bld_height, 0, 0); // mesh for wall outside
+        trianglateWallsExtrudedPolygon(triangulated_mesh, building.points_local_inner, bld_height, 1, 0);// mesh for wall inside
     }
-    return vertexData;
 }
 
-void OsmParser::trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector2D> verticesCcw, float h, bool inverseOrder, bool duplicateStartEndPoint)
+void OsmParser::trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, const std::vector<QVector2D>& verticesCcw, float h, bool inverseOrder, bool duplicateStartEndPoint)
 {
-    std::vector<QVector3D> tmp_rec_ccw(4);
+    std::array<QVector3D, 4> tmp_rec_ccw;
     uint vertices_size = verticesCcw.size() - (uint)(duplicateStartEndPoint);
 
     if(inverseOrder) {
@@ -201,25 +264,17 @@ void OsmParser::trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangula
     }
 }
 
-void OsmParser::trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector3D> verticesCcw, bool invertNormal)
+void OsmParser::trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, const std::array<QVector3D, 4>& verticesCcw, bool invertNormal)
 {
-    std::vector<vec3i> mesh_set_idx;
-    mesh_set_idx.resize(2);
-
-    if(invertNormal) {
-        mesh_set_idx[0] = {{3, 1, 0}};
-        mesh_set_idx[1] = {{3, 2, 1}};
-    } else {
-        mesh_set_idx[0] = {{0, 1, 3}};
-        mesh_set_idx[1] = {{1, 2, 3}};
-    }
-
-    uint idx_tmp;
+    static constexpr uint mesh_set_idx[2][2][3] = {
+        {{0, 1, 3}, {1, 2, 3}},
+        {{3, 1, 0}, {3, 2, 1}},
+    };
+    const uint (&mesh_set)[2][3] = mesh_set_idx[invertNormal ? 1 : 0];
 
-    for(uint i_m=0; i_m<mesh_set_idx.size(); i_m++) {
+    for(uint i_m=0; i_m<2; i_m++) {
         for(uint i_v=0; i_v<3; i_v++) {
-            idx_tmp = mesh_set_idx[i_m].array[i_v];
-            triangulatedMesh.push_back(QVector3D(verticesCcw[idx_tmp].x(), verticesCcw[idx_tmp].y(), verticesCcw[idx_tmp].z()));
+            triangulatedMesh.push_back(verticesCcw[mesh_set[i_m][i_v]]);
         }
     }
 }
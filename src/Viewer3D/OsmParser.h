@@ -9,41 +9,70 @@
 
 #pragma once
 
+#include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector2D>
 #include <QtPositioning/QGeoCoordinate>
 #include <QtCore/QVariant>
 
+#include "CityMapMeshCache.h"
+#include "OsmParserThread.h"
+
+#include <array>
+#include <vector>
+
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
+Q_DECLARE_LOGGING_CATEGORY(OsmParserLog)
+
 class Viewer3DSettings;
-class OsmParserThread;
+class OsmParserTest;
 
 class OsmParser : public QObject
 {
     Q_OBJECT
 
+    friend class OsmParserTest;
+
     // Q_PROPERTY(float buildingLevelHeight READ buildingLevelHeight WRITE setBuildingLevelHeight NOTIFY buildingLevelHeightChanged)
 
 public:
     explicit OsmParser(QObject *parent = nullptr);
 
     bool mapLoaded(){return _mapLoadedFlag;}
+    bool mapLoadedFromCache(){return _mapLoadedFromCacheFlag;}
     void setGpsRef(QGeoCoordinate gpsRef);
     void resetGpsRef();
     QGeoCoordinate getGpsRef(){ return _gpsRefPoint;}
 
     float buildingLevelHeight(void){return _buildingLevelHeight;}
     void parseOsmFile(QString filePath);
+    /// Loads the map from a mesh cache instead of parsing the OSM file. The buildings are not available, so
+    /// buildingToMesh() has nothing to triangulate until the file is parsed.
+    void setMapFromCache(const CityMapMeshCache::MapInfo_t& mapInfo);
+    /// The reference point, bounds and level height the current buildings were triangulated with
+    CityMapMeshCache::MapInfo_t mapInfo();
 
+    /// Triangulates all buildings, spread over the global thread pool
     QByteArray buildingToMesh();
 
-    void trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector2D> verticesCcw, float h, bool inverseOrder=0, bool duplicateStartEndPoint=0);
-    void trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector3D> verticesCcw, bool invertNormal);
+    void trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, const std::vector<QVector2D>& verticesCcw, float h, bool inverseOrder=0, bool duplicateStartEndPoint=0);
+    void trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, const std::array<QVector3D, 4>& verticesCcw, bool invertNormal);
     std::pair<QGeoCoordinate, QGeoCoordinate> getMapBoundingBoxCoordinate(){ return std::pair(_coordinateMin, _coordinateMax);}
 
 private:
+    // Scratch buffers reused across the buildings of one worker chunk
+    typedef struct TriangulationScratch_s
+    {
+        std::vector<std::array<float, 2> > all_bld_points;
+        std::vector<std::vector<std::array<float, 2> > > polygon;
+    }TriangulationScratch_t;
+
+    void triangulateBuilding(const OsmParserThread::BuildingType_t& building, float levelHeight, std::vector<QVector3D>& triangulatedMesh, TriangulationScratch_t& scratch);
+
+    static constexpr int _minBuildingsPerChunk = 256;
+
     OsmParserThread* _osmParserWorker;
     QGeoCoordinate _gpsRefPoint;
     QGeoCoordinate _coordinateMin, _coordinateMax; //Osm map bounding boxes in global coordinate
@@ -52,6 +81,7 @@ private:
     bool _gpsRefSet;
     float _buildingLevelHeight;
     bool _mapLoadedFlag;
+    bool _mapLoadedFromCacheFlag;
     Viewer3DSettings* _viewer3DSettings = nullptr;
     QList<QString> _singleStoreyBuildings;
     QList<QString> _doubleStoreyLeisure;
@@ -11,6 +11,7 @@
 #include "Viewer3DUtils.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QXmlStreamReader>
 
 OsmParserThread::OsmParserThread(QObject *parent)
     : QThread{parent}
@@ -36,6 +37,15 @@ void OsmParserThread::start(QString filePath)
     emit startThread(filePath);
 }
 
+QString OsmParserThread::resolveFilePath(const QString &filePath)
+{
+#ifdef __unix__
+    return QString("/") + filePath;
+#else
+    return filePath;
+#endif
+}
+
 void OsmParserThread::parseOsmFile(QString filePath)
 {
     mapNodes.clear();
@@ -52,12 +62,8 @@ void OsmParserThread::parseOsmFile(QString filePath)
         return;
     }
 
-    //The QDomDocument class represents an XML document.
-    QDomDocument xml_content;
-// Load xml file as raw data
-#ifdef __unix__
-    filePath = QString("/") + filePath;
-#endif
+    // The file is read as a stream, so memory use follows the nodes and buildings kept rather than the file size
+    filePath = resolveFilePath(filePath);
     QFile f(filePath);
     if (!f.open(QIODevice::ReadOnly )) {
         // Error while loading file
@@ -65,11 +71,15 @@ void OsmParserThread::parseOsmFile(QString filePath)
         return;
     }
     qDebug("Loading the OSM file!!!");
-    // Set data into the QDomDocument before processing
-    xml_content.setContent(&f);
+
+    QXmlStreamReader xml(&f);
+    const bool isValid = decodeFile(xml, mapBuildings, mapNodes, coordinateMin, coordinateMax, gpsRefPoint);
     f.close();
 
-    if(decodeFile(xml_content, mapBuildings, mapNodes, coordinateMin, coordinateMax, gpsRefPoint)){
+    // Nodes are only needed to resolve the way references
+    mapNodes = QHash<uint64_t, NodeType_t>();
+
+    if(isValid){
         _mapLoadedFlag = true;
         emit fileParsed(true);
         return;
@@ -78,79 +88,74 @@ void OsmParserThread::parseOsmFile(QString filePath)
     emit fileParsed(false);
 }
 
-bool OsmParserThread::decodeFile(QDomDocument &xml_content, QMap<uint64_t, OsmParserThread::BuildingType_t> &buildingMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordinateMin, QGeoCoordinate &coordinateMax, QGeoCoordinate &gpsRef)
+bool OsmParserThread::decodeFile(QXmlStreamReader &xml, QMap<uint64_t, OsmParserThread::BuildingType_t> &buildingMap, QHash<uint64_t, NodeType_t> &nodeMap, QGeoCoordinate &coordinateMin, QGeoCoordinate &coordinateMax, QGeoCoordinate &gpsRef)
 {
-    QDomElement root = xml_content.documentElement();
-    QDomElement xmlComponent = root.firstChild().toElement();
+    if(!xml.readNextStartElement()){
+        qDebug() << "OSM file has no root element" << xml.errorString();
+        return false;
+    }
+
     QGeoCoordinate tmpGpsRef;
     bool gpsRefIsSet = false;
-    while(!xmlComponent.isNull()) {
-        if(decodeNodeTags(xmlComponent, nodeMap, coordinateMin, coordinateMax, tmpGpsRef)){
-            gpsRefIsSet = true;
-            gpsRef = tmpGpsRef;
+    while(xml.readNextStartElement()) {
+        const QStringView tagName = xml.name();
+        if(tagName == u"node" || tagName == u"bounds"){
+            if(decodeNodeTags(xml, nodeMap, coordinateMin, coordinateMax, tmpGpsRef)){
+                gpsRefIsSet = true;
+                gpsRef = tmpGpsRef;
+            }
+        }else if(tagName == u"way"){
+            decodeBuildings(xml, buildingMap, nodeMap, coordinateMin, coordinateMax, gpsRef);
+        }else if(tagName == u"relation"){
+            decodeRelations(xml, buildingMap);
+        }else{
+            xml.skipCurrentElement();
         }
-        decodeBuildings(xmlComponent, buildingMap, nodeMap, coordinateMin, coordinateMax, gpsRef);
-        decodeRelations(xmlComponent, buildingMap, nodeMap, gpsRef);
+    }
 
-        xmlComponent = xmlComponent.nextSibling().toElement();
+    if(xml.hasError()){
+        qDebug() << "Error while parsing OSM file at line" << xml.lineNumber() << xml.errorString();
+        return false;
     }
     return gpsRefIsSet;
 }
 
-bool OsmParserThread::decodeNodeTags(QDomElement &xmlComponent, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate &gpsRef)
+bool OsmParserThread::decodeNodeTags(QXmlStreamReader &xml, QHash<uint64_t, NodeType_t> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate &gpsRef)
 {
-    int64_t id_tmp=0;
-    QGeoCoordinate gps_tmp;
-    QString attribute;
+    const QXmlStreamAttributes attributes = xml.attributes();
     bool gpsRefIsSet = false;
 
-    if (xmlComponent.tagName()=="node") {
-
-        attribute = xmlComponent.attribute("id","-1");
-        id_tmp = attribute.toLongLong();
-
-        attribute = xmlComponent.attribute("lat","0");
-        gps_tmp.setLatitude(attribute.toDouble());
-
-        attribute = xmlComponent.attribute("lon","0");
-        gps_tmp.setLongitude(attribute.toDouble());
-
-        gps_tmp.setAltitude(0);
-
+    if (xml.name() == u"node") {
+        const int64_t id_tmp = attributes.hasAttribute(u"id") ? attributes.value(u"id").toLongLong() : -1;
         if(id_tmp > 0) {
-            nodeMap.insert((uint64_t)id_tmp, gps_tmp);
+            nodeMap.insert((uint64_t)id_tmp, NodeType_t{attributes.value(u"lat").toDouble(), attributes.value(u"lon").toDouble()});
         }
-    }else if(xmlComponent.tagName() == "bounds") {
-        coordMin.setLatitude(xmlComponent.attribute("minlat","0").toFloat());
-        coordMin.setLongitude(xmlComponent.attribute("minlon","0").toFloat());
+    }else if(xml.name() == u"bounds") {
+        coordMin.setLatitude(attributes.value(u"minlat").toFloat());
+        coordMin.setLongitude(attributes.value(u"minlon").toFloat());
         coordMin.setAltitude(0);
-        coordMax.setLatitude(xmlComponent.attribute("maxlat","0").toFloat());
-        coordMax.setLongitude(xmlComponent.attribute("maxlon","0").toFloat());
+        coordMax.setLatitude(attributes.value(u"maxlat").toFloat());
+        coordMax.setLongitude(attributes.value(u"maxlon").toFloat());
         coordMax.setAltitude(0);
 
         gpsRefIsSet = true;
-        gps_tmp.setLatitude(0.5 * (coordMin.latitude() + coordMax.latitude()));
-        gps_tmp.setLongitude(0.5 * (coordMin.longitude() + coordMax.longitude()));
-        gps_tmp.setAltitude(0);
-        gpsRef = gps_tmp;
+        gpsRef = QGeoCoordinate(0.5 * (coordMin.latitude() + coordMax.latitude()), 0.5 * (coordMin.longitude() + coordMax.longitude()), 0);
     }
+
+    // Node tags are not used
+    xml.skipCurrentElement();
     return gpsRefIsSet;
 }
 
-void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate gpsRef)
+void OsmParserThread::decodeBuildings(QXmlStreamReader &xml, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, const QHash<uint64_t, NodeType_t> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, const QGeoCoordinate &gpsRef)
 {
-    if (xmlComponent.tagName()!="way"){
-        return;
-    }
-
-    int64_t id_tmp = xmlComponent.attribute("id","0").toLongLong();
+    int64_t id_tmp = xml.attributes().value(u"id").toLongLong();
     if(id_tmp == 0) {
+        xml.skipCurrentElement();
         return;
     }
     OsmParserThread::BuildingType_t bld_tmp;
-    QGeoCoordinate gps_pt_tmp;
     QVector3D local_pt_tmp;
-    std::vector<QGeoCoordinate> bld_points;
     std::vector<QVector2D> bld_points_local;
     double bld_lon_max, bld_lon_min, bld_lat_max, bld_lat_min;
     double bld_x_max, bld_x_min, bld_y_max, bld_y_min;
@@ -160,19 +165,19 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
     bld_lon_min = bld_lat_min = 1e10;
 
     int64_t ref_id;
-    QDomElement Child = xmlComponent.firstChild().toElement();
-    QString attribute;
 
     bld_tmp.height = 0;
     bld_tmp.levels = 0;
 
-    while (!Child.isNull()) {
-        if (Child.tagName()=="nd") {
-            ref_id = Child.attribute("ref","0").toLongLong();
+    while (xml.readNextStartElement()) {
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == u"nd") {
+            ref_id = attributes.value(u"ref").toLongLong();
 
-            if(ref_id > 0) {
-                gps_pt_tmp = nodeMap[ref_id];
-                bld_points.push_back(gps_pt_tmp);
+            // Extracts clipped to a bounding box reference nodes outside of it
+            const auto node = nodeMap.constFind(ref_id);
+            if(ref_id > 0 && node != nodeMap.constEnd()) {
+                const QGeoCoordinate gps_pt_tmp(node->lat, node->lon, 0);
                 local_pt_tmp = mapGpsToLocalPoint(gps_pt_tmp, gpsRef);
                 bld_points_local.push_back(QVector2D(local_pt_tmp.x(), local_pt_tmp.y()));
 
@@ -181,36 +186,36 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
                 bld_x_min = (bld_x_min > local_pt_tmp.x())?(local_pt_tmp.x()):(bld_x_min);
                 bld_y_min = (bld_y_min > local_pt_tmp.y())?(local_pt_tmp.y()):(bld_y_min);
 
-                bld_lon_max = fmax(bld_lon_max, gps_pt_tmp.longitude());
-                bld_lat_max = fmax(bld_lat_max, gps_pt_tmp.latitude());
-                bld_lon_min = fmin(bld_lon_min, gps_pt_tmp.longitude());
-                bld_lat_min = fmin(bld_lat_min, gps_pt_tmp.latitude());
+                bld_lon_max = fmax(bld_lon_max, node->lon);
+                bld_lat_max = fmax(bld_lat_max, node->lat);
+                bld_lon_min = fmin(bld_lon_min, node->lon);
+                bld_lat_min = fmin(bld_lat_min, node->lat);
             }
-        }else if (Child.tagName()=="tag") {
-            attribute = Child.attribute("k","0");
-            if(attribute == "building:levels") {
-                bld_tmp.levels = Child.attribute("v","0").toFloat();
-            }else if(attribute == "height") {
-                bld_tmp.height = Child.attribute("v","0").toFloat();
-            }else if(attribute == "building" && bld_tmp.levels == 0 && bld_tmp.height == 0){
-                QString attribute_2 = Child.attribute("v","0");
+        }else if (xml.name() == u"tag") {
+            const QStringView attribute = attributes.value(u"k");
+            if(attribute == u"building:levels") {
+                bld_tmp.levels = attributes.value(u"v").toFloat();
+            }else if(attribute == u"height") {
+                bld_tmp.height = attributes.value(u"v").toFloat();
+            }else if(attribute == u"building" && bld_tmp.levels == 0 && bld_tmp.height == 0){
+                const QString attribute_2 = attributes.value(u"v").toString();
                 if(_singleStoreyBuildings.contains(attribute_2)){
                     bld_tmp.levels = 1;
                 }else{
                     bld_tmp.levels = 2;
                 }
-            }else if(attribute == "leisure" && bld_tmp.levels == 0 && bld_tmp.height == 0){
-                QString attribute_2 = Child.attribute("v","0");
+            }else if(attribute == u"leisure" && bld_tmp.levels == 0 && bld_tmp.height == 0){
+                const QString attribute_2 = attributes.value(u"v").toString();
                 if(_doubleStoreyLeisure.contains(attribute_2)){
                     bld_tmp.levels = 2;
                 }
             }
         }
 
-        Child = Child.nextSibling().toElement();
+        xml.skipCurrentElement();
     }
 
-    if(bld_points.size() > 2) {
+    if(bld_points_local.size() > 2) {
         //        float bld_height = (bld_tmp.height >= bld_tmp.levels * _buildingLevelHeight)?(bld_tmp.height):(bld_tmp.levels * _buildingLevelHeight);
         //        bld_tmp.height = bld_height;
         if(bld_tmp.levels > 0 || bld_tmp.height > 0){
@@ -219,30 +224,23 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
             coordMax.setLatitude(fmax(coordMax.latitude(), bld_lat_max));
             coordMax.setLongitude(fmax(coordMax.longitude(), bld_lon_max));
         }
-        bld_tmp.points_gps = bld_points;
-        bld_tmp.points_local = bld_points_local;
+        bld_tmp.points_local = std::move(bld_points_local);
         bld_tmp.bb_max = QVector2D(bld_x_max, bld_y_max);
         bld_tmp.bb_min = QVector2D(bld_x_min, bld_y_min);
-        bldMap.insert(id_tmp, bld_tmp);
+        bldMap.insert(id_tmp, std::move(bld_tmp));
     }
 }
 
-void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate gpsRef)
+void OsmParserThread::decodeRelations(QXmlStreamReader &xml, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap)
 {
-    if (xmlComponent.tagName()!="relation"){
-        return;
-    }
-
-    int64_t id_tmp = xmlComponent.attribute("id","0").toLongLong();
+    int64_t id_tmp = xml.attributes().value(u"id").toLongLong();
     if(id_tmp == 0) {
+        xml.skipCurrentElement();
         return;
     }
 
     OsmParserThread::BuildingType_t bld_tmp;
     int64_t ref_id;
-    QDomElement Child = xmlComponent.firstChild().toElement();
-    QString attribute;
-    QString role;
 
     bld_tmp.height = 0;
     bld_tmp.levels = 0;
@@ -250,14 +248,14 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
     bool isBuilding = false;
     bool isMultipolygon = false;
 
-    while (!Child.isNull()) {
-        if (Child.tagName()=="member") {
-            ref_id = Child.attribute("ref","0").toLongLong();
-            role = Child.attribute("role","0");
+    while (xml.readNextStartElement()) {
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == u"member") {
+            ref_id = attributes.value(u"ref").toLongLong();
+            const bool isInner = (attributes.value(u"role") == u"inner");
             auto bldItem = bldMap.find(ref_id);
             if(bldItem != bldMap.end()) {
-                bld_tmp.append(bldItem.value().points_local, role == "inner");
-                bld_tmp.append(bldItem.value().points_gps, role == "inner");
+                bld_tmp.append(bldItem.value().points_local, isInner);
                 bld_tmp.levels = fmax(bld_tmp.levels, bldItem.value().levels);
                 bld_tmp.height = fmax(bld_tmp.height, bldItem.value().height);
 
@@ -267,17 +265,18 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
                 bld_tmp.bb_min[1] = fmin(bld_tmp.bb_min[1], bldItem.value().bb_min[1]);
                 bldToBeRemoved.push_back(ref_id);
             }
-        }else if (Child.tagName()=="tag") {
-            attribute = Child.attribute("k","0");
-            if(attribute == "type") {
-                if(Child.attribute("v","0") == "multipolygon"){
+        }else if (xml.name() == u"tag") {
+            const QStringView attribute = attributes.value(u"k");
+            if(attribute == u"type") {
+                if(attributes.value(u"v") == u"multipolygon"){
                     isMultipolygon = true;
                 }
-            }else if(attribute == "building"){
+            }else if(attribute == u"building"){
                 isBuilding = true;
             }
         }
-        Child = Child.nextSibling().toElement();
+
+        xml.skipCurrentElement();
     }
 
     if(isBuilding){
@@ -285,11 +284,11 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
             bld_tmp.levels = (bld_tmp.levels == 0)?(2):(bld_tmp.levels);
         }
     }
-    if(isMultipolygon){
+    if(isMultipolygon && !bldToBeRemoved.empty()){
         for(uint i_id=0; i_id<bldToBeRemoved.size(); i_id++){
             bldMap.remove(bldToBeRemoved[i_id]);
         }
-        bldMap.insert(bldToBeRemoved[0], bld_tmp);
+        bldMap.insert(bldToBeRemoved[0], std::move(bld_tmp));
     }
 }
 
@@ -11,7 +11,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QThread>
-#include <QtXml/QDomDocument>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector2D>
@@ -19,6 +19,7 @@
 
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
+class QXmlStreamReader;
 
 class OsmParserThread : public QThread
 {
@@ -26,48 +27,40 @@ class OsmParserThread : public QThread
 public:
     typedef struct BuildingType_s
     {
-        std::vector<QGeoCoordinate> points_gps;
-        std::vector<QGeoCoordinate> points_gps_inner;
         std::vector<QVector2D> points_local;
         std::vector<QVector2D> points_local_inner;
-        std::vector<QVector3D> triangulated_mesh;
         QVector2D bb_max = QVector2D(-1e6, -1e6); //bounding boxes
         QVector2D bb_min = QVector2D(1e6, 1e6); //bounding boxes
         float height;
         float levels;
 
-        void append(std::vector<QGeoCoordinate> newPoints, bool isInner){
-            for(uint i=0; i<newPoints.size(); i++){
-                if(isInner){
-                    points_gps_inner.push_back(newPoints[i]);
-                }else{
-                    points_gps.push_back(newPoints[i]);
-                }
-            }
-        }
-
-        void append(std::vector<QVector2D> newPoints, bool isInner){
-            for(uint i=0; i<newPoints.size(); i++){
-                if(isInner){
-                    points_local_inner.push_back(newPoints[i]);
-                }else{
-                    points_local.push_back(newPoints[i]);
-                }
-            }
+        void append(const std::vector<QVector2D>& newPoints, bool isInner){
+            std::vector<QVector2D>& points = isInner ? points_local_inner : points_local;
+            points.insert(points.end(), newPoints.begin(), newPoints.end());
         }
     }BuildingType_t;
 
+    // Only the position is kept per node, a QGeoCoordinate per node costs a heap allocation
+    typedef struct NodeType_s
+    {
+        double lat;
+        double lon;
+    }NodeType_t;
+
     Q_OBJECT
 public:
     explicit OsmParserThread(QObject *parent = nullptr);
 
     QGeoCoordinate gpsRefPoint;
-    QMap<uint64_t, QGeoCoordinate> mapNodes;
+    QHash<uint64_t, NodeType_t> mapNodes;
     QMap<uint64_t, BuildingType_t> mapBuildings;
     QGeoCoordinate coordinateMin, coordinateMax;
 
     void start(QString filePath);
 
+    /// Maps the path stored in the settings to the file on disk
+    static QString resolveFilePath(const QString& filePath);
+
 private:
     QThread* _mainThread;
     bool _mapLoadedFlag;
@@ -75,10 +68,10 @@ private:
     QList<QString> _doubleStoreyLeisure;
 
     void parseOsmFile(QString filePath);
-    bool decodeFile(QDomDocument& xml_content, QMap<uint64_t, BuildingType_t > &buildingMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordinateMin, QGeoCoordinate& coordinateMax, QGeoCoordinate& gpsRef);
-    bool decodeNodeTags(QDomElement& xmlComponent, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate& gpsRef);
-    void decodeBuildings(QDomElement& xmlComponent, QMap<uint64_t, BuildingType_t > &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate gpsRef);
-    void decodeRelations(QDomElement& xmlComponent, QMap<uint64_t, BuildingType_t > &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate gpsRef);
+    bool decodeFile(QXmlStreamReader& xml, QMap<uint64_t, BuildingType_t > &buildingMap, QHash<uint64_t, NodeType_t> &nodeMap, QGeoCoordinate& coordinateMin, QGeoCoordinate& coordinateMax, QGeoCoordinate& gpsRef);
+    bool decodeNodeTags(QXmlStreamReader& xml, QHash<uint64_t, NodeType_t> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate& gpsRef);
+    void decodeBuildings(QXmlStreamReader& xml, QMap<uint64_t, BuildingType_t > &bldMap, const QHash<uint64_t, NodeType_t> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, const QGeoCoordinate& gpsRef);
+    void decodeRelations(QXmlStreamReader& xml, QMap<uint64_t, BuildingType_t > &bldMap);
 
 
 signals:
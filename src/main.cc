@@ -16,6 +16,8 @@
 #include "QGCApplication.h"
 #include "QGC.h"
 #include "AppMessages.h"
+#include "CmdLineOptParser.h"
+#include "TlogAnalyzer.h"
 
 #ifndef __mobile__
     #include "RunGuard.h"
@@ -27,8 +29,6 @@
 
 #ifdef QT_DEBUG
 
-#include "CmdLineOptParser.h"
-
 #ifdef UNITTEST_BUILD
 #include "UnitTestList.h"
 #endif
@@ -82,6 +82,25 @@ void sigHandler(int s)
 
 int main(int argc, char *argv[])
 {
+    // Headless log analysis needs no display and may run next to a normal instance, so it is handled first
+    bool analyzeTlog = false;
+    bool analyzeFieldsFound = false;
+    bool analyzeOutputFound = false;
+    QString analyzeTlogFilename;
+    QString analyzeFields;
+    QString analyzeOutputFilename;
+    CmdLineOpt_t rgAnalyzeOptions[] = {
+        { "--analyze-tlog",         &analyzeTlog,           &analyzeTlogFilename },
+        { "--analyze-fields",       &analyzeFieldsFound,    &analyzeFields },
+        { "--analyze-output",       &analyzeOutputFound,    &analyzeOutputFilename },
+    };
+
+    ParseCmdLineOptions(argc, argv, rgAnalyzeOptions, sizeof(rgAnalyzeOptions)/sizeof(rgAnalyzeOptions[0]), false);
+    if (analyzeTlog) {
+        QCoreApplication analyzeApp(argc, argv);
+        return TlogAnalyzer::runCommandLine(analyzeTlogFilename, analyzeFields, analyzeOutputFilename);
+    }
+
 #ifndef __mobile__
     // We make the runguard key different for custom and non custom
     // builds, so they can be executed together in the same device.
@@ -1,15 +1,24 @@
 #include "ADSBTest.h"
 #include "ADSBVehicleManager.h"
-#include "ADSBVehicle.h"
 #include "ADSBTCPLink.h"
+#include "ADSBSbsParser.h"
+#include "ADSBTrafficModel.h"
+#include "ADSBTrafficTable.h"
 #include "QmlObjectListModel.h"
 
+#include <QtCore/QRandomGenerator>
 #include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
-void ADSBTest::_adsbVehicleTest()
+#include <algorithm>
+
+void ADSBTest::_adsbTrafficTableUpdateTest()
 {
+    ADSBTrafficTable table;
+    int row;
+
     ADSB::VehicleInfo_t vehicleInfo;
     vehicleInfo.icaoAddress = 1;
     vehicleInfo.callsign = QStringLiteral("1");
@@ -17,30 +26,40 @@ void ADSBTest::_adsbVehicleTest()
     vehicleInfo.altitude = 1.;
     vehicleInfo.heading = 1.;
     vehicleInfo.alert = false;
-    vehicleInfo.availableFlags = ADSB::CallsignAvailable;
+    vehicleInfo.availableFlags = ADSB::CallsignAvailable | ADSB::LocationAvailable;
 
-    ADSBVehicle* const adsbVehicle = new ADSBVehicle(vehicleInfo, this);
-    QVERIFY(adsbVehicle != nullptr);
-    QVERIFY(!adsbVehicle->expired());
-
-    QCOMPARE(adsbVehicle->icaoAddress(), vehicleInfo.icaoAddress);
-    QCOMPARE(adsbVehicle->callsign(), vehicleInfo.callsign);
-    QCOMPARE_NE(adsbVehicle->coordinate(), vehicleInfo.location);
+    QCOMPARE(table.update(vehicleInfo, 0, row), ADSBTrafficTable::Added);
+    QCOMPARE(table.icaoAddress(row), vehicleInfo.icaoAddress);
+    QCOMPARE(table.callsign(row), vehicleInfo.callsign);
+    QCOMPARE(table.coordinate(row), vehicleInfo.location);
+    QCOMPARE(table.lastUpdateMsecs(row), static_cast<qint64>(0));
 
+    // Only the fields flagged as available are applied
     ADSB::VehicleInfo_t vehicleInfo2;
-    vehicleInfo2.icaoAddress = 2;
+    vehicleInfo2.icaoAddress = 1;
     vehicleInfo2.callsign = QStringLiteral("2");
     vehicleInfo2.location = QGeoCoordinate(2., 2.);
-    vehicleInfo2.availableFlags = ADSB::CallsignAvailable | ADSB::LocationAvailable;
+    vehicleInfo2.altitude = 2.;
+    vehicleInfo2.availableFlags = ADSB::AltitudeAvailable;
 
-    adsbVehicle->update(vehicleInfo2);
-    QCOMPARE_NE(adsbVehicle->callsign(), vehicleInfo2.callsign);
-    QCOMPARE_NE(adsbVehicle->coordinate(), vehicleInfo2.location);
+    QCOMPARE(table.update(vehicleInfo2, 10, row), ADSBTrafficTable::Changed);
+    QCOMPARE(row, 0);
+    QCOMPARE(table.callsign(row), vehicleInfo.callsign);
+    QCOMPARE(table.coordinate(row), vehicleInfo.location);
+    QCOMPARE(table.altitude(row), vehicleInfo2.altitude);
+    QCOMPARE(table.lastUpdateMsecs(row), static_cast<qint64>(10));
 
-    vehicleInfo2.icaoAddress = 1;
-    adsbVehicle->update(vehicleInfo2);
-    QCOMPARE(adsbVehicle->callsign(), vehicleInfo2.callsign);
-    QCOMPARE(adsbVehicle->coordinate(), vehicleInfo2.location);
+    vehicleInfo2.availableFlags = ADSB::CallsignAvailable | ADSB::LocationAvailable;
+    QCOMPARE(table.update(vehicleInfo2, 20, row), ADSBTrafficTable::Changed);
+    QCOMPARE(table.callsign(row), vehicleInfo2.callsign);
+    QCOMPARE(table.coordinate(row), vehicleInfo2.location);
+
+    // A different address is a different aircraft
+    vehicleInfo2.icaoAddress = 2;
+    QCOMPARE(table.update(vehicleInfo2, 30, row), ADSBTrafficTable::Added);
+    QCOMPARE(row, 1);
+    QCOMPARE(table.count(), 2);
+    QCOMPARE(table.callsign(table.rowOf(1)), vehicleInfo2.callsign);
 }
 
 void ADSBTest::_adsbTcpLinkTest()
@@ -88,3 +107,304 @@ void ADSBTest::_adsbVehicleManagerTest()
     manager->adsbVehicleUpdate(vehicleInfo);
     QCOMPARE(manager->adsbVehicles()->count(), 1);
 }
+
+QByteArray ADSBTest::_sbsLine(int msgType, uint32_t icaoAddress, const QByteArray &callsign, double lat, double lon, int altitudeFt, double heading)
+{
+    QList<QByteArray> values(22);
+    values[0] = "MSG";
+    values[1] = QByteArray::number(msgType);
+    values[2] = "1";
+    values[3] = "1";
+    values[4] = QByteArray::number(icaoAddress, 16).toUpper().rightJustified(6, '0');
+    values[5] = "1";
+    values[6] = "2024/06/01";
+    values[7] = "12:00:00.000";
+    values[8] = "2024/06/01";
+    values[9] = "12:00:00.000";
+
+    switch (msgType) {
+    case ADSB::IdentificationAndCategory:
+        values[10] = callsign;
+        break;
+    case ADSB::AirbornePosition:
+        values[11] = QByteArray::number(altitudeFt);
+        values[14] = QByteArray::number(lat, 'f', 5);
+        values[15] = QByteArray::number(lon, 'f', 5);
+        values[18] = "0";
+        values[19] = "0";
+        values[20] = "0";
+        values[21] = "0";
+        break;
+    case ADSB::AirborneVelocity:
+        values[12] = "420";
+        values[13] = QByteArray::number(heading, 'f', 1);
+        values[16] = "-64";
+        break;
+    default:
+        break;
+    }
+
+    return values.join(',') + "\r\n";
+}
+
+void ADSBTest::_adsbSbsParserTest()
+{
+    ADSBSbsParser parser;
+
+    // Lines for one aircraft merge into a single update holding the latest state
+    QByteArray stream;
+    stream += _sbsLine(ADSB::IdentificationAndCategory, 0x4840D6, "KLM1023 ", 0, 0, 0, 0);
+    stream += _sbsLine(ADSB::AirbornePosition, 0x4840D6, QByteArray(), 52.1, 4.5, 10000, 0);
+    stream += _sbsLine(ADSB::AirbornePosition, 0x4840D6, QByteArray(), 52.2, 4.6, 10025, 0);
+    stream += _sbsLine(ADSB::AirborneVelocity, 0x4840D6, QByteArray(), 0, 0, 0, 271.5);
+    stream += _sbsLine(ADSB::AirbornePosition, 0xABCDEF, QByteArray(), -33.9, 151.2, 35000, 0);
+    stream += "MSG,8,1,1,ABCDEF,1,2024/06/01,12:00:00.000,2024/06/01,12:00:00.000,,,,,,,,,,,,0\r\n";
+    stream += "not sbs\r\n";
+
+    // Split the last line so the parser has to leave it for the next read
+    const QByteArray partial = _sbsLine(ADSB::AirborneVelocity, 0xABCDEF, QByteArray(), 0, 0, 0, 90);
+    stream += partial.left(20);
+
+    QCOMPARE(parser.parse(stream), stream.size() - 20);
+    QCOMPARE(parser.lineCount(), static_cast<quint64>(7));
+    QCOMPARE(parser.updates().count(), 2);
+
+    const ADSB::VehicleInfo_t &klm = parser.updates()[0];
+    QCOMPARE(klm.icaoAddress, static_cast<uint32_t>(0x4840D6));
+    QCOMPARE(klm.callsign, QStringLiteral("KLM1023"));
+    QCOMPARE(klm.location, QGeoCoordinate(52.2, 4.6));
+    QCOMPARE(klm.altitude, 10025 * 0.3048);
+    QCOMPARE(klm.heading, 271.5);
+    QCOMPARE(klm.availableFlags.toInt(), (ADSB::CallsignAvailable | ADSB::LocationAvailable | ADSB::AltitudeAvailable | ADSB::HeadingAvailable | ADSB::AlertAvailable).toInt());
+
+    const ADSB::VehicleInfo_t &other = parser.updates()[1];
+    QCOMPARE(other.location, QGeoCoordinate(-33.9, 151.2));
+    QVERIFY(!(other.availableFlags & ADSB::HeadingAvailable));
+
+    // Once the rest of the split line arrives it lands in the next batch
+    parser.clearUpdates();
+    QCOMPARE(parser.parse(partial.left(20)), 0);
+    QCOMPARE(parser.parse(partial), partial.size());
+    QCOMPARE(parser.updates().count(), 1);
+    QCOMPARE(parser.updates()[0].heading, 90.0);
+    QCOMPARE(parser.updates()[0].availableFlags.toInt(), ADSB::AvailableInfoTypes(ADSB::HeadingAvailable).toInt());
+
+    // Garbage without line terminators is dropped rather than buffered forever
+    parser.clearUpdates();
+    const QByteArray garbage(ADSBSbsParser::kMaxLineLength + 1, 'x');
+    QCOMPARE(parser.parse(garbage), garbage.size());
+    QVERIFY(parser.updates().isEmpty());
+}
+
+void ADSBTest::_adsbSbsReplayTest()
+{
+    constexpr int aircraftCount = 500;
+    constexpr int rounds = 40;
+
+    // Recorded style stream: a callsign now and then, with position and velocity every round
+    QByteArray stream;
+    for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < aircraftCount; i++) {
+            const uint32_t icaoAddress = 0x400000 + i;
+            const double lat = 37.0 + (i * 0.001) + (round * 0.0001);
+            const double lon = 23.0 + (i * 0.001);
+            if ((round % 10) == 0) {
+                stream += _sbsLine(ADSB::IdentificationAndCategory, icaoAddress, QByteArray("QGC") + QByteArray::number(i), 0, 0, 0, 0);
+            }
+            stream += _sbsLine(ADSB::AirbornePosition, icaoAddress, QByteArray(), lat, lon, 30000 + round, 0);
+            stream += _sbsLine(ADSB::AirborneVelocity, icaoAddress, QByteArray(), 0, 0, 0, round);
+        }
+    }
+    const qsizetype lineCount = stream.count('\n');
+
+    QTcpServer* const server = new QTcpServer(this);
+    QVERIFY(server->listen(QHostAddress::LocalHost, 0));
+
+    ADSBTCPLink* const adsbLink = new ADSBTCPLink(QHostAddress::LocalHost, server->serverPort(), this);
+
+    QHash<uint32_t, ADSB::VehicleInfo_t> latest;
+    int updateCount = 0;
+    int finalCount = 0;
+    (void) connect(adsbLink, &ADSBTCPLink::adsbVehicleUpdate, this, [&](const ADSB::VehicleInfo_t &vehicleInfo) {
+        updateCount++;
+        ADSB::VehicleInfo_t &info = latest[vehicleInfo.icaoAddress];
+        const bool wasFinal = (info.availableFlags & ADSB::HeadingAvailable) && (info.heading == (rounds - 1));
+        info = vehicleInfo;
+        if (!wasFinal && (vehicleInfo.availableFlags & ADSB::HeadingAvailable) && (vehicleInfo.heading == (rounds - 1))) {
+            finalCount++;
+        }
+    });
+
+    QVERIFY(server->waitForNewConnection(1000));
+    QTcpSocket* const clientSocket = server->nextPendingConnection();
+    QVERIFY(clientSocket != nullptr);
+
+    // Odd sized writes put the chunk boundaries in the middle of lines
+    constexpr qsizetype chunkSize = 1459;
+    for (qsizetype offset = 0; offset < stream.size(); offset += chunkSize) {
+        (void) clientSocket->write(stream.mid(offset, chunkSize));
+    }
+    (void) clientSocket->flush();
+
+    QTRY_COMPARE_WITH_TIMEOUT(finalCount, aircraftCount, 10000);
+
+    QCOMPARE(latest.count(), aircraftCount);
+    QVERIFY(updateCount < lineCount);
+
+    const ADSB::VehicleInfo_t &last = latest[0x400000 + aircraftCount - 1];
+    QCOMPARE(last.location, QGeoCoordinate(37.0 + ((aircraftCount - 1) * 0.001) + ((rounds - 1) * 0.0001), 23.0 + ((aircraftCount - 1) * 0.001)));
+    QCOMPARE(last.altitude, (30000 + rounds - 1) * 0.3048);
+
+    delete adsbLink;
+    delete server;
+}
+
+void ADSBTest::_adsbTrafficTableTest()
+{
+    ADSBTrafficTable table;
+    QRandomGenerator random(1234);
+
+    ADSB::VehicleInfo_t vehicleInfo{};
+
+    // Aircraft without a location are not added
+    int row;
+    vehicleInfo.icaoAddress = 1;
+    vehicleInfo.availableFlags = ADSB::CallsignAvailable;
+    QCOMPARE(table.update(vehicleInfo, 0, row), ADSBTrafficTable::Ignored);
+    QCOMPARE(row, -1);
+
+    // Traffic spread around Athens, plus a cluster either side of the antimeridian
+    constexpr int aircraftCount = 5000;
+    vehicleInfo.availableFlags = ADSB::LocationAvailable | ADSB::AltitudeAvailable;
+    for (int i = 0; i < aircraftCount; i++) {
+        vehicleInfo.icaoAddress = 0x100000 + i;
+        if (i < (aircraftCount - 100)) {
+            vehicleInfo.location = QGeoCoordinate(34.9 + random.bounded(6.0), 20.7 + random.bounded(6.0));
+        } else {
+            vehicleInfo.location = QGeoCoordinate(-1.0 + random.bounded(2.0), (i % 2) ? (179.0 + random.bounded(1.0)) : (-180.0 + random.bounded(1.0)));
+        }
+        vehicleInfo.altitude = i;
+        QCOMPARE(table.update(vehicleInfo, 0, row), ADSBTrafficTable::Added);
+        QCOMPARE(row, i);
+    }
+    QCOMPARE(table.count(), aircraftCount);
+
+    QCOMPARE(table.update(vehicleInfo, 10, row), ADSBTrafficTable::Unchanged);
+    QCOMPARE(table.lastUpdateMsecs(row), static_cast<qint64>(10));
+
+    const auto bruteForce = [&table](const QGeoCoordinate &center, double radiusMeters) {
+        QList<int> rows;
+        for (int i = 0; i < table.count(); i++) {
+            if (center.distanceTo(table.coordinate(i)) <= radiusMeters) {
+                rows.append(i);
+            }
+        }
+        return rows;
+    };
+
+    const auto checkQuery = [&](const QGeoCoordinate &center, double radiusMeters) {
+        QList<int> rows = table.rowsWithin(center, radiusMeters);
+        std::sort(rows.begin(), rows.end());
+        QCOMPARE(rows, bruteForce(center, radiusMeters));
+    };
+
+    const QGeoCoordinate athens(37.9, 23.7);
+    checkQuery(athens, 5000);
+    checkQuery(athens, 50000);
+    checkQuery(QGeoCoordinate(0, 180), 80000);
+    checkQuery(QGeoCoordinate(0.5, -179.9), 30000);
+    QVERIFY(!table.rowsWithin(athens, 50000).isEmpty());
+
+    // Moving an aircraft across cells keeps the index in step
+    vehicleInfo.icaoAddress = 0x100000;
+    vehicleInfo.location = athens;
+    QCOMPARE(table.update(vehicleInfo, 20, row), ADSBTrafficTable::Changed);
+    QCOMPARE(row, 0);
+    QVERIFY(table.rowsWithin(athens, 1).contains(0));
+
+    // Removing rows moves the last row into the gap
+    const uint32_t lastIcao = table.icaoAddress(table.count() - 1);
+    table.removeRow(0);
+    QCOMPARE(table.count(), aircraftCount - 1);
+    QCOMPARE(table.rowOf(0x100000), -1);
+    QCOMPARE(table.icaoAddress(0), lastIcao);
+    QCOMPARE(table.rowOf(lastIcao), 0);
+    for (int i = 0; i < 1000; i++) {
+        table.removeRow(random.bounded(table.count()));
+    }
+    checkQuery(athens, 50000);
+    checkQuery(QGeoCoordinate(0, 180), 80000);
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = table.rowsWithin(athens, 20000).count();
+    }
+    QCOMPARE(found, bruteForce(athens, 20000).count());
+
+    table.clear();
+    QCOMPARE(table.count(), 0);
+    QVERIFY(table.rowsWithin(athens, 50000).isEmpty());
+}
+
+void ADSBTest::_adsbTrafficModelTest()
+{
+    ADSBTrafficModel model;
+    QSignalSpy countSpy(&model, &ADSBTrafficModel::countChanged);
+    QSignalSpy dataChangedSpy(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy rowsInsertedSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    ADSB::VehicleInfo_t vehicleInfo{};
+    vehicleInfo.availableFlags = ADSB::LocationAvailable | ADSB::CallsignAvailable;
+    for (int i = 0; i < 10; i++) {
+        vehicleInfo.icaoAddress = 0x200000 + i;
+        vehicleInfo.callsign = QStringLiteral("QGC%1").arg(i);
+        vehicleInfo.location = QGeoCoordinate(47.0, 8.0 + (i * 0.01));
+        model.update(vehicleInfo);
+    }
+
+    // New aircraft show up right away
+    QCOMPARE(model.count(), 10);
+    QCOMPARE(model.rowCount(), 10);
+    QCOMPARE(rowsInsertedSpy.count(), 10);
+    QCOMPARE(countSpy.count(), 10);
+    QCOMPARE(model.data(model.index(3), ADSBTrafficModel::CallsignRole).toString(), QStringLiteral("QGC3"));
+    QCOMPARE(model.data(model.index(3), ADSBTrafficModel::IcaoAddressRole).toUInt(), 0x200003u);
+    QCOMPARE(model.roleNames().value(ADSBTrafficModel::CoordinateRole), QByteArray("coordinate"));
+
+    // Many updates to a few rows publish as one dataChanged per contiguous range
+    vehicleInfo.availableFlags = ADSB::LocationAvailable;
+    for (int update = 1; update <= 20; update++) {
+        for (const int i : { 1, 2, 3, 7 }) {
+            vehicleInfo.icaoAddress = 0x200000 + i;
+            vehicleInfo.location = QGeoCoordinate(47.0 + (update * 0.001), 8.0 + (i * 0.01));
+            model.update(vehicleInfo);
+        }
+    }
+    QCOMPARE(dataChangedSpy.count(), 0);
+
+    QTRY_COMPARE(dataChangedSpy.count(), 2);
+    QCOMPARE(dataChangedSpy[0][0].toModelIndex().row(), 1);
+    QCOMPARE(dataChangedSpy[0][1].toModelIndex().row(), 3);
+    QCOMPARE(dataChangedSpy[1][0].toModelIndex().row(), 7);
+    QCOMPARE(dataChangedSpy[1][1].toModelIndex().row(), 7);
+    QCOMPARE(model.data(model.index(7), ADSBTrafficModel::CoordinateRole).value<QGeoCoordinate>(), QGeoCoordinate(47.02, 8.07));
+
+    // Unchanged reports do not dirty the row
+    dataChangedSpy.clear();
+    model.update(vehicleInfo);
+    QTest::qWait(ADSBTrafficModel::kPublishIntervalMSecs * 3);
+    QCOMPARE(dataChangedSpy.count(), 0);
+
+    QList<uint32_t> nearby = model.trafficWithin(QGeoCoordinate(47.0, 8.0), 3000);
+    std::sort(nearby.begin(), nearby.end());
+    QCOMPARE(nearby, QList<uint32_t>({ 0x200000, 0x200001, 0x200002 }));
+
+    // Everything but the freshest aircraft expires
+    model._removeExpired(model._table.lastUpdateMsecs(model._table.rowOf(0x200007)) + ADSBTrafficModel::kExpirationTimeoutMSecs - 1);
+    QCOMPARE(model.count(), 1);
+    QCOMPARE(model.data(model.index(0), ADSBTrafficModel::IcaoAddressRole).toUInt(), 0x200007u);
+
+    model.clear();
+    QCOMPARE(model.count(), 0);
+    QCOMPARE(countSpy.last()[0].toInt(), 0);
+}
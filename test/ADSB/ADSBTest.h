@@ -7,7 +7,14 @@ class ADSBTest : public UnitTest
     Q_OBJECT
 
 private slots:
-    void _adsbVehicleTest();
+    void _adsbTrafficTableUpdateTest();
     void _adsbTcpLinkTest();
     void _adsbVehicleManagerTest();
+    void _adsbSbsParserTest();
+    void _adsbSbsReplayTest();
+    void _adsbTrafficTableTest();
+    void _adsbTrafficModelTest();
+
+private:
+    static QByteArray _sbsLine(int msgType, uint32_t icaoAddress, const QByteArray &callsign, double lat, double lon, int altitudeFt, double heading);
 };
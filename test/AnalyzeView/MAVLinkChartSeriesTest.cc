@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkChartSeriesTest.h"
+#include "MAVLinkChartSeries.h"
+
+#include <QtCore/QTextStream>
+#include <QtTest/QTest>
+
+void MAVLinkChartSeriesTest::_testRingBuffer()
+{
+    MAVLinkChartSeries series(4);
+    QCOMPARE(series.count(), 0);
+
+    for (int i = 0; i < 3; i++) {
+        series.append(i * 10, i);
+    }
+    QCOMPARE(series.count(), 3);
+    QCOMPARE(series.timeAt(0), 0);
+
+    // Wrapping drops the oldest samples and keeps the rest in time order
+    for (int i = 3; i < 7; i++) {
+        series.append(i * 10, i);
+    }
+    QCOMPARE(series.count(), 4);
+    for (int i = 0; i < 4; i++) {
+        QCOMPARE(series.timeAt(i), static_cast<qint64>((i + 3) * 10));
+        QCOMPARE(series.valueAt(i), static_cast<double>(i + 3));
+    }
+
+    series.clear();
+    QCOMPARE(series.count(), 0);
+    series.append(100, 1);
+    QCOMPARE(series.timeAt(0), 100);
+}
+
+void MAVLinkChartSeriesTest::_testDecimate()
+{
+    MAVLinkChartSeries series(1000);
+    for (int i = 0; i < 1000; i++) {
+        double value = (i % 2) ? 1 : -1;
+        if (i == 500) {
+            value = 100;
+        } else if (i == 700) {
+            value = -100;
+        }
+        series.append(i, value);
+    }
+
+    // Ten columns of 100 samples each collapse to their extremes
+    double minValue = 0;
+    double maxValue = 0;
+    QList<QPointF> points = series.decimate(0, 999, 10, minValue, maxValue);
+    QCOMPARE(points.count(), 20);
+    QCOMPARE(minValue, -100.0);
+    QCOMPARE(maxValue, 100.0);
+    QVERIFY(points.contains(QPointF(500, 100)));
+    QVERIFY(points.contains(QPointF(700, -100)));
+    for (qsizetype i = 1; i < points.count(); i++) {
+        QVERIFY(points[i - 1].x() < points[i].x());
+    }
+
+    // More columns than samples in the window keeps every sample
+    points = series.decimate(200, 299, 1000, minValue, maxValue);
+    QCOMPARE(points.count(), 100);
+    QCOMPARE(points.constFirst(), QPointF(200, -1));
+    QCOMPARE(points.constLast(), QPointF(299, 1));
+    QCOMPARE(minValue, -1.0);
+    QCOMPARE(maxValue, 1.0);
+
+    // A window outside the buffered time leaves the range alone
+    minValue = 5;
+    maxValue = 6;
+    QVERIFY(series.decimate(2000, 3000, 100, minValue, maxValue).isEmpty());
+    QCOMPARE(minValue, 5.0);
+    QCOMPARE(maxValue, 6.0);
+}
+
+void MAVLinkChartSeriesTest::_testWriteCsv()
+{
+    MAVLinkChartSeries series(2);
+    series.append(1, 1.5);
+    series.append(2, 2.5);
+    series.append(3, -0.25);
+
+    QString csv;
+    QTextStream stream(&csv);
+    series.writeCsv(stream, QStringLiteral("ATTITUDE: roll"));
+    stream.flush();
+
+    QCOMPARE(csv, QStringLiteral("ATTITUDE: roll,2,2.5\nATTITUDE: roll,3,-0.25\n"));
+}
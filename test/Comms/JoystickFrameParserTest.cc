@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "JoystickFrameParserTest.h"
+#include "JoystickFrameParser.h"
+
+#include <QtTest/QTest>
+
+QByteArray JoystickFrameParserTest::_frame(const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.append(static_cast<char>(JoystickFrameParser::kSync1));
+    frame.append(static_cast<char>(JoystickFrameParser::kSync2));
+    frame.append(static_cast<char>(payload.size()));
+    frame.append(payload);
+
+    quint8 checksum = static_cast<quint8>(payload.size());
+    for (const char byte : payload) {
+        checksum += static_cast<quint8>(byte);
+    }
+    frame.append(static_cast<char>(checksum));
+
+    return frame;
+}
+
+QList<QByteArray> JoystickFrameParserTest::_parse(JoystickFrameParser &parser, const QByteArray &bytes)
+{
+    QList<QByteArray> payloads;
+    for (const char byte : bytes) {
+        if (parser.parseByte(static_cast<quint8>(byte))) {
+            payloads.append(parser.payload());
+        }
+    }
+    return payloads;
+}
+
+void JoystickFrameParserTest::_testFrame()
+{
+    JoystickFrameParser parser;
+    const QByteArray payload("\x01\x02\xff\x80", 4);
+
+    QCOMPARE(_parse(parser, _frame(payload)), QList<QByteArray>{payload});
+    QCOMPARE(parser.frames(), 1ULL);
+    QCOMPARE(parser.errors(), 0ULL);
+
+    // Back to back frames, including the largest allowed payload
+    const QByteArray maxPayload(JoystickFrameParser::kMaxPayload, '\x7f');
+    QCOMPARE(_parse(parser, _frame(maxPayload) + _frame(payload)), (QList<QByteArray>{maxPayload, payload}));
+    QCOMPARE(parser.frames(), 3ULL);
+}
+
+void JoystickFrameParserTest::_testResync()
+{
+    JoystickFrameParser parser;
+    const QByteArray payload("\x10\x20", 2);
+
+    // Leading garbage, a lone first sync byte and a repeated first sync byte are all skipped
+    QByteArray bytes("\x00\x5a\x13", 3);
+    bytes.append(static_cast<char>(JoystickFrameParser::kSync1));
+    bytes.append('\x00');
+    bytes.append(static_cast<char>(JoystickFrameParser::kSync1));
+    bytes.append(_frame(payload));
+
+    QCOMPARE(_parse(parser, bytes), QList<QByteArray>{payload});
+    QCOMPARE(parser.errors(), 0ULL);
+}
+
+void JoystickFrameParserTest::_testBadChecksum()
+{
+    JoystickFrameParser parser;
+    const QByteArray payload("\x10\x20\x30", 3);
+
+    QByteArray corrupt = _frame(payload);
+    corrupt[corrupt.size() - 1] = static_cast<char>(corrupt.at(corrupt.size() - 1) + 1);
+
+    // The bad frame is dropped and the next one is still picked up
+    QCOMPARE(_parse(parser, corrupt + _frame(payload)), QList<QByteArray>{payload});
+    QCOMPARE(parser.frames(), 1ULL);
+    QCOMPARE(parser.errors(), 1ULL);
+}
+
+void JoystickFrameParserTest::_testBadLength()
+{
+    JoystickFrameParser parser;
+    const QByteArray payload("\x05", 1);
+
+    QByteArray bytes;
+    bytes.append(static_cast<char>(JoystickFrameParser::kSync1));
+    bytes.append(static_cast<char>(JoystickFrameParser::kSync2));
+    bytes.append('\x00');
+    bytes.append(static_cast<char>(JoystickFrameParser::kSync1));
+    bytes.append(static_cast<char>(JoystickFrameParser::kSync2));
+    bytes.append(static_cast<char>(JoystickFrameParser::kMaxPayload + 1));
+    bytes.append(_frame(payload));
+
+    QCOMPARE(_parse(parser, bytes), QList<QByteArray>{payload});
+    QCOMPARE(parser.errors(), 2ULL);
+}
+
+void JoystickFrameParserTest::_testPartialFrames()
+{
+    JoystickFrameParser parser;
+    const QByteArray payload("\x01\x02\x03\x04\x05\x06", 6);
+    const QByteArray frame = _frame(payload);
+
+    // A frame split across reads at every possible point completes on the last byte only
+    for (int split = 1; split < frame.size(); split++) {
+        QVERIFY(_parse(parser, frame.left(split)).isEmpty());
+        QCOMPARE(_parse(parser, frame.mid(split)), QList<QByteArray>{payload});
+    }
+
+    // reset() throws away a frame that was cut off, e.g. when a probe moves on to the next port
+    QVERIFY(_parse(parser, frame.left(frame.size() - 2)).isEmpty());
+    parser.reset();
+    QCOMPARE(_parse(parser, frame), QList<QByteArray>{payload});
+    QCOMPARE(parser.errors(), 0ULL);
+}
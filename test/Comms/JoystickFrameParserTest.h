@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class JoystickFrameParser;
+
+class JoystickFrameParserTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    JoystickFrameParserTest() = default;
+
+private slots:
+    void _testFrame();
+    void _testResync();
+    void _testBadChecksum();
+    void _testBadLength();
+    void _testPartialFrames();
+
+private:
+    static QByteArray _frame(const QByteArray &payload);
+    /// Feeds every byte and returns the payloads of the frames completed along the way
+    static QList<QByteArray> _parse(JoystickFrameParser &parser, const QByteArray &bytes);
+};
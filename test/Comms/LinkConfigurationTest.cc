@@ -0,0 +1,86 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkConfigurationTest.h"
+#include "LinkConfiguration.h"
+#include "UDPLink.h"
+
+#include <QtTest/QTest>
+
+#include <memory>
+
+void LinkConfigurationTest::_testParseMessageIdsEmpty()
+{
+    QVERIFY(LinkConfiguration::parseMessageIds(QString()).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral(",,,")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral(" ")).isEmpty());
+}
+
+void LinkConfigurationTest::_testParseMessageIdsMalformed()
+{
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("abc")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("-1")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("1.5")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("0x21")).isEmpty());
+
+    // Bad entries are skipped without losing the good ones around them
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral("0,abc,33,,24x,30")), (QSet<uint32_t>{ 0, 33, 30 }));
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral("33,33,33")), QSet<uint32_t>{ 33 });
+}
+
+void LinkConfigurationTest::_testParseMessageIdsRange()
+{
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral("0")), QSet<uint32_t>{ 0 });
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral("16777215")), QSet<uint32_t>{ 16777215 });
+
+    // Beyond the 24 bit MAVLink 2 message id, or beyond what fits in 32 bits
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("16777216")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("4294967295")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("4294967296")).isEmpty());
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("99999999999999999999")).isEmpty());
+
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral("12915,16777216,245")), (QSet<uint32_t>{ 12915, 245 }));
+}
+
+void LinkConfigurationTest::_testParseMessageIdsWhitespace()
+{
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral(" 0 , 33,\t30\n, 245 ")), (QSet<uint32_t>{ 0, 33, 30, 245 }));
+    QCOMPARE(LinkConfiguration::parseMessageIds(QStringLiteral("33, ,30")), (QSet<uint32_t>{ 33, 30 }));
+
+    // Whitespace separates nothing on its own
+    QVERIFY(LinkConfiguration::parseMessageIds(QStringLiteral("33 30")).isEmpty());
+}
+
+void LinkConfigurationTest::_testForwardsMessage()
+{
+    const std::unique_ptr<UDPConfiguration> config = std::make_unique<UDPConfiguration>(QStringLiteral("Forwarding"));
+
+    // No filter forwards everything
+    QVERIFY(config->forwardMessageIds().isEmpty());
+    QVERIFY(config->forwardsMessage(0));
+    QVERIFY(config->forwardsMessage(33));
+    QVERIFY(config->forwardsMessage(16777215));
+
+    config->setForwardMessageIds(LinkConfiguration::parseMessageIds(QStringLiteral("0, 33")));
+    QVERIFY(config->forwardsMessage(0));
+    QVERIFY(config->forwardsMessage(33));
+    QVERIFY(!config->forwardsMessage(30));
+    QVERIFY(!config->forwardsMessage(245));
+
+    // The filter survives editing a copy of the configuration
+    const std::unique_ptr<UDPConfiguration> copy = std::make_unique<UDPConfiguration>(config.get());
+    QCOMPARE(copy->forwardMessageIds(), config->forwardMessageIds());
+    QVERIFY(copy->forwardsMessage(33));
+    QVERIFY(!copy->forwardsMessage(30));
+
+    // A filter made only of bad entries falls back to forwarding everything
+    config->setForwardMessageIds(LinkConfiguration::parseMessageIds(QStringLiteral("abc")));
+    QVERIFY(config->forwardsMessage(30));
+}
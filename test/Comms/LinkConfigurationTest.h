@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LinkConfigurationTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LinkConfigurationTest() = default;
+
+private slots:
+    void _testParseMessageIdsEmpty();
+    void _testParseMessageIdsMalformed();
+    void _testParseMessageIdsRange();
+    void _testParseMessageIdsWhitespace();
+    void _testForwardsMessage();
+};
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogReplayIndexTest.h"
+#include "LogReplayIndex.h"
+#include "MAVLinkLib.h"
+#include "TLogBuilder.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
+#include <QtTest/QTest>
+
+static constexpr quint64 kStartTimeUSecs = 1700000000000000ULL;
+static constexpr quint64 kMessageIntervalUSecs = 10000;
+
+QByteArray LogReplayIndexTest::_createTLog(int messageCount, quint64 startTimeUSecs)
+{
+    TLogBuilder tlog;
+
+    for (int i = 0; i < messageCount; i++) {
+        mavlink_message_t message;
+        const mavlink_heartbeat_t heartbeat = {static_cast<uint32_t>(i), MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, MAV_STATE_ACTIVE, 3};
+        (void) mavlink_msg_heartbeat_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_3, &message, &heartbeat);
+        tlog.appendMessage(startTimeUSecs + (i * kMessageIntervalUSecs), message);
+    }
+
+    return tlog.data();
+}
+
+void LogReplayIndexTest::_testBuildAndSeek()
+{
+    constexpr int messageCount = 1000;
+    const QByteArray tlog = _createTLog(messageCount, kStartTimeUSecs);
+    const uchar *const data = reinterpret_cast<const uchar*>(tlog.constData());
+
+    LogReplayIndex index;
+    QVERIFY(index.build(data, tlog.size()));
+    QCOMPARE(index.startTimeUSecs(), kStartTimeUSecs);
+    QCOMPARE(index.endTimeUSecs(), kStartTimeUSecs + ((messageCount - 1) * kMessageIntervalUSecs));
+
+    // 10 seconds of log indexed every 250ms
+    QCOMPARE(index.entries().count(), 40);
+    QCOMPARE(index.entries().constFirst().offset, 0);
+
+    const quint64 nowUSecs = LogReplayIndex::currentTimeUSecs();
+    const quint64 targets[] = { kStartTimeUSecs, kStartTimeUSecs + 1234567, index.endTimeUSecs(), index.endTimeUSecs() + 1 };
+    for (const quint64 target : targets) {
+        const qint64 offset = index.offsetForTime(target);
+
+        quint64 timestampUSecs;
+        qint64 frameOffset;
+        qint64 frameLength;
+        QCOMPARE(LogReplayIndex::nextRecord(data, tlog.size(), offset, nowUSecs, timestampUSecs, frameOffset, frameLength), offset);
+        QVERIFY(timestampUSecs <= target);
+        QVERIFY((target - timestampUSecs) < LogReplayIndex::kIntervalUSecs);
+        QCOMPARE(frameOffset, offset + LogReplayIndex::cbTimestamp);
+    }
+
+    // Before the first record
+    QCOMPARE(index.offsetForTime(0), 0);
+}
+
+void LogReplayIndexTest::_testResyncAfterGarbage()
+{
+    const QByteArray first = _createTLog(10, kStartTimeUSecs);
+    const QByteArray second = _createTLog(10, kStartTimeUSecs + (10 * kMessageIntervalUSecs));
+
+    // A partial write followed by bytes which look like frame starts
+    QByteArray tlog = first;
+    tlog.append(second.left(15));
+    tlog.append(QByteArray(7, static_cast<char>(MAVLINK_STX)));
+    const qint64 secondOffset = tlog.size();
+    tlog.append(second);
+
+    const uchar *const data = reinterpret_cast<const uchar*>(tlog.constData());
+    const quint64 nowUSecs = LogReplayIndex::currentTimeUSecs();
+
+    quint64 timestampUSecs;
+    qint64 frameOffset;
+    qint64 frameLength;
+    QCOMPARE(LogReplayIndex::nextRecord(data, tlog.size(), first.size(), nowUSecs, timestampUSecs, frameOffset, frameLength), secondOffset);
+    QCOMPARE(timestampUSecs, kStartTimeUSecs + (10 * kMessageIntervalUSecs));
+
+    int records = 0;
+    qint64 offset = 0;
+    while (LogReplayIndex::nextRecord(data, tlog.size(), offset, nowUSecs, timestampUSecs, frameOffset, frameLength) >= 0) {
+        offset = frameOffset + frameLength;
+        records++;
+    }
+    QCOMPARE(records, 20);
+    QCOMPARE(offset, tlog.size());
+}
+
+void LogReplayIndexTest::_testCache()
+{
+    const QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString logFilename = tempDir.filePath(QStringLiteral("replay.tlog"));
+    QFile logFile(logFilename);
+    QVERIFY(logFile.open(QIODevice::WriteOnly));
+    const QByteArray tlog = _createTLog(500, kStartTimeUSecs);
+    QCOMPARE(logFile.write(tlog), tlog.size());
+    logFile.close();
+
+    LogReplayIndex index;
+    QVERIFY(index.build(reinterpret_cast<const uchar*>(tlog.constData()), tlog.size()));
+    const QString indexFilename = LogReplayIndex::indexFilename(logFilename);
+    QVERIFY(index.save(indexFilename, QFileInfo(logFilename)));
+
+    LogReplayIndex loaded;
+    QVERIFY(loaded.load(indexFilename, QFileInfo(logFilename)));
+    QCOMPARE(loaded.startTimeUSecs(), index.startTimeUSecs());
+    QCOMPARE(loaded.endTimeUSecs(), index.endTimeUSecs());
+    QCOMPARE(loaded.entries().count(), index.entries().count());
+    QCOMPARE(loaded.entries().constLast().offset, index.entries().constLast().offset);
+
+    // A log which changed since the index was written must be indexed again
+    QVERIFY(logFile.open(QIODevice::Append));
+    QVERIFY(logFile.write(_createTLog(1, kStartTimeUSecs + 5000000)) > 0);
+    logFile.close();
+    QVERIFY(!loaded.load(indexFilename, QFileInfo(logFilename)));
+}
+
+void LogReplayIndexTest::_testCacheRejectsBadOffset()
+{
+    const QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString logFilename = tempDir.filePath(QStringLiteral("replay.tlog"));
+    QFile logFile(logFilename);
+    QVERIFY(logFile.open(QIODevice::WriteOnly));
+    const QByteArray tlog = _createTLog(500, kStartTimeUSecs);
+    QCOMPARE(logFile.write(tlog), tlog.size());
+    logFile.close();
+
+    LogReplayIndex index;
+    QVERIFY(index.build(reinterpret_cast<const uchar*>(tlog.constData()), tlog.size()));
+    const QString indexFilename = LogReplayIndex::indexFilename(logFilename);
+    QVERIFY(index.save(indexFilename, QFileInfo(logFilename)));
+
+    // The last entry's offset is the final field of the index, point it past the end of the log
+    QFile indexFile(indexFilename);
+    QVERIFY(indexFile.open(QIODevice::ReadWrite));
+    uint8_t offsetBytes[sizeof(qint64)];
+    qToBigEndian(static_cast<qint64>(tlog.size() + 1000), offsetBytes);
+    QVERIFY(indexFile.seek(indexFile.size() - sizeof(offsetBytes)));
+    QCOMPARE(indexFile.write(reinterpret_cast<const char*>(offsetBytes), sizeof(offsetBytes)), static_cast<qint64>(sizeof(offsetBytes)));
+    indexFile.close();
+
+    LogReplayIndex loaded;
+    QVERIFY(!loaded.load(indexFilename, QFileInfo(logFilename)));
+    QVERIFY(loaded.entries().isEmpty());
+}
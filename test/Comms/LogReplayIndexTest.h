@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LogReplayIndexTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LogReplayIndexTest() = default;
+
+private slots:
+    void _testBuildAndSeek();
+    void _testResyncAfterGarbage();
+    void _testCache();
+    void _testCacheRejectsBadOffset();
+
+private:
+    /// tlog with one heartbeat every 10ms of log time
+    static QByteArray _createTLog(int messageCount, quint64 startTimeUSecs);
+};
@@ -0,0 +1,77 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkLogWriterTest.h"
+#include "MAVLinkLogWriter.h"
+#include "TLogBuilder.h"
+
+#include <QtCore/QTemporaryFile>
+#include <QtTest/QTest>
+
+void MAVLinkLogWriterTest::_testFramesWrittenInOrder()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    MAVLinkLogWriter writer;
+    writer.startLogging(&file);
+    QVERIFY(writer.logging());
+
+    TLogBuilder expected;
+    for (int i = 0; i < 1000; i++) {
+        const QByteArray frame(1 + (i % 200), static_cast<char>(i));
+        const quint64 timestamp = 1000000ULL + static_cast<quint64>(i);
+        QVERIFY(writer.writeFrame(timestamp, reinterpret_cast<const uint8_t*>(frame.constData()), frame.size()));
+        expected.appendFrame(timestamp, frame);
+    }
+
+    writer.stopLogging();
+    QVERIFY(!writer.logging());
+
+    const MAVLinkLogWriter::Stats stats = writer.stats();
+    QCOMPARE(stats.framesQueued, 1000ULL);
+    QCOMPARE(stats.framesDropped, 0ULL);
+    QCOMPARE(stats.bytesWritten, static_cast<quint64>(expected.data().size()));
+    QCOMPARE(stats.writeErrors, 0ULL);
+
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.readAll(), expected.data());
+}
+
+void MAVLinkLogWriterTest::_testRingWrapAround()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+
+    MAVLinkLogWriter writer;
+    writer.startLogging(&file);
+
+    // Several times the ring size in odd sized frames so records straddle the wrap point. Frames the
+    // writer could not keep up with are dropped, so only the accepted ones are expected in the file.
+    TLogBuilder expected;
+    quint64 accepted = 0;
+    for (int i = 0; i < 60000; i++) {
+        const QByteArray frame(263, static_cast<char>(i));
+        const quint64 timestamp = static_cast<quint64>(i);
+        if (writer.writeFrame(timestamp, reinterpret_cast<const uint8_t*>(frame.constData()), frame.size())) {
+            expected.appendFrame(timestamp, frame);
+            accepted++;
+        }
+    }
+
+    writer.stopLogging();
+
+    const MAVLinkLogWriter::Stats stats = writer.stats();
+    QCOMPARE(stats.framesQueued, accepted);
+    QCOMPARE(stats.framesQueued + stats.framesDropped, 60000ULL);
+    QCOMPARE(stats.bytesWritten, static_cast<quint64>(expected.data().size()));
+
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.readAll(), expected.data());
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MqttLinkTest.h"
+#include "MqttLink.h"
+
+#include <QtTest/QTest>
+
+namespace {
+
+constexpr const char *kStatusTopic = "ugv/cmd";
+constexpr const char *kLidarTopic = "ugv/cmd/LIDAR";
+
+/// Records every payload a topic handler receives
+struct HandlerCalls
+{
+    MqttTopicHandler handler()
+    {
+        return [this](const MqttPayload &payload) {
+            payloads.push_back(payload);
+        };
+    }
+
+    std::vector<MqttPayload> payloads;
+};
+
+} // namespace
+
+void MqttLinkTest::_testTopicDispatch()
+{
+    MqttLinkCallback callback;
+    HandlerCalls status;
+    HandlerCalls lidar;
+    callback.registerTopicHandler(kStatusTopic, status.handler());
+    callback.registerTopicHandler(kLidarTopic, lidar.handler());
+
+    const mqtt::const_message_ptr statusMsg = mqtt::make_message(kStatusTopic, "{\"speed\":1}");
+    const mqtt::const_message_ptr lidarMsg = mqtt::make_message(kLidarTopic, "lidar frame");
+    callback.message_arrived(statusMsg);
+    callback.message_arrived(lidarMsg);
+    callback.message_arrived(statusMsg);
+
+    QCOMPARE(status.payloads.size(), size_t(2));
+    QCOMPARE(lidar.payloads.size(), size_t(1));
+    QCOMPARE(QString::fromStdString(*status.payloads[0]), QStringLiteral("{\"speed\":1}"));
+    QCOMPARE(QString::fromStdString(*lidar.payloads[0]), QStringLiteral("lidar frame"));
+
+    // Handlers share the message payload instead of receiving a copy
+    QVERIFY(status.payloads[0] == statusMsg->get_payload_ref().ptr());
+    QVERIFY(lidar.payloads[0] == lidarMsg->get_payload_ref().ptr());
+}
+
+void MqttLinkTest::_testUnknownTopic()
+{
+    MqttLinkCallback callback;
+    HandlerCalls status;
+    HandlerCalls lidar;
+    callback.registerTopicHandler(kStatusTopic, status.handler());
+    callback.registerTopicHandler(kLidarTopic, lidar.handler());
+
+    // Topics only match exactly, a shared prefix is not enough
+    callback.message_arrived(mqtt::make_message("ugv/other", "ignored"));
+    callback.message_arrived(mqtt::make_message("ugv/cmd/LIDAR/raw", "ignored"));
+    callback.message_arrived(mqtt::make_message("ugv", "ignored"));
+    callback.message_arrived(mqtt::make_message("UGV/CMD", "ignored"));
+
+    QVERIFY(status.payloads.empty());
+    QVERIFY(lidar.payloads.empty());
+
+    // Unknown topics leave dispatch to registered topics intact
+    callback.message_arrived(mqtt::make_message(kLidarTopic, "lidar frame"));
+    QVERIFY(status.payloads.empty());
+    QCOMPARE(lidar.payloads.size(), size_t(1));
+
+    // Nothing registered at all
+    MqttLinkCallback emptyCallback;
+    emptyCallback.message_arrived(mqtt::make_message(kStatusTopic, "ignored"));
+}
+
+void MqttLinkTest::_testReplaceHandler()
+{
+    MqttLinkCallback callback;
+    HandlerCalls first;
+    HandlerCalls second;
+    callback.registerTopicHandler(kStatusTopic, first.handler());
+    callback.registerTopicHandler(kStatusTopic, second.handler());
+
+    callback.message_arrived(mqtt::make_message(kStatusTopic, "status"));
+
+    QVERIFY(first.payloads.empty());
+    QCOMPARE(second.payloads.size(), size_t(1));
+}
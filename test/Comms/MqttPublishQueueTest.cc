@@ -0,0 +1,182 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MqttPublishQueueTest.h"
+#include "MqttPublishQueue.h"
+
+#include <QtTest/QTest>
+
+namespace {
+
+constexpr const char *kCommandTopic = "ugv/cmd";
+constexpr const char *kTelemetryTopic = "ugv/cmd/Status";
+constexpr const char *kJoystickTopic = "ugv/cmd/Joystick";
+
+/// Stands in for the broker connection: publishes are recorded and acked by the test
+class TestMqttClient : public mqtt::async_client
+{
+public:
+    TestMqttClient() : mqtt::async_client("tcp://localhost:1883", "MqttPublishQueueTest") {}
+
+    using mqtt::async_client::publish;
+
+    bool is_connected() const override { return connected; }
+
+    mqtt::delivery_token_ptr publish(mqtt::const_message_ptr msg, void *userContext, mqtt::iaction_listener &cb) override
+    {
+        const mqtt::delivery_token_ptr token = mqtt::delivery_token::create(*this, msg, userContext, cb);
+        published.push_back(token);
+        return token;
+    }
+
+    bool connected = false;
+    std::vector<mqtt::delivery_token_ptr> published;
+};
+
+mqtt::binary payload(int value)
+{
+    return mqtt::binary(std::to_string(value));
+}
+
+std::vector<std::string> publishedPayloads(const TestMqttClient &client)
+{
+    std::vector<std::string> payloads;
+    for (const mqtt::delivery_token_ptr &token : client.published) {
+        payloads.push_back(token->get_message()->to_string());
+    }
+    return payloads;
+}
+
+/// Acks everything still in flight so the queue releases its token contexts
+void ackAll(MqttPublishQueue &queue, const TestMqttClient &client)
+{
+    while (queue.stats().inFlight > 0) {
+        const int acked = static_cast<int>(client.published.size()) - queue.stats().inFlight;
+        queue.on_success(*client.published[acked]);
+    }
+}
+
+} // namespace
+
+void MqttPublishQueueTest::_testQueueDepth()
+{
+    const auto client = std::make_shared<TestMqttClient>();
+    MqttPublishQueue queue(client, 4);
+
+    for (int i = 0; i < 3; i++) {
+        QVERIFY(queue.enqueue(kCommandTopic, payload(i)));
+    }
+    QCOMPARE(queue.stats().queueDepth, 3);
+    QCOMPARE(queue.stats().maxQueueDepth, 3);
+    QVERIFY(client->published.empty());
+}
+
+void MqttPublishQueueTest::_testDropQos0()
+{
+    const auto client = std::make_shared<TestMqttClient>();
+    MqttPublishQueue queue(client, 4);
+    queue.setTopicOptions(kTelemetryTopic, 0, MqttPublishQueue::Mode::Queued);
+
+    QVERIFY(queue.enqueue(kCommandTopic, payload(0)));
+    QVERIFY(queue.enqueue(kTelemetryTopic, payload(1)));
+    QVERIFY(queue.enqueue(kTelemetryTopic, payload(2)));
+    QVERIFY(queue.enqueue(kCommandTopic, payload(3)));
+
+    // A full queue drops new telemetry rather than anything already queued
+    QVERIFY(!queue.enqueue(kTelemetryTopic, payload(4)));
+    QCOMPARE(queue.stats().dropped, 1ULL);
+    QCOMPARE(queue.stats().queueDepth, 4);
+
+    // A command makes room by dropping the newest telemetry
+    QVERIFY(queue.enqueue(kCommandTopic, payload(5)));
+    QCOMPARE(queue.stats().dropped, 2ULL);
+    QCOMPARE(queue.stats().queueDepth, 4);
+
+    client->connected = true;
+    queue.drain();
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"0", "1", "3", "5"}));
+    ackAll(queue, *client);
+}
+
+void MqttPublishQueueTest::_testRejectQos1()
+{
+    const auto client = std::make_shared<TestMqttClient>();
+    MqttPublishQueue queue(client, 2);
+
+    QVERIFY(queue.enqueue(kCommandTopic, payload(0)));
+    QVERIFY(queue.enqueue(kCommandTopic, payload(1)));
+
+    // Commands already queued are never given up for a newer one
+    QVERIFY(!queue.enqueue(kCommandTopic, payload(2)));
+    QCOMPARE(queue.stats().rejected, 1ULL);
+    QCOMPARE(queue.stats().dropped, 0ULL);
+
+    client->connected = true;
+    queue.drain();
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"0", "1"}));
+    ackAll(queue, *client);
+}
+
+void MqttPublishQueueTest::_testCoalesced()
+{
+    const auto client = std::make_shared<TestMqttClient>();
+    MqttPublishQueue queue(client, 4);
+    queue.setTopicOptions(kJoystickTopic, 0, MqttPublishQueue::Mode::Coalesced);
+
+    QVERIFY(queue.enqueue(kJoystickTopic, payload(0)));
+    QVERIFY(queue.enqueue(kCommandTopic, payload(1)));
+    QVERIFY(queue.enqueue(kJoystickTopic, payload(2)));
+    QCOMPARE(queue.stats().coalesced, 1ULL);
+    QCOMPARE(queue.stats().queueDepth, 2);
+
+    client->connected = true;
+    queue.drain();
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"2", "1"}));
+    ackAll(queue, *client);
+
+    // Once published, the next stick input is queued again instead of replacing it
+    client->connected = false;
+    QVERIFY(queue.enqueue(kJoystickTopic, payload(3)));
+    QCOMPARE(queue.stats().coalesced, 1ULL);
+    QCOMPARE(queue.stats().queueDepth, 1);
+}
+
+void MqttPublishQueueTest::_testDrain()
+{
+    const auto client = std::make_shared<TestMqttClient>();
+    MqttPublishQueue queue(client, 8, 2);
+
+    for (int i = 0; i < 5; i++) {
+        QVERIFY(queue.enqueue(kCommandTopic, payload(i)));
+    }
+
+    // Nothing goes out while disconnected, reconnecting drains up to the in-flight limit
+    QVERIFY(client->published.empty());
+    client->connected = true;
+    queue.drain();
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"0", "1"}));
+    QCOMPARE(queue.stats().inFlight, 2);
+    QCOMPARE(queue.stats().queueDepth, 3);
+
+    // Every ack lets the next message out, in order
+    queue.on_success(*client->published[0]);
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"0", "1", "2"}));
+    queue.on_failure(*client->published[1]);
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"0", "1", "2", "3"}));
+    queue.on_success(*client->published[2]);
+    queue.on_success(*client->published[3]);
+    QCOMPARE(publishedPayloads(*client), (std::vector<std::string>{"0", "1", "2", "3", "4"}));
+    queue.on_success(*client->published[4]);
+
+    const MqttPublishQueue::Stats stats = queue.stats();
+    QCOMPARE(stats.published, 4ULL);
+    QCOMPARE(stats.failed, 1ULL);
+    QCOMPARE(stats.inFlight, 0);
+    QCOMPARE(stats.queueDepth, 0);
+}
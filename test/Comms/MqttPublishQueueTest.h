@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MqttPublishQueueTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MqttPublishQueueTest() = default;
+
+private slots:
+    void _testQueueDepth();
+    void _testDropQos0();
+    void _testRejectQos1();
+    void _testCoalesced();
+    void _testDrain();
+};
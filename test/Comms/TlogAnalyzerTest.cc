@@ -0,0 +1,165 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TlogAnalyzerTest.h"
+#include "TlogAnalyzer.h"
+#include "MAVLinkLib.h"
+#include "TLogBuilder.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <algorithm>
+
+static constexpr quint64 kStartTimeUSecs = 1700000000000000ULL;
+static constexpr quint64 kAttitudeIntervalUSecs = 20000;
+static constexpr int kAttitudePerSecond = 50;
+
+QByteArray TlogAnalyzerTest::_createTLog(int seconds)
+{
+    TLogBuilder tlog;
+
+    for (int i = 0; i < (seconds * kAttitudePerSecond); i++) {
+        const quint64 timeUSecs = kStartTimeUSecs + (i * kAttitudeIntervalUSecs);
+        mavlink_message_t message;
+
+        if ((i % kAttitudePerSecond) == 0) {
+            const mavlink_heartbeat_t heartbeat = {0, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, MAV_STATE_ACTIVE, 3};
+            (void) mavlink_msg_heartbeat_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_3, &message, &heartbeat);
+            tlog.appendMessage(timeUSecs, message);
+        }
+
+        // yawspeed stays zero so MAVLink 2 truncates it from the payload
+        const mavlink_attitude_t attitude = {static_cast<uint32_t>(i * 20), i * 0.01f, -1.0f, 2.0f, 0.5f, 0.25f, 0.0f};
+        (void) mavlink_msg_attitude_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_3, &message, &attitude);
+
+        // The sequence number was used, so skipping the record looks like link loss
+        if ((i % 100) != 99) {
+            tlog.appendMessage(timeUSecs, message);
+        }
+    }
+
+    return tlog.data();
+}
+
+void TlogAnalyzerTest::_testStatistics()
+{
+    constexpr int seconds = 10;
+    const QByteArray tlog = _createTLog(seconds);
+
+    TlogAnalyzer analyzer({ QStringLiteral("ATTITUDE.roll"), QStringLiteral("ATTITUDE.yawspeed"), QStringLiteral("ATTITUDE.bogus"), QStringLiteral("NOT_A_MESSAGE.x") });
+    QVERIFY(analyzer.analyze(reinterpret_cast<const uchar*>(tlog.constData()), tlog.size()));
+
+    constexpr int dropped = 5;
+    constexpr int attitudeCount = (seconds * kAttitudePerSecond) - dropped;
+    QCOMPARE(analyzer.recordCount(), static_cast<quint64>(attitudeCount + seconds));
+    QCOMPARE(analyzer.startTimeUSecs(), kStartTimeUSecs);
+
+    QCOMPARE(analyzer.messageStats().count(), 2);
+    const TlogAnalyzer::MessageStats &heartbeat = analyzer.messageStats()[0];
+    QCOMPARE(heartbeat.msgId, static_cast<quint32>(MAVLINK_MSG_ID_HEARTBEAT));
+    QCOMPARE(heartbeat.name, QStringLiteral("HEARTBEAT"));
+    QCOMPARE(heartbeat.count, static_cast<quint64>(seconds));
+    QCOMPARE(heartbeat.rateHistogram[1], static_cast<quint32>(seconds));
+
+    // Seconds with a dropped message fall just under the 50Hz bin
+    const TlogAnalyzer::MessageStats &attitude = analyzer.messageStats()[1];
+    QCOMPARE(attitude.msgId, static_cast<quint32>(MAVLINK_MSG_ID_ATTITUDE));
+    QCOMPARE(attitude.count, static_cast<quint64>(attitudeCount));
+    QCOMPARE(attitude.maxRateHz, static_cast<quint32>(kAttitudePerSecond));
+    QCOMPARE(attitude.rateHistogram.count(), static_cast<qsizetype>(TlogAnalyzer::kRateBinCount));
+    QCOMPARE(attitude.rateHistogram[5], static_cast<quint32>(dropped));
+    QCOMPARE(attitude.rateHistogram[6], static_cast<quint32>(seconds - dropped));
+    QCOMPARE(attitude.meanRateHz, static_cast<double>(attitudeCount) / seconds);
+
+    QCOMPARE(analyzer.linkStats().count(), 1);
+    QCOMPARE(analyzer.linkStats()[0].sysId, static_cast<quint8>(1));
+    QCOMPARE(analyzer.linkStats()[0].compId, static_cast<quint8>(MAV_COMP_ID_AUTOPILOT1));
+    QCOMPARE(analyzer.linkStats()[0].received, analyzer.recordCount());
+    QCOMPARE(analyzer.linkStats()[0].lost, static_cast<quint64>(dropped));
+
+    // Unknown messages and fields are skipped
+    QCOMPARE(analyzer.fieldSeries().count(), 2);
+    const TlogAnalyzer::FieldSeries &roll = analyzer.fieldSeries()[0];
+    QCOMPARE(roll.name, QStringLiteral("ATTITUDE.roll"));
+    QCOMPARE(roll.timeSecs.count(), static_cast<qsizetype>(attitudeCount));
+    QCOMPARE(roll.values.count(), static_cast<qsizetype>(attitudeCount));
+    QCOMPARE(roll.timeSecs[1], kAttitudeIntervalUSecs / 1e6);
+    QCOMPARE(roll.values[1], static_cast<double>(0.01f));
+
+    const TlogAnalyzer::FieldSeries &yawspeed = analyzer.fieldSeries()[1];
+    QCOMPARE(yawspeed.values.count(), static_cast<qsizetype>(attitudeCount));
+    QVERIFY(std::all_of(yawspeed.values.cbegin(), yawspeed.values.cend(), [](double value) { return value == 0; }));
+}
+
+void TlogAnalyzerTest::_testChunkBoundaries()
+{
+    const QByteArray tlog = _createTLog(20);
+    const uchar *const data = reinterpret_cast<const uchar*>(tlog.constData());
+    const QStringList fields = { QStringLiteral("ATTITUDE.time_boot_ms") };
+
+    TlogAnalyzer whole(fields);
+    QVERIFY(whole.analyze(data, tlog.size()));
+
+    // Small chunks put nearly every chunk boundary in the middle of a frame
+    TlogAnalyzer chunked(fields);
+    chunked._minChunkBytes = 100;
+    QVERIFY(chunked.analyze(data, tlog.size()));
+
+    QCOMPARE(chunked.recordCount(), whole.recordCount());
+    QCOMPARE(chunked.endTimeUSecs(), whole.endTimeUSecs());
+    QCOMPARE(chunked.messageStats().count(), whole.messageStats().count());
+    for (qsizetype i = 0; i < whole.messageStats().count(); i++) {
+        QCOMPARE(chunked.messageStats()[i].count, whole.messageStats()[i].count);
+        QCOMPARE(chunked.messageStats()[i].rateHistogram, whole.messageStats()[i].rateHistogram);
+    }
+    QCOMPARE(chunked.linkStats()[0].received, whole.linkStats()[0].received);
+    QCOMPARE(chunked.linkStats()[0].lost, whole.linkStats()[0].lost);
+    QCOMPARE(chunked.fieldSeries()[0].values, whole.fieldSeries()[0].values);
+
+    // Series stay in log order across chunks
+    const QList<double> &bootTimes = chunked.fieldSeries()[0].values;
+    QVERIFY(std::is_sorted(bootTimes.cbegin(), bootTimes.cend()));
+}
+
+void TlogAnalyzerTest::_testJsonOutput()
+{
+    const QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString logFilename = tempDir.filePath(QStringLiteral("flight.tlog"));
+    QFile logFile(logFilename);
+    QVERIFY(logFile.open(QIODevice::WriteOnly));
+    const QByteArray tlog = _createTLog(3);
+    QCOMPARE(logFile.write(tlog), tlog.size());
+    logFile.close();
+
+    QCOMPARE(TlogAnalyzer::runCommandLine(logFilename, QStringLiteral("ATTITUDE.roll,ATTITUDE.pitch"), QString()), 0);
+
+    QFile jsonFile(tempDir.filePath(QStringLiteral("flight.json")));
+    QVERIFY(jsonFile.open(QIODevice::ReadOnly));
+    const QJsonObject root = QJsonDocument::fromJson(jsonFile.readAll()).object();
+
+    QCOMPARE(root[QStringLiteral("messages")].toArray().count(), 2);
+    QCOMPARE(root[QStringLiteral("links")].toArray().count(), 1);
+
+    const QJsonObject pitch = root[QStringLiteral("series")].toObject()[QStringLiteral("ATTITUDE.pitch")].toObject();
+    const QJsonArray times = pitch[QStringLiteral("time")].toArray();
+    const QJsonArray values = pitch[QStringLiteral("value")].toArray();
+    QCOMPARE(times.count(), static_cast<qsizetype>((3 * kAttitudePerSecond) - 1));
+    QCOMPARE(values.count(), times.count());
+    QCOMPARE(values[0].toDouble(), -1.0);
+
+    // Missing logs are an error, not an empty report
+    QCOMPARE(TlogAnalyzer::runCommandLine(tempDir.filePath(QStringLiteral("missing.tlog")), QString(), QString()), 1);
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class TlogAnalyzerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    TlogAnalyzerTest() = default;
+
+private slots:
+    void _testStatistics();
+    void _testChunkBoundaries();
+    void _testJsonOutput();
+
+private:
+    /// tlog with ATTITUDE at 50Hz and HEARTBEAT at 1Hz, every hundredth ATTITUDE is dropped
+    static QByteArray _createTLog(int seconds);
+};
@@ -0,0 +1,129 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "FactGroupTest.h"
+#include "FactGroup.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+
+class TestFactGroup : public FactGroup
+{
+public:
+    TestFactGroup(int updateRateMsecs)
+        : FactGroup     (updateRateMsecs)
+        , doubleFact    (0, QStringLiteral("doubleValue"),  FactMetaData::valueTypeDouble)
+        , uint8Fact     (0, QStringLiteral("uint8Value"),   FactMetaData::valueTypeUint8)
+    {
+        _addFact(&doubleFact,   doubleFact.name());
+        _addFact(&uint8Fact,    uint8Fact.name());
+    }
+
+    Fact doubleFact;
+    Fact uint8Fact;
+};
+
+}
+
+void FactGroupTest::_testCoalescedSignals()
+{
+    TestFactGroup factGroup(10);
+    QSignalSpy rawValueSpy(&factGroup.doubleFact, &Fact::rawValueChanged);
+    QSignalSpy valueSpy(&factGroup.doubleFact, &Fact::valueChanged);
+    QSignalSpy uint8ValueSpy(&factGroup.uint8Fact, &Fact::valueChanged);
+
+    const quint64 signalCount = FactGroup::valueChangedSignalCount();
+    const quint64 flushCount = FactGroup::flushCount();
+
+    for (int i = 1; i <= 100; i++) {
+        factGroup.doubleFact.setTelemetryValue(i * 0.5);
+        factGroup.uint8Fact.setTelemetryValue(i);
+    }
+
+    // Raw values stay current for C++ users while the ui signal waits for the frame clock
+    QCOMPARE(rawValueSpy.count(), 100);
+    QCOMPARE(valueSpy.count(), 0);
+    QCOMPARE(factGroup.doubleFact.rawValue().toDouble(), 50.0);
+
+    QTRY_COMPARE(valueSpy.count(), 1);
+    QCOMPARE(uint8ValueSpy.count(), 1);
+    QCOMPARE(valueSpy.takeFirst().at(0).toDouble(), 50.0);
+    QVERIFY(!factGroup.doubleFact.deferredValueChangeSignal());
+
+    QVERIFY(FactGroup::valueChangedSignalCount() >= signalCount + 2);
+    QVERIFY(FactGroup::flushCount() >= flushCount + 1);
+
+    // Nothing dirty, nothing sent
+    QTest::qWait(50);
+    QCOMPARE(uint8ValueSpy.count(), 1);
+}
+
+void FactGroupTest::_testUpdateRate()
+{
+    TestFactGroup factGroup(500);
+    QSignalSpy valueSpy(&factGroup.doubleFact, &Fact::valueChanged);
+
+    // The first change after an idle period goes out on the next frame
+    factGroup.doubleFact.setTelemetryValue(1.0);
+    QTRY_COMPARE_WITH_TIMEOUT(valueSpy.count(), 1, 200);
+
+    // Further changes are held back until the update rate allows another flush
+    factGroup.doubleFact.setTelemetryValue(2.0);
+    factGroup.doubleFact.setTelemetryValue(3.0);
+    QTest::qWait(100);
+    QCOMPARE(valueSpy.count(), 1);
+    QTRY_COMPARE_WITH_TIMEOUT(valueSpy.count(), 2, 2000);
+    QCOMPARE(valueSpy.last().at(0).toDouble(), 3.0);
+}
+
+void FactGroupTest::_testLiveUpdates()
+{
+    TestFactGroup factGroup(1000);
+    QSignalSpy valueSpy(&factGroup.doubleFact, &Fact::valueChanged);
+
+    factGroup.doubleFact.setTelemetryValue(1.0);
+    QTRY_COMPARE(valueSpy.count(), 1);
+
+    // Switching to live sends whatever is still pending
+    factGroup.doubleFact.setTelemetryValue(2.0);
+    QCOMPARE(valueSpy.count(), 1);
+    factGroup.setLiveUpdates(true);
+    QCOMPARE(valueSpy.count(), 2);
+
+    factGroup.doubleFact.setTelemetryValue(3.0);
+    QCOMPARE(valueSpy.count(), 3);
+
+    factGroup.setLiveUpdates(false);
+    factGroup.doubleFact.setTelemetryValue(4.0);
+    QCOMPARE(valueSpy.count(), 3);
+}
+
+void FactGroupTest::_testTelemetryValueTypes()
+{
+    Fact uint8Fact(0, QStringLiteral("uint8Value"), FactMetaData::valueTypeUint8);
+    uint8Fact.setTelemetryValue(static_cast<quint8>(7));
+    QCOMPARE(uint8Fact.rawValue().typeId(), static_cast<int>(QMetaType::UInt));
+    QCOMPARE(uint8Fact.rawValue().toUInt(), 7u);
+
+    Fact floatFact(0, QStringLiteral("floatValue"), FactMetaData::valueTypeFloat);
+    floatFact.setTelemetryValue(1.5);
+    QCOMPARE(floatFact.rawValue().typeId(), static_cast<int>(QMetaType::Float));
+
+    // Facts outside a group still signal immediately, and only on change
+    QSignalSpy valueSpy(&floatFact, &Fact::valueChanged);
+    floatFact.setTelemetryValue(2.5f);
+    floatFact.setTelemetryValue(2.5f);
+    QCOMPARE(valueSpy.count(), 1);
+
+    Fact stringFact(0, QStringLiteral("stringValue"), FactMetaData::valueTypeString);
+    stringFact.setTelemetryValue(42);
+    QCOMPARE(stringFact.rawValue().toString(), QStringLiteral("42"));
+}
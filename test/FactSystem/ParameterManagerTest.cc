@@ -13,7 +13,9 @@
 #include "Vehicle.h"
 #include "QGCApplication.h"
 #include "ParameterManager.h"
+#include "ParameterIndexWaitList.h"
 
+#include <QtCore/QFile>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
@@ -184,6 +186,103 @@ void ParameterManagerTest::_FTPnoFailure()
     QCOMPARE(arguments.at(0).toFloat(), 0.0f);
 }
 
+/// Loads the parameters from MockLink, then reconnects with MockLink reporting the PARAM_HASH of that load so the
+/// second load comes out of the parameter cache.
+void ParameterManagerTest::_cacheLoad(void)
+{
+    MultiVehicleManager* vehicleMgr = qgcApp()->toolbox()->multiVehicleManager();
+    QVERIFY(vehicleMgr);
+
+    _mockLink = MockLink::startPX4MockLink(false);
+    QSignalSpy spyParamsReady(vehicleMgr, &MultiVehicleManager::parameterReadyVehicleAvailableChanged);
+    QVERIFY(spyParamsReady.wait(60000));
+
+    Vehicle* vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    const int vehicleId = vehicle->id();
+    const QStringList paramNames = vehicle->parameterManager()->parameterNames(MAV_COMP_ID_AUTOPILOT1);
+    QVERIFY(!paramNames.isEmpty());
+
+    // The cache is written once all the reads complete
+    const QString cacheFile = ParameterManager::parameterCacheFile(vehicleId, MAV_COMP_ID_AUTOPILOT1);
+    quint32 paramHash = 0;
+    QList<ParameterManager::ParamCacheEntry> entries;
+    QVERIFY(ParameterManager::_readLocalParamCache(cacheFile, paramHash, &entries));
+    QCOMPARE(entries.count(), paramNames.count());
+    QCOMPARE(entries.first().name, paramNames.first());
+
+    _disconnectMockLink();
+
+    // Each MockLink gets the next vehicle id, so give the next one the same cache
+    const QString nextCacheFile = ParameterManager::parameterCacheFile(vehicleId + 1, MAV_COMP_ID_AUTOPILOT1);
+    (void) QFile::remove(nextCacheFile);
+    QVERIFY(QFile::copy(cacheFile, nextCacheFile));
+
+    spyParamsReady.clear();
+    _mockLink = MockLink::startPX4MockLink(false);
+    _mockLink->setParamHashCheck(paramHash);
+    QVERIFY(spyParamsReady.wait(60000));
+
+    vehicle = vehicleMgr->activeVehicle();
+    QVERIFY(vehicle);
+    QCOMPARE(vehicle->id(), vehicleId + 1);
+    QCOMPARE(vehicle->parameterManager()->missingParameters(), false);
+    QCOMPARE(vehicle->parameterManager()->parameterNames(MAV_COMP_ID_AUTOPILOT1), paramNames);
+    for (const ParameterManager::ParamCacheEntry& entry: entries) {
+        QCOMPARE(vehicle->parameterManager()->getParameter(MAV_COMP_ID_AUTOPILOT1, entry.name)->rawValue(), entry.rawValue);
+    }
+
+    // The cache hit is acknowledged so the vehicle stops streaming the list
+    QVERIFY(_mockLink->paramHashCheckAccepted());
+
+    _disconnectMockLink();
+    (void) QFile::remove(cacheFile);
+    (void) QFile::remove(nextCacheFile);
+}
+
+void ParameterManagerTest::_indexWaitList(void)
+{
+    ParameterIndexWaitList waitList;
+    QCOMPARE(waitList.count(), 0);
+    QCOMPARE(waitList.nextWaiting(0), -1);
+
+    // Spans more than one bitmap word with a partial last word
+    constexpr int paramCount = 150;
+    waitList.reset(paramCount);
+    QCOMPARE(waitList.count(), paramCount);
+    QVERIFY(waitList.contains(0));
+    QVERIFY(waitList.contains(paramCount - 1));
+    QVERIFY(!waitList.contains(paramCount));
+    QVERIFY(!waitList.contains(-1));
+
+    for (int paramIndex = 0; paramIndex < paramCount; paramIndex++) {
+        if ((paramIndex != 3) && (paramIndex != 64) && (paramIndex != 149)) {
+            QVERIFY(waitList.remove(paramIndex));
+        }
+    }
+    QVERIFY(!waitList.remove(0));
+    QCOMPARE(waitList.count(), 3);
+    QCOMPARE(waitList.waitingIndices(), QList<int>({ 3, 64, 149 }));
+    QCOMPARE(waitList.nextWaiting(4), 64);
+    QCOMPARE(waitList.nextWaiting(65), 149);
+    QCOMPARE(waitList.nextWaiting(150), -1);
+
+    QCOMPARE(waitList.retryCount(64), 0);
+    QCOMPARE(waitList.bumpRetryCount(64), 1);
+    QCOMPARE(waitList.bumpRetryCount(64), 2);
+    QCOMPARE(waitList.retryCount(64), 2);
+
+    // A new request list starts everything over
+    waitList.reset(paramCount);
+    QCOMPARE(waitList.count(), paramCount);
+    QCOMPARE(waitList.retryCount(64), 0);
+
+    waitList.clear();
+    QCOMPARE(waitList.count(), 0);
+    QVERIFY(!waitList.contains(3));
+    QCOMPARE(waitList.nextWaiting(0), -1);
+}
+
 #if 0
 void ParameterManagerTest::_FTPChangeParam()
 {
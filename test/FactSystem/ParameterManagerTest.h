@@ -24,6 +24,8 @@ private slots:
     void _requestListMissingParamSuccess(void);
     void _requestListMissingParamFail(void);
     void _FTPnoFailure(void);
+    void _cacheLoad(void);
+    void _indexWaitList(void);
     // void _FTPChangeParam(void);
 
 
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkFramingTest.h"
+#include "MAVLinkFraming.h"
+#include "TLogBuilder.h"
+
+#include <QtTest/QTest>
+
+/// Builds a stream laid out like a .tlog file: each frame is preceded by a big endian 64 bit timestamp
+QByteArray MAVLinkFramingTest::_createTLogStream(int messagePairs)
+{
+    TLogBuilder stream;
+    quint64 timestamp = 1700000000000000ULL;
+
+    for (int i = 0; i < messagePairs; i++) {
+        mavlink_message_t message;
+
+        const mavlink_heartbeat_t heartbeat = {0, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, MAV_STATE_ACTIVE, 3};
+        (void) mavlink_msg_heartbeat_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_3, &message, &heartbeat);
+        stream.appendMessage(timestamp++, message);
+
+        const mavlink_attitude_t attitude = {static_cast<uint32_t>(i), 0.1f, 0.2f, 0.3f, 0.01f, 0.02f, 0.03f};
+        (void) mavlink_msg_attitude_encode_chan(1, MAV_COMP_ID_AUTOPILOT1, MAVLINK_COMM_3, &message, &attitude);
+        stream.appendMessage(timestamp++, message);
+    }
+
+    return stream.data();
+}
+
+void MAVLinkFramingTest::_testFindNextStx()
+{
+    QByteArray data(64, '\0');
+    const uint8_t *const bytes = reinterpret_cast<const uint8_t*>(data.constData());
+
+    QCOMPARE(MAVLinkFraming::findNextStx(bytes, data.size()), data.size());
+
+    data[37] = static_cast<char>(MAVLINK_STX_MAVLINK1);
+    QCOMPARE(MAVLinkFraming::findNextStx(bytes, data.size()), 37);
+
+    data[21] = static_cast<char>(MAVLINK_STX);
+    QCOMPARE(MAVLinkFraming::findNextStx(bytes, data.size()), 21);
+
+    // Tail shorter than one vector
+    QCOMPARE(MAVLinkFraming::findNextStx(bytes + 38, 5), 5);
+    data[60] = static_cast<char>(MAVLINK_STX);
+    QCOMPARE(MAVLinkFraming::findNextStx(bytes + 38, data.size() - 38), 22);
+}
+
+void MAVLinkFramingTest::_testParseNextMatchesParseChar()
+{
+    const QByteArray stream = _createTLogStream(100);
+    const uint8_t *const data = reinterpret_cast<const uint8_t*>(stream.constData());
+
+    mavlink_message_t message;
+    mavlink_status_t status;
+
+    QList<QPair<uint32_t, uint8_t>> expected;
+    mavlink_reset_channel_status(MAVLINK_COMM_2);
+    for (qsizetype i = 0; i < stream.size(); i++) {
+        if (mavlink_parse_char(MAVLINK_COMM_2, data[i], &message, &status)) {
+            expected.append(qMakePair(message.msgid, message.seq));
+        }
+    }
+
+    QList<QPair<uint32_t, uint8_t>> actual;
+    mavlink_reset_channel_status(MAVLINK_COMM_2);
+    qsizetype position = 0;
+    while (MAVLinkFraming::parseNext(MAVLINK_COMM_2, data, stream.size(), position, message, status)) {
+        actual.append(qMakePair(message.msgid, message.seq));
+    }
+    QCOMPARE(position, stream.size());
+
+    QCOMPARE(actual.count(), 200);
+    QCOMPARE(actual, expected);
+}
+
+void MAVLinkFramingTest::_testFrameLength()
+{
+    QByteArray stream = _createTLogStream(1);
+    const uint8_t *const data = reinterpret_cast<const uint8_t*>(stream.constData());
+
+    // Heartbeat frame after the first timestamp, attitude frame after the second
+    const qsizetype heartbeatLength = MAVLinkFraming::frameLength(data + sizeof(quint64), stream.size() - sizeof(quint64));
+    QVERIFY(heartbeatLength > 0);
+    const qsizetype attitudeOffset = sizeof(quint64) + heartbeatLength + sizeof(quint64);
+    QCOMPARE(attitudeOffset + MAVLinkFraming::frameLength(data + attitudeOffset, stream.size() - attitudeOffset), stream.size());
+
+    // Not a start of frame, truncated frame
+    QCOMPARE(MAVLinkFraming::frameLength(data, stream.size()), 0);
+    QCOMPARE(MAVLinkFraming::frameLength(data + sizeof(quint64), heartbeatLength - 1), 0);
+
+    // Payload corruption fails the CRC
+    stream[sizeof(quint64) + 12] = static_cast<char>(stream[sizeof(quint64) + 12] ^ 0x55);
+    QCOMPARE(MAVLinkFraming::frameLength(reinterpret_cast<const uint8_t*>(stream.constData()) + sizeof(quint64), stream.size() - sizeof(quint64)), 0);
+}
+
+void MAVLinkFramingTest::_benchmarkParseChar()
+{
+    const QByteArray stream = _createTLogStream(5000);
+    const uint8_t *const data = reinterpret_cast<const uint8_t*>(stream.constData());
+    mavlink_message_t message;
+    mavlink_status_t status;
+    int messageCount = 0;
+
+    QBENCHMARK {
+        mavlink_reset_channel_status(MAVLINK_COMM_2);
+        messageCount = 0;
+        for (qsizetype i = 0; i < stream.size(); i++) {
+            if (mavlink_parse_char(MAVLINK_COMM_2, data[i], &message, &status)) {
+                messageCount++;
+            }
+        }
+    }
+    QCOMPARE(messageCount, 10000);
+}
+
+void MAVLinkFramingTest::_benchmarkParseNext()
+{
+    const QByteArray stream = _createTLogStream(5000);
+    const uint8_t *const data = reinterpret_cast<const uint8_t*>(stream.constData());
+    mavlink_message_t message;
+    mavlink_status_t status;
+    int messageCount = 0;
+
+    QBENCHMARK {
+        mavlink_reset_channel_status(MAVLINK_COMM_2);
+        messageCount = 0;
+        qsizetype position = 0;
+        while (MAVLinkFraming::parseNext(MAVLINK_COMM_2, data, stream.size(), position, message, status)) {
+            messageCount++;
+        }
+    }
+    QCOMPARE(messageCount, 10000);
+}
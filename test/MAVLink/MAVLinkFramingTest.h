@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MAVLinkFramingTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    MAVLinkFramingTest() = default;
+
+private slots:
+    void _testFindNextStx();
+    void _testParseNextMatchesParseChar();
+    void _testFrameLength();
+    void _benchmarkParseChar();
+    void _benchmarkParseNext();
+
+private:
+    static QByteArray _createTLogStream(int messagePairs);
+};
@@ -13,11 +13,14 @@
 #include "PlanMasterController.h"
 #include "SimpleMissionItem.h"
 #include "MissionSettingsItem.h"
+#include "CameraSection.h"
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
 #include "MultiSignalSpy.h"
+#include "FlightPathSegment.h"
 
+#include <QtCore/QTemporaryDir>
 #include <QtTest/QTest>
 
 MissionControllerTest::MissionControllerTest(void)
@@ -232,6 +235,112 @@ void MissionControllerTest::_testVehicleYawRecalc(void)
     }
 }
 
+/// Compares the current flight status values against the values from a full recalc
+void MissionControllerTest::_compareToFullFlightStatusRecalc(void)
+{
+    auto sameValue = [](double value, double expected) {
+        return (qIsNaN(value) && qIsNaN(expected)) || qAbs(value - expected) <= 1e-6 * qMax(1.0, qAbs(expected));
+    };
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+
+    const double missionDistance        = _missionController->missionDistance();
+    const double missionTime            = _missionController->missionTime();
+    const double missionMaxTelemetry    = _missionController->missionMaxTelemetry();
+    const double minAMSLAltitude        = _missionController->minAMSLAltitude();
+    QList<double> distanceFromStart;
+    QList<double> distance;
+    QList<double> vehicleYaw;
+    QList<double> altPercent;
+    for (int i=0; i<visualItems->count(); i++) {
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+        distanceFromStart.append(item->distanceFromStart());
+        distance.append(item->distance());
+        vehicleYaw.append(item->missionVehicleYaw());
+        altPercent.append(item->altPercent());
+    }
+
+    _missionController->_recalcMissionFlightStatus();
+
+    QVERIFY(sameValue(missionDistance,      _missionController->missionDistance()));
+    QVERIFY(sameValue(missionTime,          _missionController->missionTime()));
+    QVERIFY(sameValue(missionMaxTelemetry,  _missionController->missionMaxTelemetry()));
+    QVERIFY(sameValue(minAMSLAltitude,      _missionController->minAMSLAltitude()));
+    for (int i=0; i<visualItems->count(); i++) {
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+        QVERIFY2(sameValue(distanceFromStart[i],   item->distanceFromStart()), qPrintable(QString::number(i)));
+        QVERIFY2(sameValue(distance[i],            item->distance()), qPrintable(QString::number(i)));
+        QVERIFY2(sameValue(vehicleYaw[i],          item->missionVehicleYaw()), qPrintable(QString::number(i)));
+        QVERIFY2(sameValue(altPercent[i],          item->altPercent()), qPrintable(QString::number(i)));
+    }
+}
+
+void MissionControllerTest::_testLargePlanIncrementalRecalc(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    // Build and save a large plan, then load it back so the edits run against a freshly loaded mission
+    const int cWaypoints = 2000;
+    QGeoCoordinate currentCoord(47.0, 8.0);
+    for (int i=1; i<=cWaypoints; i++) {
+        currentCoord = currentCoord.atDistanceAndAzimuth(50, (i % 2) ? 90 : 0);
+        _missionController->insertSimpleMissionItem(currentCoord, i);
+    }
+    QTest::qWait(100); // Recalcs in MissionController are queued to remove dups. Allow return to main message loop.
+
+    const QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString planFile = tempDir.filePath(QStringLiteral("LargePlan.plan"));
+    _masterController->saveToFile(planFile);
+
+    _masterController->loadFromFile(planFile);
+    QTest::qWait(100);
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QCOMPARE(visualItems->count(), cWaypoints + 1);
+    const double originalDistance = _missionController->missionDistance();
+    QVERIFY(originalDistance > 0);
+
+    // Single item coordinate edits spread over the mission must only queue a recalc from the edited item
+    const int cEdits = 50;
+    for (int i=0; i<cEdits; i++) {
+        const int index = 1 + ((i * 397) % cWaypoints);
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(index);
+        item->setCoordinate(item->coordinate().atDistanceAndAzimuth(10, 45));
+        QCOMPARE(_missionController->_flightStatusDirtyFirst, index);
+        QCOMPARE(_missionController->_flightStatusDirtyLast, index);
+        QCoreApplication::processEvents();
+    }
+    QTest::qWait(100);
+    QVERIFY(_missionController->missionDistance() != originalDistance);
+
+    // Incremental results must match a full recalc
+    VisualMissionItem* movedItem = visualItems->value<VisualMissionItem*>(cWaypoints / 2);
+    movedItem->setCoordinate(movedItem->coordinate().atDistanceAndAzimuth(100, 180));
+    QTest::qWait(100);
+    _compareToFullFlightStatusRecalc();
+
+    // Speed changes carry forward until the next speed change, so the walk must run past the edited item
+    SimpleMissionItem* speedItem = visualItems->value<SimpleMissionItem*>(cWaypoints / 4);
+    QVERIFY(speedItem);
+    speedItem->speedSection()->setSpecifyFlightSpeed(true);
+    speedItem->speedSection()->flightSpeed()->setRawValue(3.0);
+    QTest::qWait(100);
+    _compareToFullFlightStatusRecalc();
+
+    // Additional commands in an item shift the sequence numbers of the following items
+    SimpleMissionItem* gimbalItem = visualItems->value<SimpleMissionItem*>(cWaypoints / 3);
+    QVERIFY(gimbalItem);
+    const int lastSequenceNumber = visualItems->value<VisualMissionItem*>(cWaypoints)->sequenceNumber();
+    gimbalItem->cameraSection()->setSpecifyGimbal(true);
+    QTest::qWait(100);
+    QVERIFY(visualItems->value<VisualMissionItem*>(cWaypoints)->sequenceNumber() > lastSequenceNumber);
+    for (int i=1; i<visualItems->count(); i++) {
+        QCOMPARE(visualItems->value<VisualMissionItem*>(i)->sequenceNumber(), visualItems->value<VisualMissionItem*>(i - 1)->lastSequenceNumber() + 1);
+    }
+    _compareToFullFlightStatusRecalc();
+}
+
 void MissionControllerTest::_testLoadJsonSectionAvailable(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
@@ -256,6 +365,105 @@ void MissionControllerTest::_testLoadJsonSectionAvailable(void)
     }
 }
 
+void MissionControllerTest::_testLoadDefersItemSections(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _masterController->loadFromFile(":/unittest/SectionTest.plan");
+
+    // Items: settings, takeoff, waypoint, waypoint + gimbal command, waypoint
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QCOMPARE(visualItems->count(), 5);
+
+    // Only the waypoint which picked up the gimbal command needed its sections during load
+    for (int i=1; i<visualItems->count(); i++) {
+        SimpleMissionItem* item = visualItems->value<SimpleMissionItem*>(i);
+        QVERIFY(item);
+        QCOMPARE(item->findChild<CameraSection*>(QString(), Qt::FindDirectChildrenOnly) != nullptr, i == 3);
+    }
+
+    SimpleMissionItem* gimbalItem = visualItems->value<SimpleMissionItem*>(3);
+    QVERIFY(gimbalItem->cameraSection()->specifyGimbal());
+    QVERIFY(!qIsNaN(gimbalItem->specifiedGimbalPitch()));
+    QCOMPARE(gimbalItem->lastSequenceNumber(), gimbalItem->sequenceNumber() + 1);
+
+    // Asking for the sections creates them without dirtying the item
+    SimpleMissionItem* waypointItem = visualItems->value<SimpleMissionItem*>(2);
+    QVERIFY(waypointItem->cameraSection());
+    QVERIFY(waypointItem->findChild<CameraSection*>(QString(), Qt::FindDirectChildrenOnly));
+    QCOMPARE(waypointItem->cameraSection()->available(), true);
+    QCOMPARE(waypointItem->dirty(), false);
+    QCOMPARE(_masterController->dirty(), false);
+
+    // Saving and loading again must give back the same mission items
+    QList<int> rgSequenceNumbers;
+    for (int i=0; i<visualItems->count(); i++) {
+        rgSequenceNumbers.append(visualItems->value<VisualMissionItem*>(i)->sequenceNumber());
+    }
+    const QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString planFile = tempDir.filePath(QStringLiteral("SectionTest.plan"));
+    _masterController->saveToFile(planFile);
+    _masterController->loadFromFile(planFile);
+
+    visualItems = _missionController->visualItems();
+    QCOMPARE(visualItems->count(), rgSequenceNumbers.count());
+    for (int i=0; i<visualItems->count(); i++) {
+        QCOMPARE(visualItems->value<VisualMissionItem*>(i)->sequenceNumber(), rgSequenceNumbers[i]);
+    }
+    QVERIFY(visualItems->value<SimpleMissionItem*>(3)->cameraSection()->specifyGimbal());
+}
+
+void MissionControllerTest::_testFlightPathLines(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    const int cWaypoints = 20;
+    QGeoCoordinate currentCoord(47.0, 8.0);
+    for (int i=1; i<=cWaypoints; i++) {
+        currentCoord = currentCoord.atDistanceAndAzimuth(50, (i % 2) ? 90 : 0);
+        _missionController->insertSimpleMissionItem(currentCoord, i);
+    }
+    QTest::qWait(100);
+
+    // Every drawable segment is either part of a line or listed as a terrain collision
+    QmlObjectListModel* segments = _missionController->simpleFlightPathSegments();
+    QVERIFY(segments->count() >= cWaypoints - 1);
+    QVariantList lines = _missionController->flightPathLines();
+    int lineSegmentCount = 0;
+    for (const QVariant& line: lines) {
+        QVERIFY(line.toList().count() > 1);
+        lineSegmentCount += line.toList().count() - 1;
+    }
+    QCOMPARE(lineSegmentCount + _missionController->terrainCollisionSegments()->count(), segments->count());
+
+    // A straight run of waypoints with no collisions is a single line
+    if (_missionController->terrainCollisionSegments()->count() == 0) {
+        QCOMPARE(lines.count(), 1);
+    }
+
+    // Moving an item updates the line geometry
+    VisualMissionItem* movedItem = _missionController->visualItems()->value<VisualMissionItem*>(cWaypoints / 2);
+    QVERIFY(movedItem);
+    const QGeoCoordinate movedCoord = movedItem->coordinate().atDistanceAndAzimuth(100, 180);
+    movedItem->setCoordinate(movedCoord);
+    QTest::qWait(100);
+    bool foundMovedCoord = false;
+    for (const QVariant& line: _missionController->flightPathLines()) {
+        for (const QVariant& coord: line.toList()) {
+            if (coord.value<QGeoCoordinate>() == movedCoord) {
+                foundMovedCoord = true;
+            }
+        }
+    }
+    for (int i=0; i<_missionController->terrainCollisionSegments()->count(); i++) {
+        FlightPathSegment* segment = _missionController->terrainCollisionSegments()->value<FlightPathSegment*>(i);
+        if (segment->coordinate1() == movedCoord || segment->coordinate2() == movedCoord) {
+            foundMovedCoord = true;
+        }
+    }
+    QVERIFY(foundMovedCoord);
+}
+
 void MissionControllerTest::_testGlobalAltMode(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
@@ -34,6 +34,9 @@ private slots:
     void _testGlobalAltMode             (void);
     void _testGimbalRecalc              (void);
     void _testVehicleYawRecalc          (void);
+    void _testLargePlanIncrementalRecalc(void);
+    void _testLoadDefersItemSections    (void);
+    void _testFlightPathLines           (void);
 
 private:
 #if 0
@@ -49,6 +52,7 @@ private:
     void _testOfflineToOnlineWorker(MAV_AUTOPILOT firmwareType);
 #endif
     void _setupVisualItemSignals(VisualMissionItem* visualItem);
+    void _compareToFullFlightStatusRecalc(void);
 
     // MissiomItems signals
 
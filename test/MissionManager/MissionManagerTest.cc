@@ -11,9 +11,13 @@
 #include "MissionManagerTest.h"
 #include "MissionManager.h"
 #include "MultiSignalSpy.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
 
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
+#include <QtCore/QScopeGuard>
 
 const MissionManagerTest::TestCase_t MissionManagerTest::_rgTestCases[] = {
     { "0\t0\t3\t16\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 0, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_WAYPOINT,     10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
@@ -363,3 +367,83 @@ void MissionManagerTest::_testErrorAckFailureStrings(void)
     }
 
 }
+
+void MissionManagerTest::_roundTripItemsWindowed(int cItems, int& maxRequestsInFlight)
+{
+    // Editor has a home position item on the front, PX4 does not store it so param1 tags each item with the
+    // sequence number it will have on the vehicle
+    QList<MissionItem*> missionItems;
+    for (int i=0; i<=cItems; i++) {
+        missionItems.append(new MissionItem(i, MAV_CMD_NAV_WAYPOINT, MAV_FRAME_GLOBAL_RELATIVE_ALT, i - 1, 0, 0, 0, 47.0 + (i * 0.001), 8.0, 50, true, false, this));
+    }
+
+    QSignalSpy sendCompleteSpy(_missionManager, &MissionManager::sendComplete);
+    _missionManager->writeMissionItems(missionItems);
+    QVERIFY(sendCompleteSpy.count() || sendCompleteSpy.wait(_missionManagerSignalWaitTime));
+    QCOMPARE(sendCompleteSpy.first().first().toBool(), false);
+
+    // Requests still unanswered each time an item comes in
+    maxRequestsInFlight = 0;
+    PlanManager* planManager = _missionManager;
+    QMetaObject::Connection progressConnection = connect(_missionManager, &MissionManager::progressPctChanged, this, [planManager, &maxRequestsInFlight]() {
+        maxRequestsInFlight = qMax(maxRequestsInFlight, static_cast<int>(planManager->_missionRequestMSecs.count()));
+    });
+
+    QSignalSpy newMissionItemsSpy(_missionManager, &MissionManager::newMissionItemsAvailable);
+    _missionManager->loadFromVehicle();
+    const bool itemsAvailable = newMissionItemsSpy.count() || newMissionItemsSpy.wait(_missionManagerSignalWaitTime);
+    disconnect(progressConnection);
+    QVERIFY(itemsAvailable);
+
+    const QList<MissionItem*>& readItems = _missionManager->missionItems();
+    QCOMPARE(readItems.count(), cItems);
+    for (int i=0; i<cItems; i++) {
+        QCOMPARE(readItems[i]->sequenceNumber(), i);
+        QCOMPARE(static_cast<int>(readItems[i]->param1()), i);
+    }
+
+    _multiSpyMissionManager->clearAllSignals();
+}
+
+void MissionManagerTest::_testPipelinedTransferPX4(void)
+{
+    const int cItems = 60;
+    const int cWindow = 16;
+
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    Fact* transferWindow = qgcApp()->toolbox()->settingsManager()->appSettings()->missionTransferWindow();
+    const auto restoreDefaults = qScopeGuard([this, transferWindow]() {
+        _mockLink->setLinkConditions(0, 0);
+        _mockLink->setMissionItemWriteWindow(1);
+        transferWindow->setRawValue(1);
+    });
+
+    _mockLink->setLinkConditions(30 /* latencyMSecs */, 0 /* lossPercent */);
+
+    // One request at a time, each item asked for once
+    int maxRequestsInFlight = 0;
+    transferWindow->setRawValue(1);
+    _mockLink->setMissionItemWriteWindow(1);
+    _roundTripItemsWindowed(cItems, maxRequestsInFlight);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QCOMPARE(maxRequestsInFlight, 0);
+    QCOMPARE(_mockLink->missionItemReadRequestCount(), cItems);
+
+    // Windowed requests overlap, and a reply to one request does not cause the others to be sent again
+    transferWindow->setRawValue(cWindow);
+    _mockLink->setMissionItemWriteWindow(cWindow);
+    _roundTripItemsWindowed(cItems, maxRequestsInFlight);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QVERIFY(maxRequestsInFlight > 0);
+    QVERIFY(maxRequestsInFlight < cWindow);
+    QCOMPARE(_mockLink->missionItemReadRequestCount(), cItems);
+
+    // Lost requests must be picked up by the retries without losing or reordering items
+    _mockLink->setLinkConditions(30 /* latencyMSecs */, 10 /* lossPercent */);
+    _roundTripItemsWindowed(cItems, maxRequestsInFlight);
+}
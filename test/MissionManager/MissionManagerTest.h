@@ -26,6 +26,7 @@ private slots:
     void _testReadFailureHandlingPX4(void);
     //void _testReadFailureHandlingAPM(void);
     //void _testErrorAckFailureStrings(void);
+    void _testPipelinedTransferPX4(void);
 
 private:
     void _testWriteFailureHandlingPX4(void);
@@ -37,6 +38,7 @@ private:
     void _writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
     void _testWriteFailureHandlingWorker(void);
     void _testReadFailureHandlingWorker(void);
+    void _roundTripItemsWindowed(int cItems, int& maxRequestsInFlight);
     
     static const TestCase_t _rgTestCases[];
     static const size_t     _cTestCases;
@@ -12,6 +12,10 @@
 #include "PlanViewSettings.h"
 #include "MultiSignalSpy.h"
 
+#include <QtCore/QtMath>
+#include <QtGui/QPolygonF>
+#include <QtTest/QSignalSpy>
+
 SurveyComplexItemTest::SurveyComplexItemTest(void)
 {
     _rgSurveySignals[surveyVisualTransectPointsChangedIndex] =    SIGNAL(visualTransectPointsChanged());
@@ -355,3 +359,172 @@ void SurveyComplexItemTest::_testHoverCaptureItemGeneration(void)
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, true /* useConditionGate */, expectedCommands);
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, false /* useConditionGate */, expectedCommands);
 }
+
+void SurveyComplexItemTest::_testBackgroundRebuild(void)
+{
+    const auto firstTransectAzimuth = [this]() {
+        const QVariantList gridPoints = _surveyItem->visualTransectPoints();
+        const double azimuth = gridPoints[0].value<QGeoCoordinate>().azimuthTo(gridPoints[1].value<QGeoCoordinate>());
+        return qRound(_clampGridAngle180(azimuth));
+    };
+
+    QSignalSpy visualSpy(_surveyItem, &SurveyComplexItem::visualTransectPointsChanged);
+
+    // Selecting the item for editing alone still rebuilds synchronously
+    _mapPolygon->setInteractive(true);
+    _surveyItem->gridAngle()->setRawValue(15);
+    QVERIFY(!_surveyItem->_transectsJobPending);
+    QCOMPARE(visualSpy.count(), 1);
+    QCOMPARE(firstTransectAzimuth(), 15);
+    visualSpy.clear();
+
+    // While a vertex is being dragged a burst of changes only applies the result of the last one
+    _mapPolygon->setVertexDrag(true);
+    for (int gridAngle=1; gridAngle<=20; gridAngle++) {
+        _surveyItem->gridAngle()->setRawValue(gridAngle);
+    }
+    QCOMPARE(visualSpy.count(), 0);
+    QTRY_COMPARE(visualSpy.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(visualSpy.count(), 1);
+    QCOMPARE(firstTransectAzimuth(), 20);
+
+    // The background result must match a synchronous rebuild
+    const QVariantList backgroundPoints = _surveyItem->visualTransectPoints();
+    _mapPolygon->setVertexDrag(false);
+    _surveyItem->_rebuildTransects();
+    QCOMPARE(_surveyItem->visualTransectPoints(), backgroundPoints);
+    visualSpy.clear();
+
+    // Ending the drag doesn't wait for the pending rebuild, it is applied once the job finishes
+    _mapPolygon->setCenterDrag(true);
+    _surveyItem->gridAngle()->setRawValue(45);
+    _mapPolygon->setCenterDrag(false);
+    QCOMPARE(visualSpy.count(), 0);
+    QTRY_COMPARE(visualSpy.count(), 1);
+    QCOMPARE(firstTransectAzimuth(), 45);
+    visualSpy.clear();
+
+    // A synchronous rebuild throws away whatever is still pending
+    _mapPolygon->setVertexDrag(true);
+    _surveyItem->gridAngle()->setRawValue(10);
+    _surveyItem->_rebuildTransectsPhase1();
+    QTest::qWait(100);
+    QVERIFY(!_surveyItem->_transectsJobPending);
+    _mapPolygon->setVertexDrag(false);
+    _surveyItem->_rebuildTransects();
+    visualSpy.clear();
+
+    // Getters report the last applied transects without waiting for the pending rebuild or signalling
+    _mapPolygon->setVertexDrag(true);
+    const int lastSequenceNumber = _surveyItem->lastSequenceNumber();
+    _surveyItem->gridAngle()->setRawValue(30);
+    QCOMPARE(_surveyItem->lastSequenceNumber(), lastSequenceNumber);
+    (void) _surveyItem->additionalTimeDelay();
+    QVERIFY(_surveyItem->_transectsJobPending);
+    QCOMPARE(visualSpy.count(), 0);
+    QCOMPARE(firstTransectAzimuth(), 10);
+    QTRY_COMPARE(visualSpy.count(), 1);
+    QCOMPARE(firstTransectAzimuth(), 30);
+
+    // Building the mission items for upload picks up the pending rebuild
+    _surveyItem->gridAngle()->setRawValue(60);
+    QList<MissionItem*> items;
+    _surveyItem->appendMissionItems(items, this);
+    QVERIFY(!_surveyItem->_transectsJobPending);
+    QCOMPARE(firstTransectAzimuth(), 60);
+    QCOMPARE(items.count() - 1, _surveyItem->lastSequenceNumber() - _surveyItem->sequenceNumber());
+    _mapPolygon->setVertexDrag(false);
+    _mapPolygon->setInteractive(false);
+}
+
+void SurveyComplexItemTest::_testTransectGenerationBenchmark(void)
+{
+    // Intersection as it was done before, comparing every pair of intersections along each line
+    const auto pairwiseIntersect = [](const QList<QLineF>& lineList, const QPolygonF& polygon) {
+        QList<QLineF> resultLines;
+        for (const QLineF& line : lineList) {
+            QList<QPointF> intersections;
+            for (int j=0; j<polygon.count()-1; j++) {
+                QPointF intersectPoint;
+                if ((line.intersects(QLineF(polygon[j], polygon[j+1]), &intersectPoint) == QLineF::BoundedIntersection) && !intersections.contains(intersectPoint)) {
+                    intersections.append(intersectPoint);
+                }
+            }
+            if (intersections.count() > 1) {
+                QLineF longest;
+                for (int i=0; i<intersections.count(); i++) {
+                    for (int j=0; j<intersections.count(); j++) {
+                        const QLineF lineTest(intersections[i], intersections[j]);
+                        if (lineTest.length() > longest.length()) {
+                            longest = lineTest;
+                        }
+                    }
+                }
+                resultLines.append(longest);
+            }
+        }
+        return resultLines;
+    };
+
+    // Roughly 300 hectares, traced finely enough to be concave all the way around
+    const QGeoCoordinate center(47.633550640000003, -122.08982199);
+    const int tracedVertexCount = 360;
+    QList<QGeoCoordinate> tracedField;
+    QPolygonF tracedFieldNed;
+    for (int i=0; i<tracedVertexCount; i++) {
+        const double azimuth = (360.0 * i) / tracedVertexCount;
+        const double radius = 1000.0 * (1.0 + (0.15 * qSin(qDegreesToRadians(azimuth * 5))));
+        tracedField.append(center.atDistanceAndAzimuth(radius, azimuth));
+        tracedFieldNed << QPointF(radius * qSin(qDegreesToRadians(azimuth)), -radius * qCos(qDegreesToRadians(azimuth)));
+    }
+    tracedFieldNed << tracedFieldNed.first();
+
+    QList<QLineF> lineList;
+    for (double x=-1300; x<=1300; x+=2.5) {
+        lineList.append(QLineF(x, -1500, x + 400, 1500));
+    }
+
+    QList<QLineF> intersectLines;
+    SurveyComplexItem::_intersectLinesWithPolygon(lineList, tracedFieldNed, intersectLines);
+    const QList<QLineF> expectedLines = pairwiseIntersect(lineList, tracedFieldNed);
+    QCOMPARE(intersectLines.count(), expectedLines.count());
+    for (int i=0; i<intersectLines.count(); i++) {
+        QVERIFY(intersectLines[i] == expectedLines[i]);
+    }
+
+    const QList<QGeoCoordinate> squareField = {
+        center,
+        center.atDistanceAndAzimuth(1730, 90),
+        center.atDistanceAndAzimuth(1730, 90).atDistanceAndAzimuth(1730, 180),
+        center.atDistanceAndAzimuth(1730, 180),
+    };
+
+    SurveyComplexItem::TransectParams_t params;
+    params.gridAngle                = 30;
+    params.entryPoint               = SurveyComplexItem::EntryLocationFirst;
+    params.refly90Degrees           = true;
+    params.flyAlternateTransects    = false;
+    params.hoverAndCapture          = false;
+    params.triggerDistance          = 20;
+    params.turnAroundDistance       = 30;
+
+    // Halving the spacing must roughly double the transect count, on both the convex and the traced field
+    for (const QList<QGeoCoordinate>& field : { squareField, tracedField }) {
+        params.polygon = field;
+        params.gridSpacing = 20;
+        const int coarseCount = SurveyComplexItem::_buildTransects(params).count();
+        params.gridSpacing = 10;
+        const int fineCount = SurveyComplexItem::_buildTransects(params).count();
+        QVERIFY(coarseCount > 0);
+        QVERIFY(fineCount > (coarseCount * 3) / 2);
+    }
+
+    params.polygon = tracedField;
+    params.gridSpacing = 2;
+    int transectCount = 0;
+    QBENCHMARK {
+        transectCount = SurveyComplexItem::_buildTransects(params).count();
+    }
+    QVERIFY(transectCount > 0);
+}
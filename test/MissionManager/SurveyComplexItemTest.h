@@ -37,6 +37,8 @@ private slots:
     void _testItemGeneration(void);
     void _testItemCount(void);
     void _testHoverCaptureItemGeneration(void);
+    void _testBackgroundRebuild(void);
+    void _testTransectGenerationBenchmark(void);
 #else
     // Handy mechanism to to a single test
 private slots:
@@ -47,6 +49,8 @@ private:
     void _testEntryLocation(void);
     void _testItemGeneration(void);
     void _testHoverCaptureItemGeneration(void);
+    void _testBackgroundRebuild(void);
+    void _testTransectGenerationBenchmark(void);
 #endif
 
 private:
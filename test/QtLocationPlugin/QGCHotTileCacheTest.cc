@@ -0,0 +1,193 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCHotTileCacheTest.h"
+#include "QGCHotTileCache.h"
+#include "QGCCacheTile.h"
+
+#include <QtTest/QTest>
+
+#include <memory>
+
+QStringList QGCHotTileCacheTest::_sameShardHashes(QGCHotTileCache &cache, int count)
+{
+    // Fixed width hashes so every tile costs the same
+    QStringList hashes;
+    const QGCHotTileCache::Shard *const shard = &cache._shard(QStringLiteral("tile%1").arg(0, 6, 10, QLatin1Char('0')));
+    for (int i = 0; hashes.count() < count; i++) {
+        const QString hash = QStringLiteral("tile%1").arg(i, 6, 10, QLatin1Char('0'));
+        if (&cache._shard(hash) == shard) {
+            hashes.append(hash);
+        }
+    }
+    return hashes;
+}
+
+QGCCacheTile QGCHotTileCacheTest::_tile(const QString &hash, qsizetype imgSize)
+{
+    return QGCCacheTile(hash, QByteArray(imgSize, 'x'), QStringLiteral("png"), QStringLiteral("Test"));
+}
+
+qint64 QGCHotTileCacheTest::_budgetForTiles(const QString &hash, int tileCount)
+{
+    const qint64 cost = kImgSize + (hash.size() * static_cast<qint64>(sizeof(QChar))) + QGCHotTileCache::kEntryOverhead;
+    return cost * tileCount * QGCHotTileCache::kShardCount;
+}
+
+bool QGCHotTileCacheTest::_contains(QGCHotTileCache &cache, const QString &hash)
+{
+    const std::unique_ptr<QGCCacheTile> tile(cache.find(hash));
+    return (tile != nullptr);
+}
+
+void QGCHotTileCacheTest::_testInsertEvictOrder()
+{
+    QGCHotTileCache cache;
+    const QStringList hashes = _sameShardHashes(cache, 5);
+    cache.setMaxBytes(_budgetForTiles(hashes[0], 3));
+
+    for (int i = 0; i < 3; i++) {
+        cache.insert(_tile(hashes[i]));
+    }
+    QCOMPARE(cache.stats().tiles, qint64(3));
+    QCOMPARE(cache.stats().evictions, 0ULL);
+
+    // Tiles leave in insertion order once the shard is full
+    cache.insert(_tile(hashes[3]));
+    QCOMPARE(cache.stats().evictions, 1ULL);
+    cache.insert(_tile(hashes[4]));
+    QCOMPARE(cache.stats().evictions, 2ULL);
+    QCOMPARE(cache.stats().tiles, qint64(3));
+
+    // Checked newest first, so the lookups themselves don't change which tile is oldest
+    QVERIFY(_contains(cache, hashes[4]));
+    QVERIFY(_contains(cache, hashes[3]));
+    QVERIFY(_contains(cache, hashes[2]));
+    QVERIFY(!_contains(cache, hashes[1]));
+    QVERIFY(!_contains(cache, hashes[0]));
+
+    // The tile comes back intact
+    const std::unique_ptr<QGCCacheTile> tile(cache.find(hashes[2]));
+    QVERIFY(tile);
+    QCOMPARE(tile->hash(), hashes[2]);
+    QCOMPARE(tile->img(), QByteArray(kImgSize, 'x'));
+    QCOMPARE(tile->format(), QStringLiteral("png"));
+    QCOMPARE(tile->type(), QStringLiteral("Test"));
+}
+
+void QGCHotTileCacheTest::_testHitPromotion()
+{
+    QGCHotTileCache cache;
+    const QStringList hashes = _sameShardHashes(cache, 5);
+    cache.setMaxBytes(_budgetForTiles(hashes[0], 3));
+
+    for (int i = 0; i < 3; i++) {
+        cache.insert(_tile(hashes[i]));
+    }
+
+    // A hit on the oldest tile moves it to the front, so the next oldest goes instead
+    QVERIFY(_contains(cache, hashes[0]));
+    cache.insert(_tile(hashes[3]));
+    QVERIFY(!_contains(cache, hashes[1]));
+
+    // A miss promotes nothing: hashes[2] is now the oldest and goes next
+    QVERIFY(!_contains(cache, hashes[4]));
+    cache.insert(_tile(hashes[4]));
+    QVERIFY(!_contains(cache, hashes[2]));
+    QVERIFY(_contains(cache, hashes[0]));
+    QVERIFY(_contains(cache, hashes[3]));
+    QVERIFY(_contains(cache, hashes[4]));
+
+    const QGCHotTileCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, 4ULL);
+    QCOMPARE(stats.misses, 3ULL);
+}
+
+void QGCHotTileCacheTest::_testByteBudget()
+{
+    QGCHotTileCache cache;
+    const QStringList hashes = _sameShardHashes(cache, 8);
+    const qint64 maxBytes = _budgetForTiles(hashes[0], 4);
+    cache.setMaxBytes(maxBytes);
+
+    // The shard budget is never exceeded however many tiles go in
+    for (const QString &hash : hashes) {
+        cache.insert(_tile(hash));
+        QVERIFY(cache.stats().bytes <= (maxBytes / QGCHotTileCache::kShardCount));
+    }
+    QCOMPARE(cache.stats().tiles, qint64(4));
+    QCOMPARE(cache.stats().bytes, maxBytes / QGCHotTileCache::kShardCount);
+
+    // A tile larger than a whole shard is not cached and evicts nothing
+    const quint64 evictions = cache.stats().evictions;
+    cache.insert(_tile(QStringLiteral("huge"), maxBytes / QGCHotTileCache::kShardCount));
+    QVERIFY(!_contains(cache, QStringLiteral("huge")));
+    QCOMPARE(cache.stats().evictions, evictions);
+    QCOMPARE(cache.stats().tiles, qint64(4));
+
+    // Empty tiles are not cached
+    cache.insert(_tile(QStringLiteral("empty"), 0));
+    QVERIFY(!_contains(cache, QStringLiteral("empty")));
+
+    // Shrinking the budget evicts the oldest tiles right away
+    cache.setMaxBytes(_budgetForTiles(hashes[0], 2));
+    QCOMPARE(cache.stats().tiles, qint64(2));
+    QVERIFY(_contains(cache, hashes[7]));
+    QVERIFY(_contains(cache, hashes[6]));
+    QVERIFY(!_contains(cache, hashes[5]));
+
+    cache.clear();
+    QCOMPARE(cache.stats().tiles, qint64(0));
+    QCOMPARE(cache.stats().bytes, qint64(0));
+}
+
+void QGCHotTileCacheTest::_testReplace()
+{
+    QGCHotTileCache cache;
+    const QStringList hashes = _sameShardHashes(cache, 3);
+    cache.setMaxBytes(_budgetForTiles(hashes[0], 3));
+
+    cache.insert(_tile(hashes[0]));
+    cache.insert(_tile(hashes[1]));
+    const qint64 bytes = cache.stats().bytes;
+
+    // Inserting a cached hash again replaces the tile without counting it twice and makes it the newest
+    cache.insert(QGCCacheTile(hashes[0], QByteArray(kImgSize, 'y'), QStringLiteral("jpg"), QStringLiteral("Test")));
+    QCOMPARE(cache.stats().tiles, qint64(2));
+    QCOMPARE(cache.stats().bytes, bytes);
+
+    const std::unique_ptr<QGCCacheTile> tile(cache.find(hashes[0]));
+    QVERIFY(tile);
+    QCOMPARE(tile->img(), QByteArray(kImgSize, 'y'));
+    QCOMPARE(tile->format(), QStringLiteral("jpg"));
+
+    cache.setMaxBytes(_budgetForTiles(hashes[0], 1));
+    QVERIFY(_contains(cache, hashes[0]));
+    QVERIFY(!_contains(cache, hashes[1]));
+}
+
+void QGCHotTileCacheTest::_testDisabled()
+{
+    QGCHotTileCache cache;
+    const QString hash = QStringLiteral("tile000000");
+
+    // The default budget of 0 caches nothing
+    cache.insert(_tile(hash));
+    QVERIFY(!_contains(cache, hash));
+    QCOMPARE(cache.stats().tiles, qint64(0));
+
+    cache.setMaxBytes(_budgetForTiles(hash, 2));
+    cache.insert(_tile(hash));
+    QVERIFY(_contains(cache, hash));
+
+    // Turning it off drops everything
+    cache.setMaxBytes(0);
+    QCOMPARE(cache.stats().tiles, qint64(0));
+    QVERIFY(!_contains(cache, hash));
+}
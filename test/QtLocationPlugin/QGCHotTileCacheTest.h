@@ -0,0 +1,40 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCHotTileCache;
+class QGCCacheTile;
+
+class QGCHotTileCacheTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCHotTileCacheTest() = default;
+
+private slots:
+    void _testInsertEvictOrder();
+    void _testHitPromotion();
+    void _testByteBudget();
+    void _testReplace();
+    void _testDisabled();
+
+private:
+    /// Tile hashes which all land in the same shard, so they share one LRU list and budget
+    static QStringList _sameShardHashes(QGCHotTileCache &cache, int count);
+    static QGCCacheTile _tile(const QString &hash, qsizetype imgSize = kImgSize);
+    /// Budget which holds exactly tileCount tiles of kImgSize in every shard
+    static qint64 _budgetForTiles(const QString &hash, int tileCount);
+    static bool _contains(QGCHotTileCache &cache, const QString &hash);
+
+    static constexpr qsizetype kImgSize = 1000;
+};
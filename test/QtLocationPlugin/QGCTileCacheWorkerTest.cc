@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCTileCacheWorker.h"
+#include "QGCMapTasks.h"
+#include "QGCCacheTile.h"
+
+#include <QtTest/QTest>
+
+#include <memory>
+
+void QGCTileCacheWorkerTest::_queueTask(QGCCacheWorker &worker, QGCMapTask *task)
+{
+    QMutexLocker lock(&worker._taskQueueMutex);
+    worker._taskQueues[QGCCacheWorker::_taskPriority(task)].enqueue(task);
+}
+
+QGCMapTask *QGCTileCacheWorkerTest::_saveTask(const QString &hash, quint64 tileSet)
+{
+    return new QGCSaveTileTask(new QGCCacheTile(hash, QByteArray(16, 'x'), QStringLiteral("png"), QStringLiteral("Test"), tileSet));
+}
+
+void QGCTileCacheWorkerTest::_testTaskPriority()
+{
+    const std::unique_ptr<QGCMapTask> fetchTile(new QGCFetchTileTask(QStringLiteral("visible")));
+    const std::unique_ptr<QGCMapTask> fetchSets(new QGCFetchTileSetTask());
+    const std::unique_ptr<QGCMapTask> browseSave(_saveTask(QStringLiteral("browse"), UINT64_MAX));
+    const std::unique_ptr<QGCMapTask> prefetchSave(_saveTask(QStringLiteral("prefetch"), 1));
+    const std::unique_ptr<QGCMapTask> rename(new QGCRenameTileSetTask(1, QStringLiteral("Renamed")));
+    const std::unique_ptr<QGCMapTask> deleteSet(new QGCDeleteTileSetTask(1));
+
+    QCOMPARE(QGCCacheWorker::_taskPriority(fetchTile.get()), QGCCacheWorker::PriorityHigh);
+    QCOMPARE(QGCCacheWorker::_taskPriority(fetchSets.get()), QGCCacheWorker::PriorityHigh);
+    QCOMPARE(QGCCacheWorker::_taskPriority(browseSave.get()), QGCCacheWorker::PriorityNormal);
+    QCOMPARE(QGCCacheWorker::_taskPriority(rename.get()), QGCCacheWorker::PriorityNormal);
+    QCOMPARE(QGCCacheWorker::_taskPriority(prefetchSave.get()), QGCCacheWorker::PriorityLow);
+    QCOMPARE(QGCCacheWorker::_taskPriority(deleteSet.get()), QGCCacheWorker::PriorityLow);
+}
+
+void QGCTileCacheWorkerTest::_testVisibleTilesFirst()
+{
+    QGCCacheWorker worker;
+
+    // A bulk prefetch is already queued when the map view starts asking for tiles
+    QList<QGCMapTask*> prefetch;
+    for (int i = 0; i < 10; i++) {
+        prefetch.append(_saveTask(QStringLiteral("prefetch%1").arg(i), 1));
+        _queueTask(worker, prefetch.last());
+    }
+    QGCMapTask *const browse = _saveTask(QStringLiteral("browse"), UINT64_MAX);
+    _queueTask(worker, browse);
+    QGCMapTask *const visible1 = new QGCFetchTileTask(QStringLiteral("visible1"));
+    QGCMapTask *const visible2 = new QGCFetchTileTask(QStringLiteral("visible2"));
+    _queueTask(worker, visible1);
+    _queueTask(worker, visible2);
+
+    QList<QGCMapTask*> served;
+    {
+        QMutexLocker lock(&worker._taskQueueMutex);
+        QCOMPARE(worker._queuedTaskCount(), static_cast<qsizetype>(prefetch.count() + 3));
+        while (QGCMapTask *const task = worker._dequeueTask()) {
+            served.append(task);
+        }
+        QCOMPARE(worker._queuedTaskCount(), static_cast<qsizetype>(0));
+    }
+
+    // Visible tiles in request order, then tiles cached while browsing, then the prefetch in order
+    const QList<QGCMapTask*> expected = QList<QGCMapTask*>{ visible1, visible2, browse } + prefetch;
+    QCOMPARE(served, expected);
+
+    qDeleteAll(served);
+}
+
+void QGCTileCacheWorkerTest::_testSaveBatchStopsAtHigherPriority()
+{
+    QGCCacheWorker worker;
+
+    _queueTask(worker, _saveTask(QStringLiteral("prefetch0"), 1));
+    _queueTask(worker, _saveTask(QStringLiteral("prefetch1"), 1));
+
+    QMutexLocker lock(&worker._taskQueueMutex);
+    QVERIFY(worker._nextTaskIsSave());
+
+    // A visible tile request arriving mid batch must not wait for the rest of the prefetch saves
+    QGCMapTask *const visible = new QGCFetchTileTask(QStringLiteral("visible"));
+    worker._taskQueues[QGCCacheWorker::_taskPriority(visible)].enqueue(visible);
+    QVERIFY(!worker._nextTaskIsSave());
+
+    QGCMapTask *const next = worker._dequeueTask();
+    QCOMPARE(next, visible);
+    delete next;
+    QVERIFY(worker._nextTaskIsSave());
+
+    lock.unlock();
+    worker.stop();
+    QVERIFY(!worker.isRunning());
+    lock.relock();
+    QCOMPARE(worker._queuedTaskCount(), static_cast<qsizetype>(0));
+}
@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCCacheWorker;
+class QGCMapTask;
+
+class QGCTileCacheWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCTileCacheWorkerTest() = default;
+
+private slots:
+    void _testTaskPriority();
+    void _testVisibleTilesFirst();
+    void _testSaveBatchStopsAtHigherPriority();
+
+private:
+    /// Queues task the same way enqueueTask does, without starting the worker thread
+    static void _queueTask(QGCCacheWorker &worker, QGCMapTask *task);
+    static QGCMapTask *_saveTask(const QString &hash, quint64 tileSet);
+};
@@ -10,10 +10,19 @@
 #include "TerrainQueryTest.h"
 #include "TerrainTileManager.h"
 #include "TerrainQuery.h"
-
+#include "TerrainTileCopernicus.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
 
+#include <limits>
+
 /// Point Nemo is a point on Earth furthest from land
 static const QGeoCoordinate pointNemo = QGeoCoordinate(-48.875556, -123.392500);
 
@@ -195,6 +204,182 @@ void TerrainQueryTest::_testRequestCarpetHeights()
     QVERIFY(arguments.at(3).toList().constFirst().toList().constFirst().toDouble() == UnitTestTerrainQuery::Flat10Region::amslElevation);
 }
 
+int TerrainQueryTest::_standInTileX(double longitude)
+{
+    return static_cast<int>(floor((longitude + 180.0) / TerrainTileCopernicus::kTileSizeDegrees));
+}
+
+int TerrainQueryTest::_standInTileY(double latitude)
+{
+    return static_cast<int>(floor((latitude + 90.0) / TerrainTileCopernicus::kTileSizeDegrees));
+}
+
+QByteArray TerrainQueryTest::_standInTileResponse(int tileX, int tileY)
+{
+    constexpr int gridSize = 10;
+    const double elevation = _standInElevation(tileX);
+    const double swLat = (tileY * TerrainTileCopernicus::kTileSizeDegrees) - 90.0;
+    const double swLon = (tileX * TerrainTileCopernicus::kTileSizeDegrees) - 180.0;
+
+    QJsonArray row;
+    for (int i = 0; i < gridSize; i++) {
+        row.append(elevation);
+    }
+    QJsonArray carpet;
+    for (int i = 0; i < gridSize; i++) {
+        carpet.append(row);
+    }
+
+    const QJsonObject bounds{
+        { "sw", QJsonArray{ swLat, swLon } },
+        { "ne", QJsonArray{ swLat + TerrainTileCopernicus::kTileSizeDegrees, swLon + TerrainTileCopernicus::kTileSizeDegrees } },
+    };
+    const QJsonObject stats{
+        { "min", elevation },
+        { "max", elevation },
+        { "avg", elevation },
+    };
+    const QJsonObject data{
+        { "bounds", bounds },
+        { "stats", stats },
+        { "carpet", carpet },
+    };
+    const QJsonObject root{
+        { "status", "success" },
+        { "data", data },
+    };
+
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+void TerrainQueryTest::_seedStandInTiles(const QGeoRectangle &region)
+{
+    TerrainTileManager* const manager = TerrainTileManager::instance();
+    const TerrainTileManager::SharedMapProvider provider = TerrainTileManager::_elevationProvider();
+
+    for (int tileX = _standInTileX(region.topLeft().longitude()); tileX <= _standInTileX(region.bottomRight().longitude()); tileX++) {
+        for (int tileY = _standInTileY(region.bottomRight().latitude()); tileY <= _standInTileY(region.topLeft().latitude()); tileY++) {
+            const QByteArray tileData = TerrainTileCopernicus::serializeFromData(_standInTileResponse(tileX, tileY));
+            QVERIFY(!tileData.isEmpty());
+            QVERIFY(manager->_cacheTile(tileData, TerrainTileManager::_tileHash(provider, TerrainTileManager::_tileKey(tileX, tileY))));
+        }
+    }
+}
+
+void TerrainQueryTest::_testPolyPathHeights()
+{
+    TerrainTileManager* const manager = TerrainTileManager::instance();
+    const QTemporaryDir tileCacheDir;
+    QVERIFY(tileCacheDir.isValid());
+    const QString savedTileCacheDir = manager->_tileCacheDir;
+    manager->_tileCacheDir = tileCacheDir.path();
+
+    // East across several tiles, then north within a single tile column
+    const QGeoCoordinate east(pointNemo.latitude(), pointNemo.longitude() + 0.025);
+    const QGeoCoordinate north(east.latitude() + 0.02, east.longitude());
+    const QList<QGeoCoordinate> polyPath = { pointNemo, east, north };
+    _seedStandInTiles(QGeoRectangle(polyPath));
+
+    TerrainQueryInterface query;
+    bool received = false;
+    bool success = false;
+    QList<TerrainQuery::PathHeightInfo_t> rgPathHeightInfo;
+    (void) connect(&query, &TerrainQueryInterface::polyPathHeightsReceived, this, [&](bool querySuccess, const QList<TerrainQuery::PathHeightInfo_t> &result) {
+        received = true;
+        success = querySuccess;
+        rgPathHeightInfo = result;
+    });
+    manager->addPolyPathQuery(&query, polyPath);
+
+    manager->_tileCacheDir = savedTileCacheDir;
+    manager->_tiles.clear();
+
+    // All tiles were cached so the result is returned without a download
+    QVERIFY(received);
+    QVERIFY(success);
+    QCOMPARE(rgPathHeightInfo.count(), 2);
+
+    double expectedMin = std::numeric_limits<double>::max();
+    double expectedMax = std::numeric_limits<double>::lowest();
+    for (int tileX = _standInTileX(pointNemo.longitude()); tileX <= _standInTileX(east.longitude()); tileX++) {
+        expectedMin = qMin(expectedMin, _standInElevation(tileX));
+        expectedMax = qMax(expectedMax, _standInElevation(tileX));
+    }
+
+    const TerrainQuery::PathHeightInfo_t &eastSegment = rgPathHeightInfo[0];
+    QVERIFY(eastSegment.heights.count() > 2);
+    QVERIFY(eastSegment.distanceBetween > 0.);
+    QVERIFY(eastSegment.finalDistanceBetween > 0.);
+    QCOMPARE(eastSegment.heights.constFirst(), _standInElevation(_standInTileX(pointNemo.longitude())));
+    QCOMPARE(eastSegment.heights.constLast(), _standInElevation(_standInTileX(east.longitude())));
+    QCOMPARE(eastSegment.minHeight, expectedMin);
+    QCOMPARE(eastSegment.maxHeight, expectedMax);
+
+    const TerrainQuery::PathHeightInfo_t &northSegment = rgPathHeightInfo[1];
+    QVERIFY(northSegment.heights.count() > 2);
+    QCOMPARE(northSegment.minHeight, _standInElevation(_standInTileX(east.longitude())));
+    QCOMPARE(northSegment.maxHeight, northSegment.minHeight);
+}
+
+void TerrainQueryTest::_benchmarkPolyPathHeights()
+{
+    TerrainTileManager* const manager = TerrainTileManager::instance();
+    const QTemporaryDir tileCacheDir;
+    QVERIFY(tileCacheDir.isValid());
+    const QString savedTileCacheDir = manager->_tileCacheDir;
+    manager->_tileCacheDir = tileCacheDir.path();
+
+    // 2000 waypoint survey: 1000 east-west transects 3.3km long, 5.5m apart
+    QList<QGeoCoordinate> polyPath;
+    for (int i = 0; i < 1000; i++) {
+        const double latitude = pointNemo.latitude() + (i * 0.00005);
+        const QGeoCoordinate west(latitude, pointNemo.longitude());
+        const QGeoCoordinate east(latitude, pointNemo.longitude() + 0.03);
+        (void) polyPath.append((i % 2) ? east : west);
+        (void) polyPath.append((i % 2) ? west : east);
+    }
+    _seedStandInTiles(QGeoRectangle(polyPath));
+
+    TerrainQueryInterface query;
+    qsizetype segmentCount = 0;
+    (void) connect(&query, &TerrainQueryInterface::polyPathHeightsReceived, this, [&segmentCount](bool success, const QList<TerrainQuery::PathHeightInfo_t> &rgPathHeightInfo) {
+        segmentCount = success ? rgPathHeightInfo.count() : -1;
+    });
+
+    QBENCHMARK {
+        manager->addPolyPathQuery(&query, polyPath);
+    }
+
+    manager->_tileCacheDir = savedTileCacheDir;
+    manager->_tiles.clear();
+
+    QCOMPARE(segmentCount, polyPath.count() - 1);
+}
+
+void TerrainQueryTest::_testPruneTileCacheDir()
+{
+    const QTemporaryDir tileCacheDir;
+    QVERIFY(tileCacheDir.isValid());
+
+    const QStringList fileNames = { QStringLiteral("recent.bin"), QStringLiteral("stale.bin"), QStringLiteral("other.txt") };
+    for (const QString &fileName : fileNames) {
+        QFile file(tileCacheDir.filePath(fileName));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(QByteArray(16, 'x')), 16);
+        QVERIFY(file.flush());
+        if (fileName != QStringLiteral("recent.bin")) {
+            QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-(TerrainTileManager::kMaxTileDiskCacheAgeDays + 1)), QFileDevice::FileModificationTime));
+        }
+    }
+
+    TerrainTileManager::_pruneTileCacheDir(tileCacheDir.path());
+
+    // Only tiles are pruned
+    QVERIFY(QFile::exists(tileCacheDir.filePath(QStringLiteral("recent.bin"))));
+    QVERIFY(!QFile::exists(tileCacheDir.filePath(QStringLiteral("stale.bin"))));
+    QVERIFY(QFile::exists(tileCacheDir.filePath(QStringLiteral("other.txt"))));
+}
+
 // Test Requires Internet, so disable by default.
 // Or, check if internet and elevation server are available?
 #if 0
@@ -88,5 +88,18 @@ private slots:
     void _testRequestCoordinateHeights();
     void _testRequestPathHeights();
     void _testRequestCarpetHeights();
+    void _testPolyPathHeights();
+    void _benchmarkPolyPathHeights();
+    void _testPruneTileCacheDir();
     // void _testTerrainAtCoordinateQuery();
+
+private:
+    /// Elevation of every grid value in the stand-in tiles, constant per tile and varying west to east
+    static double _standInElevation(int tileX) { return 10. * (tileX % 5); }
+    static int _standInTileX(double longitude);
+    static int _standInTileY(double latitude);
+    /// Copernicus style tile response, as the elevation server would return it
+    static QByteArray _standInTileResponse(int tileX, int tileY);
+    /// Loads the tile manager cache with stand-in tiles for every tile touching the region
+    static void _seedStandInTiles(const QGeoRectangle &region);
 };
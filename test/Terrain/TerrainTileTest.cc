@@ -10,4 +10,112 @@
 #include "TerrainTileTest.h"
 #include "TerrainTile.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtPositioning/QGeoCoordinate>
 #include <QtTest/QTest>
+
+#include <memory>
+
+/// 2x2 tile covering (0,0) to (2,2), south row { 0, 10 }, north row { 20, 30 }
+QByteArray TerrainTileTest::_serializedTile()
+{
+    TerrainTile::TileInfo_t tileInfo{};
+    tileInfo.swLat = 0.0;
+    tileInfo.swLon = 0.0;
+    tileInfo.neLat = 2.0;
+    tileInfo.neLon = 2.0;
+    tileInfo.minElevation = 0;
+    tileInfo.maxElevation = 30;
+    tileInfo.avgElevation = 15.0;
+    tileInfo.gridSizeLat = 2;
+    tileInfo.gridSizeLon = 2;
+
+    const int16_t grid[] = { 0, 10, 20, 30 };
+
+    QByteArray bytes(reinterpret_cast<const char*>(&tileInfo), sizeof(tileInfo));
+    bytes.append(reinterpret_cast<const char*>(grid), sizeof(grid));
+    return bytes;
+}
+
+void TerrainTileTest::_testNearestElevation()
+{
+    const TerrainTile tile(_serializedTile());
+    QVERIFY(tile.isValid());
+    QCOMPARE(tile.byteSize(), _serializedTile().size());
+
+    QCOMPARE(tile.elevation(QGeoCoordinate(0.5, 0.5)), 0.0);
+    QCOMPARE(tile.elevation(QGeoCoordinate(0.5, 1.5)), 10.0);
+    QCOMPARE(tile.elevation(QGeoCoordinate(1.5, 0.5)), 20.0);
+    QCOMPARE(tile.elevation(QGeoCoordinate(1.5, 1.5)), 30.0);
+    QVERIFY(qIsNaN(tile.elevation(QGeoCoordinate(3.0, 0.5))));
+
+    const TerrainTile truncated(_serializedTile().chopped(2));
+    QVERIFY(!truncated.isValid());
+}
+
+void TerrainTileTest::_testBatchNearest()
+{
+    const TerrainTile tile(_serializedTile());
+    QVERIFY(tile.isValid());
+
+    const double latitudes[]  = { 0.5, 1.0, 1.5,  1.0, 0.0, 3.0 };
+    const double longitudes[] = { 0.5, 1.0, 0.75, 1.5, 1.9, 1.0 };
+    double elevations[6];
+    tile.elevations(latitudes, longitudes, 6, elevations);
+
+    // The default matches elevation() for every coordinate
+    for (int i = 0; i < 6; i++) {
+        const double expected = tile.elevation(QGeoCoordinate(latitudes[i], longitudes[i]));
+        if (qIsNaN(expected)) {
+            QVERIFY(qIsNaN(elevations[i]));
+        } else {
+            QCOMPARE(elevations[i], expected);
+        }
+    }
+
+    QCOMPARE(elevations[0], 0.0);   // South west cell
+    QCOMPARE(elevations[1], 30.0);  // Cell corner belongs to the north east cell
+    QCOMPARE(elevations[2], 20.0);  // North west cell
+    QCOMPARE(elevations[3], 30.0);  // North east cell
+    QCOMPARE(elevations[4], 10.0);  // South east cell
+    QVERIFY(qIsNaN(elevations[5])); // Outside the tile
+}
+
+void TerrainTileTest::_testBatchBilinear()
+{
+    const TerrainTile tile(_serializedTile());
+    QVERIFY(tile.isValid());
+
+    const double latitudes[]  = { 0.5, 1.0, 1.5,  1.0, 0.0, 3.0 };
+    const double longitudes[] = { 0.5, 1.0, 0.75, 1.5, 2.0, 1.0 };
+    double elevations[6];
+    tile.elevations(latitudes, longitudes, 6, elevations, TerrainTile::Interpolation::Bilinear);
+
+    QCOMPARE(elevations[0], 0.0);   // Cell center returns the grid value
+    QCOMPARE(elevations[1], 15.0);  // Midway between all four cells
+    QCOMPARE(elevations[2], 22.5);  // On the north row centers, a quarter of the way east
+    QCOMPARE(elevations[3], 20.0);  // East edge clamps to the east column
+    QCOMPARE(elevations[4], 10.0);  // South east corner clamps to the corner cell
+    QVERIFY(qIsNaN(elevations[5])); // Outside the tile
+}
+
+void TerrainTileTest::_testMappedFile()
+{
+    const QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    const QString path = tempDir.filePath(QStringLiteral("tile.bin"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(_serializedTile()), _serializedTile().size());
+    file.close();
+
+    const std::unique_ptr<TerrainTile> tile(TerrainTile::fromMappedFile(path));
+    QVERIFY(tile);
+    QVERIFY(tile->isValid());
+    QCOMPARE(tile->data(), _serializedTile());
+    QCOMPARE(tile->elevation(QGeoCoordinate(1.5, 1.5)), 30.0);
+
+    QVERIFY(!TerrainTile::fromMappedFile(tempDir.filePath(QStringLiteral("missing.bin"))));
+}
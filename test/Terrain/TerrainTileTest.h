@@ -16,4 +16,11 @@ class TerrainTileTest : public UnitTest
     Q_OBJECT
 
 private slots:
+    void _testNearestElevation();
+    void _testBatchNearest();
+    void _testBatchBilinear();
+    void _testMappedFile();
+
+private:
+    static QByteArray _serializedTile();
 };
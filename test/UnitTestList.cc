@@ -17,6 +17,7 @@
 // AnalyzeView
 #include "ExifParserTest.h"
 #include "GeoTagControllerTest.h"
+#include "MAVLinkChartSeriesTest.h"
 // #include "MavlinkLogTest.h"
 // #include "LogDownloadTest.h"
 #include "PX4LogParserTest.h"
@@ -32,9 +33,17 @@
 #include "QGCCameraManagerTest.h"
 
 // Comms
+#include "JoystickFrameParserTest.h"
+#include "LinkConfigurationTest.h"
+#include "LogReplayIndexTest.h"
+#include "MAVLinkLogWriterTest.h"
+#include "MqttLinkTest.h"
+#include "MqttPublishQueueTest.h"
 #include "QGCSerialPortInfoTest.h"
+#include "TlogAnalyzerTest.h"
 
 // FactSystem
+#include "FactGroupTest.h"
 #include "FactSystemTestGeneric.h"
 #include "FactSystemTestPX4.h"
 #include "ParameterManagerTest.h"
@@ -49,6 +58,7 @@
 #include "GpsTest.h"
 
 // MAVLink
+#include "MAVLinkFramingTest.h"
 #include "StatusTextHandlerTest.h"
 #include "SigningTest.h"
 
@@ -85,6 +95,10 @@
 
 // QmlControls
 
+// QtLocationPlugin
+#include "QGCHotTileCacheTest.h"
+#include "QGCTileCacheWorkerTest.h"
+
 // Terrain
 #include "TerrainQueryTest.h"
 #include "TerrainTileTest.h"
@@ -107,6 +121,12 @@
 // #include "SendMavCommandWithHandlerTest.h"
 // #include "SendMavCommandWithSignalingTest.h"
 
+// Viewer3D
+#ifdef QGC_VIEWER3D
+#include "CityMapMeshCacheTest.h"
+#include "OsmParserTest.h"
+#endif
+
 // Missing
 // #include "FlightGearUnitTest.h"
 // #include "LinkManagerTest.h"
@@ -123,6 +143,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     // AnalyzeView
     UT_REGISTER_TEST(ExifParserTest)
     UT_REGISTER_TEST(GeoTagControllerTest)
+    UT_REGISTER_TEST(MAVLinkChartSeriesTest)
     // UT_REGISTER_TEST(MavlinkLogTest)
     // UT_REGISTER_TEST(LogDownloadTest)
     UT_REGISTER_TEST(PX4LogParserTest)
@@ -138,9 +159,17 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(QGCCameraManagerTest)
 
     // Comms
+    UT_REGISTER_TEST(JoystickFrameParserTest)
+    UT_REGISTER_TEST(LinkConfigurationTest)
+    UT_REGISTER_TEST(LogReplayIndexTest)
+    UT_REGISTER_TEST(MAVLinkLogWriterTest)
+    UT_REGISTER_TEST(MqttLinkTest)
+    UT_REGISTER_TEST(MqttPublishQueueTest)
     UT_REGISTER_TEST(QGCSerialPortInfoTest)
+    UT_REGISTER_TEST(TlogAnalyzerTest)
 
     // FactSystem
+    UT_REGISTER_TEST(FactGroupTest)
     UT_REGISTER_TEST(FactSystemTestGeneric)
     UT_REGISTER_TEST(FactSystemTestPX4)
     UT_REGISTER_TEST(ParameterManagerTest)
@@ -155,6 +184,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     // UT_REGISTER_TEST(GpsTest)
 
     // MAVLink
+    UT_REGISTER_TEST(MAVLinkFramingTest)
     UT_REGISTER_TEST(StatusTextHandlerTest)
     UT_REGISTER_TEST(SigningTest)
 
@@ -189,6 +219,10 @@ int runTests(bool stress, QStringView unitTestOptions)
 
     // QmlControls
 
+    // QtLocationPlugin
+    UT_REGISTER_TEST(QGCHotTileCacheTest)
+    UT_REGISTER_TEST(QGCTileCacheWorkerTest)
+
     // Terrain
     UT_REGISTER_TEST(TerrainQueryTest)
     UT_REGISTER_TEST(TerrainTileTest)
@@ -211,6 +245,12 @@ int runTests(bool stress, QStringView unitTestOptions)
     // UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
     // UT_REGISTER_TEST(SendMavCommandWithSignalingTest)
 
+    // Viewer3D
+#ifdef QGC_VIEWER3D
+    UT_REGISTER_TEST(CityMapMeshCacheTest)
+    UT_REGISTER_TEST(OsmParserTest)
+#endif
+
     // Missing
     // UT_REGISTER_TEST(FlightGearUnitTest)
     // UT_REGISTER_TEST(LinkManagerTest)
@@ -125,6 +125,182 @@ void FTPManagerTest::_testLostPackets(void)
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_testParallelSessions(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 64 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+    int         maxSessions = 0;
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // Sessions are all reset once the download completes, so look while it is running
+    connect(ftpManager, &FTPManager::commandProgress, this, [this, &maxSessions]() {
+        maxSessions = qMax(maxSessions, _mockLink->mockLinkFTP()->maxSessionsOpen());
+    });
+
+    _mockLink->mockLinkFTP()->enableRandromDrops(true);
+    ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation));
+
+    QCOMPARE(spyDownloadComplete.wait(30000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QVERIFY(maxSessions > 1);
+
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testSingleSessionFallback(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 64 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // Vehicle Naks the extra sessions, the whole file should come through the first one
+    _mockLink->mockLinkFTP()->setSessionLimit(1);
+    ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation));
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testResumeDownload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 64 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+    QString     toDir       = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    float       firstProgress = -1;
+    QString     partialFile;
+
+    // Vehicle stops responding half way through the download
+    _downloadPartial(ftpManager, filename, toDir, partialFile);
+    QVERIFY(!partialFile.isEmpty());
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    // Second attempt should pick up from what the first one received
+    connect(ftpManager, &FTPManager::commandProgress, this, [&firstProgress](float value) {
+        if (firstProgress < 0) {
+            firstProgress = value;
+        }
+    });
+
+    ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, toDir);
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QVERIFY(firstProgress >= 0.5f);
+    QVERIFY(!QFileInfo::exists(FTPDownloadFile::partFileName(arguments[0].toString())));
+    QVERIFY(!QFileInfo::exists(FTPDownloadFile::resumeFileName(arguments[0].toString())));
+
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
+/// Downloads filename with the vehicle going silent half way through, which leaves a partial file to resume from
+void FTPManagerTest::_downloadPartial(FTPManager* ftpManager, const QString& filename, const QString& toDir, QString& partialFile)
+{
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    QMetaObject::Connection progressConnection = connect(ftpManager, &FTPManager::commandProgress, this, [this](float value) {
+        if (value >= 0.5f) {
+            _mockLink->mockLinkFTP()->setErrorMode(MockLinkFTP::errModeNoResponse);
+        }
+    });
+
+    ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, toDir);
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+    disconnect(progressConnection);
+    _mockLink->mockLinkFTP()->setErrorMode(MockLinkFTP::errModeNone);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(!arguments[1].toString().isEmpty());
+
+    // What was received stays under the part file name, the destination is never left truncated
+    QVERIFY(!QFileInfo::exists(arguments[0].toString()));
+    QVERIFY(QFileInfo::exists(FTPDownloadFile::partFileName(arguments[0].toString())));
+    QVERIFY(QFileInfo::exists(FTPDownloadFile::resumeFileName(arguments[0].toString())));
+    partialFile = arguments[0].toString();
+}
+
+void FTPManagerTest::_testResumeChangedPartialFile(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 64 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+    QString     toDir       = QStandardPaths::writableLocation(QStandardPaths::TempLocation);
+    QString     partialFile;
+
+    _downloadPartial(ftpManager, filename, toDir, partialFile);
+    QVERIFY(!partialFile.isEmpty());
+
+    // Same size and resume information, but the content no longer matches the vehicle's file. The last byte is
+    // always part of a block which was received.
+    QFile file(FTPDownloadFile::partFileName(partialFile));
+    QVERIFY(file.open(QFile::ReadWrite));
+    QVERIFY(file.seek(file.size() - 1));
+    QCOMPARE(file.write(QByteArray(1, (char)0xFF)), 1);
+    file.close();
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+    ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, toDir);
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(!arguments[1].toString().isEmpty());
+    QVERIFY(!QFileInfo::exists(partialFile));
+    QVERIFY(!QFileInfo::exists(FTPDownloadFile::partFileName(partialFile)));
+    QVERIFY(!QFileInfo::exists(FTPDownloadFile::resumeFileName(partialFile)));
+
+    // With the bad partial thrown away the next download starts over and succeeds
+    ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, toDir);
+
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+
+    _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+    _disconnectMockLink();
+}
+
 void FTPManagerTest::_verifyFileSizeAndDelete(const QString& filename, int expectedSize)
 {
     QFileInfo fileInfo(filename);
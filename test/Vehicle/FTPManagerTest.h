@@ -11,12 +11,18 @@
 
 #include "UnitTest.h"
 
+class FTPManager;
+
 class FTPManagerTest : public UnitTest
 {
     Q_OBJECT
 
 private slots:
     void _testLostPackets                               (void);
+    void _testParallelSessions                          (void);
+    void _testSingleSessionFallback                     (void);
+    void _testResumeDownload                            (void);
+    void _testResumeChangedPartialFile                  (void);
     void _testListDirectory                             (void);
     void _testListDirectoryNoResponse                   (void);
     void _testListDirectoryNakResponse                  (void);
@@ -39,6 +45,7 @@ private:
     void _testCaseWorker            (const TestCase_t& testCase);
     void _sizeTestCaseWorker        (int fileSize);
     void _verifyFileSizeAndDelete   (const QString& filename, int expectedSize);
+    void _downloadPartial           (FTPManager* ftpManager, const QString& filename, const QString& toDir, QString& partialFile);
 
     static const TestCase_t _rgTestCases[];
 };
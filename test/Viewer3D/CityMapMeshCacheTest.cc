@@ -0,0 +1,169 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "CityMapMeshCacheTest.h"
+#include "CityMapMeshCache.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+QString CityMapMeshCacheTest::_settingsFilePath(const QString &filePath)
+{
+#ifdef __unix__
+    return filePath.mid(1);
+#else
+    return filePath;
+#endif
+}
+
+QByteArray CityMapMeshCacheTest::_vertexData(int vertexCount)
+{
+    QByteArray vertexData;
+    for (int i = 0; i < vertexCount * 3; i++) {
+        const float value = i * 0.5f;
+        vertexData.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    return vertexData;
+}
+
+void CityMapMeshCacheTest::_testRoundTrip()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString osmFilePath = _settingsFilePath(tempDir.filePath(QStringLiteral("map.osm")));
+
+    QFile osmFile(tempDir.filePath(QStringLiteral("map.osm")));
+    QVERIFY(osmFile.open(QIODevice::WriteOnly));
+    (void) osmFile.write("<osm/>");
+    osmFile.close();
+
+    CityMapMeshCache::MapInfo_t mapInfo;
+    mapInfo.gpsRef = QGeoCoordinate(47.3977, 8.5456, 0);
+    mapInfo.coordinateMin = QGeoCoordinate(47.39, 8.54, 0);
+    mapInfo.coordinateMax = QGeoCoordinate(47.40, 8.55, 0);
+    mapInfo.buildingLevelHeight = 3.5f;
+    const QByteArray vertexData = _vertexData(30);
+
+    CityMapMeshCache cache;
+    QVERIFY(!cache.open(osmFilePath));
+
+    QVERIFY(CityMapMeshCache::write(osmFilePath, mapInfo, vertexData));
+    QVERIFY(cache.open(osmFilePath));
+    QVERIFY(cache.isOpen());
+    QCOMPARE(cache.vertexData(), vertexData);
+    QCOMPARE(cache.mapInfo().gpsRef, mapInfo.gpsRef);
+    QCOMPARE(cache.mapInfo().coordinateMin, mapInfo.coordinateMin);
+    QCOMPARE(cache.mapInfo().coordinateMax, mapInfo.coordinateMax);
+    QCOMPARE(cache.mapInfo().buildingLevelHeight, mapInfo.buildingLevelHeight);
+
+    cache.close();
+    QVERIFY(!cache.isOpen());
+    QVERIFY(cache.vertexData().isEmpty());
+
+    // Writing again replaces the previous mesh
+    const QByteArray newVertexData = _vertexData(3);
+    QVERIFY(CityMapMeshCache::write(osmFilePath, mapInfo, newVertexData));
+    QVERIFY(cache.open(osmFilePath));
+    QCOMPARE(cache.vertexData(), newVertexData);
+    cache.close();
+
+    QVERIFY(QFile::remove(CityMapMeshCache::cacheFilePath(osmFilePath)));
+}
+
+void CityMapMeshCacheTest::_testWriteInvalid()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString osmFilePath = _settingsFilePath(tempDir.filePath(QStringLiteral("map.osm")));
+    const CityMapMeshCache::MapInfo_t mapInfo;
+
+    // No OSM file
+    QVERIFY(!CityMapMeshCache::write(osmFilePath, mapInfo, _vertexData(3)));
+
+    QFile osmFile(tempDir.filePath(QStringLiteral("map.osm")));
+    QVERIFY(osmFile.open(QIODevice::WriteOnly));
+    (void) osmFile.write("<osm/>");
+    osmFile.close();
+
+    // No vertices, or a partial vertex
+    QVERIFY(!CityMapMeshCache::write(osmFilePath, mapInfo, QByteArray()));
+    QVERIFY(!CityMapMeshCache::write(osmFilePath, mapInfo, _vertexData(3).chopped(sizeof(float))));
+    QVERIFY(!QFile::exists(CityMapMeshCache::cacheFilePath(osmFilePath)));
+}
+
+void CityMapMeshCacheTest::_testStale()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString osmFilePath = _settingsFilePath(tempDir.filePath(QStringLiteral("map.osm")));
+
+    QFile osmFile(tempDir.filePath(QStringLiteral("map.osm")));
+    QVERIFY(osmFile.open(QIODevice::WriteOnly));
+    (void) osmFile.write("<osm/>");
+    osmFile.close();
+
+    QVERIFY(CityMapMeshCache::write(osmFilePath, CityMapMeshCache::MapInfo_t(), _vertexData(3)));
+
+    // An edited OSM file invalidates the mesh built from it
+    QVERIFY(osmFile.open(QIODevice::Append));
+    (void) osmFile.write("\n");
+    osmFile.close();
+
+    CityMapMeshCache cache;
+    QVERIFY(!cache.open(osmFilePath));
+    QVERIFY(!cache.isOpen());
+
+    QVERIFY(QFile::remove(CityMapMeshCache::cacheFilePath(osmFilePath)));
+}
+
+void CityMapMeshCacheTest::_testCorrupt()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString osmFilePath = _settingsFilePath(tempDir.filePath(QStringLiteral("map.osm")));
+    const QString cacheFilePath = CityMapMeshCache::cacheFilePath(osmFilePath);
+    const QByteArray vertexData = _vertexData(3);
+
+    QFile osmFile(tempDir.filePath(QStringLiteral("map.osm")));
+    QVERIFY(osmFile.open(QIODevice::WriteOnly));
+    (void) osmFile.write("<osm/>");
+    osmFile.close();
+
+    CityMapMeshCache cache;
+    QFile cacheFile(cacheFilePath);
+
+    // Truncated header
+    QVERIFY(CityMapMeshCache::write(osmFilePath, CityMapMeshCache::MapInfo_t(), vertexData));
+    QVERIFY(cacheFile.resize(8));
+    QVERIFY(!cache.open(osmFilePath));
+    QVERIFY(!cache.isOpen());
+
+    // Wrong magic
+    QVERIFY(CityMapMeshCache::write(osmFilePath, CityMapMeshCache::MapInfo_t(), vertexData));
+    QVERIFY(cacheFile.open(QIODevice::ReadWrite));
+    (void) cacheFile.write(QByteArray(4, '\0'));
+    cacheFile.close();
+    QVERIFY(!cache.open(osmFilePath));
+
+    // Vertex data cut short
+    QVERIFY(CityMapMeshCache::write(osmFilePath, CityMapMeshCache::MapInfo_t(), vertexData));
+    QVERIFY(cacheFile.resize(cacheFile.size() - static_cast<qint64>(sizeof(float))));
+    QVERIFY(!cache.open(osmFilePath));
+
+    // Trailing bytes after the vertex data
+    QVERIFY(CityMapMeshCache::write(osmFilePath, CityMapMeshCache::MapInfo_t(), vertexData));
+    QVERIFY(cacheFile.open(QIODevice::Append));
+    (void) cacheFile.write(vertexData.left(3 * sizeof(float)));
+    cacheFile.close();
+    QVERIFY(!cache.open(osmFilePath));
+    QVERIFY(!cache.isOpen());
+
+    QVERIFY(QFile::remove(cacheFilePath));
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class CityMapMeshCacheTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    CityMapMeshCacheTest() = default;
+
+private slots:
+    void _testRoundTrip();
+    void _testWriteInvalid();
+    void _testStale();
+    void _testCorrupt();
+
+private:
+    /// Path as stored in the settings, which CityMapMeshCache resolves back to filePath
+    static QString _settingsFilePath(const QString &filePath);
+    static QByteArray _vertexData(int vertexCount);
+};
@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "OsmParserTest.h"
+#include "OsmParser.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <cstring>
+
+static constexpr const char *kTestMap = R"(<?xml version="1.0" encoding="UTF-8"?>
+<osm version="0.6">
+ <bounds minlat="47.0000000" minlon="8.0000000" maxlat="47.0010000" maxlon="8.0010000"/>
+ <node id="1" lat="47.0001" lon="8.0001"/>
+ <node id="2" lat="47.0001" lon="8.0002"/>
+ <node id="3" lat="47.0002" lon="8.0002"/>
+ <node id="4" lat="47.0002" lon="8.0001">
+  <tag k="amenity" v="bench"/>
+ </node>
+ <node id="5" lat="47.0005" lon="8.0005"/>
+ <node id="6" lat="47.0005" lon="8.0008"/>
+ <node id="7" lat="47.0008" lon="8.0008"/>
+ <node id="8" lat="47.0006" lon="8.0006"/>
+ <node id="9" lat="47.0006" lon="8.0007"/>
+ <node id="10" lat="47.0007" lon="8.0007"/>
+ <way id="100">
+  <nd ref="1"/><nd ref="2"/><nd ref="3"/><nd ref="4"/><nd ref="1"/>
+  <tag k="building" v="yes"/>
+  <tag k="building:levels" v="3"/>
+ </way>
+ <way id="101">
+  <nd ref="1"/><nd ref="2"/><nd ref="3"/><nd ref="1"/>
+  <tag k="building" v="shed"/>
+ </way>
+ <way id="102">
+  <nd ref="1"/><nd ref="2"/><nd ref="3"/><nd ref="1"/>
+  <tag k="height" v="12.5"/>
+ </way>
+ <way id="103">
+  <nd ref="1"/><nd ref="999"/><nd ref="3"/>
+  <tag k="highway" v="footway"/>
+ </way>
+ <way id="104">
+  <nd ref="5"/><nd ref="6"/><nd ref="7"/><nd ref="5"/>
+ </way>
+ <way id="105">
+  <nd ref="8"/><nd ref="9"/><nd ref="10"/><nd ref="8"/>
+ </way>
+ <relation id="200">
+  <member type="way" ref="104" role="outer"/>
+  <member type="way" ref="105" role="inner"/>
+  <tag k="type" v="multipolygon"/>
+  <tag k="building" v="yes"/>
+ </relation>
+</osm>
+)";
+
+QString OsmParserTest::_settingsFilePath(const QString &filePath)
+{
+#ifdef __unix__
+    return filePath.mid(1);
+#else
+    return filePath;
+#endif
+}
+
+bool OsmParserTest::_writeGridMap(const QString &filePath, int count)
+{
+    static constexpr int kColumns = 32;
+    static constexpr double kSpacing = 0.0002;
+    static constexpr double kSize = 0.0001;
+
+    QByteArray osm("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osm version=\"0.6\">\n");
+    osm += QStringLiteral(" <bounds minlat=\"47.0\" minlon=\"8.0\" maxlat=\"%1\" maxlon=\"%2\"/>\n")
+               .arg(47.0 + (count / kColumns + 1) * kSpacing, 0, 'f', 7).arg(8.0 + kColumns * kSpacing, 0, 'f', 7).toUtf8();
+    for (int i = 0; i < count; i++) {
+        const double lat = 47.0 + (i / kColumns) * kSpacing;
+        const double lon = 8.0 + (i % kColumns) * kSpacing;
+        const double corners[4][2] = {{lat, lon}, {lat, lon + kSize}, {lat + kSize, lon + kSize}, {lat + kSize, lon}};
+        for (int c = 0; c < 4; c++) {
+            osm += QStringLiteral(" <node id=\"%1\" lat=\"%2\" lon=\"%3\"/>\n").arg(i * 4 + c + 1).arg(corners[c][0], 0, 'f', 7).arg(corners[c][1], 0, 'f', 7).toUtf8();
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        osm += QStringLiteral(" <way id=\"%1\">\n").arg(100000 + i).toUtf8();
+        for (int c = 0; c <= 4; c++) {
+            osm += QStringLiteral("  <nd ref=\"%1\"/>\n").arg(i * 4 + (c % 4) + 1).toUtf8();
+        }
+        osm += QStringLiteral("  <tag k=\"building:levels\" v=\"%1\"/>\n </way>\n").arg(1 + (i % 3)).toUtf8();
+    }
+    osm += "</osm>\n";
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    return file.write(osm) == osm.size();
+}
+
+bool OsmParserTest::_parse(OsmParser &parser, const QString &filePath)
+{
+    bool parsed = false;
+    bool isValid = false;
+    // Queued so the result is looked at on this thread, after OsmParser has picked it up
+    (void) connect(parser._osmParserWorker, &OsmParserThread::fileParsed, this, [&parsed, &isValid](bool valid) {
+        parsed = true;
+        isValid = valid;
+    }, Qt::QueuedConnection);
+
+    parser.parseOsmFile(_settingsFilePath(filePath));
+    (void) QTest::qWaitFor([&parsed]() { return parsed; }, 10000);
+
+    (void) disconnect(parser._osmParserWorker, &OsmParserThread::fileParsed, this, nullptr);
+    return parsed && isValid;
+}
+
+void OsmParserTest::_testParse()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("map.osm"));
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    (void) file.write(kTestMap);
+    file.close();
+
+    OsmParser parser;
+    QVERIFY(_parse(parser, filePath));
+    QVERIFY(parser.mapLoaded());
+    QVERIFY(!parser.mapLoadedFromCache());
+
+    // The reference point is the centre of the bounds, which are read at float precision
+    QVERIFY(qAbs(parser.getGpsRef().latitude() - 47.0005) < 1e-5);
+    QVERIFY(qAbs(parser.getGpsRef().longitude() - 8.0005) < 1e-5);
+
+    const QMap<uint64_t, OsmParserThread::BuildingType_t> &buildings = parser._osmParserWorker->mapBuildings;
+
+    // The footway only resolves two nodes and the multipolygon replaces its member ways
+    QCOMPARE(buildings.keys(), (QList<uint64_t>{100, 101, 102, 104}));
+
+    QCOMPARE(buildings[100].points_local.size(), size_t(5));
+    QCOMPARE(buildings[100].levels, 3.f);
+    QCOMPARE(buildings[100].height, 0.f);
+    QVERIFY(buildings[100].bb_min.x() < buildings[100].bb_max.x());
+    QVERIFY(buildings[100].bb_min.y() < buildings[100].bb_max.y());
+
+    QCOMPARE(buildings[101].levels, 1.f);
+    QCOMPARE(buildings[102].height, 12.5f);
+    QCOMPARE(buildings[102].levels, 0.f);
+
+    QCOMPARE(buildings[104].points_local.size(), size_t(4));
+    QCOMPARE(buildings[104].points_local_inner.size(), size_t(4));
+    QCOMPARE(buildings[104].levels, 2.f);
+
+    // The node lookup is only needed while parsing
+    QVERIFY(parser._osmParserWorker->mapNodes.isEmpty());
+}
+
+void OsmParserTest::_testParseError()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("map.osm"));
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    (void) file.write(QByteArray(kTestMap).left(600));
+    file.close();
+
+    OsmParser parser;
+    QVERIFY(!_parse(parser, filePath));
+    QVERIFY(!parser.mapLoaded());
+
+    // Without bounds there is no reference point
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    (void) file.write("<osm version=\"0.6\"><node id=\"1\" lat=\"47\" lon=\"8\"/></osm>");
+    file.close();
+    QVERIFY(!_parse(parser, filePath));
+    QVERIFY(!parser.mapLoaded());
+}
+
+void OsmParserTest::_testBuildingToMeshChunks()
+{
+    static constexpr int kBuildingCount = 3 * OsmParser::_minBuildingsPerChunk + 17;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("grid.osm"));
+    QVERIFY(_writeGridMap(filePath, kBuildingCount));
+
+    OsmParser parser;
+    QVERIFY(_parse(parser, filePath));
+    QCOMPARE(static_cast<int>(parser._osmParserWorker->mapBuildings.size()), kBuildingCount);
+
+    // The chunked mesh must be the buildings triangulated one after the other in map order
+    std::vector<QVector3D> expected;
+    OsmParser::TriangulationScratch_t scratch;
+    for (const OsmParserThread::BuildingType_t &building : parser._osmParserWorker->mapBuildings) {
+        parser.triangulateBuilding(building, parser.buildingLevelHeight(), expected, scratch);
+    }
+    QVERIFY(!expected.empty());
+
+    const QByteArray mesh = parser.buildingToMesh();
+    QCOMPARE(mesh.size(), static_cast<qsizetype>(expected.size() * sizeof(QVector3D)));
+    QVERIFY(std::memcmp(mesh.constData(), expected.data(), mesh.size()) == 0);
+
+    // Nothing to triangulate
+    parser._osmParserWorker->mapBuildings.clear();
+    QVERIFY(parser.buildingToMesh().isEmpty());
+}
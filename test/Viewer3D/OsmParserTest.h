@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class OsmParser;
+
+class OsmParserTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    OsmParserTest() = default;
+
+private slots:
+    void _testParse();
+    void _testParseError();
+    void _testBuildingToMeshChunks();
+
+private:
+    /// Parses the file and waits for the result
+    ///     @return false: the file was rejected by the parser
+    bool _parse(OsmParser &parser, const QString &filePath);
+    /// Writes an OSM file with count square buildings laid out on a grid
+    static bool _writeGridMap(const QString &filePath, int count);
+    static QString _settingsFilePath(const QString &filePath);
+};
@@ -0,0 +1,27 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TLogBuilder.h"
+
+#include <QtCore/QtEndian>
+
+void TLogBuilder::appendMessage(quint64 timeUSecs, const mavlink_message_t &message)
+{
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+    appendFrame(timeUSecs, QByteArray::fromRawData(reinterpret_cast<const char*>(buffer), length));
+}
+
+void TLogBuilder::appendFrame(quint64 timeUSecs, const QByteArray &frame)
+{
+    uint8_t timeBytes[sizeof(quint64)];
+    qToBigEndian(timeUSecs, timeBytes);
+    (void) _data.append(reinterpret_cast<const char*>(timeBytes), sizeof(timeBytes));
+    (void) _data.append(frame);
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkLib.h"
+
+#include <QtCore/QByteArray>
+
+/// Builds the contents of a .tlog file for unit tests. Each record is a big endian 64 bit timestamp in
+/// microseconds followed by the MAVLink frame, the same layout MAVLinkProtocol writes.
+class TLogBuilder
+{
+public:
+    /// Appends the message framed for sending
+    void appendMessage(quint64 timeUSecs, const mavlink_message_t &message);
+
+    /// Appends raw frame bytes as they are, for tests which don't need a valid MAVLink frame
+    void appendFrame(quint64 timeUSecs, const QByteArray &frame);
+
+    const QByteArray &data() const { return _data; }
+
+private:
+    QByteArray _data;
+};